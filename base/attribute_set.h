@@ -15,9 +15,9 @@
 #ifndef THIRD_PARTY_CEL_CPP_BASE_ATTRIBUTE_SET_H_
 #define THIRD_PARTY_CEL_CPP_BASE_ATTRIBUTE_SET_H_
 
-#include "absl/container/btree_set.h"
 #include "absl/types/span.h"
 #include "base/attribute.h"
+#include "base/internal/sorted_vector_set.h"
 
 namespace google::api::expr::runtime {
 class AttributeUtility;
@@ -32,9 +32,13 @@ class UnknownSet;
 
 // AttributeSet is a container for CEL attributes that are identified as
 // unknown during expression evaluation.
+//
+// Attributes are kept in a sorted vector with room for a few attributes inline,
+// since most sets only hold one to three attributes and are merged repeatedly
+// as unknowns propagate through the expression.
 class AttributeSet final {
  private:
-  using Container = absl::btree_set<Attribute>;
+  using Container = base_internal::SortedVectorSet<Attribute, 3>;
 
  public:
   using value_type = typename Container::value_type;
@@ -55,11 +59,7 @@ class AttributeSet final {
   }
 
   AttributeSet(const AttributeSet& set1, const AttributeSet& set2)
-      : attributes_(set1.attributes_) {
-    for (const auto& attr : set2.attributes_) {
-      Add(attr);
-    }
-  }
+      : attributes_(set1.attributes_, set2.attributes_) {}
 
   iterator begin() const { return attributes_.begin(); }
 
@@ -91,13 +91,9 @@ class AttributeSet final {
   friend class UnknownValue;
   friend class base_internal::UnknownSet;
 
-  void Add(const Attribute& attribute) { attributes_.insert(attribute); }
+  void Add(const Attribute& attribute) { attributes_.Insert(attribute); }
 
-  void Add(const AttributeSet& other) {
-    for (const auto& attribute : other) {
-      Add(attribute);
-    }
-  }
+  void Add(const AttributeSet& other) { attributes_.Merge(other.attributes_); }
 
   // Attribute container.
   Container attributes_;
@@ -19,10 +19,6 @@ namespace cel {
 // Implementation for merge constructor.
 FunctionResultSet::FunctionResultSet(const FunctionResultSet& lhs,
                                      const FunctionResultSet& rhs)
-    : function_results_(lhs.function_results_) {
-  for (const auto& function_result : rhs) {
-    function_results_.insert(function_result);
-  }
-}
+    : function_results_(lhs.function_results_, rhs.function_results_) {}
 
 }  // namespace cel
@@ -18,8 +18,8 @@
 #include <initializer_list>
 #include <utility>
 
-#include "absl/container/btree_set.h"
 #include "base/function_result.h"
+#include "base/internal/sorted_vector_set.h"
 
 namespace google::api::expr::runtime {
 class AttributeUtility;
@@ -38,7 +38,7 @@ class UnknownSet;
 // Set semantics use |IsEqualTo()| defined on |FunctionResult|.
 class FunctionResultSet final {
  private:
-  using Container = absl::btree_set<FunctionResult>;
+  using Container = base_internal::SortedVectorSet<FunctionResult, 1>;
 
  public:
   using value_type = typename Container::value_type;
@@ -56,11 +56,15 @@ class FunctionResultSet final {
   FunctionResultSet(const FunctionResultSet& lhs, const FunctionResultSet& rhs);
 
   // Initialize with a single FunctionResult.
-  explicit FunctionResultSet(FunctionResult initial)
-      : function_results_{std::move(initial)} {}
+  explicit FunctionResultSet(FunctionResult initial) {
+    function_results_.Insert(std::move(initial));
+  }
 
-  FunctionResultSet(std::initializer_list<FunctionResult> il)
-      : function_results_(il) {}
+  FunctionResultSet(std::initializer_list<FunctionResult> il) {
+    for (const auto& function_result : il) {
+      function_results_.Insert(function_result);
+    }
+  }
 
   iterator begin() const { return function_results_.begin(); }
 
@@ -88,13 +92,11 @@ class FunctionResultSet final {
   friend class base_internal::UnknownSet;
 
   void Add(const FunctionResult& function_result) {
-    function_results_.insert(function_result);
+    function_results_.Insert(function_result);
   }
 
   void Add(const FunctionResultSet& other) {
-    for (const auto& function_result : other) {
-      Add(function_result);
-    }
+    function_results_.Merge(other.function_results_);
   }
 
   Container function_results_;
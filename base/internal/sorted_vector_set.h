@@ -0,0 +1,118 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_BASE_INTERNAL_SORTED_VECTOR_SET_H_
+#define THIRD_PARTY_CEL_CPP_BASE_INTERNAL_SORTED_VECTOR_SET_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+#include "absl/container/inlined_vector.h"
+
+namespace cel::base_internal {
+
+// Set of `T` ordered by `operator<`, stored as a sorted vector with inline
+// capacity for `N` elements.
+//
+// Unknown sets typically hold a handful of elements and are merged far more
+// often than they are searched, so a vector which avoids allocating for small
+// sets and merges in linear time beats a node based set. As with
+// `absl::btree_set`, elements which are not ordered with respect to each
+// other are considered equivalent and stored once.
+template <typename T, size_t N>
+class SortedVectorSet final {
+ private:
+  using Container = absl::InlinedVector<T, N>;
+
+ public:
+  using value_type = T;
+  using size_type = typename Container::size_type;
+  using iterator = typename Container::const_iterator;
+  using const_iterator = typename Container::const_iterator;
+
+  SortedVectorSet() = default;
+  SortedVectorSet(const SortedVectorSet&) = default;
+  SortedVectorSet(SortedVectorSet&&) = default;
+  SortedVectorSet& operator=(const SortedVectorSet&) = default;
+  SortedVectorSet& operator=(SortedVectorSet&&) = default;
+
+  // Union of `lhs` and `rhs`.
+  SortedVectorSet(const SortedVectorSet& lhs, const SortedVectorSet& rhs) {
+    if (lhs.empty()) {
+      elements_ = rhs.elements_;
+      return;
+    }
+    if (rhs.empty()) {
+      elements_ = lhs.elements_;
+      return;
+    }
+    elements_.reserve(lhs.size() + rhs.size());
+    std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                   std::back_inserter(elements_));
+  }
+
+  iterator begin() const { return elements_.begin(); }
+
+  const_iterator cbegin() const { return elements_.cbegin(); }
+
+  iterator end() const { return elements_.end(); }
+
+  const_iterator cend() const { return elements_.cend(); }
+
+  size_type size() const { return elements_.size(); }
+
+  bool empty() const { return elements_.empty(); }
+
+  bool operator==(const SortedVectorSet& other) const {
+    return elements_ == other.elements_;
+  }
+
+  void Insert(const T& value) {
+    // Appending in order is the common case when accumulating attributes.
+    if (elements_.empty() || elements_.back() < value) {
+      elements_.push_back(value);
+      return;
+    }
+    auto it = std::lower_bound(elements_.begin(), elements_.end(), value);
+    if (it != elements_.end() && !(value < *it)) {
+      return;
+    }
+    elements_.insert(it, value);
+  }
+
+  void Merge(const SortedVectorSet& other) {
+    if (other.empty()) {
+      return;
+    }
+    if (empty()) {
+      elements_ = other.elements_;
+      return;
+    }
+    if (elements_.back() < other.elements_.front()) {
+      elements_.insert(elements_.end(), other.begin(), other.end());
+      return;
+    }
+    SortedVectorSet merged(*this, other);
+    elements_ = std::move(merged.elements_);
+  }
+
+ private:
+  Container elements_;
+};
+
+}  // namespace cel::base_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_BASE_INTERNAL_SORTED_VECTOR_SET_H_
@@ -0,0 +1,100 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "base/internal/sorted_vector_set.h"
+
+#include <initializer_list>
+
+#include "internal/testing.h"
+
+namespace cel::base_internal {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+using IntSet = SortedVectorSet<int, 2>;
+
+IntSet MakeSet(std::initializer_list<int> values) {
+  IntSet set;
+  for (int value : values) {
+    set.Insert(value);
+  }
+  return set;
+}
+
+TEST(SortedVectorSetTest, InsertKeepsOrderAndDeduplicates) {
+  IntSet set = MakeSet({3, 1, 2, 3, 1, 5});
+
+  EXPECT_THAT(set, ElementsAre(1, 2, 3, 5));
+  EXPECT_EQ(set.size(), 4);
+}
+
+TEST(SortedVectorSetTest, Merge) {
+  IntSet set = MakeSet({1, 4});
+
+  set.Merge(IntSet());
+  EXPECT_THAT(set, ElementsAre(1, 4));
+  set.Merge(MakeSet({5, 6}));
+  EXPECT_THAT(set, ElementsAre(1, 4, 5, 6));
+  set.Merge(MakeSet({0, 4, 7}));
+  EXPECT_THAT(set, ElementsAre(0, 1, 4, 5, 6, 7));
+
+  IntSet empty;
+  empty.Merge(set);
+  EXPECT_EQ(empty, set);
+}
+
+TEST(SortedVectorSetTest, UnionConstructor) {
+  IntSet lhs = MakeSet({1, 3, 5});
+  IntSet rhs = MakeSet({2, 3, 4});
+
+  EXPECT_THAT(IntSet(lhs, rhs), ElementsAre(1, 2, 3, 4, 5));
+  EXPECT_THAT(IntSet(rhs, lhs), ElementsAre(1, 2, 3, 4, 5));
+  EXPECT_EQ(IntSet(lhs, IntSet()), lhs);
+  EXPECT_EQ(IntSet(IntSet(), rhs), rhs);
+  EXPECT_THAT(IntSet(IntSet(), IntSet()), IsEmpty());
+}
+
+struct Keyed {
+  int key;
+  int value;
+
+  bool operator<(const Keyed& other) const { return key < other.key; }
+  bool operator==(const Keyed& other) const {
+    return key == other.key && value == other.value;
+  }
+};
+
+TEST(SortedVectorSetTest, KeepsFirstOfEquivalentElements) {
+  SortedVectorSet<Keyed, 1> set;
+  set.Insert({2, 0});
+  set.Insert({1, 0});
+  set.Insert({2, 1});
+  SortedVectorSet<Keyed, 1> other;
+  other.Insert({1, 1});
+  other.Insert({3, 1});
+
+  SortedVectorSet<Keyed, 1> merged(set, other);
+  set.Merge(other);
+
+  EXPECT_EQ(merged, set);
+  ASSERT_EQ(set.size(), 3);
+  EXPECT_EQ(set.begin()[0].value, 0);
+  EXPECT_EQ(set.begin()[1].value, 0);
+  EXPECT_EQ(set.begin()[2].value, 1);
+}
+
+}  // namespace
+}  // namespace cel::base_internal
@@ -15,6 +15,8 @@
 #ifndef THIRD_PARTY_CEL_CPP_CHECKER_CHECKER_OPTIONS_H_
 #define THIRD_PARTY_CEL_CPP_CHECKER_CHECKER_OPTIONS_H_
 
+#include <cstdint>
+
 namespace cel {
 
 // Options for enabling core type checker features.
@@ -85,6 +87,23 @@ struct CheckerOptions {
   // expressions that compound nesting e.g.
   // type5(T)->type(type(type(type(type(T)))))); type5(type5(T)) -> type10(T)
   int max_type_decl_nesting = 13;
+
+  // Enable static cost estimation for checked expressions.
+  //
+  // When enabled, the estimated cost bounds are reported on the
+  // ValidationResult. Size hints for variables can be declared with
+  // `TypeCheckerBuilder::AddSizeHint`.
+  bool enable_cost_estimation = false;
+
+  // Maximum estimated cost (inclusive) for a checked expression. 0 means no
+  // limit.
+  //
+  // If the upper bound of the estimated cost exceeds the limit, the checker
+  // reports an error-level issue. This implies `enable_cost_estimation`.
+  //
+  // Note: the upper bound is unbounded for comprehensions over lists or maps
+  // without a size hint.
+  uint64_t max_estimated_cost = 0;
 };
 
 }  // namespace cel
@@ -0,0 +1,376 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "checker/cost_estimator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+#include "base/builtins.h"
+#include "common/ast.h"
+#include "common/constant.h"
+#include "common/expr.h"
+#include "re2/re2.h"
+
+namespace cel {
+
+namespace {
+
+constexpr uint64_t kUnbounded = CostEstimate::kUnbounded;
+
+// Fixed costs of constructing aggregates, in addition to their elements.
+constexpr uint64_t kListCreateCost = 10;
+constexpr uint64_t kMapCreateCost = 30;
+constexpr uint64_t kStructCreateCost = 40;
+
+// Number of bytes (or elements) processed per unit of cost by functions that
+// scale with the length of their operands.
+constexpr uint64_t kLengthPerCostUnit = 10;
+
+uint64_t SaturatingAdd(uint64_t a, uint64_t b) {
+  return a > kUnbounded - b ? kUnbounded : a + b;
+}
+
+uint64_t SaturatingMul(uint64_t a, uint64_t b) {
+  if (a == 0 || b == 0) {
+    return 0;
+  }
+  return a > kUnbounded / b ? kUnbounded : a * b;
+}
+
+CostEstimate Add(const CostEstimate& a, const CostEstimate& b) {
+  return {SaturatingAdd(a.min, b.min), SaturatingAdd(a.max, b.max)};
+}
+
+CostEstimate Add(const CostEstimate& a, uint64_t b) { return Add(a, {b, b}); }
+
+// Cost of a linear pass over `length` bytes or elements.
+uint64_t LengthCost(uint64_t length) {
+  if (length == kUnbounded) {
+    return kUnbounded;
+  }
+  return length / kLengthPerCostUnit +
+         (length % kLengthPerCostUnit != 0 ? 1 : 0);
+}
+
+struct NodeEstimate {
+  CostEstimate cost;
+  // Only meaningful if the node is a string, bytes, list or map.
+  SizeEstimate size;
+  // Qualified name of the variable or field path the node refers to, if any.
+  absl::optional<std::string> path;
+};
+
+// Returns true if the comprehension step appends at most one element to the
+// accumulator on each iteration, as generated by the `map` and `filter`
+// macros.
+bool IsAppendStep(const Expr& step, const std::string& accu_var) {
+  if (!step.has_call_expr()) {
+    return false;
+  }
+  const CallExpr& call = step.call_expr();
+  if (call.function() == builtin::kAdd && call.args().size() == 2) {
+    return call.args()[0].has_ident_expr() &&
+           call.args()[0].ident_expr().name() == accu_var &&
+           call.args()[1].has_list_expr() &&
+           call.args()[1].list_expr().elements().size() == 1;
+  }
+  if (call.function() == builtin::kTernary && call.args().size() == 3) {
+    const Expr& if_true = call.args()[1];
+    const Expr& if_false = call.args()[2];
+    return (IsAppendStep(if_true, accu_var) && if_false.has_ident_expr() &&
+            if_false.ident_expr().name() == accu_var) ||
+           (IsAppendStep(if_false, accu_var) && if_true.has_ident_expr() &&
+            if_true.ident_expr().name() == accu_var);
+  }
+  return false;
+}
+
+bool IsConstantTrue(const Expr& expr) {
+  return expr.has_const_expr() && expr.const_expr().has_bool_value() &&
+         expr.const_expr().bool_value();
+}
+
+class CostEstimator {
+ public:
+  CostEstimator(const Ast& ast, const SizeHints& size_hints)
+      : ast_(ast), size_hints_(size_hints) {}
+
+  NodeEstimate Estimate(const Expr& expr) {
+    NodeEstimate estimate;
+    if (expr.has_const_expr()) {
+      estimate = EstimateConst(expr.const_expr());
+    } else if (expr.has_ident_expr()) {
+      estimate = EstimateIdent(expr);
+    } else if (expr.has_select_expr()) {
+      estimate = EstimateSelect(expr);
+    } else if (expr.has_call_expr()) {
+      estimate = EstimateCall(expr);
+    } else if (expr.has_list_expr()) {
+      estimate.cost = {kListCreateCost, kListCreateCost};
+      for (const ListExprElement& element : expr.list_expr().elements()) {
+        estimate.cost = Add(estimate.cost, Estimate(element.expr()).cost);
+      }
+      uint64_t size = expr.list_expr().elements().size();
+      estimate.size = {size, size};
+    } else if (expr.has_map_expr()) {
+      estimate.cost = {kMapCreateCost, kMapCreateCost};
+      for (const MapExprEntry& entry : expr.map_expr().entries()) {
+        estimate.cost = Add(estimate.cost, Estimate(entry.key()).cost);
+        estimate.cost = Add(estimate.cost, Estimate(entry.value()).cost);
+      }
+      uint64_t size = expr.map_expr().entries().size();
+      estimate.size = {size, size};
+    } else if (expr.has_struct_expr()) {
+      estimate.cost = {kStructCreateCost, kStructCreateCost};
+      for (const StructExprField& field : expr.struct_expr().fields()) {
+        estimate.cost = Add(estimate.cost, Estimate(field.value()).cost);
+      }
+    } else if (expr.has_comprehension_expr()) {
+      estimate = EstimateComprehension(expr.comprehension_expr());
+    }
+    nodes_[expr.id()] = estimate.cost;
+    return estimate;
+  }
+
+  absl::flat_hash_map<int64_t, CostEstimate> release_nodes() {
+    return std::move(nodes_);
+  }
+
+ private:
+  NodeEstimate EstimateConst(const Constant& constant) {
+    NodeEstimate estimate;
+    if (constant.has_string_value()) {
+      uint64_t size = constant.string_value().size();
+      estimate.size = {size, size};
+    } else if (constant.has_bytes_value()) {
+      uint64_t size = constant.bytes_value().size();
+      estimate.size = {size, size};
+    }
+    return estimate;
+  }
+
+  NodeEstimate EstimateIdent(const Expr& expr) {
+    NodeEstimate estimate;
+    estimate.cost = {1, 1};
+    // Comprehension variables have no reference, so they never pick up hints
+    // for a shadowed declaration.
+    if (const Reference* reference = ast_.GetReference(expr.id());
+        reference != nullptr) {
+      estimate.path = reference->name();
+      ApplyHint(estimate);
+    }
+    return estimate;
+  }
+
+  NodeEstimate EstimateSelect(const Expr& expr) {
+    const SelectExpr& select = expr.select_expr();
+    NodeEstimate estimate;
+    estimate.cost = {1, 1};
+    // A qualified variable name resolved by the checker is looked up directly
+    // without evaluating the operand.
+    if (const Reference* reference = ast_.GetReference(expr.id());
+        reference != nullptr) {
+      estimate.path = reference->name();
+      ApplyHint(estimate);
+      return estimate;
+    }
+    NodeEstimate operand = Estimate(select.operand());
+    estimate.cost = Add(estimate.cost, operand.cost);
+    if (!select.test_only() && operand.path.has_value()) {
+      estimate.path = absl::StrCat(*operand.path, ".", select.field());
+      ApplyHint(estimate);
+    }
+    return estimate;
+  }
+
+  NodeEstimate EstimateCall(const Expr& expr) {
+    const CallExpr& call = expr.call_expr();
+    const std::string& function = call.function();
+
+    absl::optional<NodeEstimate> target;
+    if (call.has_target()) {
+      target = Estimate(call.target());
+    }
+    std::vector<NodeEstimate> args;
+    args.reserve(call.args().size());
+    for (const Expr& arg : call.args()) {
+      args.push_back(Estimate(arg));
+    }
+
+    NodeEstimate estimate;
+    estimate.cost = {1, 1};
+
+    if ((function == builtin::kAnd || function == builtin::kOr) &&
+        args.size() == 2) {
+      // The right operand is skipped if the left one short-circuits.
+      estimate.cost.min = SaturatingAdd(1, args[0].cost.min);
+      estimate.cost.max =
+          SaturatingAdd(1, Add(args[0].cost, args[1].cost).max);
+      return estimate;
+    }
+    if (function == builtin::kTernary && args.size() == 3) {
+      const NodeEstimate& if_true = args[1];
+      const NodeEstimate& if_false = args[2];
+      estimate.cost =
+          Add(Add(args[0].cost, 1),
+              {std::min(if_true.cost.min, if_false.cost.min),
+               std::max(if_true.cost.max, if_false.cost.max)});
+      estimate.size = {std::min(if_true.size.min, if_false.size.min),
+                       std::max(if_true.size.max, if_false.size.max)};
+      return estimate;
+    }
+
+    if (target.has_value()) {
+      estimate.cost = Add(estimate.cost, target->cost);
+    }
+    for (const NodeEstimate& arg : args) {
+      estimate.cost = Add(estimate.cost, arg.cost);
+    }
+
+    // Receiver-style and global overloads of the string functions.
+    const NodeEstimate* subject = nullptr;
+    const NodeEstimate* operand = nullptr;
+    const Expr* operand_expr = nullptr;
+    if (target.has_value() && args.size() == 1) {
+      subject = &*target;
+      operand = &args[0];
+      operand_expr = &call.args()[0];
+    } else if (!target.has_value() && args.size() == 2) {
+      subject = &args[0];
+      operand = &args[1];
+      operand_expr = &call.args()[1];
+    }
+    if (subject == nullptr) {
+      return estimate;
+    }
+
+    if (function == builtin::kStringContains ||
+        function == builtin::kStringStartsWith ||
+        function == builtin::kStringEndsWith) {
+      estimate.cost = Add(estimate.cost, {LengthCost(subject->size.min),
+                                          LengthCost(subject->size.max)});
+    } else if (function == builtin::kRegexMatch) {
+      SizeEstimate program_size = operand->size;
+      if (operand_expr->has_const_expr() &&
+          operand_expr->const_expr().has_string_value()) {
+        RE2 re2(operand_expr->const_expr().string_value());
+        if (re2.ok()) {
+          uint64_t size = re2.ProgramSize();
+          program_size = {size, size};
+        }
+      }
+      estimate.cost = Add(
+          estimate.cost,
+          {SaturatingMul(LengthCost(subject->size.min), program_size.min),
+           SaturatingMul(LengthCost(subject->size.max), program_size.max)});
+    } else if (!target.has_value() && IsSized(call.args()[0])) {
+      if (function == builtin::kAdd) {
+        estimate.size = {SaturatingAdd(subject->size.min, operand->size.min),
+                         SaturatingAdd(subject->size.max, operand->size.max)};
+        estimate.cost = Add(estimate.cost, {LengthCost(estimate.size.min),
+                                            LengthCost(estimate.size.max)});
+      } else if (function == builtin::kEqual ||
+                 function == builtin::kInequal) {
+        // Values of different sizes compare in constant time.
+        estimate.cost = Add(
+            estimate.cost,
+            {0, LengthCost(std::min(subject->size.max, operand->size.max))});
+      }
+    } else if (function == builtin::kIn && IsList(call.args()[1])) {
+      estimate.cost = Add(estimate.cost, {0, operand->size.max});
+    }
+    return estimate;
+  }
+
+  NodeEstimate EstimateComprehension(const ComprehensionExpr& comprehension) {
+    NodeEstimate range = Estimate(comprehension.iter_range());
+    NodeEstimate init = Estimate(comprehension.accu_init());
+    NodeEstimate condition = Estimate(comprehension.loop_condition());
+    NodeEstimate step = Estimate(comprehension.loop_step());
+    NodeEstimate result = Estimate(comprehension.result());
+
+    // The loop may exit after the first iteration unless the condition is
+    // always true.
+    uint64_t min_iterations = range.size.min;
+    if (!IsConstantTrue(comprehension.loop_condition())) {
+      min_iterations = std::min<uint64_t>(min_iterations, 1);
+    }
+    CostEstimate iteration = Add(condition.cost, step.cost);
+
+    NodeEstimate estimate;
+    estimate.cost = Add(Add(range.cost, init.cost), result.cost);
+    estimate.cost = Add(estimate.cost,
+                        {SaturatingMul(min_iterations, iteration.min),
+                         SaturatingMul(range.size.max, iteration.max)});
+    if (comprehension.accu_init().has_list_expr() &&
+        comprehension.accu_init().list_expr().elements().empty() &&
+        IsAppendStep(comprehension.loop_step(), comprehension.accu_var())) {
+      estimate.size = {0, range.size.max};
+    }
+    return estimate;
+  }
+
+  void ApplyHint(NodeEstimate& estimate) {
+    if (auto it = size_hints_.find(*estimate.path); it != size_hints_.end()) {
+      estimate.size = it->second;
+    }
+  }
+
+  bool IsSized(const Expr& expr) const {
+    const TypeSpec* type = ast_.GetType(expr.id());
+    if (type == nullptr) {
+      return false;
+    }
+    if (type->has_primitive()) {
+      return type->primitive() == PrimitiveType::kString ||
+             type->primitive() == PrimitiveType::kBytes;
+    }
+    return type->has_list_type() || type->has_map_type();
+  }
+
+  bool IsList(const Expr& expr) const {
+    const TypeSpec* type = ast_.GetType(expr.id());
+    return type != nullptr && type->has_list_type();
+  }
+
+  const Ast& ast_;
+  const SizeHints& size_hints_;
+  absl::flat_hash_map<int64_t, CostEstimate> nodes_;
+};
+
+}  // namespace
+
+absl::StatusOr<CostEstimates> EstimateCost(const Ast& ast,
+                                           const SizeHints& size_hints) {
+  if (!ast.is_checked()) {
+    return absl::InvalidArgumentError(
+        "cost estimation requires a checked expression");
+  }
+  CostEstimator estimator(ast, size_hints);
+  CostEstimates estimates;
+  estimates.total = estimator.Estimate(ast.root_expr()).cost;
+  estimates.nodes = estimator.release_nodes();
+  return estimates;
+}
+
+}  // namespace cel
@@ -0,0 +1,93 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_CHECKER_COST_ESTIMATOR_H_
+#define THIRD_PARTY_CEL_CPP_CHECKER_COST_ESTIMATOR_H_
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "common/ast.h"
+
+namespace cel {
+
+// Bounds on the size of a string or bytes value (in bytes), or of a list or
+// map (in elements).
+struct SizeEstimate {
+  static constexpr uint64_t kUnbounded = std::numeric_limits<uint64_t>::max();
+
+  uint64_t min = 0;
+  uint64_t max = kUnbounded;
+};
+
+// Bounds on the cost of evaluating an expression, in abstract units roughly
+// corresponding to one evaluation step (e.g. a variable lookup or a function
+// call on fixed-size arguments).
+//
+// Bounds saturate at `kUnbounded`, e.g. for a comprehension over a list of
+// unknown size.
+struct CostEstimate {
+  static constexpr uint64_t kUnbounded = std::numeric_limits<uint64_t>::max();
+
+  uint64_t min = 0;
+  uint64_t max = 0;
+
+  bool is_bounded() const { return max != kUnbounded; }
+};
+
+inline bool operator==(const CostEstimate& lhs, const CostEstimate& rhs) {
+  return lhs.min == rhs.min && lhs.max == rhs.max;
+}
+
+inline bool operator!=(const CostEstimate& lhs, const CostEstimate& rhs) {
+  return !operator==(lhs, rhs);
+}
+
+// Size hints keyed by the fully qualified name of a variable, optionally
+// followed by field selections, e.g. "request.auth.claims.groups".
+using SizeHints = absl::flat_hash_map<std::string, SizeEstimate>;
+
+struct CostEstimates {
+  // Cost of evaluating the whole expression.
+  CostEstimate total;
+  // Cost of evaluating each node, including its operands.
+  absl::flat_hash_map<int64_t, CostEstimate> nodes;
+};
+
+// Estimates the cost of evaluating a type-checked expression.
+//
+// The model assumes:
+//  - comprehensions iterate once per element of their range, so nested
+//    comprehensions multiply;
+//  - string functions (e.g. `contains`, `startsWith`, concatenation and
+//    equality) scale with the length of their operands;
+//  - `matches` scales with the length of the input and the size of the
+//    compiled regular expression;
+//  - `&&`, `||` and `?:` may short-circuit, which is reflected in the
+//    minimum cost.
+//
+// Sizes are exact for literals, taken from `size_hints` for variables and
+// field selections, and otherwise unknown. A comprehension over a range of
+// unknown size has an unbounded maximum cost.
+//
+// Returns InvalidArgument if the ast is not checked.
+absl::StatusOr<CostEstimates> EstimateCost(const Ast& ast,
+                                           const SizeHints& size_hints);
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_CHECKER_COST_ESTIMATOR_H_
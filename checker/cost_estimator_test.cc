@@ -0,0 +1,212 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "checker/cost_estimator.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "checker/checker_options.h"
+#include "checker/internal/test_ast_helpers.h"
+#include "checker/standard_library.h"
+#include "checker/type_checker.h"
+#include "checker/type_checker_builder.h"
+#include "checker/type_checker_builder_factory.h"
+#include "checker/validation_result.h"
+#include "common/ast.h"
+#include "common/decl.h"
+#include "common/type.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "google/protobuf/arena.h"
+#include "re2/re2.h"
+
+namespace cel {
+namespace {
+
+using ::absl_testing::StatusIs;
+using ::cel::checker_internal::MakeTestParsedAst;
+using ::cel::internal::GetSharedTestingDescriptorPool;
+using ::testing::Contains;
+using ::testing::Ge;
+using ::testing::HasSubstr;
+using ::testing::Optional;
+using ::testing::Pair;
+using ::testing::Truly;
+
+absl::StatusOr<std::unique_ptr<TypeChecker>> MakeChecker(
+    const CheckerOptions& options = {}) {
+  CEL_ASSIGN_OR_RETURN(
+      std::unique_ptr<TypeCheckerBuilder> builder,
+      CreateTypeCheckerBuilder(GetSharedTestingDescriptorPool(), options));
+  CEL_RETURN_IF_ERROR(builder->AddLibrary(StandardCheckerLibrary()));
+  google::protobuf::Arena* arena = builder->arena();
+  CEL_RETURN_IF_ERROR(builder->AddVariable(MakeVariableDecl("x", IntType())));
+  CEL_RETURN_IF_ERROR(builder->AddVariable(MakeVariableDecl("a", BoolType())));
+  CEL_RETURN_IF_ERROR(builder->AddVariable(MakeVariableDecl("b", BoolType())));
+  CEL_RETURN_IF_ERROR(
+      builder->AddVariable(MakeVariableDecl("s", StringType())));
+  CEL_RETURN_IF_ERROR(builder->AddVariable(
+      MakeVariableDecl("l", ListType(arena, IntType()))));
+  CEL_RETURN_IF_ERROR(builder->AddVariable(MakeVariableDecl(
+      "req", MapType(arena, StringType(), ListType(arena, IntType())))));
+  builder->AddSizeHint("l", {0, 10});
+  return builder->Build();
+}
+
+absl::StatusOr<std::unique_ptr<Ast>> MakeCheckedAst(
+    absl::string_view expression) {
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<TypeChecker> checker, MakeChecker());
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<Ast> ast,
+                       MakeTestParsedAst(expression));
+  CEL_ASSIGN_OR_RETURN(ValidationResult result,
+                       checker->Check(std::move(ast)));
+  return result.ReleaseAst();
+}
+
+absl::StatusOr<CostEstimate> Estimate(absl::string_view expression,
+                                      const SizeHints& size_hints = {}) {
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<Ast> ast, MakeCheckedAst(expression));
+  CEL_ASSIGN_OR_RETURN(CostEstimates estimates,
+                       EstimateCost(*ast, size_hints));
+  return estimates.total;
+}
+
+MATCHER_P2(CostIs, min, max, "") { return arg.min == min && arg.max == max; }
+
+TEST(CostEstimatorTest, RequiresCheckedAst) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Ast> ast, MakeTestParsedAst("x"));
+  EXPECT_THAT(EstimateCost(*ast, {}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(CostEstimatorTest, Call) {
+  ASSERT_OK_AND_ASSIGN(CostEstimate cost, Estimate("x + 1"));
+  EXPECT_THAT(cost, CostIs(2, 2));
+}
+
+TEST(CostEstimatorTest, ShortCircuit) {
+  ASSERT_OK_AND_ASSIGN(CostEstimate cost, Estimate("a || b"));
+  EXPECT_THAT(cost, CostIs(2, 3));
+}
+
+TEST(CostEstimatorTest, StringFunctionScalesWithLength) {
+  ASSERT_OK_AND_ASSIGN(CostEstimate cost,
+                       Estimate("s.startsWith('a')", {{"s", {0, 100}}}));
+  EXPECT_THAT(cost, CostIs(2, 12));
+
+  ASSERT_OK_AND_ASSIGN(cost, Estimate("s.startsWith('a')"));
+  EXPECT_FALSE(cost.is_bounded());
+}
+
+TEST(CostEstimatorTest, RegexScalesWithProgramSize) {
+  RE2 re2("a+b");
+  ASSERT_TRUE(re2.ok());
+  ASSERT_OK_AND_ASSIGN(CostEstimate cost,
+                       Estimate("s.matches('a+b')", {{"s", {20, 20}}}));
+  EXPECT_THAT(cost, CostIs(2 + 2 * re2.ProgramSize(),
+                           2 + 2 * re2.ProgramSize()));
+}
+
+TEST(CostEstimatorTest, ComprehensionWithoutSizeIsUnbounded) {
+  ASSERT_OK_AND_ASSIGN(CostEstimate cost, Estimate("l.all(e, e > 0)"));
+  EXPECT_FALSE(cost.is_bounded());
+}
+
+TEST(CostEstimatorTest, NestedComprehensionsMultiply) {
+  SizeHints hints = {{"l", {0, 10}}};
+  ASSERT_OK_AND_ASSIGN(CostEstimate single, Estimate("l.all(e, e > 0)", hints));
+  ASSERT_OK_AND_ASSIGN(CostEstimate nested,
+                       Estimate("l.all(i, l.all(j, i < j))", hints));
+  ASSERT_TRUE(single.is_bounded());
+  ASSERT_TRUE(nested.is_bounded());
+  EXPECT_THAT(nested.max, Ge(10 * single.max));
+}
+
+TEST(CostEstimatorTest, ComprehensionOverLiteral) {
+  ASSERT_OK_AND_ASSIGN(CostEstimate cost, Estimate("[1, 2, 3].all(e, e > 0)"));
+  EXPECT_TRUE(cost.is_bounded());
+}
+
+TEST(CostEstimatorTest, MapMacroPropagatesSize) {
+  ASSERT_OK_AND_ASSIGN(
+      CostEstimate cost,
+      Estimate("l.map(e, e * 2).all(e, e > 0)", {{"l", {0, 10}}}));
+  EXPECT_TRUE(cost.is_bounded());
+}
+
+TEST(CostEstimatorTest, FieldPathHint) {
+  ASSERT_OK_AND_ASSIGN(
+      CostEstimate cost,
+      Estimate("req.items.exists(e, e > 0)", {{"req.items", {0, 5}}}));
+  EXPECT_TRUE(cost.is_bounded());
+}
+
+TEST(CostEstimatorTest, ReportsPerNodeCosts) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Ast> ast, MakeCheckedAst("a || b"));
+  ASSERT_OK_AND_ASSIGN(CostEstimates estimates, EstimateCost(*ast, {}));
+  EXPECT_THAT(estimates.nodes,
+              Contains(Pair(ast->root_expr().id(), CostIs(2, 3))));
+  EXPECT_EQ(estimates.nodes.size(), 3);
+}
+
+TEST(CostEstimatorTest, CheckerReportsEstimate) {
+  CheckerOptions options;
+  options.enable_cost_estimation = true;
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<TypeChecker> checker,
+                       MakeChecker(options));
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Ast> ast,
+                       MakeTestParsedAst("l.all(e, e > 0)"));
+  ASSERT_OK_AND_ASSIGN(ValidationResult result,
+                       checker->Check(std::move(ast)));
+  EXPECT_TRUE(result.IsValid());
+  EXPECT_THAT(result.GetCostEstimate(),
+              Optional(Truly([](const CostEstimate& cost) {
+                return cost.is_bounded() && cost.max > 10;
+              })));
+}
+
+TEST(CostEstimatorTest, CheckerEnforcesLimit) {
+  CheckerOptions options;
+  options.max_estimated_cost = 20;
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<TypeChecker> checker,
+                       MakeChecker(options));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Ast> ast, MakeTestParsedAst("x + 1"));
+  ASSERT_OK_AND_ASSIGN(ValidationResult result,
+                       checker->Check(std::move(ast)));
+  EXPECT_TRUE(result.IsValid());
+
+  ASSERT_OK_AND_ASSIGN(ast, MakeTestParsedAst("s.contains('a')"));
+  ASSERT_OK_AND_ASSIGN(result, checker->Check(std::move(ast)));
+  EXPECT_FALSE(result.IsValid());
+  EXPECT_THAT(result.FormatError(),
+              HasSubstr("estimated cost exceeds limit: unbounded > 20"));
+}
+
+TEST(CostEstimatorTest, DisabledByDefault) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<TypeChecker> checker, MakeChecker());
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Ast> ast, MakeTestParsedAst("x"));
+  ASSERT_OK_AND_ASSIGN(ValidationResult result,
+                       checker->Check(std::move(ast)));
+  EXPECT_FALSE(result.GetCostEstimate().has_value());
+}
+
+}  // namespace
+}  // namespace cel
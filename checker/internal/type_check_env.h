@@ -28,6 +28,7 @@
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
+#include "checker/cost_estimator.h"
 #include "common/constant.h"
 #include "common/decl.h"
 #include "common/type.h"
@@ -118,6 +119,13 @@ class TypeCheckEnv {
 
   const absl::optional<Type>& expected_type() const { return expected_type_; }
 
+  void set_size_hints(SizeHints size_hints) {
+    size_hints_ = std::move(size_hints);
+  }
+
+  // Size hints for cost estimation, keyed by variable or field path.
+  const SizeHints& size_hints() const { return size_hints_; }
+
   absl::Span<const std::shared_ptr<const TypeIntrospector>> type_providers()
       const {
     return type_providers_;
@@ -221,6 +229,7 @@ class TypeCheckEnv {
   std::vector<std::shared_ptr<const TypeIntrospector>> type_providers_;
 
   absl::optional<Type> expected_type_;
+  SizeHints size_hints_;
 };
 
 }  // namespace cel::checker_internal
@@ -311,6 +311,7 @@ absl::StatusOr<std::unique_ptr<TypeChecker>> TypeCheckerBuilderImpl::Build() {
   if (expected_type_.has_value()) {
     env.set_expected_type(*expected_type_);
   }
+  env.set_size_hints(size_hints_);
 
   ConfigRecord anonymous_config;
   std::vector<ConfigRecord> configs;
@@ -445,4 +446,9 @@ void TypeCheckerBuilderImpl::SetExpectedType(const Type& type) {
   expected_type_ = type;
 }
 
+void TypeCheckerBuilderImpl::AddSizeHint(absl::string_view path,
+                                         SizeEstimate size) {
+  size_hints_[path] = size;
+}
+
 }  // namespace cel::checker_internal
@@ -28,6 +28,7 @@
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "checker/checker_options.h"
+#include "checker/cost_estimator.h"
 #include "checker/internal/type_check_env.h"
 #include "checker/type_checker.h"
 #include "checker/type_checker_builder.h"
@@ -76,6 +77,8 @@ class TypeCheckerBuilderImpl : public TypeCheckerBuilder {
 
   void set_container(absl::string_view container) override;
 
+  void AddSizeHint(absl::string_view path, SizeEstimate size) override;
+
   const CheckerOptions& options() const override { return options_; }
 
   google::protobuf::Arena* absl_nonnull arena() override {
@@ -139,6 +142,7 @@ class TypeCheckerBuilderImpl : public TypeCheckerBuilder {
   absl::flat_hash_set<std::string> library_ids_;
   std::string container_;
   absl::optional<Type> expected_type_;
+  SizeHints size_hints_;
 };
 
 }  // namespace cel::checker_internal
@@ -33,6 +33,7 @@
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "checker/checker_options.h"
+#include "checker/cost_estimator.h"
 #include "checker/internal/format_type_name.h"
 #include "checker/internal/namespace_generator.h"
 #include "checker/internal/type_check_env.h"
@@ -1323,7 +1324,28 @@ absl::StatusOr<ValidationResult> TypeCheckerImpl::Check(
 
   ast->set_is_checked(true);
 
-  return ValidationResult(std::move(ast), std::move(issues));
+  if (!options_.enable_cost_estimation && options_.max_estimated_cost == 0) {
+    return ValidationResult(std::move(ast), std::move(issues));
+  }
+
+  CEL_ASSIGN_OR_RETURN(CostEstimates estimates,
+                       EstimateCost(*ast, env_.size_hints()));
+  if (options_.max_estimated_cost > 0 &&
+      estimates.total.max > options_.max_estimated_cost) {
+    issues.push_back(TypeCheckIssue::CreateError(
+        ComputeSourceLocation(*ast, ast->root_expr().id()),
+        absl::StrCat("estimated cost exceeds limit: ",
+                     estimates.total.is_bounded()
+                         ? absl::StrCat(estimates.total.max)
+                         : "unbounded",
+                     " > ", options_.max_estimated_cost)));
+    ValidationResult result(std::move(issues));
+    result.SetCostEstimate(estimates.total);
+    return result;
+  }
+  ValidationResult result(std::move(ast), std::move(issues));
+  result.SetCostEstimate(estimates.total);
+  return result;
 }
 
 }  // namespace cel::checker_internal
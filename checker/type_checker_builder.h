@@ -24,6 +24,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "checker/checker_options.h"
+#include "checker/cost_estimator.h"
 #include "checker/type_checker.h"
 #include "common/decl.h"
 #include "common/type.h"
@@ -136,6 +137,19 @@ class TypeCheckerBuilder {
   // surprising behavior if used in a custom library.
   virtual void set_container(absl::string_view container) = 0;
 
+  // Declares bounds on the size of a variable or field used for cost
+  // estimation (see `CheckerOptions::enable_cost_estimation`).
+  //
+  // `path` is the fully qualified variable name optionally followed by field
+  // selections, e.g. "request.auth.claims.groups". Sizes are in bytes for
+  // strings and bytes, and in elements for lists and maps.
+  //
+  // Note: if set multiple times for the same path, the last value is used.
+  //
+  // Hints only tighten cost estimates, so the default implementation, kept for
+  // builders which predate this method, ignores them.
+  virtual void AddSizeHint(absl::string_view path, SizeEstimate size) {}
+
   // The current options for the TypeChecker being built.
   virtual const CheckerOptions& options() const = 0;
 
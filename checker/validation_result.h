@@ -23,7 +23,9 @@
 #include "absl/base/nullability.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
 #include "absl/types/span.h"
+#include "checker/cost_estimator.h"
 #include "checker/type_check_issue.h"
 #include "common/ast.h"
 #include "common/source.h"
@@ -69,6 +71,16 @@ class ValidationResult {
     return std::move(source_);
   }
 
+  // The estimated cost of evaluating the checked expression, if cost
+  // estimation was enabled (see `CheckerOptions::enable_cost_estimation`).
+  const absl::optional<CostEstimate>& GetCostEstimate() const {
+    return cost_estimate_;
+  }
+
+  void SetCostEstimate(CostEstimate cost_estimate) {
+    cost_estimate_ = cost_estimate;
+  }
+
   // Returns a string representation of the issues in the result suitable for
   // display.
   //
@@ -89,6 +101,7 @@ class ValidationResult {
   absl_nullable std::unique_ptr<Ast> ast_;
   std::vector<TypeCheckIssue> issues_;
   absl_nullable std::unique_ptr<Source> source_;
+  absl::optional<CostEstimate> cost_estimate_;
 };
 
 }  // namespace cel
@@ -25,6 +25,7 @@
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
 #include "common/arena_string_view.h"
+#include "internal/concurrent_string_pool.h"
 #include "internal/string_pool.h"
 #include "google/protobuf/arena.h"
 
@@ -35,6 +36,13 @@ class ArenaStringPool;
 absl_nonnull std::unique_ptr<ArenaStringPool> NewArenaStringPool(
     google::protobuf::Arena* absl_nonnull arena ABSL_ATTRIBUTE_LIFETIME_BOUND);
 
+// Returns a pool which interns into `strings`, sharing storage with every other
+// user of `strings`. Unlike pools backed by an arena, the returned pool is
+// thread-safe.
+absl_nonnull std::unique_ptr<ArenaStringPool> NewArenaStringPool(
+    internal::ConcurrentStringPool* absl_nonnull strings
+        ABSL_ATTRIBUTE_LIFETIME_BOUND);
+
 class ArenaStringPool final {
  public:
   ArenaStringPool(const ArenaStringPool&) = delete;
@@ -43,19 +51,31 @@ class ArenaStringPool final {
   ArenaStringPool& operator=(ArenaStringPool&&) = delete;
 
   ArenaStringView InternString(const char* absl_nullable string) {
-    return ArenaStringView(strings_.InternString(string), strings_.arena());
+    return InternString(absl::NullSafeStringView(string));
   }
 
   ArenaStringView InternString(absl::string_view string) {
+    if (shared_strings_ != nullptr) {
+      return ArenaStringView(shared_strings_->InternString(string),
+                             strings_.arena());
+    }
     return ArenaStringView(strings_.InternString(string), strings_.arena());
   }
 
   ArenaStringView InternString(std::string&& string) {
+    if (shared_strings_ != nullptr) {
+      return ArenaStringView(shared_strings_->InternString(string),
+                             strings_.arena());
+    }
     return ArenaStringView(strings_.InternString(std::move(string)),
                            strings_.arena());
   }
 
   ArenaStringView InternString(const absl::Cord& string) {
+    if (shared_strings_ != nullptr) {
+      return ArenaStringView(shared_strings_->InternString(string),
+                             strings_.arena());
+    }
     return ArenaStringView(strings_.InternString(string), strings_.arena());
   }
 
@@ -69,11 +89,19 @@ class ArenaStringPool final {
  private:
   friend absl_nonnull std::unique_ptr<ArenaStringPool> NewArenaStringPool(
       google::protobuf::Arena* absl_nonnull);
+  friend absl_nonnull std::unique_ptr<ArenaStringPool> NewArenaStringPool(
+      internal::ConcurrentStringPool* absl_nonnull);
 
   explicit ArenaStringPool(google::protobuf::Arena* absl_nonnull arena)
-      : strings_(arena) {}
+      : strings_(arena), shared_strings_(nullptr) {}
+
+  explicit ArenaStringPool(
+      internal::ConcurrentStringPool* absl_nonnull shared_strings)
+      : strings_(shared_strings->arena()), shared_strings_(shared_strings) {}
 
+  // Only used for its arena if `shared_strings_` is set.
   internal::StringPool strings_;
+  internal::ConcurrentStringPool* absl_nullable const shared_strings_;
 };
 
 inline absl_nonnull std::unique_ptr<ArenaStringPool> NewArenaStringPool(
@@ -81,6 +109,12 @@ inline absl_nonnull std::unique_ptr<ArenaStringPool> NewArenaStringPool(
   return std::unique_ptr<ArenaStringPool>(new ArenaStringPool(arena));
 }
 
+inline absl_nonnull std::unique_ptr<ArenaStringPool> NewArenaStringPool(
+    internal::ConcurrentStringPool* absl_nonnull strings
+        ABSL_ATTRIBUTE_LIFETIME_BOUND) {
+  return std::unique_ptr<ArenaStringPool>(new ArenaStringPool(strings));
+}
+
 }  // namespace cel
 
 #endif  // THIRD_PARTY_CEL_CPP_COMMON_ARENA_STRING_POOL_H_
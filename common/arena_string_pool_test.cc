@@ -18,6 +18,7 @@
 
 #include "absl/strings/cord_test_helpers.h"
 #include "absl/strings/string_view.h"
+#include "internal/concurrent_string_pool.h"
 #include "internal/testing.h"
 #include "google/protobuf/arena.h"
 
@@ -68,5 +69,17 @@ TEST(ArenaStringPool, InternCord) {
   EXPECT_EQ(expected.data(), got.data());
 }
 
+TEST(ArenaStringPool, SharedStrings) {
+  internal::ConcurrentStringPool strings;
+  auto string_pool1 = NewArenaStringPool(&strings);
+  auto string_pool2 = NewArenaStringPool(&strings);
+  auto expected = string_pool1->InternString("Hello World!");
+  auto got = string_pool2->InternString(absl::MakeFragmentedCord(
+      {"Hello", " ", "World!"}));
+  EXPECT_EQ(expected.data(), got.data());
+  EXPECT_EQ(expected.arena(), strings.arena());
+  EXPECT_EQ(string_pool2->InternString(expected).data(), expected.data());
+}
+
 }  // namespace
 }  // namespace cel
@@ -68,18 +68,19 @@ ByteString ByteString::Concat(const ByteString& lhs, const ByteString& rhs,
     return lhs;
   }
 
+  const size_t lhs_size = lhs.size();
+  const size_t rhs_size = rhs.size();
+  const size_t result_size = lhs_size + rhs_size;
   if (lhs.GetKind() == ByteStringKind::kLarge ||
-      rhs.GetKind() == ByteStringKind::kLarge) {
-    // If either the left or right are absl::Cord, use absl::Cord.
-    absl::Cord result;
-    result.Append(lhs.ToCord());
-    result.Append(rhs.ToCord());
+      rhs.GetKind() == ByteStringKind::kLarge ||
+      result_size >= kByteStringConcatCordThreshold) {
+    // If either the left or right are absl::Cord, or the result is large, use
+    // absl::Cord. Cord operands are shared rather than copied.
+    absl::Cord result = lhs.ToCord();
+    rhs.AppendToCord(&result);
     return ByteString(std::move(result));
   }
 
-  const size_t lhs_size = lhs.size();
-  const size_t rhs_size = rhs.size();
-  const size_t result_size = lhs_size + rhs_size;
   ByteString result;
   if (result_size <= kSmallByteStringCapacity) {
     // If the resulting string fits in inline storage, do it.
@@ -94,6 +94,11 @@ struct CEL_COMMON_INTERNAL_BYTE_STRING_TRIVIAL_ABI SmallByteStringRep final {
 inline constexpr size_t kSmallByteStringCapacity =
     sizeof(SmallByteStringRep::data);
 
+// Concatenations producing at least this many bytes result in an `absl::Cord`
+// rather than a flat copy on the arena, so that repeatedly appending to a large
+// string shares the existing data instead of copying it each time.
+inline constexpr size_t kByteStringConcatCordThreshold = 4096;
+
 inline constexpr size_t kMediumByteStringSizeBits = sizeof(size_t) * 8 - 2;
 inline constexpr size_t kMediumByteStringMaxSize =
     (size_t{1} << kMediumByteStringSizeBits) - 1;
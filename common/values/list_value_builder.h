@@ -21,8 +21,11 @@
 #include "absl/base/nullability.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "common/native_type.h"
 #include "common/value.h"
+#include "common/value_kind.h"
 #include "eval/public/cel_value.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
@@ -34,11 +37,30 @@ class ValueFactory;
 
 namespace common_internal {
 
+// Elements of a list which are all `int`, `uint`, `double` or `bool` values,
+// stored unboxed as a contiguous array of `int64_t`, `uint64_t`, `double` or
+// `bool` respectively.
+struct PackedListElements {
+  ValueKind kind;
+  const void* absl_nonnull data;
+  size_t size;
+
+  template <typename T>
+  absl::Span<const T> As() const {
+    return absl::MakeConstSpan(static_cast<const T*>(data), size);
+  }
+};
+
 // Special implementation of list which is both a modern list and legacy list.
 // Do not try this at home. This should only be implemented in
 // `list_value_builder.cc`.
 class CompatListValue : public CustomListValueInterface,
                         public google::api::expr::runtime::CelList {
+ public:
+  virtual absl::optional<PackedListElements> GetPackedElements() const {
+    return absl::nullopt;
+  }
+
  private:
   NativeTypeId GetNativeTypeId() const final {
     return NativeTypeId::For<CompatListValue>();
@@ -78,6 +100,11 @@ class MutableListValue : public CustomListValueInterface {
 // inheritance and `dynamic_cast`.
 class MutableCompatListValue : public MutableListValue,
                                public google::api::expr::runtime::CelList {
+ public:
+  virtual absl::optional<PackedListElements> GetPackedElements() const {
+    return absl::nullopt;
+  }
+
  private:
   NativeTypeId GetNativeTypeId() const final {
     return NativeTypeId::For<MutableCompatListValue>();
@@ -87,6 +114,18 @@ class MutableCompatListValue : public MutableListValue,
 MutableListValue* absl_nonnull NewMutableListValue(
     google::protobuf::Arena* absl_nonnull arena ABSL_ATTRIBUTE_LIFETIME_BOUND);
 
+// Returns the concatenation of `lhs` and `rhs`. Unless either is mutable, the
+// result refers to both operands instead of copying their elements, so
+// concatenating is O(1) and repeatedly appending to the result is linear
+// overall.
+absl::StatusOr<ListValue> ConcatListValues(
+    const ListValue& lhs, const ListValue& rhs,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool
+        ABSL_ATTRIBUTE_LIFETIME_BOUND,
+    google::protobuf::MessageFactory* absl_nonnull message_factory
+        ABSL_ATTRIBUTE_LIFETIME_BOUND,
+    google::protobuf::Arena* absl_nonnull arena ABSL_ATTRIBUTE_LIFETIME_BOUND);
+
 bool IsMutableListValue(const Value& value);
 bool IsMutableListValue(const ListValue& value);
 
@@ -100,6 +139,12 @@ const MutableListValue& GetMutableListValue(
 const MutableListValue& GetMutableListValue(
     const ListValue& value ABSL_ATTRIBUTE_LIFETIME_BOUND);
 
+// Returns the unboxed elements of `value` if it was built by
+// `NewListValueBuilder` or `NewMutableListValue` and all of its elements are
+// `int`, all `uint`, all `double` or all `bool`.
+absl::optional<PackedListElements> AsPackedListElements(
+    const ListValue& value ABSL_ATTRIBUTE_LIFETIME_BOUND);
+
 absl_nonnull cel::ListValueBuilderPtr NewListValueBuilder(
     google::protobuf::Arena* absl_nonnull arena);
 
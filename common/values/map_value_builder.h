@@ -87,6 +87,18 @@ class MutableCompatMapValue : public MutableMapValue,
 MutableMapValue* absl_nonnull NewMutableMapValue(
     google::protobuf::Arena* absl_nonnull arena);
 
+// Returns `map` with the additional entry `key` and `value`. Unless `map` is
+// mutable, the result shares the entries of `map` instead of copying them, and
+// inserting into the result again is amortized O(1), so building a map by
+// repeated insertion is linear overall.
+absl::StatusOr<MapValue> MapValueWithEntry(
+    const MapValue& map, Value key, Value value,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool
+        ABSL_ATTRIBUTE_LIFETIME_BOUND,
+    google::protobuf::MessageFactory* absl_nonnull message_factory
+        ABSL_ATTRIBUTE_LIFETIME_BOUND,
+    google::protobuf::Arena* absl_nonnull arena ABSL_ATTRIBUTE_LIFETIME_BOUND);
+
 bool IsMutableMapValue(const Value& value);
 bool IsMutableMapValue(const MapValue& value);
 
@@ -0,0 +1,108 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/strings/str_cat.h"
+#include "common/value.h"
+#include "common/values/map_value_builder.h"
+#include "internal/benchmark.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "internal/testing_message_factory.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::common_internal {
+namespace {
+
+std::vector<std::string> MakeKeys(int64_t size) {
+  std::vector<std::string> keys;
+  keys.reserve(size);
+  for (int64_t i = 0; i < size; ++i) {
+    keys.push_back(absl::StrCat("field_", i));
+  }
+  return keys;
+}
+
+MapValue BuildMap(const std::vector<std::string>& keys,
+                  google::protobuf::Arena* arena) {
+  auto builder = NewMapValueBuilder(arena);
+  builder->Reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    ABSL_CHECK_OK(builder->Put(StringValue(keys[i]),
+                               IntValue(static_cast<int64_t>(i))));
+  }
+  return std::move(*builder).Build();
+}
+
+// Mirrors the evaluation of a map literal such as `{'a': 1, 'b': 2}`.
+void BM_BuildStringKeyedMap(benchmark::State& state) {
+  const std::vector<std::string> keys = MakeKeys(state.range(0));
+  for (auto _ : state) {
+    google::protobuf::Arena arena;
+    benchmark::DoNotOptimize(BuildMap(keys, &arena));
+  }
+}
+BENCHMARK(BM_BuildStringKeyedMap)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
+
+void BM_FindStringKey(benchmark::State& state) {
+  const std::vector<std::string> keys = MakeKeys(state.range(0));
+  google::protobuf::Arena arena;
+  const MapValue map_value = BuildMap(keys, &arena);
+  std::vector<Value> probes;
+  for (const std::string& key : keys) {
+    probes.push_back(StringValue(key));
+  }
+  // Also look up a key which is absent.
+  probes.push_back(StringValue("field_missing"));
+  Value result;
+  for (auto _ : state) {
+    for (const Value& probe : probes) {
+      ABSL_CHECK_OK(map_value.Find(
+          probe, internal::GetTestingDescriptorPool(),
+          internal::GetTestingMessageFactory(), &arena, &result));
+      benchmark::DoNotOptimize(result);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+BENCHMARK(BM_FindStringKey)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
+
+void BM_FindIntKey(benchmark::State& state) {
+  google::protobuf::Arena arena;
+  auto builder = NewMapValueBuilder(&arena);
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    ABSL_CHECK_OK(builder->Put(IntValue(i), IntValue(i)));
+  }
+  const MapValue map_value = std::move(*builder).Build();
+  Value result;
+  for (auto _ : state) {
+    for (int64_t i = 0; i <= state.range(0); ++i) {
+      ABSL_CHECK_OK(map_value.Find(
+          IntValue(i), internal::GetTestingDescriptorPool(),
+          internal::GetTestingMessageFactory(), &arena, &result));
+      benchmark::DoNotOptimize(result);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * (state.range(0) + 1));
+}
+BENCHMARK(BM_FindIntKey)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
+
+}  // namespace
+}  // namespace cel::common_internal
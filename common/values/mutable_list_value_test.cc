@@ -19,6 +19,7 @@
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
 #include "common/value.h"
 #include "common/value_testing.h"
 #include "common/values/list_value_builder.h"
@@ -30,9 +31,14 @@ namespace {
 using ::absl_testing::IsOk;
 using ::absl_testing::IsOkAndHolds;
 using ::absl_testing::StatusIs;
+using ::cel::test::BoolValueIs;
 using ::cel::test::ErrorValueIs;
+using ::cel::test::IntValueIs;
 using ::cel::test::StringValueIs;
+using ::testing::ElementsAre;
+using ::testing::Field;
 using ::testing::IsEmpty;
+using ::testing::Optional;
 using ::testing::Pair;
 using ::testing::UnorderedElementsAre;
 
@@ -146,5 +152,77 @@ TEST_F(MutableListValueTest, GetMutableListValue) {
             mutable_list_value);
 }
 
+TEST_F(MutableListValueTest, PackedElements) {
+  auto* mutable_list_value = NewMutableListValue(arena());
+  ListValue list_value(CustomListValue(mutable_list_value, arena()));
+  EXPECT_FALSE(AsPackedListElements(list_value).has_value());
+  EXPECT_THAT(mutable_list_value->Append(IntValue(3)), IsOk());
+  EXPECT_THAT(mutable_list_value->Append(IntValue(1)), IsOk());
+  EXPECT_THAT(mutable_list_value->Append(IntValue(2)), IsOk());
+
+  absl::optional<PackedListElements> packed = AsPackedListElements(list_value);
+  ASSERT_TRUE(packed.has_value());
+  EXPECT_EQ(packed->kind, ValueKind::kInt);
+  EXPECT_THAT(packed->As<int64_t>(), ElementsAre(3, 1, 2));
+  EXPECT_EQ(list_value.DebugString(), "[3, 1, 2]");
+
+  Value value;
+  EXPECT_THAT(
+      list_value.Get(1, descriptor_pool(), message_factory(), arena(), &value),
+      IsOk());
+  EXPECT_THAT(value, IntValueIs(1));
+  EXPECT_THAT(list_value.Contains(IntValue(2), descriptor_pool(),
+                                  message_factory(), arena(), &value),
+              IsOk());
+  EXPECT_THAT(value, BoolValueIs(true));
+  EXPECT_THAT(list_value.Contains(IntValue(4), descriptor_pool(),
+                                  message_factory(), arena(), &value),
+              IsOk());
+  EXPECT_THAT(value, BoolValueIs(false));
+  // Elements of other kinds are compared using heterogeneous equality.
+  EXPECT_THAT(list_value.Contains(DoubleValue(2.0), descriptor_pool(),
+                                  message_factory(), arena(), &value),
+              IsOk());
+  EXPECT_THAT(value, BoolValueIs(true));
+}
+
+TEST_F(MutableListValueTest, PackedElementsFallBackToValues) {
+  auto* mutable_list_value = NewMutableListValue(arena());
+  ListValue list_value(CustomListValue(mutable_list_value, arena()));
+  EXPECT_THAT(mutable_list_value->Append(IntValue(1)), IsOk());
+  EXPECT_THAT(mutable_list_value->Append(StringValue("foo")), IsOk());
+  EXPECT_FALSE(AsPackedListElements(list_value).has_value());
+  EXPECT_EQ(list_value.DebugString(), "[1, \"foo\"]");
+
+  std::vector<std::pair<size_t, Value>> elements;
+  auto for_each_callback = [&](size_t index,
+                               const Value& value) -> absl::StatusOr<bool> {
+    elements.push_back(std::pair{index, value});
+    return true;
+  };
+  EXPECT_THAT(list_value.ForEach(for_each_callback, descriptor_pool(),
+                                 message_factory(), arena()),
+              IsOk());
+  EXPECT_THAT(elements, ElementsAre(Pair(0, IntValueIs(1)),
+                                    Pair(1, StringValueIs("foo"))));
+  Value value;
+  EXPECT_THAT(list_value.Contains(StringValue("foo"), descriptor_pool(),
+                                  message_factory(), arena(), &value),
+              IsOk());
+  EXPECT_THAT(value, BoolValueIs(true));
+}
+
+TEST_F(MutableListValueTest, BuilderPacksElements) {
+  auto builder = NewListValueBuilder(arena());
+  builder->Reserve(2);
+  EXPECT_THAT(builder->Add(DoubleValue(1.5)), IsOk());
+  EXPECT_THAT(builder->Add(DoubleValue(0.5)), IsOk());
+  ListValue list_value = std::move(*builder).Build();
+  EXPECT_THAT(AsPackedListElements(list_value),
+              Optional(Field(&PackedListElements::kind, ValueKind::kDouble)));
+  EXPECT_THAT(AsPackedListElements(list_value)->As<double>(),
+              ElementsAre(1.5, 0.5));
+}
+
 }  // namespace
 }  // namespace cel::common_internal
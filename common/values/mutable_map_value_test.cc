@@ -18,6 +18,7 @@
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "common/value.h"
 #include "common/value_testing.h"
 #include "common/values/map_value_builder.h"
@@ -147,6 +148,51 @@ TEST_F(MutableMapValueTest, FindHas) {
   EXPECT_THAT(value, BoolValueIs(true));
 }
 
+TEST_F(MutableMapValueTest, GrowsPastSmallMap) {
+  auto* mutable_map_value = NewMutableMapValue(arena());
+  auto key = [](int i) -> Value {
+    if (i % 2 == 0) {
+      return StringValue(absl::StrCat("key", i));
+    }
+    return IntValue(i);
+  };
+  for (int i = 0; i < 32; ++i) {
+    EXPECT_THAT(mutable_map_value->Put(key(i), IntValue(i)), IsOk());
+    EXPECT_THAT(mutable_map_value->Put(key(0), IntValue(i)),
+                StatusIs(absl::StatusCode::kAlreadyExists));
+  }
+  CustomMapValue map_value(mutable_map_value, arena());
+  EXPECT_EQ(map_value.Size(), 32);
+  Value value;
+  for (int i = 0; i < 32; ++i) {
+    EXPECT_THAT(map_value.Find(key(i), descriptor_pool(), message_factory(),
+                               arena(), &value),
+                IsOkAndHolds(IsTrue()));
+    EXPECT_THAT(value, IntValueIs(i));
+  }
+  EXPECT_THAT(map_value.Find(StringValue("key1"), descriptor_pool(),
+                             message_factory(), arena(), &value),
+              IsOkAndHolds(IsFalse()));
+}
+
+TEST_F(MutableMapValueTest, BuilderSmallMap) {
+  auto builder = NewMapValueBuilder(arena());
+  EXPECT_THAT(builder->Put(StringValue("foo"), IntValue(1)), IsOk());
+  EXPECT_THAT(builder->Put(StringValue("bar"), IntValue(2)), IsOk());
+  EXPECT_THAT(builder->Put(StringValue("foo"), IntValue(3)),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+  MapValue map_value = std::move(*builder).Build();
+  EXPECT_EQ(map_value.Size(), 2);
+  Value value;
+  EXPECT_THAT(map_value.Find(StringValue("bar"), descriptor_pool(),
+                             message_factory(), arena(), &value),
+              IsOkAndHolds(IsTrue()));
+  EXPECT_THAT(value, IntValueIs(2));
+  EXPECT_THAT(map_value.Find(StringValue("baz"), descriptor_pool(),
+                             message_factory(), arena(), &value),
+              IsOkAndHolds(IsFalse()));
+}
+
 TEST_F(MutableMapValueTest, IsMutableMapValue) {
   auto* mutable_map_value = NewMutableMapValue(arena());
   EXPECT_TRUE(
@@ -19,6 +19,7 @@
 #include "absl/status/status_matchers.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/cord_test_helpers.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "common/native_type.h"
@@ -208,5 +209,23 @@ TEST_F(StringValueTest, Contains) {
           .Contains(StringValue(absl::Cord("string is large enough"))));
 }
 
+TEST_F(StringValueTest, Concat) {
+  StringValue small = StringValue::Concat(StringValue("foo"),
+                                          StringValue("bar"), arena());
+  EXPECT_EQ(small, "foobar");
+  EXPECT_THAT(small.TryFlat(), Optional(Eq("foobar")));
+
+  // Large results are built as cords which share the operands.
+  std::string large(4096, 'a');
+  StringValue cord = StringValue::Concat(
+      StringValue::From(absl::MakeFragmentedCord({large, large})),
+      StringValue("b"), arena());
+  EXPECT_EQ(cord.Size(), 2 * large.size() + 1);
+  EXPECT_TRUE(cord.EndsWith("ab"));
+  EXPECT_EQ(
+      StringValue::Concat(cord, StringValue("c"), arena()).ToString(),
+      absl::StrCat(large, large, "bc"));
+}
+
 }  // namespace
 }  // namespace cel
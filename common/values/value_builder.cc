@@ -12,9 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <climits>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <iterator>
 #include <memory>
 #include <new>
 #include <string>
@@ -22,17 +25,22 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/attributes.h"
 #include "absl/base/call_once.h"
 #include "absl/base/casts.h"
 #include "absl/base/nullability.h"
 #include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/hash/hash.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "common/allocator.h"
@@ -77,37 +85,346 @@ absl::Status CheckListElement(const Value& value) {
   return absl::OkStatus();
 }
 
-template <typename Vector>
-absl::Status ListValueToJsonArray(
-    const Vector& vector,
-    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
-    google::protobuf::MessageFactory* absl_nonnull message_factory,
-    google::protobuf::Message* absl_nonnull json) {
-  ABSL_DCHECK(descriptor_pool != nullptr);
-  ABSL_DCHECK(message_factory != nullptr);
-  ABSL_DCHECK(json != nullptr);
-  ABSL_DCHECK_EQ(json->GetDescriptor()->well_known_type(),
-                 google::protobuf::Descriptor::WELLKNOWNTYPE_LISTVALUE);
+// Storage for the elements of a list built by `ListValueBuilderImpl` or
+// `MutableCompatListValueImpl`.
+//
+// As long as all elements are `int`, all `uint`, all `double` or all `bool`
+// they are stored unboxed in a contiguous array allocated on the arena, which
+// avoids the per-element overhead of `Value` and lets `Contains` compare
+// native values directly. Appending an element of any other kind converts the
+// storage to a vector of `Value`.
+class ListElements final {
+ public:
+  explicit ListElements(google::protobuf::Arena* absl_nonnull arena)
+      : values_(arena) {}
 
-  ListValueReflection reflection;
-  CEL_RETURN_IF_ERROR(reflection.Initialize(json->GetDescriptor()));
+  ListElements(ListElements&&) = default;
+  ListElements(const ListElements&) = delete;
+  ListElements& operator=(const ListElements&) = delete;
+  ListElements& operator=(ListElements&&) = delete;
 
-  json->Clear();
+  google::protobuf::Arena* absl_nonnull arena() const {
+    return values_.get_allocator().arena();
+  }
+
+  bool empty() const { return size() == 0; }
+
+  size_t size() const {
+    return representation_ == Representation::kValue ? values_.size()
+                                                     : packed_size_;
+  }
+
+  // Whether the elements can be abandoned on the arena without running their
+  // destructors.
+  bool trivially_destructible() const {
+    return values_trivially_destructible_;
+  }
+
+  void Reserve(size_t capacity) {
+    switch (representation_) {
+      case Representation::kEmpty:
+        // The representation is not known until the first element is added.
+        reserved_ = std::max(reserved_, capacity);
+        break;
+      case Representation::kInt:
+        ReservePacked<int64_t>(capacity);
+        break;
+      case Representation::kUint:
+        ReservePacked<uint64_t>(capacity);
+        break;
+      case Representation::kDouble:
+        ReservePacked<double>(capacity);
+        break;
+      case Representation::kBool:
+        ReservePacked<bool>(capacity);
+        break;
+      case Representation::kValue:
+        values_.reserve(capacity);
+        break;
+    }
+  }
+
+  void Append(Value value) {
+    if (representation_ == Representation::kEmpty) {
+      representation_ = RepresentationOf(value);
+      Reserve(std::max<size_t>(reserved_, 1));
+    }
+    if (representation_ != Representation::kValue) {
+      if (ABSL_PREDICT_TRUE(AppendPacked(value))) {
+        return;
+      }
+      Box();
+    }
+    values_.push_back(std::move(value));
+    if (values_trivially_destructible_) {
+      values_trivially_destructible_ =
+          ArenaTraits<>::trivially_destructible(values_.back());
+    }
+  }
+
+  Value Get(size_t index) const {
+    ABSL_DCHECK_LT(index, size());
+    switch (representation_) {
+      case Representation::kInt:
+        return IntValue(Packed<int64_t>()[index]);
+      case Representation::kUint:
+        return UintValue(Packed<uint64_t>()[index]);
+      case Representation::kDouble:
+        return DoubleValue(Packed<double>()[index]);
+      case Representation::kBool:
+        return BoolValue(Packed<bool>()[index]);
+      default:
+        return values_[index];
+    }
+  }
+
+  CelValue GetLegacy(size_t index, bool stable,
+                     google::protobuf::Arena* absl_nonnull arena) const {
+    ABSL_DCHECK_LT(index, size());
+    switch (representation_) {
+      case Representation::kInt:
+        return CelValue::CreateInt64(Packed<int64_t>()[index]);
+      case Representation::kUint:
+        return CelValue::CreateUint64(Packed<uint64_t>()[index]);
+      case Representation::kDouble:
+        return CelValue::CreateDouble(Packed<double>()[index]);
+      case Representation::kBool:
+        return CelValue::CreateBool(Packed<bool>()[index]);
+      default:
+        return common_internal::UnsafeLegacyValue(values_[index], stable,
+                                                  arena);
+    }
+  }
+
+  absl::optional<PackedListElements> GetPacked() const {
+    switch (representation_) {
+      case Representation::kInt:
+        return PackedListElements{ValueKind::kInt, packed_data_, packed_size_};
+      case Representation::kUint:
+        return PackedListElements{ValueKind::kUint, packed_data_,
+                                  packed_size_};
+      case Representation::kDouble:
+        return PackedListElements{ValueKind::kDouble, packed_data_,
+                                  packed_size_};
+      case Representation::kBool:
+        return PackedListElements{ValueKind::kBool, packed_data_,
+                                  packed_size_};
+      default:
+        return absl::nullopt;
+    }
+  }
+
+  absl::Status ForEach(
+      CustomListValueInterface::ForEachWithIndexCallback callback) const {
+    if (representation_ == Representation::kValue) {
+      const size_t size = values_.size();
+      for (size_t i = 0; i < size; ++i) {
+        CEL_ASSIGN_OR_RETURN(auto ok, callback(i, values_[i]));
+        if (!ok) {
+          break;
+        }
+      }
+      return absl::OkStatus();
+    }
+    for (size_t i = 0; i < packed_size_; ++i) {
+      CEL_ASSIGN_OR_RETURN(auto ok, callback(i, Get(i)));
+      if (!ok) {
+        break;
+      }
+    }
+    return absl::OkStatus();
+  }
 
-  if (vector.empty()) {
+  absl::Status Contains(
+      const Value& other,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull result) const {
+    if (auto contains = ContainsPacked(other); contains) {
+      *result = BoolValue(*contains);
+      return absl::OkStatus();
+    }
+    // Either the elements are boxed or `other` is of a different kind than
+    // the elements, in which case heterogeneous equality applies.
+    Value equal;
+    const size_t size = this->size();
+    for (size_t i = 0; i < size; ++i) {
+      if (representation_ == Representation::kValue) {
+        CEL_RETURN_IF_ERROR(values_[i].Equal(other, descriptor_pool,
+                                             message_factory, arena, &equal));
+      } else {
+        CEL_RETURN_IF_ERROR(Get(i).Equal(other, descriptor_pool,
+                                         message_factory, arena, &equal));
+      }
+      if (auto bool_result = equal.AsBool();
+          bool_result.has_value() && bool_result->NativeValue()) {
+        *result = BoolValue(true);
+        return absl::OkStatus();
+      }
+    }
+    *result = BoolValue(false);
     return absl::OkStatus();
   }
 
-  for (const auto& element : vector) {
-    CEL_RETURN_IF_ERROR(element->ConvertToJson(descriptor_pool, message_factory,
-                                               reflection.AddValues(json)));
+  std::string DebugString() const {
+    std::string out = "[";
+    const size_t size = this->size();
+    for (size_t i = 0; i < size; ++i) {
+      if (i != 0) {
+        out.append(", ");
+      }
+      out.append(Get(i).DebugString());
+    }
+    out.push_back(']');
+    return out;
+  }
+
+ private:
+  enum class Representation : uint8_t {
+    kEmpty,
+    kInt,
+    kUint,
+    kDouble,
+    kBool,
+    kValue,
+  };
+
+  static Representation RepresentationOf(const Value& value) {
+    switch (value.kind()) {
+      case ValueKind::kInt:
+        return Representation::kInt;
+      case ValueKind::kUint:
+        return Representation::kUint;
+      case ValueKind::kDouble:
+        return Representation::kDouble;
+      case ValueKind::kBool:
+        return Representation::kBool;
+      default:
+        return Representation::kValue;
+    }
+  }
+
+  template <typename T>
+  absl::Span<const T> Packed() const {
+    return absl::MakeConstSpan(static_cast<const T*>(packed_data_),
+                               packed_size_);
+  }
+
+  template <typename T>
+  void ReservePacked(size_t capacity) {
+    if (capacity <= packed_capacity_) {
+      return;
+    }
+    void* data = arena()->AllocateAligned(capacity * sizeof(T), alignof(T));
+    if (packed_size_ != 0) {
+      std::memcpy(data, packed_data_, packed_size_ * sizeof(T));
+    }
+    packed_data_ = data;
+    packed_capacity_ = capacity;
   }
-  return absl::OkStatus();
-}
 
-template <typename Vector>
-absl::Status ListValueToJson(
-    const Vector& vector,
+  template <typename T>
+  void PushPacked(T value) {
+    if (ABSL_PREDICT_FALSE(packed_size_ == packed_capacity_)) {
+      ReservePacked<T>(std::max<size_t>(packed_capacity_ * 2, 4));
+    }
+    static_cast<T*>(packed_data_)[packed_size_++] = value;
+  }
+
+  bool AppendPacked(const Value& value) {
+    switch (representation_) {
+      case Representation::kInt:
+        if (auto int_value = value.AsInt(); int_value) {
+          PushPacked<int64_t>(int_value->NativeValue());
+          return true;
+        }
+        return false;
+      case Representation::kUint:
+        if (auto uint_value = value.AsUint(); uint_value) {
+          PushPacked<uint64_t>(uint_value->NativeValue());
+          return true;
+        }
+        return false;
+      case Representation::kDouble:
+        if (auto double_value = value.AsDouble(); double_value) {
+          PushPacked<double>(double_value->NativeValue());
+          return true;
+        }
+        return false;
+      case Representation::kBool:
+        if (auto bool_value = value.AsBool(); bool_value) {
+          PushPacked<bool>(bool_value->NativeValue());
+          return true;
+        }
+        return false;
+      default:
+        return false;
+    }
+  }
+
+  template <typename T>
+  static bool ContainsNative(absl::Span<const T> elements, T value) {
+    return std::find(elements.begin(), elements.end(), value) !=
+           elements.end();
+  }
+
+  // Returns whether `other` is one of the elements if that can be decided by
+  // comparing native values, that is if the elements are unboxed and of the
+  // same kind as `other`.
+  absl::optional<bool> ContainsPacked(const Value& other) const {
+    switch (representation_) {
+      case Representation::kInt:
+        if (auto int_value = other.AsInt(); int_value) {
+          return ContainsNative(Packed<int64_t>(), int_value->NativeValue());
+        }
+        break;
+      case Representation::kUint:
+        if (auto uint_value = other.AsUint(); uint_value) {
+          return ContainsNative(Packed<uint64_t>(), uint_value->NativeValue());
+        }
+        break;
+      case Representation::kDouble:
+        if (auto double_value = other.AsDouble(); double_value) {
+          return ContainsNative(Packed<double>(), double_value->NativeValue());
+        }
+        break;
+      case Representation::kBool:
+        if (auto bool_value = other.AsBool(); bool_value) {
+          return ContainsNative(Packed<bool>(), bool_value->NativeValue());
+        }
+        break;
+      default:
+        break;
+    }
+    return absl::nullopt;
+  }
+
+  // Converts the unboxed elements to `Value`s, after which all elements are
+  // stored as `Value`s.
+  void Box() {
+    ABSL_DCHECK(representation_ != Representation::kValue);
+    values_.reserve(std::max(packed_capacity_, packed_size_ + 1));
+    for (size_t i = 0; i < packed_size_; ++i) {
+      values_.push_back(Get(i));
+    }
+    representation_ = Representation::kValue;
+    packed_data_ = nullptr;
+    packed_size_ = 0;
+    packed_capacity_ = 0;
+  }
+
+  ValueVector values_;
+  void* absl_nullable packed_data_ = nullptr;
+  size_t packed_size_ = 0;
+  size_t packed_capacity_ = 0;
+  size_t reserved_ = 0;
+  Representation representation_ = Representation::kEmpty;
+  bool values_trivially_destructible_ = true;
+};
+
+absl::Status ListValueToJsonArray(
+    const ListElements& elements,
     const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
     google::protobuf::MessageFactory* absl_nonnull message_factory,
     google::protobuf::Message* absl_nonnull json) {
@@ -115,17 +432,25 @@ absl::Status ListValueToJson(
   ABSL_DCHECK(message_factory != nullptr);
   ABSL_DCHECK(json != nullptr);
   ABSL_DCHECK_EQ(json->GetDescriptor()->well_known_type(),
-                 google::protobuf::Descriptor::WELLKNOWNTYPE_VALUE);
+                 google::protobuf::Descriptor::WELLKNOWNTYPE_LISTVALUE);
 
-  ValueReflection reflection;
+  ListValueReflection reflection;
   CEL_RETURN_IF_ERROR(reflection.Initialize(json->GetDescriptor()));
-  return ListValueToJsonArray(vector, descriptor_pool, message_factory,
-                              reflection.MutableListValue(json));
+
+  json->Clear();
+
+  const size_t size = elements.size();
+  for (size_t i = 0; i < size; ++i) {
+    CEL_RETURN_IF_ERROR(elements.Get(i).ConvertToJson(
+        descriptor_pool, message_factory, reflection.AddValues(json)));
+  }
+  return absl::OkStatus();
 }
 
 class CompatListValueImplIterator final : public ValueIterator {
  public:
-  explicit CompatListValueImplIterator(absl::Span<const Value> elements)
+  explicit CompatListValueImplIterator(
+      const ListElements& elements ABSL_ATTRIBUTE_LIFETIME_BOUND)
       : elements_(elements) {}
 
   bool HasNext() override { return index_ < elements_.size(); }
@@ -139,7 +464,7 @@ class CompatListValueImplIterator final : public ValueIterator {
           "ValueManager::Next called after ValueManager::HasNext returned "
           "false");
     }
-    *result = elements_[index_++];
+    *result = elements_.Get(index_++);
     return absl::OkStatus();
   }
 
@@ -156,7 +481,7 @@ class CompatListValueImplIterator final : public ValueIterator {
     if (index_ >= elements_.size()) {
       return false;
     }
-    *key_or_value = elements_[index_];
+    *key_or_value = elements_.Get(index_);
     ++index_;
     return true;
   }
@@ -175,14 +500,14 @@ class CompatListValueImplIterator final : public ValueIterator {
       return false;
     }
     if (value != nullptr) {
-      *value = elements_[index_];
+      *value = elements_.Get(index_);
     }
     *key = IntValue(index_++);
     return true;
   }
 
  private:
-  const absl::Span<const Value> elements_;
+  const ListElements& elements_;
   size_t index_ = 0;
 };
 
@@ -207,7 +532,7 @@ class ListValueBuilderImpl final : public ListValueBuilder {
   }
 
   ~ListValueBuilderImpl() override {
-    if (!elements_trivially_destructible_) {
+    if (!elements_->trivially_destructible()) {
       elements_.Destruct();
     }
   }
@@ -220,16 +545,12 @@ class ListValueBuilderImpl final : public ListValueBuilder {
 
   void UnsafeAdd(Value value) override {
     ABSL_DCHECK_OK(CheckListElement(value));
-    elements_->emplace_back(std::move(value));
-    if (elements_trivially_destructible_) {
-      elements_trivially_destructible_ =
-          ArenaTraits<>::trivially_destructible(elements_->back());
-    }
+    elements_->Append(std::move(value));
   }
 
   size_t Size() const override { return elements_->size(); }
 
-  void Reserve(size_t capacity) override { elements_->reserve(capacity); }
+  void Reserve(size_t capacity) override { elements_->Reserve(capacity); }
 
   ListValue Build() && override;
 
@@ -242,19 +563,15 @@ class ListValueBuilderImpl final : public ListValueBuilder {
 
  private:
   google::protobuf::Arena* absl_nonnull const arena_;
-  internal::Manual<ValueVector> elements_;
-  bool elements_trivially_destructible_ = true;
+  internal::Manual<ListElements> elements_;
 };
 
 class CompatListValueImpl final : public CompatListValue {
  public:
-  explicit CompatListValueImpl(ValueVector&& elements)
+  explicit CompatListValueImpl(ListElements&& elements)
       : elements_(std::move(elements)) {}
 
-  std::string DebugString() const override {
-    return absl::StrCat("[", absl::StrJoin(elements_, ", ", ValueFormatter{}),
-                        "]");
-  }
+  std::string DebugString() const override { return elements_.DebugString(); }
 
   absl::Status ConvertToJsonArray(
       const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
@@ -268,9 +585,10 @@ class CompatListValueImpl final : public CompatListValue {
     ABSL_DCHECK(arena != nullptr);
 
     ListValueBuilderImpl builder(arena);
-    builder.Reserve(elements_.size());
-    for (const auto& element : elements_) {
-      builder.UnsafeAdd(element.Clone(arena));
+    const size_t size = elements_.size();
+    builder.Reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+      builder.UnsafeAdd(elements_.Get(i).Clone(arena));
     }
     return std::move(builder).BuildCustom();
   }
@@ -282,43 +600,46 @@ class CompatListValueImpl final : public CompatListValue {
       const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
       google::protobuf::MessageFactory* absl_nonnull message_factory,
       google::protobuf::Arena* absl_nonnull arena) const override {
-    const size_t size = elements_.size();
-    for (size_t i = 0; i < size; ++i) {
-      CEL_ASSIGN_OR_RETURN(auto ok, callback(i, elements_[i]));
-      if (!ok) {
-        break;
-      }
-    }
-    return absl::OkStatus();
+    return elements_.ForEach(callback);
   }
 
   absl::StatusOr<absl_nonnull ValueIteratorPtr> NewIterator() const override {
-    return std::make_unique<CompatListValueImplIterator>(
-        absl::MakeConstSpan(elements_));
+    return std::make_unique<CompatListValueImplIterator>(elements_);
+  }
+
+  absl::Status Contains(
+      const Value& other,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull result) const override {
+    return elements_.Contains(other, descriptor_pool, message_factory, arena,
+                              result);
   }
 
   CelValue operator[](int index) const override {
-    return Get(elements_.get_allocator().arena(), index);
+    return Get(elements_.arena(), index);
   }
 
   // Like `operator[](int)` above, but also accepts an arena. Prefer calling
   // this variant if the arena is known.
   CelValue Get(google::protobuf::Arena* arena, int index) const override {
     if (arena == nullptr) {
-      arena = elements_.get_allocator().arena();
+      arena = elements_.arena();
     }
     if (ABSL_PREDICT_FALSE(index < 0 || index >= size())) {
       return CelValue::CreateError(google::protobuf::Arena::Create<absl::Status>(
           arena, IndexOutOfBoundsError(index).ToStatus()));
     }
-    return common_internal::UnsafeLegacyValue(
-        elements_[index],
-        /*stable=*/true,
-        arena != nullptr ? arena : elements_.get_allocator().arena());
+    return elements_.GetLegacy(index, /*stable=*/true, arena);
   }
 
   int size() const override { return static_cast<int>(Size()); }
 
+  absl::optional<PackedListElements> GetPackedElements() const override {
+    return elements_.GetPacked();
+  }
+
  protected:
   absl::Status Get(size_t index,
                    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
@@ -328,13 +649,13 @@ class CompatListValueImpl final : public CompatListValue {
     if (index >= elements_.size()) {
       *result = IndexOutOfBoundsError(index);
     } else {
-      *result = elements_[index];
+      *result = elements_.Get(index);
     }
     return absl::OkStatus();
   }
 
  private:
-  const ValueVector elements_;
+  const ListElements elements_;
 };
 
 }  // namespace
@@ -374,11 +695,11 @@ const CompatListValue* absl_nonnull ListValueBuilderImpl::BuildCompat() && {
 
 const CompatListValue* absl_nonnull ListValueBuilderImpl::BuildCompatAt(
     void* absl_nonnull address) && {
+  const bool trivially_destructible = elements_->trivially_destructible();
   CompatListValueImpl* absl_nonnull impl =
       ::new (address) CompatListValueImpl(std::move(*elements_));
-  if (!elements_trivially_destructible_) {
+  if (!trivially_destructible) {
     arena_->OwnDestructor(impl);
-    elements_trivially_destructible_ = true;
   }
   return impl;
 }
@@ -388,10 +709,7 @@ class MutableCompatListValueImpl final : public MutableCompatListValue {
   explicit MutableCompatListValueImpl(google::protobuf::Arena* absl_nonnull arena)
       : elements_(arena) {}
 
-  std::string DebugString() const override {
-    return absl::StrCat("[", absl::StrJoin(elements_, ", ", ValueFormatter{}),
-                        "]");
-  }
+  std::string DebugString() const override { return elements_.DebugString(); }
 
   absl::Status ConvertToJsonArray(
       const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
@@ -405,9 +723,10 @@ class MutableCompatListValueImpl final : public MutableCompatListValue {
     ABSL_DCHECK(arena != nullptr);
 
     ListValueBuilderImpl builder(arena);
-    builder.Reserve(elements_.size());
-    for (const auto& element : elements_) {
-      builder.UnsafeAdd(element.Clone(arena));
+    const size_t size = elements_.size();
+    builder.Reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+      builder.UnsafeAdd(elements_.Get(i).Clone(arena));
     }
     return std::move(builder).BuildCustom();
   }
@@ -419,57 +738,58 @@ class MutableCompatListValueImpl final : public MutableCompatListValue {
       const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
       google::protobuf::MessageFactory* absl_nonnull message_factory,
       google::protobuf::Arena* absl_nonnull arena) const override {
-    const size_t size = elements_.size();
-    for (size_t i = 0; i < size; ++i) {
-      CEL_ASSIGN_OR_RETURN(auto ok, callback(i, elements_[i]));
-      if (!ok) {
-        break;
-      }
-    }
-    return absl::OkStatus();
+    return elements_.ForEach(callback);
   }
 
   absl::StatusOr<absl_nonnull ValueIteratorPtr> NewIterator() const override {
-    return std::make_unique<CompatListValueImplIterator>(
-        absl::MakeConstSpan(elements_));
+    return std::make_unique<CompatListValueImplIterator>(elements_);
+  }
+
+  absl::Status Contains(
+      const Value& other,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull result) const override {
+    return elements_.Contains(other, descriptor_pool, message_factory, arena,
+                              result);
   }
 
   CelValue operator[](int index) const override {
-    return Get(elements_.get_allocator().arena(), index);
+    return Get(elements_.arena(), index);
   }
 
   // Like `operator[](int)` above, but also accepts an arena. Prefer calling
   // this variant if the arena is known.
   CelValue Get(google::protobuf::Arena* arena, int index) const override {
     if (arena == nullptr) {
-      arena = elements_.get_allocator().arena();
+      arena = elements_.arena();
     }
     if (ABSL_PREDICT_FALSE(index < 0 || index >= size())) {
       return CelValue::CreateError(google::protobuf::Arena::Create<absl::Status>(
           arena, IndexOutOfBoundsError(index).ToStatus()));
     }
-    return common_internal::UnsafeLegacyValue(
-        elements_[index], /*stable=*/false,
-        arena != nullptr ? arena : elements_.get_allocator().arena());
+    return elements_.GetLegacy(index, /*stable=*/false, arena);
   }
 
   int size() const override { return static_cast<int>(Size()); }
 
+  absl::optional<PackedListElements> GetPackedElements() const override {
+    return elements_.GetPacked();
+  }
+
   absl::Status Append(Value value) const override {
     CEL_RETURN_IF_ERROR(CheckListElement(value));
-    elements_.emplace_back(std::move(value));
-    if (elements_trivially_destructible_) {
-      elements_trivially_destructible_ =
-          ArenaTraits<>::trivially_destructible(elements_.back());
-      if (!elements_trivially_destructible_) {
-        elements_.get_allocator().arena()->OwnDestructor(
-            const_cast<MutableCompatListValueImpl*>(this));
-      }
+    const bool was_trivially_destructible = elements_.trivially_destructible();
+    elements_.Append(std::move(value));
+    if (was_trivially_destructible && !elements_.trivially_destructible()) {
+      elements_.arena()->OwnDestructor(
+          const_cast<MutableCompatListValueImpl*>(this));
     }
     return absl::OkStatus();
   }
 
-  void Reserve(size_t capacity) const override { elements_.reserve(capacity); }
+  void Reserve(size_t capacity) const override { elements_.Reserve(capacity); }
 
  protected:
   absl::Status Get(size_t index,
@@ -480,16 +800,239 @@ class MutableCompatListValueImpl final : public MutableCompatListValue {
     if (index >= elements_.size()) {
       *result = IndexOutOfBoundsError(index);
     } else {
-      *result = elements_[index];
+      *result = elements_.Get(index);
     }
     return absl::OkStatus();
   }
 
  private:
-  mutable ValueVector elements_;
-  mutable bool elements_trivially_destructible_ = true;
+  mutable ListElements elements_;
+};
+
+// Concatenations nested at most this deep are indexed by descending into their
+// operands, deeper ones are flattened on the first random access.
+constexpr size_t kMaxUnflattenedConcatDepth = 4;
+
+// The result of `lhs + rhs` which shares the elements of its operands instead
+// of copying them. Comprehensions such as `filter` and `map` accumulate their
+// result by repeated concatenation, which is then linear instead of quadratic
+// in the size of the result.
+//
+// The value may outlive the evaluation which created it, so it only uses the
+// descriptor pool, message factory and arena passed to each call.
+class ConcatListValue final : public CustomListValueInterface {
+ public:
+  // `arena` is the arena this value is allocated on.
+  ConcatListValue(ListValue lhs, size_t lhs_size, ListValue rhs,
+                  size_t rhs_size, size_t depth,
+                  google::protobuf::Arena* absl_nonnull arena)
+      : lhs_(std::move(lhs)),
+        rhs_(std::move(rhs)),
+        lhs_size_(lhs_size),
+        size_(lhs_size + rhs_size),
+        depth_(depth),
+        arena_(arena) {}
+
+  size_t depth() const { return depth_; }
+
+  std::string DebugString() const override {
+    std::string out = "[";
+    ForEachOperand([&](const ListValue& operand) -> absl::StatusOr<bool> {
+      // Operands are never empty, so their elements are between the brackets.
+      std::string elements = operand.DebugString();
+      if (out.size() != 1) {
+        out.append(", ");
+      }
+      out.append(absl::string_view(elements).substr(1, elements.size() - 2));
+      return true;
+    }).IgnoreError();
+    out.push_back(']');
+    return out;
+  }
+
+  absl::Status ConvertToJsonArray(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Message* absl_nonnull json) const override {
+    google::protobuf::Arena arena;
+    CEL_ASSIGN_OR_RETURN(const CompatListValue* absl_nonnull flattened,
+                         Flatten(descriptor_pool, message_factory, &arena));
+    return CustomListValue(flattened, &arena)
+        .ConvertToJsonArray(descriptor_pool, message_factory, json);
+  }
+
+  CustomListValue Clone(google::protobuf::Arena* absl_nonnull arena) const override {
+    ABSL_DCHECK(arena != nullptr);
+
+    // Rebuilds the concatenation from clones of its operands, which doesn't
+    // require iterating over the elements.
+    absl::optional<ListValue> result;
+    size_t result_size = 0;
+    size_t depth = 0;
+    ForEachOperand([&](const ListValue& operand) -> absl::StatusOr<bool> {
+      ListValue clone = Value(operand).Clone(arena).GetList();
+      CEL_ASSIGN_OR_RETURN(size_t clone_size, clone.Size());
+      if (!result.has_value()) {
+        result = std::move(clone);
+        result_size = clone_size;
+        return true;
+      }
+      ConcatListValue* absl_nonnull impl = ::new (arena->AllocateAligned(
+          sizeof(ConcatListValue), alignof(ConcatListValue)))
+          ConcatListValue(*std::move(result), result_size, std::move(clone),
+                          clone_size, ++depth, arena);
+      arena->OwnDestructor(impl);
+      result = CustomListValue(impl, arena);
+      result_size += clone_size;
+      return true;
+    }).IgnoreError();
+    ABSL_DCHECK(result.has_value() && result->IsCustom());
+    return std::move(*result).GetCustom();
+  }
+
+  size_t Size() const override { return size_; }
+
+  absl::Status ForEach(
+      ForEachWithIndexCallback callback,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena) const override {
+    size_t index = 0;
+    bool done = false;
+    return ForEachOperand(
+        [&](const ListValue& operand) -> absl::StatusOr<bool> {
+          CEL_RETURN_IF_ERROR(operand.ForEach(
+              [&](const Value& element) -> absl::StatusOr<bool> {
+                CEL_ASSIGN_OR_RETURN(bool ok, callback(index++, element));
+                done = !ok;
+                return ok;
+              },
+              descriptor_pool, message_factory, arena));
+          return !done;
+        });
+  }
+
+ protected:
+  absl::Status Get(size_t index,
+                   const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+                   google::protobuf::MessageFactory* absl_nonnull message_factory,
+                   google::protobuf::Arena* absl_nonnull arena,
+                   Value* absl_nonnull result) const override {
+    if (ABSL_PREDICT_FALSE(index >= size_)) {
+      *result = IndexOutOfBoundsError(index);
+      return absl::OkStatus();
+    }
+    if (depth_ <= kMaxUnflattenedConcatDepth) {
+      if (index < lhs_size_) {
+        return lhs_.Get(index, descriptor_pool, message_factory, arena, result);
+      }
+      return rhs_.Get(index - lhs_size_, descriptor_pool, message_factory,
+                      arena, result);
+    }
+    CEL_ASSIGN_OR_RETURN(const CompatListValue* absl_nonnull flattened,
+                         Flatten(descriptor_pool, message_factory, arena));
+    return CustomListValue(flattened, arena)
+        .Get(index, descriptor_pool, message_factory, arena, result);
+  }
+
+ private:
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<ConcatListValue>();
+  }
+
+  // Invokes `callback` with each operand which is not itself a concatenation,
+  // from left to right. Operands are visited with an explicit stack, as a
+  // comprehension nests concatenations as deep as its number of iterations.
+  absl::Status ForEachOperand(
+      absl::FunctionRef<absl::StatusOr<bool>(const ListValue&)> callback)
+      const;
+
+  // Copies the elements into a single list allocated on `arena`. The copy is
+  // kept for later calls if `arena` is the one this value is allocated on,
+  // otherwise it may not live as long as this value.
+  absl::StatusOr<const CompatListValue* absl_nonnull> Flatten(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena) const;
+
+  const ListValue lhs_;
+  const ListValue rhs_;
+  const size_t lhs_size_;
+  const size_t size_;
+  const size_t depth_;
+  // Only compared against the arena passed to `Flatten`.
+  const google::protobuf::Arena* absl_nonnull const arena_;
+  mutable absl::once_flag flatten_once_;
+  mutable absl::Status flatten_status_;
+  mutable const CompatListValue* absl_nullable flattened_ = nullptr;
 };
 
+const ConcatListValue* absl_nullable AsConcatListValue(const ListValue& value) {
+  if (auto custom_list_value = value.AsCustom();
+      custom_list_value &&
+      custom_list_value->GetTypeId() == NativeTypeId::For<ConcatListValue>()) {
+    return cel::internal::down_cast<const ConcatListValue*>(
+        custom_list_value->interface());
+  }
+  return nullptr;
+}
+
+absl::Status ConcatListValue::ForEachOperand(
+    absl::FunctionRef<absl::StatusOr<bool>(const ListValue&)> callback) const {
+  std::vector<const ListValue*> stack = {&rhs_, &lhs_};
+  while (!stack.empty()) {
+    const ListValue* absl_nonnull operand = stack.back();
+    stack.pop_back();
+    if (const ConcatListValue* concat = AsConcatListValue(*operand);
+        concat != nullptr) {
+      stack.push_back(&concat->rhs_);
+      stack.push_back(&concat->lhs_);
+      continue;
+    }
+    CEL_ASSIGN_OR_RETURN(bool ok, callback(*operand));
+    if (!ok) {
+      break;
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<const CompatListValue* absl_nonnull> ConcatListValue::Flatten(
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) const {
+  auto flatten = [&]() -> absl::StatusOr<const CompatListValue* absl_nonnull> {
+    ListValueBuilderImpl builder(arena);
+    builder.Reserve(size_);
+    CEL_RETURN_IF_ERROR(ForEachOperand(
+        [&](const ListValue& operand) -> absl::StatusOr<bool> {
+          CEL_RETURN_IF_ERROR(operand.ForEach(
+              [&](const Value& element) -> absl::StatusOr<bool> {
+                builder.UnsafeAdd(element);
+                return true;
+              },
+              descriptor_pool, message_factory, arena));
+          return true;
+        }));
+    return std::move(builder).BuildCompat();
+  };
+  if (arena != arena_) {
+    return flatten();
+  }
+  absl::call_once(flatten_once_, [&]() {
+    absl::StatusOr<const CompatListValue* absl_nonnull> flattened = flatten();
+    if (flattened.ok()) {
+      flattened_ = *flattened;
+    } else {
+      flatten_status_ = std::move(flattened).status();
+    }
+  });
+  if (!flatten_status_.ok()) {
+    return flatten_status_;
+  }
+  return flattened_;
+}
+
 }  // namespace
 
 }  // namespace common_internal
@@ -530,6 +1073,49 @@ MutableListValue* absl_nonnull NewMutableListValue(
       MutableCompatListValueImpl(arena);
 }
 
+absl::StatusOr<ListValue> ConcatListValues(
+    const ListValue& lhs, const ListValue& rhs,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) {
+  CEL_ASSIGN_OR_RETURN(size_t lhs_size, lhs.Size());
+  if (lhs_size == 0) {
+    return rhs;
+  }
+  CEL_ASSIGN_OR_RETURN(size_t rhs_size, rhs.Size());
+  if (rhs_size == 0) {
+    return lhs;
+  }
+  if (IsMutableListValue(lhs) || IsMutableListValue(rhs)) {
+    // Mutable lists can still change, so their elements must be copied.
+    ListValueBuilderImpl builder(arena);
+    builder.Reserve(lhs_size + rhs_size);
+    for (const ListValue* operand : {&lhs, &rhs}) {
+      CEL_RETURN_IF_ERROR(operand->ForEach(
+          [&](const Value& element) -> absl::StatusOr<bool> {
+            CEL_RETURN_IF_ERROR(builder.Add(element));
+            return true;
+          },
+          descriptor_pool, message_factory, arena));
+    }
+    return std::move(builder).Build();
+  }
+  size_t depth = 0;
+  if (const ConcatListValue* concat = AsConcatListValue(lhs);
+      concat != nullptr) {
+    depth = concat->depth();
+  }
+  if (const ConcatListValue* concat = AsConcatListValue(rhs);
+      concat != nullptr) {
+    depth = std::max(depth, concat->depth());
+  }
+  ConcatListValue* absl_nonnull impl = ::new (arena->AllocateAligned(
+      sizeof(ConcatListValue), alignof(ConcatListValue)))
+      ConcatListValue(lhs, lhs_size, rhs, rhs_size, depth + 1, arena);
+  arena->OwnDestructor(impl);
+  return CustomListValue(impl, arena);
+}
+
 bool IsMutableListValue(const Value& value) {
   if (auto custom_list_value = value.AsCustomList(); custom_list_value) {
     NativeTypeId native_type_id = custom_list_value->GetTypeId();
@@ -613,6 +1199,24 @@ const MutableListValue& GetMutableListValue(const ListValue& value) {
   ABSL_UNREACHABLE();
 }
 
+absl::optional<PackedListElements> AsPackedListElements(
+    const ListValue& value) {
+  if (auto custom_list_value = value.AsCustom(); custom_list_value) {
+    NativeTypeId native_type_id = custom_list_value->GetTypeId();
+    if (native_type_id == NativeTypeId::For<CompatListValue>()) {
+      return cel::internal::down_cast<const CompatListValue*>(
+                 custom_list_value->interface())
+          ->GetPackedElements();
+    }
+    if (native_type_id == NativeTypeId::For<MutableCompatListValue>()) {
+      return cel::internal::down_cast<const MutableCompatListValue*>(
+                 custom_list_value->interface())
+          ->GetPackedElements();
+    }
+  }
+  return absl::nullopt;
+}
+
 absl_nonnull cel::ListValueBuilderPtr NewListValueBuilder(
     google::protobuf::Arena* absl_nonnull arena) {
   return std::make_unique<ListValueBuilderImpl>(arena);
@@ -877,10 +1481,230 @@ using ValueFlatHashMap =
     absl::flat_hash_map<Value, Value, ValueHasher, ValueEqualer,
                         ValueFlatHashMapAllocator>;
 
+// Storage for the entries of the maps built here. Most maps are small, such as
+// map literals in policies, so the first `kSmallCapacity` entries are kept in
+// insertion order in an arena array and found by a linear scan which compares a
+// one byte fingerprint of the key's hash before comparing keys. The
+// fingerprints are computed once on insertion, so looking up a string key
+// hashes the probe once and compares strings only on fingerprint matches. Maps
+// which grow larger are promoted to a hash table.
+class MapEntries final {
+ public:
+  using value_type = std::pair<const Value, Value>;
+
+  static constexpr size_t kSmallCapacity = 8;
+
+  class const_iterator final {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = MapEntries::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    const_iterator() = default;
+
+    reference operator*() const { return is_small_ ? *small_ : *large_; }
+
+    pointer operator->() const { return &**this; }
+
+    const_iterator& operator++() {
+      if (is_small_) {
+        ++small_;
+      } else {
+        ++large_;
+      }
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator it = *this;
+      ++*this;
+      return it;
+    }
+
+    friend bool operator==(const const_iterator& lhs,
+                           const const_iterator& rhs) {
+      ABSL_DCHECK_EQ(lhs.is_small_, rhs.is_small_);
+      return lhs.is_small_ ? lhs.small_ == rhs.small_
+                           : lhs.large_ == rhs.large_;
+    }
+
+    friend bool operator!=(const const_iterator& lhs,
+                           const const_iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    friend class MapEntries;
+
+    explicit const_iterator(const value_type* small)
+        : small_(small), is_small_(true) {}
+
+    explicit const_iterator(ValueFlatHashMap::const_iterator large)
+        : large_(large) {}
+
+    const value_type* small_ = nullptr;
+    ValueFlatHashMap::const_iterator large_;
+    bool is_small_ = false;
+  };
+
+  explicit MapEntries(google::protobuf::Arena* absl_nonnull arena) : large_(arena) {}
+
+  MapEntries(MapEntries&& other)
+      : large_(std::move(other.large_)),
+        small_(std::exchange(other.small_, nullptr)),
+        small_size_(std::exchange(other.small_size_, 0)),
+        small_capacity_(std::exchange(other.small_capacity_, 0)),
+        is_small_(other.is_small_),
+        trivially_destructible_(other.trivially_destructible_) {
+    std::memcpy(fingerprints_, other.fingerprints_, sizeof(fingerprints_));
+  }
+
+  MapEntries(const MapEntries&) = delete;
+  MapEntries& operator=(const MapEntries&) = delete;
+  MapEntries& operator=(MapEntries&&) = delete;
+
+  ~MapEntries() { DestroySmall(); }
+
+  google::protobuf::Arena* absl_nonnull arena() const {
+    return large_.get_allocator().arena();
+  }
+
+  bool empty() const { return size() == 0; }
+
+  size_t size() const { return is_small_ ? small_size_ : large_.size(); }
+
+  // Whether the entries can be abandoned on the arena without running their
+  // destructors.
+  bool trivially_destructible() const { return trivially_destructible_; }
+
+  const_iterator begin() const {
+    return is_small_ ? const_iterator(small_) : const_iterator(large_.begin());
+  }
+
+  const_iterator end() const {
+    return is_small_ ? const_iterator(small_ + small_size_)
+                     : const_iterator(large_.end());
+  }
+
+  void Reserve(size_t capacity) {
+    if (!is_small_) {
+      large_.reserve(capacity);
+    } else if (capacity > kSmallCapacity) {
+      Promote(capacity);
+    } else {
+      ReserveSmall(capacity);
+    }
+  }
+
+  // Inserts an entry whose key must not already be present.
+  void Insert(Value key, Value value) {
+    ABSL_DCHECK(Find(key) == nullptr);
+    const value_type* entry;
+    if (is_small_ && small_size_ < kSmallCapacity) {
+      if (small_size_ == small_capacity_) {
+        ReserveSmall(std::min(std::max<size_t>(small_capacity_ * 2, 2),
+                              kSmallCapacity));
+      }
+      fingerprints_[small_size_] = Fingerprint(ValueHasher{}(key));
+      entry = ::new (static_cast<void*>(&small_[small_size_]))
+          value_type(std::move(key), std::move(value));
+      ++small_size_;
+    } else {
+      if (is_small_) {
+        Promote(kSmallCapacity * 2);
+      }
+      auto insertion = large_.emplace(std::move(key), std::move(value));
+      ABSL_DCHECK(insertion.second);
+      entry = &*insertion.first;
+    }
+    if (trivially_destructible_) {
+      trivially_destructible_ =
+          ArenaTraits<>::trivially_destructible(entry->first) &&
+          ArenaTraits<>::trivially_destructible(entry->second);
+    }
+  }
+
+  // Returns the value of the entry with `key`, which is either a `Value` or a
+  // `CelValue`, or `nullptr` if there is none.
+  template <typename K>
+  const Value* absl_nullable Find(const K& key) const {
+    if (is_small_) {
+      const uint8_t fingerprint = Fingerprint(ValueHasher{}(key));
+      for (size_t i = 0; i < small_size_; ++i) {
+        if (fingerprints_[i] == fingerprint &&
+            ValueEqualer{}(small_[i].first, key)) {
+          return &small_[i].second;
+        }
+      }
+      return nullptr;
+    }
+    if (auto it = large_.find(key); it != large_.end()) {
+      return &it->second;
+    }
+    return nullptr;
+  }
+
+ private:
+  static uint8_t Fingerprint(size_t hash) {
+    return static_cast<uint8_t>(hash >> (sizeof(size_t) * CHAR_BIT - 8));
+  }
+
+  void ReserveSmall(size_t capacity) {
+    ABSL_DCHECK(is_small_);
+    ABSL_DCHECK_LE(capacity, kSmallCapacity);
+    if (capacity <= small_capacity_) {
+      return;
+    }
+    value_type* small = static_cast<value_type*>(arena()->AllocateAligned(
+        capacity * sizeof(value_type), alignof(value_type)));
+    for (size_t i = 0; i < small_size_; ++i) {
+      ::new (static_cast<void*>(&small[i]))
+          value_type(small_[i].first, std::move(small_[i].second));
+    }
+    const size_t size = small_size_;
+    DestroySmall();
+    small_ = small;
+    small_size_ = size;
+    small_capacity_ = capacity;
+  }
+
+  // Moves the entries to the hash table, which is used from then on.
+  void Promote(size_t capacity) {
+    ABSL_DCHECK(is_small_);
+    large_.reserve(std::max(capacity, small_size_));
+    for (size_t i = 0; i < small_size_; ++i) {
+      large_.emplace(small_[i].first, std::move(small_[i].second));
+    }
+    DestroySmall();
+    small_ = nullptr;
+    small_capacity_ = 0;
+    is_small_ = false;
+  }
+
+  void DestroySmall() {
+    if (!trivially_destructible_) {
+      for (size_t i = 0; i < small_size_; ++i) {
+        small_[i].~value_type();
+      }
+    }
+    small_size_ = 0;
+  }
+
+  ValueFlatHashMap large_;
+  value_type* absl_nullable small_ = nullptr;
+  size_t small_size_ = 0;
+  size_t small_capacity_ = 0;
+  bool is_small_ = true;
+  bool trivially_destructible_ = true;
+  uint8_t fingerprints_[kSmallCapacity];
+};
+
 class CompatMapValueImplIterator final : public ValueIterator {
  public:
-  explicit CompatMapValueImplIterator(const ValueFlatHashMap* absl_nonnull map)
-      : begin_(map->begin()), end_(map->end()) {}
+  explicit CompatMapValueImplIterator(const MapEntries* absl_nonnull entries)
+      : begin_(entries->begin()), end_(entries->end()) {}
 
   bool HasNext() override { return begin_ != end_; }
 
@@ -938,27 +1762,27 @@ class CompatMapValueImplIterator final : public ValueIterator {
   }
 
  private:
-  typename ValueFlatHashMap::const_iterator begin_;
-  const typename ValueFlatHashMap::const_iterator end_;
+  MapEntries::const_iterator begin_;
+  const MapEntries::const_iterator end_;
 };
 
 class MapValueBuilderImpl final : public MapValueBuilder {
  public:
   explicit MapValueBuilderImpl(google::protobuf::Arena* absl_nonnull arena)
       : arena_(arena) {
-    map_.Construct(arena_);
+    entries_.Construct(arena_);
   }
 
   ~MapValueBuilderImpl() override {
-    if (!entries_trivially_destructible_) {
-      map_.Destruct();
+    if (!entries_->trivially_destructible()) {
+      entries_.Destruct();
     }
   }
 
   absl::Status Put(Value key, Value value) override {
     CEL_RETURN_IF_ERROR(CheckMapKey(key));
     CEL_RETURN_IF_ERROR(CheckMapValue(value));
-    if (auto it = map_->find(key); ABSL_PREDICT_FALSE(it != map_->end())) {
+    if (ABSL_PREDICT_FALSE(entries_->Find(key) != nullptr)) {
       return DuplicateKeyError().ToStatus();
     }
     UnsafePut(std::move(key), std::move(value));
@@ -966,18 +1790,12 @@ class MapValueBuilderImpl final : public MapValueBuilder {
   }
 
   void UnsafePut(Value key, Value value) override {
-    auto insertion = map_->insert({std::move(key), std::move(value)});
-    ABSL_DCHECK(insertion.second);
-    if (entries_trivially_destructible_) {
-      entries_trivially_destructible_ =
-          ArenaTraits<>::trivially_destructible(insertion.first->first) &&
-          ArenaTraits<>::trivially_destructible(insertion.first->second);
-    }
+    entries_->Insert(std::move(key), std::move(value));
   }
 
-  size_t Size() const override { return map_->size(); }
+  size_t Size() const override { return entries_->size(); }
 
-  void Reserve(size_t capacity) override { map_->reserve(capacity); }
+  void Reserve(size_t capacity) override { entries_->Reserve(capacity); }
 
   MapValue Build() && override;
 
@@ -987,44 +1805,46 @@ class MapValueBuilderImpl final : public MapValueBuilder {
 
  private:
   google::protobuf::Arena* absl_nonnull const arena_;
-  internal::Manual<ValueFlatHashMap> map_;
-  bool entries_trivially_destructible_ = true;
+  internal::Manual<MapEntries> entries_;
 };
 
 class CompatMapValueImpl final : public CompatMapValue {
  public:
-  explicit CompatMapValueImpl(ValueFlatHashMap&& map) : map_(std::move(map)) {}
+  explicit CompatMapValueImpl(MapEntries&& entries)
+      : entries_(std::move(entries)) {}
 
   std::string DebugString() const override {
-    return absl::StrCat("{", absl::StrJoin(map_, ", ", ValueFormatter{}), "}");
+    return absl::StrCat("{", absl::StrJoin(entries_, ", ", ValueFormatter{}),
+                        "}");
   }
 
   absl::Status ConvertToJsonObject(
       const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
       google::protobuf::MessageFactory* absl_nonnull message_factory,
       google::protobuf::Message* absl_nonnull json) const override {
-    return MapValueToJsonObject(map_, descriptor_pool, message_factory, json);
+    return MapValueToJsonObject(entries_, descriptor_pool, message_factory,
+                                json);
   }
 
   CustomMapValue Clone(google::protobuf::Arena* absl_nonnull arena) const override {
     ABSL_DCHECK(arena != nullptr);
 
     MapValueBuilderImpl builder(arena);
-    builder.Reserve(map_.size());
-    for (const auto& entry : map_) {
+    builder.Reserve(entries_.size());
+    for (const auto& entry : entries_) {
       builder.UnsafePut(entry.first.Clone(arena), entry.second.Clone(arena));
     }
     return std::move(builder).BuildCustom();
   }
 
-  size_t Size() const override { return map_.size(); }
+  size_t Size() const override { return entries_.size(); }
 
   absl::Status ListKeys(
       const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
       google::protobuf::MessageFactory* absl_nonnull message_factory,
       google::protobuf::Arena* absl_nonnull arena,
       ListValue* absl_nonnull result) const override {
-    *result = CustomListValue(ProjectKeys(), map_.get_allocator().arena());
+    *result = CustomListValue(ProjectKeys(), entries_.arena());
     return absl::OkStatus();
   }
 
@@ -1033,7 +1853,7 @@ class CompatMapValueImpl final : public CompatMapValue {
       const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
       google::protobuf::MessageFactory* absl_nonnull message_factory,
       google::protobuf::Arena* absl_nonnull arena) const override {
-    for (const auto& entry : map_) {
+    for (const auto& entry : entries_) {
       CEL_ASSIGN_OR_RETURN(auto ok, callback(entry.first, entry.second));
       if (!ok) {
         break;
@@ -1043,11 +1863,11 @@ class CompatMapValueImpl final : public CompatMapValue {
   }
 
   absl::StatusOr<absl_nonnull ValueIteratorPtr> NewIterator() const override {
-    return std::make_unique<CompatMapValueImplIterator>(&map_);
+    return std::make_unique<CompatMapValueImplIterator>(&entries_);
   }
 
   absl::optional<CelValue> operator[](CelValue key) const override {
-    return Get(map_.get_allocator().arena(), key);
+    return Get(entries_.arena(), key);
   }
 
   using CompatMapValue::Get;
@@ -1057,10 +1877,9 @@ class CompatMapValueImpl final : public CompatMapValue {
       status.IgnoreError();
       return absl::nullopt;
     }
-    if (auto it = map_.find(key); it != map_.end()) {
+    if (const Value* value = entries_.Find(key); value != nullptr) {
       return common_internal::UnsafeLegacyValue(
-          it->second, /*stable=*/true,
-          arena != nullptr ? arena : map_.get_allocator().arena());
+          *value, /*stable=*/true, arena != nullptr ? arena : entries_.arena());
     }
     return absl::nullopt;
   }
@@ -1068,7 +1887,7 @@ class CompatMapValueImpl final : public CompatMapValue {
   absl::StatusOr<bool> Has(const CelValue& key) const override {
     // This check safeguards against issues with invalid key types such as NaN.
     CEL_RETURN_IF_ERROR(CelValue::CheckMapKeyType(key));
-    return map_.find(key) != map_.end();
+    return entries_.Find(key) != nullptr;
   }
 
   int size() const override { return static_cast<int>(Size()); }
@@ -1089,8 +1908,8 @@ class CompatMapValueImpl final : public CompatMapValue {
       google::protobuf::Arena* absl_nonnull arena,
       Value* absl_nonnull result) const override {
     CEL_RETURN_IF_ERROR(CheckMapKey(key));
-    if (auto it = map_.find(key); it != map_.end()) {
-      *result = it->second;
+    if (const Value* value = entries_.Find(key); value != nullptr) {
+      *result = *value;
       return true;
     }
     return false;
@@ -1102,16 +1921,16 @@ class CompatMapValueImpl final : public CompatMapValue {
       google::protobuf::MessageFactory* absl_nonnull message_factory,
       google::protobuf::Arena* absl_nonnull arena) const override {
     CEL_RETURN_IF_ERROR(CheckMapKey(key));
-    return map_.find(key) != map_.end();
+    return entries_.Find(key) != nullptr;
   }
 
  private:
   const CompatListValue* absl_nonnull ProjectKeys() const {
     absl::call_once(keys_once_, [this]() {
-      ListValueBuilderImpl builder(map_.get_allocator().arena());
-      builder.Reserve(map_.size());
+      ListValueBuilderImpl builder(entries_.arena());
+      builder.Reserve(entries_.size());
 
-      for (const auto& entry : map_) {
+      for (const auto& entry : entries_) {
         builder.UnsafeAdd(entry.first);
       }
 
@@ -1121,35 +1940,35 @@ class CompatMapValueImpl final : public CompatMapValue {
         reinterpret_cast<const CompatListValueImpl*>(&keys_[0]));
   }
 
-  const ValueFlatHashMap map_;
+  const MapEntries entries_;
   mutable absl::once_flag keys_once_;
   alignas(CompatListValueImpl) mutable char keys_[sizeof(CompatListValueImpl)];
 };
 
 MapValue MapValueBuilderImpl::Build() && {
-  if (map_->empty()) {
+  if (entries_->empty()) {
     return MapValue();
   }
   return std::move(*this).BuildCustom();
 }
 
 CustomMapValue MapValueBuilderImpl::BuildCustom() && {
-  if (map_->empty()) {
+  if (entries_->empty()) {
     return CustomMapValue(EmptyCompatMapValue(), arena_);
   }
   return CustomMapValue(std::move(*this).BuildCompat(), arena_);
 }
 
 const CompatMapValue* absl_nonnull MapValueBuilderImpl::BuildCompat() && {
-  if (map_->empty()) {
+  if (entries_->empty()) {
     return EmptyCompatMapValue();
   }
+  const bool trivially_destructible = entries_->trivially_destructible();
   CompatMapValueImpl* absl_nonnull impl = ::new (arena_->AllocateAligned(
       sizeof(CompatMapValueImpl), alignof(CompatMapValueImpl)))
-      CompatMapValueImpl(std::move(*map_));
-  if (!entries_trivially_destructible_) {
+      CompatMapValueImpl(std::move(*entries_));
+  if (!trivially_destructible) {
     arena_->OwnDestructor(impl);
-    entries_trivially_destructible_ = true;
   }
   return impl;
 }
@@ -1157,38 +1976,40 @@ const CompatMapValue* absl_nonnull MapValueBuilderImpl::BuildCompat() && {
 class TrivialMutableMapValueImpl final : public MutableCompatMapValue {
  public:
   explicit TrivialMutableMapValueImpl(google::protobuf::Arena* absl_nonnull arena)
-      : map_(arena) {}
+      : entries_(arena) {}
 
   std::string DebugString() const override {
-    return absl::StrCat("{", absl::StrJoin(map_, ", ", ValueFormatter{}), "}");
+    return absl::StrCat("{", absl::StrJoin(entries_, ", ", ValueFormatter{}),
+                        "}");
   }
 
   absl::Status ConvertToJsonObject(
       const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
       google::protobuf::MessageFactory* absl_nonnull message_factory,
       google::protobuf::Message* absl_nonnull json) const override {
-    return MapValueToJsonObject(map_, descriptor_pool, message_factory, json);
+    return MapValueToJsonObject(entries_, descriptor_pool, message_factory,
+                                json);
   }
 
   CustomMapValue Clone(google::protobuf::Arena* absl_nonnull arena) const override {
     ABSL_DCHECK(arena != nullptr);
 
     MapValueBuilderImpl builder(arena);
-    builder.Reserve(map_.size());
-    for (const auto& entry : map_) {
+    builder.Reserve(entries_.size());
+    for (const auto& entry : entries_) {
       builder.UnsafePut(entry.first.Clone(arena), entry.second.Clone(arena));
     }
     return std::move(builder).BuildCustom();
   }
 
-  size_t Size() const override { return map_.size(); }
+  size_t Size() const override { return entries_.size(); }
 
   absl::Status ListKeys(
       const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
       google::protobuf::MessageFactory* absl_nonnull message_factory,
       google::protobuf::Arena* absl_nonnull arena,
       ListValue* absl_nonnull result) const override {
-    *result = CustomListValue(ProjectKeys(), map_.get_allocator().arena());
+    *result = CustomListValue(ProjectKeys(), entries_.arena());
     return absl::OkStatus();
   }
 
@@ -1197,7 +2018,7 @@ class TrivialMutableMapValueImpl final : public MutableCompatMapValue {
       const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
       google::protobuf::MessageFactory* absl_nonnull message_factory,
       google::protobuf::Arena* absl_nonnull arena) const override {
-    for (const auto& entry : map_) {
+    for (const auto& entry : entries_) {
       CEL_ASSIGN_OR_RETURN(auto ok, callback(entry.first, entry.second));
       if (!ok) {
         break;
@@ -1207,11 +2028,11 @@ class TrivialMutableMapValueImpl final : public MutableCompatMapValue {
   }
 
   absl::StatusOr<absl_nonnull ValueIteratorPtr> NewIterator() const override {
-    return std::make_unique<CompatMapValueImplIterator>(&map_);
+    return std::make_unique<CompatMapValueImplIterator>(&entries_);
   }
 
   absl::optional<CelValue> operator[](CelValue key) const override {
-    return Get(map_.get_allocator().arena(), key);
+    return Get(entries_.arena(), key);
   }
 
   using MutableCompatMapValue::Get;
@@ -1221,10 +2042,10 @@ class TrivialMutableMapValueImpl final : public MutableCompatMapValue {
       status.IgnoreError();
       return absl::nullopt;
     }
-    if (auto it = map_.find(key); it != map_.end()) {
+    if (const Value* value = entries_.Find(key); value != nullptr) {
       return common_internal::UnsafeLegacyValue(
-          it->second, /*stable=*/false,
-          arena != nullptr ? arena : map_.get_allocator().arena());
+          *value, /*stable=*/false,
+          arena != nullptr ? arena : entries_.arena());
     }
     return absl::nullopt;
   }
@@ -1232,7 +2053,7 @@ class TrivialMutableMapValueImpl final : public MutableCompatMapValue {
   absl::StatusOr<bool> Has(const CelValue& key) const override {
     // This check safeguards against issues with invalid key types such as NaN.
     CEL_RETURN_IF_ERROR(CelValue::CheckMapKeyType(key));
-    return map_.find(key) != map_.end();
+    return entries_.Find(key) != nullptr;
   }
 
   int size() const override { return static_cast<int>(Size()); }
@@ -1248,24 +2069,19 @@ class TrivialMutableMapValueImpl final : public MutableCompatMapValue {
   absl::Status Put(Value key, Value value) const override {
     CEL_RETURN_IF_ERROR(CheckMapKey(key));
     CEL_RETURN_IF_ERROR(CheckMapValue(value));
-    if (auto it = map_.find(key); ABSL_PREDICT_FALSE(it != map_.end())) {
+    if (ABSL_PREDICT_FALSE(entries_.Find(key) != nullptr)) {
       return DuplicateKeyError().ToStatus();
     }
-    auto insertion = map_.insert({std::move(key), std::move(value)});
-    ABSL_DCHECK(insertion.second);
-    if (entries_trivially_destructible_) {
-      entries_trivially_destructible_ =
-          ArenaTraits<>::trivially_destructible(insertion.first->first) &&
-          ArenaTraits<>::trivially_destructible(insertion.first->second);
-      if (!entries_trivially_destructible_) {
-        map_.get_allocator().arena()->OwnDestructor(
-            const_cast<TrivialMutableMapValueImpl*>(this));
-      }
+    const bool was_trivially_destructible = entries_.trivially_destructible();
+    entries_.Insert(std::move(key), std::move(value));
+    if (was_trivially_destructible && !entries_.trivially_destructible()) {
+      entries_.arena()->OwnDestructor(
+          const_cast<TrivialMutableMapValueImpl*>(this));
     }
     return absl::OkStatus();
   }
 
-  void Reserve(size_t capacity) const override { map_.reserve(capacity); }
+  void Reserve(size_t capacity) const override { entries_.Reserve(capacity); }
 
  protected:
   absl::StatusOr<bool> Find(
@@ -1275,8 +2091,8 @@ class TrivialMutableMapValueImpl final : public MutableCompatMapValue {
       google::protobuf::Arena* absl_nonnull arena,
       Value* absl_nonnull result) const override {
     CEL_RETURN_IF_ERROR(CheckMapKey(key));
-    if (auto it = map_.find(key); it != map_.end()) {
-      *result = it->second;
+    if (const Value* value = entries_.Find(key); value != nullptr) {
+      *result = *value;
       return true;
     }
     return false;
@@ -1288,16 +2104,16 @@ class TrivialMutableMapValueImpl final : public MutableCompatMapValue {
       google::protobuf::MessageFactory* absl_nonnull message_factory,
       google::protobuf::Arena* absl_nonnull arena) const override {
     CEL_RETURN_IF_ERROR(CheckMapKey(key));
-    return map_.find(key) != map_.end();
+    return entries_.Find(key) != nullptr;
   }
 
  private:
   const CompatListValue* absl_nonnull ProjectKeys() const {
     absl::call_once(keys_once_, [this]() {
-      ListValueBuilderImpl builder(map_.get_allocator().arena());
-      builder.Reserve(map_.size());
+      ListValueBuilderImpl builder(entries_.arena());
+      builder.Reserve(entries_.size());
 
-      for (const auto& entry : map_) {
+      for (const auto& entry : entries_) {
         builder.UnsafeAdd(entry.first);
       }
 
@@ -1307,12 +2123,246 @@ class TrivialMutableMapValueImpl final : public MutableCompatMapValue {
         reinterpret_cast<const CompatListValueImpl*>(&keys_[0]));
   }
 
-  mutable ValueFlatHashMap map_;
-  mutable bool entries_trivially_destructible_ = true;
+  mutable MapEntries entries_;
   mutable absl::once_flag keys_once_;
   alignas(CompatListValueImpl) mutable char keys_[sizeof(CompatListValueImpl)];
 };
 
+using MapInsertionEntries = std::vector<std::pair<Value, Value>>;
+
+// Entries inserted by `MapValueWithEntry` on top of an existing map. The log is
+// shared by the successive versions of the map, each of which sees a prefix of
+// the entries, so inserting into the latest version appends to the log instead
+// of copying the map.
+class MapInsertionLog final {
+ public:
+  MapInsertionLog(MapValue base, size_t base_size, MapInsertionEntries entries)
+      : base_(std::move(base)),
+        base_size_(base_size),
+        entries_(std::move(entries)) {
+    positions_.reserve(entries_.size());
+    for (size_t i = 0; i < entries_.size(); ++i) {
+      positions_.insert({entries_[i].first, i});
+    }
+  }
+
+  const MapValue& base() const { return base_; }
+
+  size_t base_size() const { return base_size_; }
+
+  // Appends an entry if the log holds exactly `size` entries, that is if the
+  // version seeing `size` entries is the latest one. Returns `false` otherwise.
+  bool Append(size_t size, Value key, Value value) {
+    absl::MutexLock lock(&mutex_);
+    if (entries_.size() != size) {
+      return false;
+    }
+    positions_.insert({key, size});
+    entries_.push_back({std::move(key), std::move(value)});
+    return true;
+  }
+
+  // Looks up `key` among the first `size` entries.
+  bool Find(const Value& key, size_t size,
+            Value* absl_nullable result) const {
+    absl::ReaderMutexLock lock(&mutex_);
+    if (auto it = positions_.find(key);
+        it != positions_.end() && it->second < size) {
+      if (result != nullptr) {
+        *result = entries_[it->second].second;
+      }
+      return true;
+    }
+    return false;
+  }
+
+  std::pair<Value, Value> Get(size_t position) const {
+    absl::ReaderMutexLock lock(&mutex_);
+    return entries_[position];
+  }
+
+  MapInsertionEntries CopyEntries(size_t size) const {
+    absl::ReaderMutexLock lock(&mutex_);
+    return MapInsertionEntries(entries_.begin(), entries_.begin() + size);
+  }
+
+ private:
+  const MapValue base_;
+  const size_t base_size_;
+  mutable absl::Mutex mutex_;
+  MapInsertionEntries entries_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<Value, size_t, ValueHasher, ValueEqualer> positions_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+MapInsertionLog* absl_nonnull NewMapInsertionLog(
+    MapValue base, size_t base_size, MapInsertionEntries entries,
+    google::protobuf::Arena* absl_nonnull arena) {
+  MapInsertionLog* absl_nonnull log = ::new (arena->AllocateAligned(
+      sizeof(MapInsertionLog), alignof(MapInsertionLog)))
+      MapInsertionLog(std::move(base), base_size, std::move(entries));
+  arena->OwnDestructor(log);
+  return log;
+}
+
+// A version of a map created by `MapValueWithEntry`, which is the base map of
+// its log followed by the first `size` entries of the log.
+//
+// The value may outlive the evaluation which created it, so it only uses the
+// descriptor pool, message factory and arena passed to each call.
+class InsertedMapValue final : public CustomMapValueInterface {
+ public:
+  InsertedMapValue(MapInsertionLog* absl_nonnull log, size_t size)
+      : log_(log), size_(size) {}
+
+  MapInsertionLog* absl_nonnull log() const { return log_; }
+
+  size_t inserted_size() const { return size_; }
+
+  std::string DebugString() const override {
+    std::string out = log_->base().DebugString();
+    ABSL_DCHECK(!out.empty() && out.back() == '}');
+    out.pop_back();
+    for (size_t i = 0; i < size_; ++i) {
+      const auto entry = log_->Get(i);
+      if (out.size() != 1) {
+        out.append(", ");
+      }
+      out.append(entry.first.DebugString());
+      out.append(": ");
+      out.append(entry.second.DebugString());
+    }
+    out.push_back('}');
+    return out;
+  }
+
+  absl::Status ConvertToJsonObject(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Message* absl_nonnull json) const override {
+    google::protobuf::Arena arena;
+    MapValueBuilderImpl builder(&arena);
+    builder.Reserve(Size());
+    CEL_RETURN_IF_ERROR(ForEach(
+        [&](const Value& key, const Value& value) -> absl::StatusOr<bool> {
+          builder.UnsafePut(key, value);
+          return true;
+        },
+        descriptor_pool, message_factory, &arena));
+    return std::move(builder).BuildCustom().ConvertToJsonObject(
+        descriptor_pool, message_factory, json);
+  }
+
+  CustomMapValue Clone(google::protobuf::Arena* absl_nonnull arena) const override {
+    ABSL_DCHECK(arena != nullptr);
+
+    // Clones the base map and the visible entries into a new log, which
+    // doesn't require iterating over the base map.
+    MapInsertionEntries entries = log_->CopyEntries(size_);
+    for (auto& entry : entries) {
+      entry.first = entry.first.Clone(arena);
+      entry.second = entry.second.Clone(arena);
+    }
+    MapInsertionLog* absl_nonnull log = NewMapInsertionLog(
+        Value(log_->base()).Clone(arena).GetMap(), log_->base_size(),
+        std::move(entries), arena);
+    return CustomMapValue(
+        ::new (arena->AllocateAligned(sizeof(InsertedMapValue),
+                                      alignof(InsertedMapValue)))
+            InsertedMapValue(log, size_),
+        arena);
+  }
+
+  size_t Size() const override { return log_->base_size() + size_; }
+
+  absl::Status ListKeys(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      ListValue* absl_nonnull result) const override {
+    ListValueBuilderImpl builder(arena);
+    builder.Reserve(Size());
+    CEL_RETURN_IF_ERROR(ForEach(
+        [&](const Value& key, const Value&) -> absl::StatusOr<bool> {
+          builder.UnsafeAdd(key);
+          return true;
+        },
+        descriptor_pool, message_factory, arena));
+    *result = std::move(builder).Build();
+    return absl::OkStatus();
+  }
+
+  absl::Status ForEach(
+      ForEachCallback callback,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena) const override {
+    bool done = false;
+    CEL_RETURN_IF_ERROR(log_->base().ForEach(
+        [&](const Value& key, const Value& value) -> absl::StatusOr<bool> {
+          CEL_ASSIGN_OR_RETURN(bool ok, callback(key, value));
+          done = !ok;
+          return ok;
+        },
+        descriptor_pool, message_factory, arena));
+    for (size_t i = 0; !done && i < size_; ++i) {
+      // Entries are copied out of the log, as `callback` may insert into it.
+      const auto entry = log_->Get(i);
+      CEL_ASSIGN_OR_RETURN(bool ok, callback(entry.first, entry.second));
+      done = !ok;
+    }
+    return absl::OkStatus();
+  }
+
+ protected:
+  absl::StatusOr<bool> Find(
+      const Value& key,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull result) const override {
+    CEL_RETURN_IF_ERROR(CheckMapKey(key));
+    if (log_->Find(key, size_, result)) {
+      return true;
+    }
+    return log_->base().Find(key, descriptor_pool, message_factory, arena,
+                             result);
+  }
+
+  absl::StatusOr<bool> Has(
+      const Value& key,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena) const override {
+    CEL_RETURN_IF_ERROR(CheckMapKey(key));
+    if (log_->Find(key, size_, /*result=*/nullptr)) {
+      return true;
+    }
+    Value result;
+    CEL_RETURN_IF_ERROR(log_->base().Has(key, descriptor_pool, message_factory,
+                                         arena, &result));
+    return result.IsTrue();
+  }
+
+ private:
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<InsertedMapValue>();
+  }
+
+  MapInsertionLog* absl_nonnull const log_;
+  const size_t size_;
+};
+
+const InsertedMapValue* absl_nullable AsInsertedMapValue(const MapValue& value) {
+  if (auto custom_map_value = value.AsCustom();
+      custom_map_value &&
+      custom_map_value->GetTypeId() == NativeTypeId::For<InsertedMapValue>()) {
+    return cel::internal::down_cast<const InsertedMapValue*>(
+        custom_map_value->interface());
+  }
+  return nullptr;
+}
+
 }  // namespace
 
 absl::StatusOr<const CompatMapValue* absl_nonnull> MakeCompatMapValue(
@@ -1340,6 +2390,61 @@ MutableMapValue* absl_nonnull NewMutableMapValue(
       TrivialMutableMapValueImpl(arena);
 }
 
+absl::StatusOr<MapValue> MapValueWithEntry(
+    const MapValue& map, Value key, Value value,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) {
+  CEL_RETURN_IF_ERROR(CheckMapKey(key));
+  CEL_RETURN_IF_ERROR(CheckMapValue(value));
+  if (IsMutableMapValue(map)) {
+    // Mutable maps can still change, so their entries must be copied.
+    MapValueBuilderImpl builder(arena);
+    CEL_RETURN_IF_ERROR(map.ForEach(
+        [&](const Value& entry_key,
+            const Value& entry_value) -> absl::StatusOr<bool> {
+          CEL_RETURN_IF_ERROR(builder.Put(entry_key, entry_value));
+          return true;
+        },
+        descriptor_pool, message_factory, arena));
+    CEL_RETURN_IF_ERROR(builder.Put(std::move(key), std::move(value)));
+    return std::move(builder).Build();
+  }
+  MapInsertionLog* absl_nullable log = nullptr;
+  size_t size = 0;
+  if (const InsertedMapValue* inserted = AsInsertedMapValue(map);
+      inserted != nullptr) {
+    log = inserted->log();
+    size = inserted->inserted_size();
+  }
+  const MapValue& base = log != nullptr ? log->base() : map;
+  Value has;
+  CEL_RETURN_IF_ERROR(
+      base.Has(key, descriptor_pool, message_factory, arena, &has));
+  if (ABSL_PREDICT_FALSE(has.IsTrue() ||
+                         (log != nullptr &&
+                          log->Find(key, size, /*result=*/nullptr)))) {
+    return DuplicateKeyError().ToStatus();
+  }
+  if (log == nullptr) {
+    CEL_ASSIGN_OR_RETURN(size_t base_size, map.Size());
+    log = NewMapInsertionLog(map, base_size, MapInsertionEntries(), arena);
+  }
+  if (!log->Append(size, key, value)) {
+    // A newer version of the map already appended to the log, so this version
+    // branches off with a copy of the entries it sees.
+    log = NewMapInsertionLog(log->base(), log->base_size(),
+                             log->CopyEntries(size), arena);
+    const bool appended = log->Append(size, std::move(key), std::move(value));
+    ABSL_DCHECK(appended);
+  }
+  return CustomMapValue(
+      ::new (arena->AllocateAligned(sizeof(InsertedMapValue),
+                                    alignof(InsertedMapValue)))
+          InsertedMapValue(log, size + 1),
+      arena);
+}
+
 bool IsMutableMapValue(const Value& value) {
   if (auto custom_map_value = value.AsCustomMap(); custom_map_value) {
     NativeTypeId native_type_id = custom_map_value->GetTypeId();
@@ -0,0 +1,307 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "common/values/list_value_builder.h"
+#include "common/values/map_value_builder.h"
+#include "internal/testing.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::common_internal {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::cel::test::BoolValueIs;
+using ::cel::test::ErrorValueIs;
+using ::cel::test::IntValueIs;
+using ::cel::test::ListValueElements;
+using ::cel::test::MapValueElements;
+using ::cel::test::StringValueIs;
+using ::testing::ElementsAre;
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+class ConcatListValuesTest : public ValueTest<> {
+ public:
+  ListValue MakeList(std::vector<int64_t> elements) {
+    return MakeList(std::move(elements), arena());
+  }
+
+  ListValue MakeList(std::vector<int64_t> elements,
+                     google::protobuf::Arena* absl_nonnull arena) {
+    auto builder = NewListValueBuilder(arena);
+    for (int64_t element : elements) {
+      builder->UnsafeAdd(IntValue(element));
+    }
+    return std::move(*builder).Build();
+  }
+
+  absl::StatusOr<ListValue> Concat(const ListValue& lhs, const ListValue& rhs) {
+    return Concat(lhs, rhs, arena());
+  }
+
+  absl::StatusOr<ListValue> Concat(const ListValue& lhs, const ListValue& rhs,
+                                   google::protobuf::Arena* absl_nonnull arena) {
+    return ConcatListValues(lhs, rhs, descriptor_pool(), message_factory(),
+                            arena);
+  }
+};
+
+TEST_F(ConcatListValuesTest, Shallow) {
+  ASSERT_OK_AND_ASSIGN(ListValue value,
+                       Concat(MakeList({0, 1}), MakeList({2})));
+
+  EXPECT_EQ(value.DebugString(), "[0, 1, 2]");
+  EXPECT_THAT(value.Size(), IsOkAndHolds(3));
+  EXPECT_THAT(value.Get(1, descriptor_pool(), message_factory(), arena()),
+              IsOkAndHolds(IntValueIs(1)));
+  EXPECT_THAT(value.Get(2, descriptor_pool(), message_factory(), arena()),
+              IsOkAndHolds(IntValueIs(2)));
+  EXPECT_THAT(
+      value.Get(3, descriptor_pool(), message_factory(), arena()),
+      IsOkAndHolds(ErrorValueIs(StatusIs(absl::StatusCode::kInvalidArgument))));
+  EXPECT_THAT(value.Contains(IntValue(2), descriptor_pool(), message_factory(),
+                             arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(value.Equal(MakeList({0, 1, 2}), descriptor_pool(),
+                          message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(true)));
+}
+
+TEST_F(ConcatListValuesTest, Empty) {
+  ListValue empty = MakeList({});
+  ListValue list = MakeList({0});
+
+  ASSERT_OK_AND_ASSIGN(ListValue value, Concat(empty, list));
+  EXPECT_FALSE(value.IsCustom());
+  ASSERT_OK_AND_ASSIGN(value, Concat(list, empty));
+  EXPECT_FALSE(value.IsCustom());
+  EXPECT_THAT(value, ListValueElements(ElementsAre(IntValueIs(0)),
+                                       descriptor_pool(), message_factory(),
+                                       arena()));
+}
+
+TEST_F(ConcatListValuesTest, Accumulate) {
+  // Mirrors the accumulator of `filter` and `map`, which is concatenated with
+  // a single element list on each iteration.
+  constexpr int64_t kSize = 100;
+  ListValue value;
+  for (int64_t i = 0; i < kSize; ++i) {
+    ASSERT_OK_AND_ASSIGN(value, Concat(value, MakeList({i})));
+  }
+
+  ASSERT_THAT(value.Size(), IsOkAndHolds(kSize));
+  for (int64_t i = 0; i < kSize; ++i) {
+    EXPECT_THAT(value.Get(i, descriptor_pool(), message_factory(), arena()),
+                IsOkAndHolds(IntValueIs(i)));
+  }
+  std::vector<int64_t> elements;
+  EXPECT_THAT(value.ForEach(
+                  [&](const Value& element) -> absl::StatusOr<bool> {
+                    elements.push_back(element.GetInt().NativeValue());
+                    return elements.size() < 3;
+                  },
+                  descriptor_pool(), message_factory(), arena()),
+              IsOk());
+  EXPECT_THAT(elements, ElementsAre(0, 1, 2));
+
+  auto* message = NewArenaValueMessage();
+  EXPECT_THAT(
+      value.ConvertToJson(descriptor_pool(), message_factory(), message),
+      IsOk());
+}
+
+TEST_F(ConcatListValuesTest, Clone) {
+  ASSERT_OK_AND_ASSIGN(ListValue value,
+                       Concat(MakeList({0, 1}), MakeList({2})));
+  google::protobuf::Arena other_arena;
+
+  EXPECT_THAT(value.Clone(&other_arena),
+              ListValueElements(
+                  ElementsAre(IntValueIs(0), IntValueIs(1), IntValueIs(2)),
+                  descriptor_pool(), message_factory(), arena()));
+}
+
+TEST_F(ConcatListValuesTest, CloneOutlivesOriginalArena) {
+  constexpr int64_t kSize = 10;
+  Value clone;
+  {
+    google::protobuf::Arena original_arena;
+    ListValue value;
+    for (int64_t i = 0; i < kSize; ++i) {
+      ASSERT_OK_AND_ASSIGN(value, Concat(value, MakeList({i}, &original_arena),
+                                         &original_arena));
+    }
+    clone = Value(value).Clone(arena());
+  }
+
+  EXPECT_EQ(clone.DebugString(), "[0, 1, 2, 3, 4, 5, 6, 7, 8, 9]");
+  ListValue list = clone.GetList();
+  for (int64_t i = 0; i < kSize; ++i) {
+    EXPECT_THAT(list.Get(i, descriptor_pool(), message_factory(), arena()),
+                IsOkAndHolds(IntValueIs(i)));
+  }
+}
+
+TEST_F(ConcatListValuesTest, FlattensOnCallerArena) {
+  // Deep enough to be flattened on random access.
+  constexpr int64_t kSize = 10;
+  ListValue value;
+  for (int64_t i = 0; i < kSize; ++i) {
+    ASSERT_OK_AND_ASSIGN(value, Concat(value, MakeList({i})));
+  }
+
+  for (int64_t i = 0; i < kSize; ++i) {
+    // The flattened copy made on a shorter lived arena isn't kept.
+    google::protobuf::Arena call_arena;
+    EXPECT_THAT(value.Get(i, descriptor_pool(), message_factory(), &call_arena),
+                IsOkAndHolds(IntValueIs(i)));
+  }
+  EXPECT_THAT(value.Get(3, descriptor_pool(), message_factory(), arena()),
+              IsOkAndHolds(IntValueIs(3)));
+}
+
+TEST_F(ConcatListValuesTest, MutableOperand) {
+  auto* mutable_list_value = NewMutableListValue(arena());
+  ASSERT_THAT(mutable_list_value->Append(IntValue(0)), IsOk());
+
+  ASSERT_OK_AND_ASSIGN(
+      ListValue value,
+      Concat(CustomListValue(mutable_list_value, arena()), MakeList({1})));
+  ASSERT_THAT(mutable_list_value->Append(IntValue(2)), IsOk());
+
+  EXPECT_THAT(value, ListValueElements(ElementsAre(IntValueIs(0),
+                                                   IntValueIs(1)),
+                                       descriptor_pool(), message_factory(),
+                                       arena()));
+}
+
+class MapValueWithEntryTest : public ValueTest<> {
+ public:
+  absl::StatusOr<MapValue> Insert(const MapValue& map, absl::string_view key,
+                                  int64_t value) {
+    return MapValueWithEntry(map, StringValue(key), IntValue(value),
+                             descriptor_pool(), message_factory(), arena());
+  }
+};
+
+TEST_F(MapValueWithEntryTest, Insert) {
+  auto builder = NewMapValueBuilder(arena());
+  ASSERT_THAT(builder->Put(StringValue("a"), IntValue(1)), IsOk());
+  const MapValue base = std::move(*builder).Build();
+
+  ASSERT_OK_AND_ASSIGN(MapValue value, Insert(base, "b", 2));
+
+  EXPECT_EQ(value.DebugString(), "{\"a\": 1, \"b\": 2}");
+  EXPECT_THAT(value.Size(), IsOkAndHolds(2));
+  EXPECT_THAT(value.Get(StringValue("a"), descriptor_pool(),
+                        message_factory(), arena()),
+              IsOkAndHolds(IntValueIs(1)));
+  EXPECT_THAT(value.Get(StringValue("b"), descriptor_pool(),
+                        message_factory(), arena()),
+              IsOkAndHolds(IntValueIs(2)));
+  EXPECT_THAT(value.Has(StringValue("c"), descriptor_pool(),
+                        message_factory(), arena()),
+              IsOkAndHolds(BoolValueIs(false)));
+  EXPECT_THAT(value.Has(IntValue(1), descriptor_pool(), message_factory(),
+                        arena()),
+              IsOkAndHolds(BoolValueIs(false)));
+  ASSERT_OK_AND_ASSIGN(ListValue keys, value.ListKeys(descriptor_pool(),
+                                                      message_factory(),
+                                                      arena()));
+  EXPECT_THAT(keys, ListValueElements(
+                        UnorderedElementsAre(StringValueIs("a"),
+                                             StringValueIs("b")),
+                        descriptor_pool(), message_factory(), arena()));
+  EXPECT_THAT(Insert(value, "a", 3),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+  EXPECT_THAT(Insert(value, "b", 3),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+}
+
+TEST_F(MapValueWithEntryTest, Versions) {
+  ASSERT_OK_AND_ASSIGN(MapValue first, Insert(MapValue(), "a", 1));
+  ASSERT_OK_AND_ASSIGN(MapValue second, Insert(first, "b", 2));
+  // Inserting into an older version does not affect the newer one.
+  ASSERT_OK_AND_ASSIGN(MapValue branch, Insert(first, "c", 3));
+  ASSERT_OK_AND_ASSIGN(MapValue third, Insert(second, "c", 4));
+
+  EXPECT_THAT(first, MapValueElements(
+                         ElementsAre(Pair(StringValueIs("a"), IntValueIs(1))),
+                         descriptor_pool(), message_factory(), arena()));
+  EXPECT_THAT(branch, MapValueElements(
+                          ElementsAre(Pair(StringValueIs("a"), IntValueIs(1)),
+                                      Pair(StringValueIs("c"), IntValueIs(3))),
+                          descriptor_pool(), message_factory(), arena()));
+  EXPECT_THAT(third, MapValueElements(
+                         ElementsAre(Pair(StringValueIs("a"), IntValueIs(1)),
+                                     Pair(StringValueIs("b"), IntValueIs(2)),
+                                     Pair(StringValueIs("c"), IntValueIs(4))),
+                         descriptor_pool(), message_factory(), arena()));
+  EXPECT_THAT(Insert(branch, "b", 5), IsOk());
+}
+
+TEST_F(MapValueWithEntryTest, CloneOutlivesOriginalArena) {
+  Value clone;
+  {
+    google::protobuf::Arena original_arena;
+    ASSERT_OK_AND_ASSIGN(
+        MapValue first,
+        MapValueWithEntry(MapValue(), StringValue("a"), IntValue(1),
+                          descriptor_pool(), message_factory(),
+                          &original_arena));
+    ASSERT_OK_AND_ASSIGN(
+        MapValue second,
+        MapValueWithEntry(first, StringValue("b"), IntValue(2),
+                          descriptor_pool(), message_factory(),
+                          &original_arena));
+    clone = Value(second).Clone(arena());
+  }
+
+  EXPECT_EQ(clone.DebugString(), "{\"a\": 1, \"b\": 2}");
+  EXPECT_THAT(clone.GetMap(),
+              MapValueElements(
+                  UnorderedElementsAre(Pair(StringValueIs("a"), IntValueIs(1)),
+                                       Pair(StringValueIs("b"), IntValueIs(2))),
+                  descriptor_pool(), message_factory(), arena()));
+  auto* message = NewArenaValueMessage();
+  EXPECT_THAT(
+      clone.ConvertToJson(descriptor_pool(), message_factory(), message),
+      IsOk());
+}
+
+TEST_F(MapValueWithEntryTest, InvalidEntry) {
+  EXPECT_THAT(MapValueWithEntry(MapValue(), DoubleValue(1.0), IntValue(1),
+                                descriptor_pool(), message_factory(), arena()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(MapValueWithEntry(MapValue(), StringValue("a"),
+                                ErrorValue(absl::CancelledError()),
+                                descriptor_pool(), message_factory(), arena()),
+              StatusIs(absl::StatusCode::kCancelled));
+}
+
+}  // namespace
+}  // namespace cel::common_internal
@@ -211,6 +211,39 @@ TEST(CompilerFactoryTest, GetTypeChecker) {
   EXPECT_TRUE(result.IsValid());
 }
 
+TEST(CompilerFactoryTest, CostEstimation) {
+  CompilerOptions options;
+  options.checker_options.max_estimated_cost = 100;
+
+  ASSERT_OK_AND_ASSIGN(
+      auto builder,
+      NewCompilerBuilder(cel::internal::GetSharedTestingDescriptorPool(),
+                         options));
+  ASSERT_THAT(builder->AddLibrary(StandardCompilerLibrary()), IsOk());
+  ASSERT_THAT(builder->GetCheckerBuilder().AddVariable(
+                  MakeVariableDecl("l", ListType(builder->GetCheckerBuilder()
+                                                     .arena(),
+                                                 StringType()))),
+              IsOk());
+  ASSERT_THAT(builder->GetCheckerBuilder().AddVariable(
+                  MakeVariableDecl("m", ListType(builder->GetCheckerBuilder()
+                                                     .arena(),
+                                                 StringType()))),
+              IsOk());
+  builder->GetCheckerBuilder().AddSizeHint("l", {0, 5});
+  ASSERT_OK_AND_ASSIGN(auto compiler, builder->Build());
+
+  ASSERT_OK_AND_ASSIGN(ValidationResult result,
+                       compiler->Compile("l.exists(x, x == 'a')"));
+  EXPECT_TRUE(result.IsValid());
+  ASSERT_TRUE(result.GetCostEstimate().has_value());
+  EXPECT_LE(result.GetCostEstimate()->max, 100);
+
+  ASSERT_OK_AND_ASSIGN(result, compiler->Compile("m.exists(x, x == 'a')"));
+  EXPECT_FALSE(result.IsValid());
+  EXPECT_THAT(result.FormatError(), HasSubstr("estimated cost exceeds limit"));
+}
+
 TEST(CompilerFactoryTest, DisableStandardMacros) {
   CompilerOptions options;
   options.parser_options.disable_standard_macros = true;
@@ -93,6 +93,9 @@ CelExpressionBuilderFlatImpl::CreateExpressionImpl(
 
   if (issues_ptr != nullptr) {
     for (const auto& issue : issues) {
+      if (issue.severity() == RuntimeIssue::Severity::kInformation) {
+        continue;
+      }
       warnings->push_back(issue.ToStatus());
     }
   }
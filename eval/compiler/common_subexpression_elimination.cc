@@ -0,0 +1,328 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/common_subexpression_elimination.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "common/ast.h"
+#include "common/ast_rewrite.h"
+#include "common/ast_traverse.h"
+#include "common/ast_visitor_base.h"
+#include "common/expr.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+#include "eval/compiler/resolver.h"
+#include "internal/status_macros.h"
+#include "runtime/runtime_issue.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+using ::cel::RuntimeIssue;
+
+constexpr absl::string_view kBlock = "cel.@block";
+
+// Returns the identifier a select chain is rooted at, or nullptr if the chain
+// starts with some other expression (e.g. a call).
+const cel::Expr* ChainRoot(const cel::Expr& expr) {
+  const cel::Expr* current = &expr;
+  while (current->has_select_expr()) {
+    current = &current->select_expr().operand();
+  }
+  return current->has_ident_expr() ? current : nullptr;
+}
+
+// Returns the dotted path for a select chain rooted at an identifier, e.g.
+// "a.b.c" for `a.b.c`.
+std::string ChainPath(const cel::Expr& expr) {
+  if (expr.has_select_expr()) {
+    return absl::StrCat(ChainPath(expr.select_expr().operand()), ".",
+                        expr.select_expr().field());
+  }
+  return expr.ident_expr().name();
+}
+
+// Cache key for a select node. Presence tests are distinguished from field
+// accesses on the same path.
+std::string ChainKey(const cel::Expr& expr) {
+  if (expr.select_expr().test_only()) {
+    return absl::StrCat("has(", ChainPath(expr), ")");
+  }
+  return ChainPath(expr);
+}
+
+class CandidateCollector : public cel::AstVisitorBase {
+ public:
+  void PreVisitExpr(const cel::Expr& expr) override {
+    max_id_ = std::max(max_id_, expr.id());
+  }
+
+  void PreVisitComprehension(
+      const cel::Expr& expr,
+      const cel::ComprehensionExpr& comprehension) override {
+    shadowed_.insert(comprehension.iter_var());
+    shadowed_.insert(comprehension.iter_var2());
+    shadowed_.insert(comprehension.accu_var());
+  }
+
+  void PostVisitCall(const cel::Expr& expr,
+                     const cel::CallExpr& call) override {
+    if (call.function() == kBlock) {
+      has_block_ = true;
+    }
+  }
+
+  void PostVisitSelect(const cel::Expr& expr,
+                       const cel::SelectExpr& select) override {
+    selects_.push_back(&expr);
+  }
+
+  int64_t max_id() const { return max_id_; }
+  bool has_block() const { return has_block_; }
+  const absl::flat_hash_set<std::string>& shadowed() const {
+    return shadowed_;
+  }
+  const std::vector<const cel::Expr*>& selects() const { return selects_; }
+
+ private:
+  int64_t max_id_ = 0;
+  bool has_block_ = false;
+  absl::flat_hash_set<std::string> shadowed_;
+  std::vector<const cel::Expr*> selects_;
+};
+
+// Replaces hoisted occurrences with a reference to their block binding.
+class OccurrenceRewriter : public cel::AstRewriterBase {
+ public:
+  OccurrenceRewriter(const absl::flat_hash_map<int64_t, size_t>& replacements,
+                     cel::Ast& ast, int64_t& next_id)
+      : replacements_(replacements), ast_(ast), next_id_(next_id) {}
+
+  bool PreVisitRewrite(cel::Expr& expr) override {
+    auto it = replacements_.find(expr.id());
+    if (it == replacements_.end()) {
+      return false;
+    }
+    int64_t id = next_id_++;
+    if (const cel::TypeSpec* type = ast_.GetType(expr.id()); type != nullptr) {
+      // Keep the type so checked-only optimizations still apply to the alias.
+      cel::TypeSpec copy = *type;
+      ast_.mutable_type_map()[id] = std::move(copy);
+    }
+    expr.set_id(id);
+    expr.mutable_ident_expr().set_name(absl::StrCat("@index", it->second));
+    ++replaced_;
+    return true;
+  }
+
+  int replaced() const { return replaced_; }
+
+ private:
+  const absl::flat_hash_map<int64_t, size_t>& replacements_;
+  cel::Ast& ast_;
+  int64_t& next_id_;
+  int replaced_ = 0;
+};
+
+// Whether the planner may resolve the select chain as a single qualified name
+// rather than a field access.
+bool MayResolveAsQualifiedName(const Resolver& resolver, const cel::Ast& ast,
+                               const cel::Expr& expr) {
+  if (ast.reference_map().contains(expr.id())) {
+    return true;
+  }
+  if (expr.select_expr().test_only()) {
+    return false;
+  }
+  std::string path = ChainPath(expr);
+  if (resolver.FindConstant(path, expr.id()).has_value()) {
+    return true;
+  }
+  auto type = resolver.FindType(path, expr.id());
+  return !type.ok() || type->has_value();
+}
+
+}  // namespace
+
+absl::StatusOr<int> EliminateCommonSubexpressions(const Resolver& resolver,
+                                                  cel::Ast& ast) {
+  CandidateCollector collector;
+  cel::AstTraverse(ast.root_expr(), collector);
+  if (collector.has_block() || collector.selects().empty()) {
+    return 0;
+  }
+
+  // A chain that may name a namespaced entity can't be split: hoisting its
+  // operand would turn part of the name into a variable lookup.
+  absl::flat_hash_set<const cel::Expr*> excluded;
+  for (const cel::Expr* select : collector.selects()) {
+    const cel::Expr* root = ChainRoot(*select);
+    if (root == nullptr || excluded.contains(select)) {
+      continue;
+    }
+    const std::string& name = root->ident_expr().name();
+    bool exclude = absl::StartsWith(name, "@") ||
+                   collector.shadowed().contains(name) ||
+                   MayResolveAsQualifiedName(resolver, ast, *select);
+    if (!exclude) {
+      continue;
+    }
+    for (const cel::Expr* node = select; node->has_select_expr();
+         node = &node->select_expr().operand()) {
+      excluded.insert(node);
+    }
+  }
+
+  struct Candidate {
+    int depth = 0;
+    std::vector<const cel::Expr*> occurrences;
+  };
+  absl::flat_hash_map<std::string, Candidate> candidates;
+  for (const cel::Expr* select : collector.selects()) {
+    if (ChainRoot(*select) == nullptr || excluded.contains(select)) {
+      continue;
+    }
+    Candidate& candidate = candidates[ChainKey(*select)];
+    if (candidate.occurrences.empty()) {
+      for (const cel::Expr* node = select; node->has_select_expr();
+           node = &node->select_expr().operand()) {
+        ++candidate.depth;
+      }
+    }
+    candidate.occurrences.push_back(select);
+  }
+
+  // Longest chains first: once a chain is hoisted, the occurrences of its
+  // prefixes inside it collapse into the single copy in the binding.
+  std::vector<std::pair<int, std::string>> order;
+  absl::flat_hash_map<std::string, int64_t> counts;
+  for (const auto& [key, candidate] : candidates) {
+    order.push_back({candidate.depth, key});
+    counts[key] = candidate.occurrences.size();
+  }
+  std::sort(order.begin(), order.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first != rhs.first ? lhs.first > rhs.first
+                                  : lhs.second < rhs.second;
+  });
+
+  std::vector<std::pair<int, std::string>> hoisted;
+  for (const auto& [depth, key] : order) {
+    int64_t count = counts[key];
+    if (count < 2) {
+      continue;
+    }
+    hoisted.push_back({depth, key});
+    const cel::Expr* occurrence = candidates[key].occurrences.front();
+    for (const cel::Expr* node = &occurrence->select_expr().operand();
+         node->has_select_expr(); node = &node->select_expr().operand()) {
+      if (auto it = counts.find(ChainKey(*node)); it != counts.end()) {
+        it->second -= count - 1;
+      }
+    }
+  }
+  if (hoisted.empty()) {
+    return 0;
+  }
+
+  // Bindings may only refer to earlier bindings, so shorter chains go first.
+  std::sort(hoisted.begin(), hoisted.end());
+
+  absl::flat_hash_map<int64_t, size_t> replacements;
+  std::vector<cel::Expr> bindings;
+  bindings.reserve(hoisted.size());
+  for (size_t i = 0; i < hoisted.size(); ++i) {
+    const Candidate& candidate = candidates[hoisted[i].second];
+    for (const cel::Expr* occurrence : candidate.occurrences) {
+      replacements[occurrence->id()] = i;
+    }
+    bindings.push_back(*candidate.occurrences.front());
+  }
+
+  int64_t next_id = collector.max_id();
+  for (const auto& [id, type] : ast.type_map()) {
+    next_id = std::max(next_id, id);
+  }
+  for (const auto& [id, reference] : ast.reference_map()) {
+    next_id = std::max(next_id, id);
+  }
+  ++next_id;
+
+  OccurrenceRewriter rewriter(replacements, ast, next_id);
+  for (cel::Expr& binding : bindings) {
+    cel::AstRewrite(binding.mutable_select_expr().mutable_operand(), rewriter);
+  }
+  int replaced_in_bindings = rewriter.replaced();
+  cel::AstRewrite(ast.mutable_root_expr(), rewriter);
+  int replaced = rewriter.replaced() - replaced_in_bindings;
+
+  cel::Expr block;
+  block.set_id(next_id++);
+  if (const cel::TypeSpec* type = ast.GetType(ast.root_expr().id());
+      type != nullptr) {
+    cel::TypeSpec copy = *type;
+    ast.mutable_type_map()[block.id()] = std::move(copy);
+  }
+  cel::CallExpr& call = block.mutable_call_expr();
+  call.set_function(kBlock);
+  cel::Expr& list = call.add_args();
+  list.set_id(next_id++);
+  cel::ListExpr& list_expr = list.mutable_list_expr();
+  for (cel::Expr& binding : bindings) {
+    list_expr.add_elements().set_expr(std::move(binding));
+  }
+  call.add_args() = std::move(ast.mutable_root_expr());
+  ast.mutable_root_expr() = std::move(block);
+
+  return replaced;
+}
+
+namespace {
+
+class CommonSubexpressionEliminationTransform : public AstTransform {
+ public:
+  absl::Status UpdateAst(PlannerContext& context,
+                         cel::Ast& ast) const override {
+    CEL_ASSIGN_OR_RETURN(int replaced,
+                         EliminateCommonSubexpressions(context.resolver(), ast));
+    if (replaced == 0) {
+      return absl::OkStatus();
+    }
+    return context.issue_collector().AddIssue(
+        RuntimeIssue::CreateInformation(absl::StrCat(
+            "common subexpression elimination replaced ", replaced,
+            " occurrences of repeated select expressions")));
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<AstTransform> NewCommonSubexpressionEliminationTransform() {
+  return std::make_unique<CommonSubexpressionEliminationTransform>();
+}
+
+}  // namespace google::api::expr::runtime
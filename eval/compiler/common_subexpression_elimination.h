@@ -0,0 +1,48 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_COMPILER_COMMON_SUBEXPRESSION_ELIMINATION_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_COMMON_SUBEXPRESSION_ELIMINATION_H_
+
+#include <memory>
+
+#include "absl/status/statusor.h"
+#include "common/ast.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+#include "eval/compiler/resolver.h"
+
+namespace google::api::expr::runtime {
+
+// Hoists repeated field selections (e.g. `request.auth.claims.email`) into the
+// bindings of a `cel.@block` wrapping the expression. Each occurrence is
+// replaced with an `@index<N>` reference, so the selection is evaluated lazily
+// and at most once per evaluation.
+//
+// Only select chains rooted at a variable are considered, since they can't
+// have side effects. Chains that may be resolved as a qualified name (a
+// namespaced variable, enum constant or type) and variables that are shadowed
+// by a comprehension variable anywhere in the expression are left alone.
+// Expressions that already contain a `cel.@block` are not modified.
+//
+// Returns the number of replaced occurrences.
+absl::StatusOr<int> EliminateCommonSubexpressions(const Resolver& resolver,
+                                                  cel::Ast& ast);
+
+// AstTransform applying EliminateCommonSubexpressions. The number of
+// deduplicated occurrences is reported as an informational RuntimeIssue.
+std::unique_ptr<AstTransform> NewCommonSubexpressionEliminationTransform();
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_COMMON_SUBEXPRESSION_ELIMINATION_H_
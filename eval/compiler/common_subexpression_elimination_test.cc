@@ -0,0 +1,141 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/common_subexpression_elimination.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "cel/expr/syntax.pb.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status_matchers.h"
+#include "absl/strings/string_view.h"
+#include "common/ast.h"
+#include "common/ast_proto.h"
+#include "common/expr.h"
+#include "eval/compiler/resolver.h"
+#include "eval/public/cel_function_registry.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/type_registry.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::cel::Ast;
+using ::cel::Expr;
+using ::google::api::expr::parser::Parse;
+
+class CommonSubexpressionEliminationTest : public testing::Test {
+ protected:
+  CommonSubexpressionEliminationTest()
+      : resolver_("", function_registry_.InternalGetRegistry(),
+                  type_registry_, type_registry_.GetComposedTypeProvider()) {}
+
+  std::unique_ptr<Ast> ParseOrDie(absl::string_view expression) {
+    cel::expr::ParsedExpr parsed_expr = Parse(expression).value();
+    return cel::CreateAstFromParsedExpr(parsed_expr).value();
+  }
+
+  CelFunctionRegistry function_registry_;
+  cel::TypeRegistry type_registry_;
+  Resolver resolver_;
+};
+
+TEST_F(CommonSubexpressionEliminationTest, HoistsRepeatedSelects) {
+  std::unique_ptr<Ast> ast =
+      ParseOrDie("a.b.c == 'x' || a.b.c == 'y' || a.b.d == 'z'");
+
+  EXPECT_THAT(EliminateCommonSubexpressions(resolver_, *ast), IsOkAndHolds(3));
+
+  const Expr& root = ast->root_expr();
+  ASSERT_TRUE(root.has_call_expr());
+  EXPECT_EQ(root.call_expr().function(), "cel.@block");
+  ASSERT_EQ(root.call_expr().args().size(), 2);
+
+  // a.b is shared by a.b.c and a.b.d, so it gets a binding of its own that
+  // the a.b.c binding refers to.
+  const auto& bindings = root.call_expr().args()[0].list_expr().elements();
+  ASSERT_EQ(bindings.size(), 2);
+  const Expr& a_b = bindings[0].expr();
+  EXPECT_EQ(a_b.select_expr().field(), "b");
+  EXPECT_EQ(a_b.select_expr().operand().ident_expr().name(), "a");
+  const Expr& a_b_c = bindings[1].expr();
+  EXPECT_EQ(a_b_c.select_expr().field(), "c");
+  EXPECT_EQ(a_b_c.select_expr().operand().ident_expr().name(), "@index0");
+}
+
+TEST_F(CommonSubexpressionEliminationTest, AssignsUniqueIds) {
+  std::unique_ptr<Ast> ast = ParseOrDie("a.b.c + a.b.c + a.b.d");
+
+  ASSERT_THAT(EliminateCommonSubexpressions(resolver_, *ast), IsOkAndHolds(3));
+
+  absl::flat_hash_set<int64_t> ids;
+  std::vector<const Expr*> stack = {&ast->root_expr()};
+  while (!stack.empty()) {
+    const Expr* expr = stack.back();
+    stack.pop_back();
+    EXPECT_TRUE(ids.insert(expr->id()).second) << "duplicate id " << expr->id();
+    if (expr->has_select_expr()) {
+      stack.push_back(&expr->select_expr().operand());
+    } else if (expr->has_call_expr()) {
+      for (const Expr& arg : expr->call_expr().args()) {
+        stack.push_back(&arg);
+      }
+    } else if (expr->has_list_expr()) {
+      for (const auto& element : expr->list_expr().elements()) {
+        stack.push_back(&element.expr());
+      }
+    }
+  }
+}
+
+TEST_F(CommonSubexpressionEliminationTest, DistinguishesPresenceTests) {
+  std::unique_ptr<Ast> ast = ParseOrDie("has(a.b) && a.b == 1");
+
+  // Only the operand `a` is shared, and identifiers aren't hoisted.
+  EXPECT_THAT(EliminateCommonSubexpressions(resolver_, *ast), IsOkAndHolds(0));
+  EXPECT_EQ(ast->root_expr().call_expr().function(), "_&&_");
+}
+
+TEST_F(CommonSubexpressionEliminationTest, SkipsComprehensionVariables) {
+  std::unique_ptr<Ast> ast =
+      ParseOrDie("x.y.z > 0 && [x].all(x, x.y.z > 0 && x.y.z < 10)");
+
+  EXPECT_THAT(EliminateCommonSubexpressions(resolver_, *ast), IsOkAndHolds(0));
+}
+
+TEST_F(CommonSubexpressionEliminationTest, SkipsExistingBlocks) {
+  std::unique_ptr<Ast> ast =
+      ParseOrDie("cel.@block([a.b], @index0.c == a.b.c || a.b.c == 1)");
+
+  EXPECT_THAT(EliminateCommonSubexpressions(resolver_, *ast), IsOkAndHolds(0));
+}
+
+TEST_F(CommonSubexpressionEliminationTest, DoesNotSplitQualifiedNames) {
+  std::unique_ptr<Ast> ast = ParseOrDie("pkg.var.f == 1 || pkg.var.g == 2");
+  // As annotated by the type checker for a variable named `pkg.var`.
+  for (const Expr& arg : ast->root_expr().call_expr().args()) {
+    const Expr& select = arg.call_expr().args()[0];
+    ast->mutable_reference_map()[select.select_expr().operand().id()].set_name(
+        "pkg.var");
+  }
+
+  EXPECT_THAT(EliminateCommonSubexpressions(resolver_, *ast), IsOkAndHolds(0));
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,197 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/constant_list_membership_optimization.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "base/builtins.h"
+#include "common/ast.h"
+#include "common/expr.h"
+#include "common/standard_definitions.h"
+#include "common/value.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+#include "eval/eval/constant_in_step.h"
+#include "eval/eval/evaluator_core.h"
+#include "internal/status_macros.h"
+#include "runtime/internal/convert_constant.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::Ast;
+using ::cel::CallExpr;
+using ::cel::Expr;
+using ::cel::ListExpr;
+using ::cel::ListExprElement;
+using ::cel::Reference;
+using ::cel::StandardOverloadIds;
+using ::cel::Value;
+using ::cel::runtime_internal::ConvertConstant;
+
+using ReferenceMap = absl::flat_hash_map<int64_t, Reference>;
+
+bool IsInFunction(const CallExpr& call) {
+  return call.function() == cel::builtin::kIn ||
+         call.function() == cel::builtin::kInDeprecated ||
+         call.function() == cel::builtin::kInFunction;
+}
+
+// Returns true if `expr` is `item in [c1, c2, ...]` where every element is a
+// literal.
+bool IsConstantListMembership(const Expr& expr,
+                              const ReferenceMap& reference_map) {
+  if (!expr.has_call_expr()) {
+    return false;
+  }
+  const CallExpr& call = expr.call_expr();
+  if (!IsInFunction(call) || call.has_target() || call.args().size() != 2 ||
+      !call.args()[1].has_list_expr()) {
+    return false;
+  }
+  for (const ListExprElement& element :
+       call.args()[1].list_expr().elements()) {
+    if (element.optional() || !element.has_expr() ||
+        !element.expr().has_const_expr()) {
+      return false;
+    }
+  }
+
+  // If parse-only, assume this is the standard list membership operator.
+  if (reference_map.empty()) {
+    return true;
+  }
+  auto reference = reference_map.find(expr.id());
+  return reference != reference_map.end() &&
+         reference->second.overload_id().size() == 1 &&
+         reference->second.overload_id().front() ==
+             StandardOverloadIds::kInList;
+}
+
+class ConstantListMembershipOptimization : public ProgramOptimizer {
+ public:
+  explicit ConstantListMembershipOptimization(const ReferenceMap& reference_map)
+      : reference_map_(reference_map) {}
+
+  absl::Status OnPreVisit(PlannerContext& context, const Expr& node) override {
+    return absl::OkStatus();
+  }
+
+  absl::Status OnPostVisit(PlannerContext& context, const Expr& node) override {
+    if (!IsConstantListMembership(node, reference_map_)) {
+      return absl::OkStatus();
+    }
+
+    ProgramBuilder::Subexpression* subexpression =
+        context.program_builder().GetSubexpression(&node);
+    if (subexpression == nullptr || subexpression->IsFlattened()) {
+      // Already modified, can't update further.
+      return absl::OkStatus();
+    }
+
+    CEL_ASSIGN_OR_RETURN(
+        std::shared_ptr<const ConstantListIndex> index,
+        BuildIndex(context, node.call_expr().args()[1].list_expr()));
+    if (index == nullptr) {
+      return absl::OkStatus();
+    }
+
+    const Expr& item = node.call_expr().args()[0];
+    if (subexpression->IsRecursive()) {
+      return RewriteRecursivePlan(subexpression, node, std::move(index));
+    }
+    return RewriteStackMachinePlan(context, node, item, std::move(index));
+  }
+
+ private:
+  // Returns nullptr if some element can't be indexed.
+  absl::StatusOr<std::shared_ptr<const ConstantListIndex>> BuildIndex(
+      PlannerContext& context, const ListExpr& list) const {
+    std::vector<Value> elements;
+    elements.reserve(list.elements().size());
+    for (const ListExprElement& element : list.elements()) {
+      CEL_ASSIGN_OR_RETURN(
+          Value value,
+          ConvertConstant(element.expr().const_expr(), context.MutableArena()));
+      if (!ConstantListIndex::IsIndexable(value)) {
+        return nullptr;
+      }
+      elements.push_back(std::move(value));
+    }
+
+    auto builder = cel::NewListValueBuilder(context.MutableArena());
+    builder->Reserve(elements.size());
+    for (const Value& element : elements) {
+      CEL_RETURN_IF_ERROR(builder->Add(element));
+    }
+    return std::make_shared<const ConstantListIndex>(elements,
+                                                     std::move(*builder).Build());
+  }
+
+  absl::Status RewriteRecursivePlan(
+      ProgramBuilder::Subexpression* absl_nonnull subexpression,
+      const Expr& call, std::shared_ptr<const ConstantListIndex> index) {
+    auto program = subexpression->ExtractRecursiveProgram();
+    auto deps = program.step->ExtractDependencies();
+    if (!deps.has_value() || deps->size() != 2) {
+      // Possibly already const-folded, put the plan back.
+      subexpression->set_recursive_program(std::move(program.step),
+                                           program.depth);
+      return absl::OkStatus();
+    }
+    subexpression->set_recursive_program(
+        CreateDirectConstantInStep(std::move(deps->at(0)), std::move(index),
+                                   call.id()),
+        program.depth);
+    return absl::OkStatus();
+  }
+
+  absl::Status RewriteStackMachinePlan(
+      PlannerContext& context, const Expr& call, const Expr& item,
+      std::shared_ptr<const ConstantListIndex> index) {
+    if (context.GetSubplan(item).empty()) {
+      // This subexpression was already optimized, nothing to do.
+      return absl::OkStatus();
+    }
+
+    CEL_ASSIGN_OR_RETURN(ExecutionPath new_plan, context.ExtractSubplan(item));
+    new_plan.push_back(CreateConstantInStep(std::move(index), call.id()));
+
+    return context.ReplaceSubplan(call, std::move(new_plan));
+  }
+
+  const ReferenceMap& reference_map_;
+};
+
+}  // namespace
+
+ProgramOptimizerFactory CreateConstantListMembershipExtension() {
+  return [](PlannerContext& context,
+            const Ast& ast) -> absl::StatusOr<std::unique_ptr<ProgramOptimizer>> {
+    if (!context.options().enable_heterogeneous_equality) {
+      return nullptr;
+    }
+    return std::make_unique<ConstantListMembershipOptimization>(
+        ast.reference_map());
+  };
+}
+
+}  // namespace google::api::expr::runtime
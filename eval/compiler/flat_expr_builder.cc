@@ -30,9 +30,11 @@
 
 #include "absl/algorithm/container.h"
 #include "absl/base/attributes.h"
+#include "absl/base/nullability.h"
 #include "absl/base/optimization.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/functional/any_invocable.h"
 #include "absl/log/absl_check.h"
@@ -57,10 +59,12 @@
 #include "common/constant.h"
 #include "common/expr.h"
 #include "common/kind.h"
+#include "common/native_type.h"
 #include "common/type.h"
 #include "common/value.h"
 #include "eval/compiler/flat_expr_builder_extensions.h"
 #include "eval/compiler/resolver.h"
+#include "eval/eval/compiler_constant_step.h"
 #include "eval/eval/comprehension_step.h"
 #include "eval/eval/const_value_step.h"
 #include "eval/eval/container_access_step.h"
@@ -80,13 +84,18 @@
 #include "eval/eval/shadowable_value_step.h"
 #include "eval/eval/ternary_step.h"
 #include "eval/eval/trace_step.h"
+#include "internal/casts.h"
+#include "internal/concurrent_string_pool.h"
 #include "internal/status_macros.h"
+#include "runtime/executor.h"
+#include "runtime/function_overload_reference.h"
 #include "runtime/internal/convert_constant.h"
 #include "runtime/internal/issue_collector.h"
 #include "runtime/runtime_issue.h"
 #include "runtime/runtime_options.h"
 #include "runtime/type_registry.h"
 #include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
 
 namespace google::api::expr::runtime {
 
@@ -506,10 +515,13 @@ class FlatExprVisitor : public cel::AstVisitor {
       const Resolver& resolver, const cel::RuntimeOptions& options,
       std::vector<std::unique_ptr<ProgramOptimizer>> program_optimizers,
       const absl::flat_hash_map<int64_t, cel::Reference>& reference_map,
+      const absl::flat_hash_map<int64_t, cel::TypeSpec>& type_map,
       const cel::TypeProvider& type_provider, IssueCollector& issue_collector,
       ProgramBuilder& program_builder, PlannerContext& extension_context,
-      bool enable_optional_types)
+      bool enable_optional_types,
+      std::shared_ptr<cel::Executor> parallel_executor)
       : resolver_(resolver),
+        type_map_(type_map),
         type_provider_(type_provider),
         progress_status_(absl::OkStatus()),
         resolved_select_expr_(nullptr),
@@ -518,7 +530,8 @@ class FlatExprVisitor : public cel::AstVisitor {
         issue_collector_(issue_collector),
         program_builder_(program_builder),
         extension_context_(extension_context),
-        enable_optional_types_(enable_optional_types) {
+        enable_optional_types_(enable_optional_types),
+        parallel_executor_(std::move(parallel_executor)) {
     constexpr size_t kCallHandlerSizeHint = 11;
     call_handlers_.reserve(kCallHandlerSizeHint);
     call_handlers_[cel::builtin::kIndex] = [this](const cel::Expr& expr,
@@ -941,10 +954,8 @@ class FlatExprVisitor : public cel::AstVisitor {
             "unexpected number of dependencies for select operation."));
         return;
       }
-      StringValue field = cel::StringValue(select_expr.field());
-
       SetRecursiveStep(
-          CreateDirectSelectStep(std::move(deps[0]), std::move(field),
+          CreateDirectSelectStep(std::move(deps[0]), FieldName(select_expr),
                                  select_expr.test_only(), expr.id(),
                                  options_.enable_empty_wrapper_null_unboxing,
                                  enable_optional_types_),
@@ -952,7 +963,8 @@ class FlatExprVisitor : public cel::AstVisitor {
       return;
     }
 
-    AddStep(CreateSelectStep(select_expr, expr.id(),
+    AddStep(CreateSelectStep(FieldName(select_expr), select_expr.test_only(),
+                             expr.id(),
                              options_.enable_empty_wrapper_null_unboxing,
                              enable_optional_types_));
   }
@@ -1153,6 +1165,20 @@ class FlatExprVisitor : public cel::AstVisitor {
       return;
     }
 
+    if (parallel_executor_ != nullptr &&
+        ClassifyParallelBranch(*left_expr) == ParallelBranchKind::kExpensive &&
+        ClassifyParallelBranch(*right_expr) == ParallelBranchKind::kExpensive) {
+      auto lhs = left_plan->ExtractRecursiveProgram().step;
+      auto rhs = right_plan->ExtractRecursiveProgram().step;
+      SetRecursiveStep(
+          is_or ? CreateDirectParallelOrStep(std::move(lhs), std::move(rhs),
+                                             expr->id(), parallel_executor_)
+                : CreateDirectParallelAndStep(std::move(lhs), std::move(rhs),
+                                              expr->id(), parallel_executor_),
+          max_depth + 1);
+      return;
+    }
+
     if (is_or) {
       SetRecursiveStep(
           CreateDirectOrStep(left_plan->ExtractRecursiveProgram().step,
@@ -1719,6 +1745,36 @@ class FlatExprVisitor : public cel::AstVisitor {
       // builder.
       ABSL_DCHECK(program_builder_.current() != nullptr);
       auto args = program_builder_.current()->ExtractRecursiveDependencies();
+      if (parallel_executor_ != nullptr) {
+        absl::InlinedVector<bool, 4> concurrent_args;
+        concurrent_args.reserve(num_args);
+        if (receiver_style) {
+          concurrent_args.push_back(
+              ClassifyParallelBranch(call_expr->target()) ==
+              ParallelBranchKind::kExpensive);
+        }
+        for (const cel::Expr& arg : call_expr->args()) {
+          concurrent_args.push_back(ClassifyParallelBranch(arg) ==
+                                    ParallelBranchKind::kExpensive);
+        }
+        // Only worth scheduling if at least two arguments can overlap.
+        if (absl::c_count(concurrent_args, true) >= 2) {
+          SetRecursiveStep(CreateDirectParallelFunctionStep(
+                               expr->id(), *call_expr, std::move(args),
+                               std::move(overloads), concurrent_args,
+                               parallel_executor_),
+                           *recursion_depth + 1);
+          return;
+        }
+      }
+      if (auto operand_kind = TypedBinaryOperandKind(*call_expr, overloads);
+          operand_kind.has_value()) {
+        SetRecursiveStep(CreateDirectTypedBinaryFunctionStep(
+                             expr->id(), *call_expr, std::move(args),
+                             std::move(overloads), *operand_kind),
+                         *recursion_depth + 1);
+        return;
+      }
       SetRecursiveStep(
           CreateDirectFunctionStep(expr->id(), *call_expr, std::move(args),
                                    std::move(overloads)),
@@ -1728,6 +1784,162 @@ class FlatExprVisitor : public cel::AstVisitor {
     AddStep(CreateFunctionStep(*call_expr, expr->id(), std::move(overloads)));
   }
 
+  // Returns the kind the type checker assigned to `expr` if it is one of the
+  // numeric types with typed operator fast paths.
+  absl::optional<cel::Kind> CheckedNumericKind(const cel::Expr& expr) const {
+    auto it = type_map_.find(expr.id());
+    if (it == type_map_.end() || !it->second.has_primitive()) {
+      return absl::nullopt;
+    }
+    switch (it->second.primitive()) {
+      case cel::PrimitiveType::kInt64:
+        return cel::Kind::kInt;
+      case cel::PrimitiveType::kUint64:
+        return cel::Kind::kUint;
+      case cel::PrimitiveType::kDouble:
+        return cel::Kind::kDouble;
+      default:
+        return absl::nullopt;
+    }
+  }
+
+  // Returns the operand kind if `call` is a builtin binary operator whose
+  // operands were checked to the same numeric type and the environment
+  // provides the matching overload. Otherwise, the call is dispatched as usual.
+  absl::optional<cel::Kind> TypedBinaryOperandKind(
+      const cel::CallExpr& call,
+      absl::Span<const cel::FunctionOverloadReference> overloads) const {
+    if (!options_.enable_fast_builtins || call.has_target() ||
+        call.args().size() != 2) {
+      return absl::nullopt;
+    }
+    absl::optional<cel::Kind> kind = CheckedNumericKind(call.args()[0]);
+    if (!kind.has_value() || kind != CheckedNumericKind(call.args()[1]) ||
+        !HasTypedBinaryFunctionStep(call.function(), *kind)) {
+      return absl::nullopt;
+    }
+    // Don't bypass an environment that doesn't define the operator for this
+    // type.
+    for (const cel::FunctionOverloadReference& overload : overloads) {
+      const std::vector<cel::Kind>& types = overload.descriptor.types();
+      if (types.size() == 2 && types[0] == *kind && types[1] == *kind) {
+        return kind;
+      }
+    }
+    return absl::nullopt;
+  }
+
+  // Classification of a subexpression for concurrent evaluation.
+  enum class ParallelBranchKind {
+    // Doesn't call any parallel-safe function, not worth scheduling.
+    kCheap,
+    // Calls a parallel-safe function and may be evaluated concurrently with
+    // its siblings.
+    kExpensive,
+    // Must be evaluated on the caller's frame (e.g. it declares comprehension
+    // variables).
+    kUnsafe,
+  };
+
+  ParallelBranchKind ClassifyParallelBranch(const cel::Expr& expr) {
+    if (auto it = parallel_branch_kinds_.find(&expr);
+        it != parallel_branch_kinds_.end()) {
+      return it->second;
+    }
+    ParallelBranchKind kind = ParallelBranchKind::kCheap;
+    auto merge = [&](const cel::Expr& child) {
+      kind = std::max(kind, ClassifyParallelBranch(child));
+    };
+    if (expr.has_comprehension_expr()) {
+      kind = ParallelBranchKind::kUnsafe;
+    } else if (expr.has_select_expr()) {
+      merge(expr.select_expr().operand());
+    } else if (expr.has_list_expr()) {
+      for (const auto& element : expr.list_expr().elements()) {
+        merge(element.expr());
+      }
+    } else if (expr.has_struct_expr()) {
+      for (const auto& field : expr.struct_expr().fields()) {
+        merge(field.value());
+      }
+    } else if (expr.has_map_expr()) {
+      for (const auto& entry : expr.map_expr().entries()) {
+        merge(entry.key());
+        merge(entry.value());
+      }
+    } else if (expr.has_call_expr()) {
+      const cel::CallExpr& call = expr.call_expr();
+      if (call.function() == kBlock) {
+        kind = ParallelBranchKind::kUnsafe;
+      } else {
+        if (call.has_target()) {
+          merge(call.target());
+        }
+        for (const cel::Expr& arg : call.args()) {
+          merge(arg);
+        }
+        if (kind == ParallelBranchKind::kCheap &&
+            IsParallelSafeCall(expr, call)) {
+          kind = ParallelBranchKind::kExpensive;
+        }
+      }
+    }
+    parallel_branch_kinds_[&expr] = kind;
+    return kind;
+  }
+
+  // Returns true if every overload candidate for the call was marked
+  // parallel-safe in the function registry.
+  bool IsParallelSafeCall(const cel::Expr& expr,
+                          const cel::CallExpr& call) const {
+    bool receiver_style = call.has_target();
+    size_t num_args = call.args().size() + (receiver_style ? 1 : 0);
+    if (!resolver_
+             .FindLazyOverloads(call.function(), receiver_style, num_args,
+                                expr.id())
+             .empty()) {
+      return false;
+    }
+    std::vector<cel::FunctionOverloadReference> overloads =
+        resolver_.FindOverloads(call.function(), receiver_style, num_args,
+                                expr.id());
+    return !overloads.empty() &&
+           absl::c_all_of(overloads,
+                          [](const cel::FunctionOverloadReference& overload) {
+                            return overload.parallel_safe;
+                          });
+  }
+
+  // Returns the field name of `select_expr` as a value. Names of fields of
+  // messages in the runtime's descriptor pool are interned in the runtime
+  // environment, so that programs planned from the same runtime share their
+  // storage. Other names (e.g. map keys) are unbounded and are copied per
+  // program, since interned strings are never released.
+  StringValue FieldName(const cel::SelectExpr& select_expr) {
+    const google::protobuf::Descriptor* descriptor =
+        CheckedMessageType(select_expr.operand());
+    if (descriptor == nullptr ||
+        descriptor->FindFieldByName(select_expr.field()) == nullptr) {
+      return cel::StringValue(select_expr.field());
+    }
+    cel::internal::ConcurrentStringPool& pool =
+        extension_context_.string_pool();
+    return StringValue::Wrap(pool.InternString(select_expr.field()),
+                             pool.arena());
+  }
+
+  // Returns the descriptor of the message type the type checker assigned to
+  // `expr`, if any.
+  const google::protobuf::Descriptor* absl_nullable CheckedMessageType(
+      const cel::Expr& expr) const {
+    auto it = type_map_.find(expr.id());
+    if (it == type_map_.end() || !it->second.has_message_type()) {
+      return nullptr;
+    }
+    return extension_context_.descriptor_pool()->FindMessageTypeByName(
+        it->second.message_type().type());
+  }
+
   // Add a step to the program, taking ownership. If successful, returns the
   // pointer to the step. Otherwise, returns nullptr.
   //
@@ -1943,6 +2155,7 @@ class FlatExprVisitor : public cel::AstVisitor {
                                                   const cel::CallExpr& call);
 
   const Resolver& resolver_;
+  const absl::flat_hash_map<int64_t, cel::TypeSpec>& type_map_;
   const cel::TypeProvider& type_provider_;
   absl::Status progress_status_;
   absl::flat_hash_map<std::string, CallHandler> call_handlers_;
@@ -1971,6 +2184,10 @@ class FlatExprVisitor : public cel::AstVisitor {
 
   bool enable_optional_types_;
   absl::optional<BlockInfo> block_;
+
+  std::shared_ptr<cel::Executor> parallel_executor_;
+  absl::flat_hash_map<const cel::Expr*, ParallelBranchKind>
+      parallel_branch_kinds_;
 };
 
 FlatExprVisitor::CallHandlerResult FlatExprVisitor::HandleIndex(
@@ -2150,6 +2367,16 @@ FlatExprVisitor::CallHandlerResult FlatExprVisitor::HandleHeterogeneousEquality(
           "unexpected number of args for builtin equality operator"));
       return CallHandlerResult::kIntercepted;
     }
+    absl::optional<cel::Kind> operand_kind =
+        CheckedNumericKind(call.args()[0]);
+    if (operand_kind.has_value() &&
+        operand_kind == CheckedNumericKind(call.args()[1])) {
+      SetRecursiveStep(
+          CreateDirectTypedEqualityStep(std::move(args[0]), std::move(args[1]),
+                                        inequality, *operand_kind, expr.id()),
+          *depth + 1);
+      return CallHandlerResult::kIntercepted;
+    }
     SetRecursiveStep(
         CreateDirectEqualityStep(std::move(args[0]), std::move(args[1]),
                                  inequality, expr.id()),
@@ -2534,10 +2761,52 @@ std::vector<ExecutionPathView> FlattenExpressionTable(
   return subexpression_indexes;
 }
 
+// Lowers the flattened execution path into an instruction array.
+//
+// Instructions correspond one to one with the steps in `path`, so the
+// subexpression ranges (and jump offsets) carry over unchanged.
+std::vector<LoweredExecutionPathView> LowerExpressionTable(
+    const ExecutionPath& path,
+    absl::Span<const ExecutionPathView> subexpressions,
+    LoweredExecutionPath& lowered) {
+  lowered.clear();
+  lowered.reserve(path.size());
+  for (const auto& step : path) {
+    Instruction& instruction = lowered.emplace_back();
+    instruction.step = step.get();
+    if (step->GetNativeTypeId() ==
+        cel::NativeTypeId::For<CompilerConstantStep>()) {
+      instruction.opcode = Opcode::kConstant;
+      instruction.constant =
+          &cel::internal::down_cast<const CompilerConstantStep&>(*step)
+               .value();
+    } else if (auto slot_index = GetIdentStepSlotIndex(*step);
+               slot_index.has_value()) {
+      instruction.opcode = Opcode::kSlot;
+      instruction.operand = static_cast<int32_t>(*slot_index);
+    } else if (auto jump = GetJumpStepOperands(*step); jump.has_value()) {
+      instruction.opcode = jump->conditional ? Opcode::kCondJump : Opcode::kJump;
+      instruction.jump_condition = jump->jump_condition;
+      instruction.leave_on_stack = jump->leave_on_stack;
+      instruction.operand = jump->offset;
+    }
+  }
+
+  std::vector<LoweredExecutionPathView> lowered_subexpressions;
+  lowered_subexpressions.reserve(subexpressions.size());
+  for (const ExecutionPathView& subexpression : subexpressions) {
+    const size_t offset = subexpression.data() - path.data();
+    lowered_subexpressions.push_back(
+        absl::MakeConstSpan(lowered).subspan(offset, subexpression.size()));
+  }
+  return lowered_subexpressions;
+}
+
 }  // namespace
 
 absl::StatusOr<FlatExpression> FlatExprBuilder::CreateExpressionImpl(
-    std::unique_ptr<Ast> ast, std::vector<RuntimeIssue>* issues) const {
+    std::unique_ptr<Ast> ast, std::vector<RuntimeIssue>* issues,
+    absl::Span<const ProgramOptimizerFactory> additional_optimizers) const {
   if (absl::StartsWith(container_, ".") || absl::EndsWith(container_, ".")) {
     return absl::InvalidArgumentError(
         absl::StrCat("Invalid expression container: '", container_, "'"));
@@ -2568,13 +2837,22 @@ absl::StatusOr<FlatExpression> FlatExprBuilder::CreateExpressionImpl(
       optimizers.push_back(std::move(optimizer));
     }
   }
+  for (const ProgramOptimizerFactory& optimizer_factory :
+       additional_optimizers) {
+    CEL_ASSIGN_OR_RETURN(auto optimizer,
+                         optimizer_factory(extension_context, *ast));
+    if (optimizer != nullptr) {
+      optimizers.push_back(std::move(optimizer));
+    }
+  }
 
   // These objects are expected to remain scoped to one build call -- references
   // to them shouldn't be persisted in any part of the result expression.
   FlatExprVisitor visitor(resolver, options_, std::move(optimizers),
-                          ast->reference_map(), GetTypeProvider(),
+                          ast->reference_map(), ast->type_map(),
+                          GetTypeProvider(),
                           issue_collector, program_builder, extension_context,
-                          enable_optional_types_);
+                          enable_optional_types_, parallel_executor_);
 
   cel::TraversalOptions opts;
   opts.use_comprehension_callbacks = true;
@@ -2592,6 +2870,18 @@ absl::StatusOr<FlatExpression> FlatExprBuilder::CreateExpressionImpl(
   std::vector<ExecutionPathView> subexpressions =
       FlattenExpressionTable(program_builder, execution_path);
 
+  if (options_.enable_instruction_lowering) {
+    LoweredExecutionPath lowered_path;
+    std::vector<LoweredExecutionPathView> lowered_subexpressions =
+        LowerExpressionTable(execution_path, subexpressions, lowered_path);
+    FlatExpression expression(std::move(execution_path),
+                              std::move(subexpressions), visitor.slot_count(),
+                              GetTypeProvider(), options_, std::move(arena));
+    expression.set_lowered_path(std::move(lowered_path),
+                                std::move(lowered_subexpressions));
+    return expression;
+  }
+
   return FlatExpression(std::move(execution_path), std::move(subexpressions),
                         visitor.slot_count(), GetTypeProvider(), options_,
                         std::move(arena));
@@ -26,11 +26,13 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "base/ast.h"
 #include "base/type_provider.h"
 #include "common/value.h"
 #include "eval/compiler/flat_expr_builder_extensions.h"
 #include "eval/eval/evaluator_core.h"
+#include "runtime/executor.h"
 #include "runtime/function_registry.h"
 #include "runtime/internal/runtime_env.h"
 #include "runtime/runtime_issue.h"
@@ -83,7 +85,16 @@ class FlatExprBuilder {
   // can pass ownership of a freshly converted AST.
   absl::StatusOr<FlatExpression> CreateExpressionImpl(
       std::unique_ptr<cel::Ast> ast,
-      std::vector<cel::RuntimeIssue>* issues) const;
+      std::vector<cel::RuntimeIssue>* issues) const {
+    return CreateExpressionImpl(std::move(ast), issues,
+                                /*additional_optimizers=*/{});
+  }
+
+  // Overload applying `additional_optimizers` after the configured program
+  // optimizers, for extensions that only apply to a single program.
+  absl::StatusOr<FlatExpression> CreateExpressionImpl(
+      std::unique_ptr<cel::Ast> ast, std::vector<cel::RuntimeIssue>* issues,
+      absl::Span<const ProgramOptimizerFactory> additional_optimizers) const;
 
   const cel::runtime_internal::RuntimeEnv& env() const { return *env_; }
 
@@ -95,6 +106,13 @@ class FlatExprBuilder {
 
   bool optional_types_enabled() const { return enable_optional_types_; }
 
+  // Called by `cel::extensions::EnableParallelEvaluation` to evaluate
+  // independent subexpressions calling parallel-safe functions concurrently on
+  // the given executor. Only applies to recursively planned programs.
+  void set_parallel_executor(std::shared_ptr<cel::Executor> executor) {
+    parallel_executor_ = std::move(executor);
+  }
+
  private:
   const cel::TypeProvider& GetTypeProvider() const;
 
@@ -111,6 +129,7 @@ class FlatExprBuilder {
   bool use_legacy_type_provider_;
   std::vector<std::unique_ptr<AstTransform>> ast_transforms_;
   std::vector<ProgramOptimizerFactory> program_optimizers_;
+  std::shared_ptr<cel::Executor> parallel_executor_;
 };
 
 }  // namespace google::api::expr::runtime
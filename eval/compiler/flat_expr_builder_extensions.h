@@ -46,6 +46,7 @@
 #include "eval/eval/evaluator_core.h"
 #include "eval/eval/trace_step.h"
 #include "internal/casts.h"
+#include "internal/concurrent_string_pool.h"
 #include "runtime/internal/issue_collector.h"
 #include "runtime/internal/runtime_env.h"
 #include "runtime/runtime_options.h"
@@ -399,6 +400,16 @@ class PlannerContext {
     return environment_->descriptor_pool.get();
   }
 
+  // Interning pool shared by all programs planned from the same runtime.
+  // Interned strings live as long as the runtime environment, which the
+  // planned program keeps alive, and are never released. Only intern strings
+  // from a set bounded by the runtime's configuration, e.g. names declared in
+  // the descriptor pool, never strings taken from expressions alone.
+  // Thread-safe.
+  cel::internal::ConcurrentStringPool& string_pool() const {
+    return environment_->string_pool;
+  }
+
   // Returns `true` if an arena was explicitly provided during planning.
   bool HasExplicitArena() const { return explicit_arena_; }
 
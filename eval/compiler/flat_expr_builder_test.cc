@@ -172,6 +172,62 @@ TEST(FlatExprBuilderTest, SimpleEndToEnd) {
   EXPECT_THAT(result.StringOrDie().value(), Eq("prefixtest"));
 }
 
+TEST(FlatExprBuilderTest, InternsMessageFieldNamesAcrossPrograms) {
+  auto env = NewTestingRuntimeEnv();
+  CelExpressionBuilderFlatImpl builder(env);
+  // msg.single_int64 + msg.single_int32, with `msg` checked as a
+  // TestAllTypes.
+  CheckedExpr expr1;
+  ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(R"pb(
+    type_map {
+      key: 3
+      value { message_type: "cel.expr.conformance.proto3.TestAllTypes" }
+    }
+    type_map {
+      key: 5
+      value { message_type: "cel.expr.conformance.proto3.TestAllTypes" }
+    }
+    expr {
+      id: 1
+      call_expr {
+        function: "_+_"
+        args {
+          id: 2
+          select_expr {
+            field: "single_int64"
+            operand {
+              id: 3
+              ident_expr { name: "msg" }
+            }
+          }
+        }
+        args {
+          id: 4
+          select_expr {
+            field: "single_int32"
+            operand {
+              id: 5
+              ident_expr { name: "msg" }
+            }
+          }
+        }
+      }
+    })pb",
+                                                  &expr1));
+  // Fields of unchecked operands, which may be map keys, are not interned.
+  ASSERT_OK_AND_ASSIGN(ParsedExpr expr2,
+                       parser::Parse("x.single_int64 + x.other"));
+
+  ASSERT_OK_AND_ASSIGN(auto cel_expr1, builder.CreateExpression(&expr1));
+  EXPECT_EQ(env->string_pool.size(), 2);
+  ASSERT_OK_AND_ASSIGN(auto cel_expr2, builder.CreateExpression(&expr1));
+  EXPECT_EQ(env->string_pool.size(), 2);
+  ASSERT_OK_AND_ASSIGN(
+      auto cel_expr3,
+      builder.CreateExpression(&expr2.expr(), &expr2.source_info()));
+  EXPECT_EQ(env->string_pool.size(), 2);
+}
+
 TEST(FlatExprBuilderTest, ExprUnset) {
   Expr expr;
   SourceInfo source_info;
@@ -0,0 +1,206 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/compiler/profiling.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+#include "common/ast.h"
+#include "common/expr.h"
+#include "common/value.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+#include "eval/eval/attribute_trail.h"
+#include "eval/eval/direct_expression_step.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/expression_step_base.h"
+#include "internal/status_macros.h"
+#include "runtime/evaluation_profile.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+using ::cel::EvaluationProfile;
+
+// `Arena::SpaceUsed` walks the arena's blocks, so it's only queried if
+// allocation tracking is enabled.
+uint64_t AllocatedBytes(const google::protobuf::Arena* arena,
+                        bool track_allocations) {
+  return track_allocations ? arena->SpaceUsed() : 0;
+}
+
+class ProfileEnterStep : public ExpressionStepBase {
+ public:
+  ProfileEnterStep(int64_t expr_id, size_t index,
+                   std::shared_ptr<EvaluationProfile> profile,
+                   bool track_allocations)
+      : ExpressionStepBase(expr_id, /*comes_from_ast=*/false),
+        index_(index),
+        profile_(std::move(profile)),
+        track_allocations_(track_allocations) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    profile_->Enter(index_, AllocatedBytes(frame->arena(), track_allocations_));
+    return absl::OkStatus();
+  }
+
+ private:
+  size_t index_;
+  std::shared_ptr<EvaluationProfile> profile_;
+  bool track_allocations_;
+};
+
+class ProfileExitStep : public ExpressionStepBase {
+ public:
+  ProfileExitStep(int64_t expr_id, size_t index,
+                  std::shared_ptr<EvaluationProfile> profile,
+                  bool track_allocations)
+      : ExpressionStepBase(expr_id, /*comes_from_ast=*/false),
+        index_(index),
+        profile_(std::move(profile)),
+        track_allocations_(track_allocations) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    profile_->Exit(index_, AllocatedBytes(frame->arena(), track_allocations_));
+    return absl::OkStatus();
+  }
+
+ private:
+  size_t index_;
+  std::shared_ptr<EvaluationProfile> profile_;
+  bool track_allocations_;
+};
+
+// A decorator that profiles a recursively evaluated CEL expression.
+class DirectProfileStep : public DirectExpressionStep {
+ public:
+  DirectProfileStep(std::unique_ptr<DirectExpressionStep> expression,
+                    size_t index, std::shared_ptr<EvaluationProfile> profile,
+                    bool track_allocations)
+      : DirectExpressionStep(expression->expr_id()),
+        expression_(std::move(expression)),
+        index_(index),
+        profile_(std::move(profile)),
+        track_allocations_(track_allocations) {}
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, cel::Value& result,
+                        AttributeTrail& trail) const override {
+    profile_->Enter(index_, AllocatedBytes(frame.arena(), track_allocations_));
+    absl::Status status = expression_->Evaluate(frame, result, trail);
+    profile_->Exit(index_, AllocatedBytes(frame.arena(), track_allocations_));
+    return status;
+  }
+
+  absl::optional<std::vector<const DirectExpressionStep*>> GetDependencies()
+      const override {
+    return {{expression_.get()}};
+  }
+
+  absl::optional<std::vector<std::unique_ptr<DirectExpressionStep>>>
+  ExtractDependencies() override {
+    std::vector<std::unique_ptr<DirectExpressionStep>> dependencies;
+    dependencies.push_back(std::move(expression_));
+    return dependencies;
+  }
+
+ private:
+  std::unique_ptr<DirectExpressionStep> expression_;
+  size_t index_;
+  std::shared_ptr<EvaluationProfile> profile_;
+  bool track_allocations_;
+};
+
+class ProfilingOptimizer : public ProgramOptimizer {
+ public:
+  ProfilingOptimizer(std::shared_ptr<EvaluationProfile> profile,
+                     bool track_allocations)
+      : profile_(std::move(profile)), track_allocations_(track_allocations) {}
+
+  absl::Status OnPreVisit(PlannerContext& context,
+                          const cel::Expr& node) override {
+    return absl::OkStatus();
+  }
+
+  absl::Status OnPostVisit(PlannerContext& context,
+                           const cel::Expr& node) override {
+    // Constants are cheap, and other optimizations look for them in the plan.
+    if (node.has_const_expr()) {
+      return absl::OkStatus();
+    }
+    absl::optional<size_t> index = profile_->NodeIndex(node.id());
+    ProgramBuilder::Subexpression* subexpression =
+        context.program_builder().GetSubexpression(&node);
+    if (!index.has_value() || subexpression == nullptr) {
+      return absl::OkStatus();
+    }
+
+    if (subexpression->IsRecursive()) {
+      auto program = subexpression->ExtractRecursiveProgram();
+      subexpression->set_recursive_program(
+          std::make_unique<DirectProfileStep>(std::move(program.step), *index,
+                                              profile_, track_allocations_),
+          program.depth);
+      return absl::OkStatus();
+    }
+
+    if (context.GetSubplan(node).empty()) {
+      return absl::OkStatus();
+    }
+    // Jumps are relative and stay within the subplan (or target its end), so
+    // bracketing the subplan doesn't change control flow.
+    CEL_ASSIGN_OR_RETURN(ExecutionPath subplan, context.ExtractSubplan(node));
+    ExecutionPath path;
+    path.reserve(subplan.size() + 2);
+    path.push_back(
+        std::make_unique<ProfileEnterStep>(node.id(), *index, profile_,
+                                           track_allocations_));
+    for (auto& step : subplan) {
+      path.push_back(std::move(step));
+    }
+    path.push_back(
+        std::make_unique<ProfileExitStep>(node.id(), *index, profile_,
+                                          track_allocations_));
+    return context.ReplaceSubplan(node, std::move(path));
+  }
+
+ private:
+  std::shared_ptr<EvaluationProfile> profile_;
+  bool track_allocations_;
+};
+
+}  // namespace
+
+ProgramOptimizerFactory CreateProfilingExtension(ProfileFactory factory,
+                                                 bool track_allocations) {
+  return [fac = std::move(factory), track_allocations](
+             PlannerContext&, const cel::Ast& ast)
+             -> absl::StatusOr<std::unique_ptr<ProgramOptimizer>> {
+    std::shared_ptr<EvaluationProfile> profile = fac(ast);
+    if (profile != nullptr) {
+      return std::make_unique<ProfilingOptimizer>(std::move(profile),
+                                                  track_allocations);
+    }
+    return nullptr;
+  };
+}
+
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,52 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Planner extension recording per-node evaluation cost.
+//
+// CEL users should not use this directly, see runtime/profiling.h.
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_COMPILER_PROFILING_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_COMPILER_PROFILING_H_
+
+#include <memory>
+
+#include "absl/functional/any_invocable.h"
+#include "common/ast.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+#include "runtime/evaluation_profile.h"
+
+namespace google::api::expr::runtime {
+
+// Maps the planned ast to the profile its evaluations are recorded in.
+//
+// A null profile may be returned to skip profiling the given expression.
+using ProfileFactory =
+    absl::AnyInvocable<std::shared_ptr<cel::EvaluationProfile>(
+        const cel::Ast&) const>;
+
+// Create a new profiling extension.
+//
+// Each expression node is bracketed with steps recording the wall time of its
+// evaluation, and its arena allocations if `track_allocations` is set: a pair
+// of steps around the node's subplan for the stack machine, or a decorator
+// around the node's direct step for recursive plans. Constants are not
+// profiled.
+//
+// This should be added after any other program optimizers so that their
+// rewrites are profiled rather than disabled.
+ProgramOptimizerFactory CreateProfilingExtension(ProfileFactory factory,
+                                                 bool track_allocations = false);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_COMPILER_PROFILING_H_
@@ -23,7 +23,9 @@
 
 #include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "base/builtins.h"
@@ -37,6 +39,7 @@
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 #include "eval/eval/regex_match_step.h"
+#include "eval/eval/trace_step.h"
 #include "internal/casts.h"
 #include "internal/status_macros.h"
 #include "re2/re2.h"
@@ -47,8 +50,10 @@ namespace {
 using ::cel::Ast;
 using ::cel::CallExpr;
 using ::cel::Cast;
+using ::cel::ComprehensionExpr;
 using ::cel::Expr;
 using ::cel::InstanceOf;
+using ::cel::ListExprElement;
 using ::cel::NativeTypeId;
 using ::cel::Reference;
 using ::cel::StringValue;
@@ -87,6 +92,137 @@ bool IsFunctionOverload(const Expr& expr, absl::string_view function,
   return false;
 }
 
+bool IsDisjunction(const Expr& expr) {
+  return expr.has_call_expr() &&
+         expr.call_expr().function() == cel::builtin::kOr &&
+         !expr.call_expr().has_target() && expr.call_expr().args().size() == 2;
+}
+
+// Collects the operands of the disjunction rooted at `expr` in evaluation
+// order, looking through nested disjunctions.
+void CollectDisjuncts(const Expr& expr, std::vector<const Expr*>& disjuncts) {
+  if (!IsDisjunction(expr)) {
+    disjuncts.push_back(&expr);
+    return;
+  }
+  for (const Expr& arg : expr.call_expr().args()) {
+    CollectDisjuncts(arg, disjuncts);
+  }
+}
+
+// Whether `lhs` and `rhs` are the same identifier or chain of field selections
+// on it, and hence evaluate to the same value.
+bool IsSameOperand(const Expr& lhs, const Expr& rhs) {
+  if (lhs.has_ident_expr() && rhs.has_ident_expr()) {
+    return lhs.ident_expr().name() == rhs.ident_expr().name();
+  }
+  if (lhs.has_select_expr() && rhs.has_select_expr()) {
+    const auto& lhs_select = lhs.select_expr();
+    const auto& rhs_select = rhs.select_expr();
+    return !lhs_select.test_only() && !rhs_select.test_only() &&
+           lhs_select.field() == rhs_select.field() &&
+           IsSameOperand(lhs_select.operand(), rhs_select.operand());
+  }
+  return false;
+}
+
+// Returns the identifier at the root of `expr`, if `expr` is an identifier or
+// a chain of field selections on one.
+const Expr* absl_nullable GetOperandRoot(const Expr& expr) {
+  const Expr* operand = &expr;
+  while (operand->has_select_expr() && !operand->select_expr().test_only()) {
+    operand = &operand->select_expr().operand();
+  }
+  return operand->has_ident_expr() ? operand : nullptr;
+}
+
+bool IsIdent(const Expr& expr, absl::string_view name) {
+  return expr.has_ident_expr() && expr.ident_expr().name() == name;
+}
+
+// Returns the argument of `expr` if it is a global call to `function` with a
+// single argument.
+const Expr* absl_nullable GetUnaryCallArg(const Expr& expr,
+                                          absl::string_view function) {
+  if (!expr.has_call_expr() || expr.call_expr().function() != function ||
+      expr.call_expr().has_target() || expr.call_expr().args().size() != 1) {
+    return nullptr;
+  }
+  return &expr.call_expr().args().front();
+}
+
+const Expr& GetSubject(const Expr& matches_call) {
+  const CallExpr& call_expr = matches_call.call_expr();
+  return call_expr.has_target() ? call_expr.target()
+                                : call_expr.args().front();
+}
+
+// Skips over the tracing decorators of a recursive program.
+const DirectExpressionStep* absl_nullable SkipTraceSteps(
+    const DirectExpressionStep* absl_nullable step) {
+  while (step != nullptr &&
+         step->GetNativeTypeId() == NativeTypeId::For<TraceStep>()) {
+    auto deps = step->GetDependencies();
+    step = deps.has_value() && deps->size() == 1 ? deps->front() : nullptr;
+  }
+  return step;
+}
+
+// Returns the dependency at `index` of `step`, looking through tracing
+// decorators, if `step` is the plan of `expr` and has `arity` dependencies.
+const DirectExpressionStep* absl_nullable GetDependencyPlan(
+    const DirectExpressionStep* absl_nullable step, const Expr& expr,
+    size_t arity, size_t index) {
+  step = SkipTraceSteps(step);
+  if (step == nullptr || step->expr_id() != expr.id()) {
+    return nullptr;
+  }
+  auto deps = step->GetDependencies();
+  if (!deps.has_value() || deps->size() != arity) {
+    return nullptr;
+  }
+  return (*deps)[index];
+}
+
+// Extracts the dependency at `index` of `step`, looking through tracing
+// decorators. The shape of the plan must have been checked with
+// `GetDependencyPlan`.
+std::unique_ptr<DirectExpressionStep> ExtractDependencyPlan(
+    std::unique_ptr<DirectExpressionStep> step, size_t index) {
+  while (step->GetNativeTypeId() == NativeTypeId::For<TraceStep>()) {
+    step = std::move(step->ExtractDependencies()->front());
+  }
+  return std::move(step->ExtractDependencies()->at(index));
+}
+
+// Returns the plan of the subject of the first operand of the disjunction
+// rooted at `node`, if `program` is a tree of logic steps with a regex match
+// step for that operand.
+const DirectExpressionStep* absl_nullable FindFirstSubjectPlan(
+    const DirectExpressionStep* absl_nonnull program, const Expr& node) {
+  const DirectExpressionStep* step = program;
+  const Expr* expr = &node;
+  while (true) {
+    step = SkipTraceSteps(step);
+    if (step == nullptr || step->expr_id() != expr->id()) {
+      return nullptr;
+    }
+    auto deps = step->GetDependencies();
+    if (!deps.has_value() || deps->empty()) {
+      return nullptr;
+    }
+    if (!IsDisjunction(*expr)) {
+      // The regex match step, whose only dependency is the subject.
+      return deps->size() == 1 ? deps->front() : nullptr;
+    }
+    if (deps->size() != 2) {
+      return nullptr;
+    }
+    step = deps->front();
+    expr = &expr->call_expr().args().front();
+  }
+}
+
 // Abstraction for deduplicating regular expressions over the course of a single
 // create expression call. Should not be used during evaluation. Uses
 // std::shared_ptr and std::weak_ptr.
@@ -129,10 +265,25 @@ class RegexPrecompilationOptimization : public ProgramOptimizer {
         regex_program_builder_(regex_max_program_size) {}
 
   absl::Status OnPreVisit(PlannerContext& context, const Expr& node) override {
+    if (IsDisjunction(node) && !nested_disjunctions_.contains(&node)) {
+      // Only the outermost disjunction is rewritten, so that a chain of `||`
+      // is matched with a single set regardless of how it is nested.
+      MarkNestedDisjunctions(node);
+    }
     return absl::OkStatus();
   }
 
   absl::Status OnPostVisit(PlannerContext& context, const Expr& node) override {
+    if (IsDisjunction(node)) {
+      if (nested_disjunctions_.contains(&node)) {
+        return absl::OkStatus();
+      }
+      return RewriteDisjunction(context, node);
+    }
+    if (node.has_comprehension_expr()) {
+      return RewriteExists(context, node);
+    }
+
     // Check that this is the correct matches overload instead of a user defined
     // overload.
     if (!IsFunctionOverload(node, cel::builtin::kRegexMatch, "matches_string",
@@ -163,14 +314,280 @@ class RegexPrecompilationOptimization : public ProgramOptimizer {
       return absl::OkStatus();
     }
 
-    const Expr& subject_expr =
-        call_expr.has_target() ? call_expr.target() : call_expr.args().front();
-
-    return RewritePlan(context, subexpression, node, subject_expr,
-                       std::move(regex_program));
+    CEL_ASSIGN_OR_RETURN(bool rewritten,
+                         RewritePlan(context, subexpression, node,
+                                     GetSubject(node), regex_program));
+    if (rewritten) {
+      precompiled_calls_[&node] = std::move(regex_program);
+    }
+    return absl::OkStatus();
   }
 
  private:
+  void MarkNestedDisjunctions(const Expr& node) {
+    for (const Expr& arg : node.call_expr().args()) {
+      if (IsDisjunction(arg)) {
+        nested_disjunctions_.insert(&arg);
+        MarkNestedDisjunctions(arg);
+      }
+    }
+  }
+
+  // Replaces a disjunction of precompiled `matches` calls on the same subject
+  // by a single pass of an `RE2::Set` over the subject. The individual calls
+  // have already been checked and rewritten when they were visited, so any
+  // invalid pattern has been reported and the plan is left as is whenever
+  // the disjunction does not qualify.
+  absl::Status RewriteDisjunction(PlannerContext& context, const Expr& node) {
+    std::vector<const Expr*> disjuncts;
+    CollectDisjuncts(node, disjuncts);
+
+    std::vector<std::shared_ptr<const RE2>> programs;
+    programs.reserve(disjuncts.size());
+    for (const Expr* disjunct : disjuncts) {
+      auto precompiled = precompiled_calls_.find(disjunct);
+      if (precompiled == precompiled_calls_.end() ||
+          !IsSameOperand(GetSubject(*disjunct),
+                         GetSubject(*disjuncts.front()))) {
+        return absl::OkStatus();
+      }
+      programs.push_back(precompiled->second);
+    }
+
+    ProgramBuilder::Subexpression* subexpression =
+        context.program_builder().GetSubexpression(&node);
+    if (subexpression == nullptr || subexpression->IsFlattened()) {
+      return absl::OkStatus();
+    }
+
+    absl::StatusOr<std::shared_ptr<const RegexSet>> regex_set =
+        CompileRegexSet(std::move(programs));
+    if (!regex_set.ok()) {
+      // Too large to combine, keep matching the patterns individually.
+      return absl::OkStatus();
+    }
+
+    if (subexpression->IsRecursive()) {
+      RewriteRecursiveDisjunction(subexpression, node, *std::move(regex_set));
+      return absl::OkStatus();
+    }
+    return RewriteStackMachineDisjunction(context, node, *disjuncts.front(),
+                                          *std::move(regex_set));
+  }
+
+  // Returns the `matches` call of `[p1, ..., pN].exists(p, s.matches(p))`,
+  // where the patterns are string literals and the subject `s` does not refer
+  // to the variables of the comprehension.
+  const Expr* absl_nullable GetExistsMatchesCall(const Expr& node) const {
+    const ComprehensionExpr& comprehension = node.comprehension_expr();
+    const std::string& iter_var = comprehension.iter_var();
+    const std::string& accu_var = comprehension.accu_var();
+    if (!comprehension.iter_var2().empty() ||
+        !comprehension.iter_range().has_list_expr() ||
+        comprehension.iter_range().list_expr().elements().empty()) {
+      return nullptr;
+    }
+    for (const ListExprElement& element :
+         comprehension.iter_range().list_expr().elements()) {
+      if (element.optional() || !element.expr().has_const_expr() ||
+          !element.expr().const_expr().has_string_value()) {
+        return nullptr;
+      }
+    }
+
+    // The expansion of the `exists` macro.
+    const Expr& init = comprehension.accu_init();
+    if (!init.has_const_expr() || !init.const_expr().has_bool_value() ||
+        init.const_expr().bool_value() ||
+        !IsIdent(comprehension.result(), accu_var)) {
+      return nullptr;
+    }
+    const Expr* condition = GetUnaryCallArg(comprehension.loop_condition(),
+                                            cel::builtin::kNotStrictlyFalse);
+    if (condition == nullptr) {
+      condition = GetUnaryCallArg(comprehension.loop_condition(),
+                                  cel::builtin::kNotStrictlyFalseDeprecated);
+    }
+    if (condition == nullptr) {
+      return nullptr;
+    }
+    condition = GetUnaryCallArg(*condition, cel::builtin::kNot);
+    if (condition == nullptr || !IsIdent(*condition, accu_var)) {
+      return nullptr;
+    }
+    const Expr& loop_step = comprehension.loop_step();
+    if (!IsDisjunction(loop_step) ||
+        !IsIdent(loop_step.call_expr().args()[0], accu_var)) {
+      return nullptr;
+    }
+
+    const Expr& call = loop_step.call_expr().args()[1];
+    if (!IsFunctionOverload(call, cel::builtin::kRegexMatch, "matches_string",
+                            2, reference_map_) ||
+        !IsIdent(call.call_expr().args().back(), iter_var)) {
+      return nullptr;
+    }
+    const Expr* root = GetOperandRoot(GetSubject(call));
+    if (root == nullptr || IsIdent(*root, iter_var) ||
+        IsIdent(*root, accu_var)) {
+      return nullptr;
+    }
+    return &call;
+  }
+
+  // Replaces `[p1, ..., pN].exists(p, s.matches(p))` by a single pass of an
+  // `RE2::Set` over `s`. Like for constant `matches` calls, invalid patterns
+  // are reported whether or not the plan can be updated.
+  //
+  // The rewrite drops the comprehension, so it is skipped when iterating over
+  // the patterns may exceed `comprehension_max_iterations`.
+  absl::Status RewriteExists(PlannerContext& context, const Expr& node) {
+    const Expr* call = GetExistsMatchesCall(node);
+    if (call == nullptr) {
+      return absl::OkStatus();
+    }
+
+    const auto& elements =
+        node.comprehension_expr().iter_range().list_expr().elements();
+    std::vector<std::shared_ptr<const RE2>> programs;
+    for (const ListExprElement& element : elements) {
+      CEL_ASSIGN_OR_RETURN(programs.emplace_back(),
+                           regex_program_builder_.BuildRegexProgram(
+                               element.expr().const_expr().string_value()));
+    }
+
+    const int max_iterations = context.options().comprehension_max_iterations;
+    if (max_iterations > 0 &&
+        elements.size() > static_cast<size_t>(max_iterations)) {
+      return absl::OkStatus();
+    }
+
+    ProgramBuilder::Subexpression* subexpression =
+        context.program_builder().GetSubexpression(&node);
+    if (subexpression == nullptr || subexpression->IsFlattened()) {
+      return absl::OkStatus();
+    }
+
+    absl::StatusOr<std::shared_ptr<const RegexSet>> regex_set =
+        CompileRegexSet(std::move(programs));
+    if (!regex_set.ok()) {
+      // Too large to combine, keep iterating over the patterns.
+      return absl::OkStatus();
+    }
+
+    if (subexpression->IsRecursive()) {
+      RewriteRecursiveExists(subexpression, node, *call,
+                             *std::move(regex_set));
+      return absl::OkStatus();
+    }
+    return RewriteStackMachineExists(context, node, *call,
+                                     *std::move(regex_set));
+  }
+
+  void RewriteRecursiveExists(
+      ProgramBuilder::Subexpression* absl_nonnull subexpression,
+      const Expr& node, const Expr& call,
+      std::shared_ptr<const RegexSet> regex_set) {
+    // The comprehension plan depends on the range, the initial accumulator,
+    // the loop step, the condition and the result, in that order.
+    const DirectExpressionStep* loop_step_plan = GetDependencyPlan(
+        subexpression->recursive_program().step.get(), node, 5, 2);
+    const DirectExpressionStep* call_plan = GetDependencyPlan(
+        loop_step_plan, node.comprehension_expr().loop_step(), 2, 1);
+    if (GetDependencyPlan(call_plan, call, 2, 0) == nullptr) {
+      return;
+    }
+    auto program = subexpression->ExtractRecursiveProgram();
+    std::unique_ptr<DirectExpressionStep> subject = ExtractDependencyPlan(
+        ExtractDependencyPlan(
+            ExtractDependencyPlan(std::move(program.step), 2), 1),
+        0);
+    subexpression->set_recursive_program(
+        CreateDirectRegexSetMatchStep(node.id(), std::move(subject),
+                                      std::move(regex_set)),
+        program.depth);
+  }
+
+  absl::Status RewriteStackMachineExists(
+      PlannerContext& context, const Expr& node, const Expr& call,
+      std::shared_ptr<const RegexSet> regex_set) {
+    // The subject must still be planned on its own, rather than as part of a
+    // recursive program for the loop step.
+    for (const Expr* expr : {&node.comprehension_expr().loop_step(), &call}) {
+      ProgramBuilder::Subexpression* subexpression =
+          context.program_builder().GetSubexpression(expr);
+      if (subexpression == nullptr || subexpression->IsFlattened() ||
+          subexpression->IsRecursive()) {
+        return absl::OkStatus();
+      }
+    }
+    const Expr& subject = GetSubject(call);
+    if (context.GetSubplan(subject).empty()) {
+      return absl::OkStatus();
+    }
+
+    CEL_ASSIGN_OR_RETURN(ExecutionPath new_plan,
+                         context.ExtractSubplan(subject));
+    CEL_ASSIGN_OR_RETURN(new_plan.emplace_back(),
+                         CreateRegexSetMatchStep(std::move(regex_set),
+                                                 node.id()));
+
+    return context.ReplaceSubplan(node, std::move(new_plan));
+  }
+
+  void RewriteRecursiveDisjunction(
+      ProgramBuilder::Subexpression* absl_nonnull subexpression,
+      const Expr& node, std::shared_ptr<const RegexSet> regex_set) {
+    if (FindFirstSubjectPlan(subexpression->recursive_program().step.get(),
+                             node) == nullptr) {
+      return;
+    }
+    // The shape of the plan was checked above, extract the subject along the
+    // same path.
+    auto program = subexpression->ExtractRecursiveProgram();
+    std::unique_ptr<DirectExpressionStep> step = std::move(program.step);
+    const Expr* expr = &node;
+    while (true) {
+      while (step->GetNativeTypeId() == NativeTypeId::For<TraceStep>()) {
+        step = std::move(step->ExtractDependencies()->front());
+      }
+      step = std::move(step->ExtractDependencies()->front());
+      if (!IsDisjunction(*expr)) {
+        break;
+      }
+      expr = &expr->call_expr().args().front();
+    }
+    subexpression->set_recursive_program(
+        CreateDirectRegexSetMatchStep(node.id(), std::move(step),
+                                      std::move(regex_set)),
+        program.depth);
+  }
+
+  absl::Status RewriteStackMachineDisjunction(
+      PlannerContext& context, const Expr& node, const Expr& first_call,
+      std::shared_ptr<const RegexSet> regex_set) {
+    // The first call was rewritten to evaluate its subject followed by a regex
+    // match step, reuse the former.
+    ProgramBuilder::Subexpression* first_subexpression =
+        context.program_builder().GetSubexpression(&first_call);
+    if (first_subexpression == nullptr ||
+        !first_subexpression->IsFlattened() ||
+        first_subexpression->flattened_elements().empty() ||
+        first_subexpression->flattened_elements().back()->id() !=
+            first_call.id()) {
+      return absl::OkStatus();
+    }
+
+    CEL_ASSIGN_OR_RETURN(ExecutionPath new_plan,
+                         context.ExtractSubplan(first_call));
+    new_plan.pop_back();
+    CEL_ASSIGN_OR_RETURN(new_plan.emplace_back(),
+                         CreateRegexSetMatchStep(std::move(regex_set),
+                                                 node.id()));
+
+    return context.ReplaceSubplan(node, std::move(new_plan));
+  }
+
   absl::optional<std::string> GetConstantString(
       PlannerContext& context,
       ProgramBuilder::Subexpression* absl_nullable subexpression,
@@ -212,7 +629,8 @@ class RegexPrecompilationOptimization : public ProgramOptimizer {
     return absl::nullopt;
   }
 
-  absl::Status RewritePlan(
+  // Returns whether the plan was rewritten.
+  absl::StatusOr<bool> RewritePlan(
       PlannerContext& context,
       ProgramBuilder::Subexpression* absl_nonnull subexpression,
       const Expr& call, const Expr& subject,
@@ -225,7 +643,7 @@ class RegexPrecompilationOptimization : public ProgramOptimizer {
                                    std::move(regex_program));
   }
 
-  absl::Status RewriteRecursivePlan(
+  bool RewriteRecursivePlan(
       ProgramBuilder::Subexpression* absl_nonnull subexpression,
       const Expr& call, const Expr& subject,
       std::shared_ptr<const RE2> regex_program) {
@@ -235,21 +653,21 @@ class RegexPrecompilationOptimization : public ProgramOptimizer {
       // Possibly already const-folded, put the plan back.
       subexpression->set_recursive_program(std::move(program.step),
                                            program.depth);
-      return absl::OkStatus();
+      return false;
     }
     subexpression->set_recursive_program(
         CreateDirectRegexMatchStep(call.id(), std::move(deps->at(0)),
                                    std::move(regex_program)),
         program.depth);
-    return absl::OkStatus();
+    return true;
   }
 
-  absl::Status RewriteStackMachinePlan(
+  absl::StatusOr<bool> RewriteStackMachinePlan(
       PlannerContext& context, const Expr& call, const Expr& subject,
       std::shared_ptr<const RE2> regex_program) {
     if (context.GetSubplan(subject).empty()) {
       // This subexpression was already optimized, nothing to do.
-      return absl::OkStatus();
+      return false;
     }
 
     CEL_ASSIGN_OR_RETURN(ExecutionPath new_plan,
@@ -258,11 +676,17 @@ class RegexPrecompilationOptimization : public ProgramOptimizer {
         new_plan.emplace_back(),
         CreateRegexMatchStep(std::move(regex_program), call.id()));
 
-    return context.ReplaceSubplan(call, std::move(new_plan));
+    CEL_RETURN_IF_ERROR(context.ReplaceSubplan(call, std::move(new_plan)));
+    return true;
   }
 
   const ReferenceMap& reference_map_;
   RegexProgramBuilder regex_program_builder_;
+  // `matches` calls rewritten to use a precompiled program.
+  absl::flat_hash_map<const Expr*, std::shared_ptr<const RE2>>
+      precompiled_calls_;
+  // Disjunctions which are operands of another disjunction.
+  absl::flat_hash_set<const Expr*> nested_disjunctions_;
 };
 
 }  // namespace
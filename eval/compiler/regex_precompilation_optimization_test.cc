@@ -49,12 +49,15 @@
 namespace google::api::expr::runtime {
 namespace {
 
+using ::absl_testing::StatusIs;
 using ::cel::RuntimeIssue;
 using ::cel::runtime_internal::IssueCollector;
 using ::cel::runtime_internal::NewTestingRuntimeEnv;
 using ::cel::runtime_internal::RuntimeEnv;
 using ::google::api::expr::parser::Parse;
+using ::testing::Contains;
 using ::testing::ElementsAre;
+using ::testing::HasSubstr;
 
 namespace exprpb = cel::expr;
 
@@ -214,6 +217,171 @@ TEST_P(RegexPrecompilationExtensionTest, DoesNotOptimizeCompoundExpr) {
   EXPECT_THAT(string_values_, ElementsAre("input123", "abc", "def", "abcdef"));
 }
 
+TEST_P(RegexPrecompilationExtensionTest, CombinesDisjunctionOfMatches) {
+  builder_.flat_expr_builder().AddProgramOptimizer(
+      CreateRegexPrecompilationExtension(options_.regex_max_program_size));
+
+  ASSERT_OK_AND_ASSIGN(
+      exprpb::ParsedExpr expr,
+      Parse("input.matches('^a') || input.matches('[0-9]$') || "
+            "input.matches('xyz')"));
+
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CelExpression> plan,
+      builder_.CreateExpression(&expr.expr(), &expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  activation.InsertValue("input", CelValue::CreateStringView("input123"));
+
+  // The subject is evaluated once for all of the patterns.
+  ASSERT_OK_AND_ASSIGN(CelValue result,
+                       plan->Trace(activation, &arena, RecordStringValues()));
+  EXPECT_THAT(string_values_, ElementsAre("input123"));
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_TRUE(result.BoolOrDie());
+
+  activation.RemoveValueEntry("input");
+  activation.InsertValue("input", CelValue::CreateStringView("input"));
+  ASSERT_OK_AND_ASSIGN(result, plan->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_FALSE(result.BoolOrDie());
+
+  activation.RemoveValueEntry("input");
+  activation.InsertValue("input", CelValue::CreateStringView("axyz"));
+  ASSERT_OK_AND_ASSIGN(result, plan->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_TRUE(result.BoolOrDie());
+}
+
+TEST_P(RegexPrecompilationExtensionTest, DoesNotCombineDifferentSubjects) {
+  builder_.flat_expr_builder().AddProgramOptimizer(
+      CreateRegexPrecompilationExtension(options_.regex_max_program_size));
+
+  ASSERT_OK_AND_ASSIGN(exprpb::ParsedExpr expr,
+                       Parse("input.matches('^a') || other.matches('^o')"));
+
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CelExpression> plan,
+      builder_.CreateExpression(&expr.expr(), &expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  activation.InsertValue("input", CelValue::CreateStringView("input123"));
+  activation.InsertValue("other", CelValue::CreateStringView("other"));
+
+  ASSERT_OK_AND_ASSIGN(CelValue result,
+                       plan->Trace(activation, &arena, RecordStringValues()));
+  EXPECT_THAT(string_values_, ElementsAre("input123", "other"));
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_TRUE(result.BoolOrDie());
+}
+
+TEST_P(RegexPrecompilationExtensionTest, InvalidPatternInDisjunction) {
+  builder_.flat_expr_builder().AddProgramOptimizer(
+      CreateRegexPrecompilationExtension(options_.regex_max_program_size));
+
+  ASSERT_OK_AND_ASSIGN(exprpb::ParsedExpr expr,
+                       Parse("input.matches('^a') || input.matches('(')"));
+
+  EXPECT_THAT(builder_.CreateExpression(&expr.expr(), &expr.source_info()),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("unsupported RE2 pattern")));
+}
+
+TEST_P(RegexPrecompilationExtensionTest, CombinesExistsOverPatterns) {
+  builder_.flat_expr_builder().AddProgramOptimizer(
+      CreateRegexPrecompilationExtension(options_.regex_max_program_size));
+
+  ASSERT_OK_AND_ASSIGN(
+      exprpb::ParsedExpr expr,
+      Parse("['^a', '[0-9]$', 'xyz'].exists(p, input.matches(p))"));
+
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CelExpression> plan,
+      builder_.CreateExpression(&expr.expr(), &expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  activation.InsertValue("input", CelValue::CreateStringView("input123"));
+
+  // Neither the patterns nor the loop variable are evaluated.
+  ASSERT_OK_AND_ASSIGN(CelValue result,
+                       plan->Trace(activation, &arena, RecordStringValues()));
+  EXPECT_THAT(string_values_, ElementsAre("input123"));
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_TRUE(result.BoolOrDie());
+
+  activation.RemoveValueEntry("input");
+  activation.InsertValue("input", CelValue::CreateStringView("input"));
+  ASSERT_OK_AND_ASSIGN(result, plan->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_FALSE(result.BoolOrDie());
+
+  activation.RemoveValueEntry("input");
+  activation.InsertValue("input", CelValue::CreateStringView("axyz"));
+  ASSERT_OK_AND_ASSIGN(result, plan->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_TRUE(result.BoolOrDie());
+}
+
+TEST_P(RegexPrecompilationExtensionTest,
+       DoesNotCombineExistsOverLoopVariableSubject) {
+  builder_.flat_expr_builder().AddProgramOptimizer(
+      CreateRegexPrecompilationExtension(options_.regex_max_program_size));
+
+  ASSERT_OK_AND_ASSIGN(exprpb::ParsedExpr expr,
+                       Parse("['^a', 'b'].exists(p, p.matches(p))"));
+
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CelExpression> plan,
+      builder_.CreateExpression(&expr.expr(), &expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  ASSERT_OK_AND_ASSIGN(CelValue result,
+                       plan->Trace(activation, &arena, RecordStringValues()));
+  EXPECT_THAT(string_values_, Contains("b"));
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_TRUE(result.BoolOrDie());
+}
+
+TEST_P(RegexPrecompilationExtensionTest,
+       DoesNotCombineExistsBeyondIterationBudget) {
+  cel::RuntimeOptions runtime_options = runtime_options_;
+  runtime_options.comprehension_max_iterations = 2;
+  CelExpressionBuilderFlatImpl builder(env_, runtime_options);
+  builder.flat_expr_builder().AddProgramOptimizer(
+      CreateRegexPrecompilationExtension(options_.regex_max_program_size));
+
+  ASSERT_OK_AND_ASSIGN(
+      exprpb::ParsedExpr expr,
+      Parse("['^a', '[0-9]$', 'xyz'].exists(p, input.matches(p))"));
+
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CelExpression> plan,
+      builder.CreateExpression(&expr.expr(), &expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  activation.InsertValue("input", CelValue::CreateStringView("input"));
+  EXPECT_THAT(plan->Evaluate(activation, &arena),
+              StatusIs(absl::StatusCode::kInternal,
+                       HasSubstr("Iteration budget exceeded")));
+}
+
+TEST_P(RegexPrecompilationExtensionTest, InvalidPatternInExists) {
+  builder_.flat_expr_builder().AddProgramOptimizer(
+      CreateRegexPrecompilationExtension(options_.regex_max_program_size));
+
+  ASSERT_OK_AND_ASSIGN(exprpb::ParsedExpr expr,
+                       Parse("['^a', '('].exists(p, input.matches(p))"));
+
+  EXPECT_THAT(builder_.CreateExpression(&expr.expr(), &expr.source_info()),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("unsupported RE2 pattern")));
+}
+
 class RegexConstFoldInteropTest : public RegexPrecompilationExtensionTest {
  public:
   RegexConstFoldInteropTest() : RegexPrecompilationExtensionTest() {
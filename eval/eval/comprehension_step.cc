@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/base/casts.h"
@@ -12,6 +13,7 @@
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
 #include "base/attribute.h"
 #include "common/casting.h"
 #include "common/value.h"
@@ -104,6 +106,25 @@ class ComprehensionDirectStep final : public DirectExpressionStep {
                                      : Evaluate2(frame, result, trail);
   }
 
+  absl::optional<std::vector<const DirectExpressionStep*>> GetDependencies()
+      const override {
+    return std::vector<const DirectExpressionStep*>{
+        range_.get(), accu_init_.get(), loop_step_.get(), condition_.get(),
+        result_step_.get()};
+  }
+
+  absl::optional<std::vector<std::unique_ptr<DirectExpressionStep>>>
+  ExtractDependencies() override {
+    std::vector<std::unique_ptr<DirectExpressionStep>> dependencies;
+    dependencies.reserve(5);
+    dependencies.push_back(std::move(range_));
+    dependencies.push_back(std::move(accu_init_));
+    dependencies.push_back(std::move(loop_step_));
+    dependencies.push_back(std::move(condition_));
+    dependencies.push_back(std::move(result_step_));
+    return dependencies;
+  }
+
  private:
   absl::Status Evaluate1(ExecutionFrameBase& frame, Value& result,
                          AttributeTrail& trail) const;
@@ -128,11 +149,11 @@ class ComprehensionDirectStep final : public DirectExpressionStep {
   const size_t iter_slot_;
   const size_t iter2_slot_;
   const size_t accu_slot_;
-  const std::unique_ptr<DirectExpressionStep> range_;
-  const std::unique_ptr<DirectExpressionStep> accu_init_;
-  const std::unique_ptr<DirectExpressionStep> loop_step_;
-  const std::unique_ptr<DirectExpressionStep> condition_;
-  const std::unique_ptr<DirectExpressionStep> result_step_;
+  std::unique_ptr<DirectExpressionStep> range_;
+  std::unique_ptr<DirectExpressionStep> accu_init_;
+  std::unique_ptr<DirectExpressionStep> loop_step_;
+  std::unique_ptr<DirectExpressionStep> condition_;
+  std::unique_ptr<DirectExpressionStep> result_step_;
   const bool shortcircuiting_;
 };
 
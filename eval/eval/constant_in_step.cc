@@ -0,0 +1,228 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/constant_in_step.h"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "eval/eval/attribute_trail.h"
+#include "eval/eval/direct_expression_step.h"
+#include "eval/eval/evaluator_core.h"
+#include "eval/eval/expression_step_base.h"
+#include "internal/number.h"
+#include "internal/status_macros.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+using ::cel::BoolValue;
+using ::cel::Value;
+using ::cel::ValueKind;
+using ::cel::internal::Number;
+
+Number ToNumber(const Value& value) {
+  switch (value.kind()) {
+    case ValueKind::kInt:
+      return Number::FromInt64(value.GetInt().NativeValue());
+    case ValueKind::kUint:
+      return Number::FromUint64(value.GetUint().NativeValue());
+    default:
+      return Number::FromDouble(value.GetDouble().NativeValue());
+  }
+}
+
+// Same result as EvaluateIn for a constant list container, which is never an
+// error or unknown.
+absl::StatusOr<Value> EvaluateConstantIn(ExecutionFrameBase& frame,
+                                         const Value& item,
+                                         const AttributeTrail& item_attr,
+                                         const ConstantListIndex& index) {
+  if (item.IsError()) {
+    return item;
+  }
+
+  if (frame.unknown_processing_enabled()) {
+    auto accu = frame.attribute_utility().CreateAccumulator();
+    accu.MaybeAdd(item, item_attr);
+    if (!accu.IsEmpty()) {
+      return std::move(accu).Build();
+    }
+  }
+
+  if (absl::optional<bool> found = index.Contains(item); found.has_value()) {
+    return BoolValue(*found);
+  }
+  return index.list().Contains(item, frame.descriptor_pool(),
+                               frame.message_factory(), frame.arena());
+}
+
+class DirectConstantInStep final : public DirectExpressionStep {
+ public:
+  DirectConstantInStep(std::unique_ptr<DirectExpressionStep> item,
+                       std::shared_ptr<const ConstantListIndex> index,
+                       int64_t expr_id)
+      : DirectExpressionStep(expr_id),
+        item_(std::move(item)),
+        index_(std::move(index)) {}
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
+                        AttributeTrail& attribute_trail) const override {
+    AttributeTrail item_attr;
+    CEL_RETURN_IF_ERROR(item_->Evaluate(frame, result, item_attr));
+    CEL_ASSIGN_OR_RETURN(result,
+                         EvaluateConstantIn(frame, result, item_attr, *index_));
+    return absl::OkStatus();
+  }
+
+ private:
+  std::unique_ptr<DirectExpressionStep> item_;
+  std::shared_ptr<const ConstantListIndex> index_;
+};
+
+class ConstantInStep final : public ExpressionStepBase {
+ public:
+  ConstantInStep(std::shared_ptr<const ConstantListIndex> index,
+                 int64_t expr_id)
+      : ExpressionStepBase(expr_id, /*comes_from_ast=*/true),
+        index_(std::move(index)) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    if (!frame->value_stack().HasEnough(1)) {
+      return absl::Status(absl::StatusCode::kInternal, "Value stack underflow");
+    }
+
+    CEL_ASSIGN_OR_RETURN(
+        Value result,
+        EvaluateConstantIn(*frame, frame->value_stack().Peek(),
+                           frame->value_stack().PeekAttribute(), *index_));
+    frame->value_stack().PopAndPush(1, std::move(result));
+    return absl::OkStatus();
+  }
+
+ private:
+  std::shared_ptr<const ConstantListIndex> index_;
+};
+
+}  // namespace
+
+bool ConstantListIndex::IsIndexable(const Value& value) {
+  switch (value.kind()) {
+    case ValueKind::kNull:
+    case ValueKind::kBool:
+    case ValueKind::kInt:
+    case ValueKind::kUint:
+    case ValueKind::kDouble:
+    case ValueKind::kString:
+    case ValueKind::kBytes:
+      return true;
+    default:
+      return false;
+  }
+}
+
+ConstantListIndex::ConstantListIndex(absl::Span<const Value> elements,
+                                     cel::ListValue list)
+    : list_(std::move(list)) {
+  for (const Value& element : elements) {
+    ABSL_DCHECK(IsIndexable(element));
+    switch (element.kind()) {
+      case ValueKind::kNull:
+        has_null_ = true;
+        break;
+      case ValueKind::kBool:
+        (element.GetBool().NativeValue() ? has_true_ : has_false_) = true;
+        break;
+      case ValueKind::kString:
+        strings_.insert(element.GetString().ToString());
+        break;
+      case ValueKind::kBytes:
+        bytes_.insert(element.GetBytes().ToString());
+        break;
+      default:
+        AddNumber(element);
+        break;
+    }
+  }
+}
+
+// Numbers are keyed by the first of int, uint or double that represents them
+// losslessly, so numerically equal values share a key.
+void ConstantListIndex::AddNumber(const Value& value) {
+  Number number = ToNumber(value);
+  if (number.LosslessConvertibleToInt()) {
+    ints_.insert(number.AsInt());
+  } else if (number.LosslessConvertibleToUint()) {
+    uints_.insert(number.AsUint());
+  } else if (!std::isnan(number.AsDouble())) {
+    // NaN is not equal to anything, including itself.
+    doubles_.insert(number.AsDouble());
+  }
+}
+
+bool ConstantListIndex::ContainsNumber(const Value& value) const {
+  Number number = ToNumber(value);
+  if (number.LosslessConvertibleToInt()) {
+    return ints_.contains(number.AsInt());
+  }
+  if (number.LosslessConvertibleToUint()) {
+    return uints_.contains(number.AsUint());
+  }
+  return doubles_.contains(number.AsDouble());
+}
+
+absl::optional<bool> ConstantListIndex::Contains(const Value& value) const {
+  std::string scratch;
+  switch (value.kind()) {
+    case ValueKind::kNull:
+      return has_null_;
+    case ValueKind::kBool:
+      return value.GetBool().NativeValue() ? has_true_ : has_false_;
+    case ValueKind::kInt:
+    case ValueKind::kUint:
+    case ValueKind::kDouble:
+      return ContainsNumber(value);
+    case ValueKind::kString:
+      return strings_.contains(value.GetString().ToStringView(&scratch));
+    case ValueKind::kBytes:
+      return bytes_.contains(value.GetBytes().ToStringView(&scratch));
+    default:
+      return absl::nullopt;
+  }
+}
+
+std::unique_ptr<DirectExpressionStep> CreateDirectConstantInStep(
+    std::unique_ptr<DirectExpressionStep> item,
+    std::shared_ptr<const ConstantListIndex> index, int64_t expr_id) {
+  return std::make_unique<DirectConstantInStep>(std::move(item),
+                                                std::move(index), expr_id);
+}
+
+std::unique_ptr<ExpressionStep> CreateConstantInStep(
+    std::shared_ptr<const ConstantListIndex> index, int64_t expr_id) {
+  return std::make_unique<ConstantInStep>(std::move(index), expr_id);
+}
+
+}  // namespace google::api::expr::runtime
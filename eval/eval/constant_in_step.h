@@ -0,0 +1,82 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_CONSTANT_IN_STEP_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_CONSTANT_IN_STEP_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "common/value.h"
+#include "eval/eval/direct_expression_step.h"
+#include "eval/eval/evaluator_core.h"
+
+namespace google::api::expr::runtime {
+
+// Hash index over a constant list of primitive values, used to evaluate `@in`
+// without scanning the list.
+//
+// Lookups follow heterogeneous equality: numbers compare by numeric value
+// regardless of int, uint or double representation.
+class ConstantListIndex {
+ public:
+  // Returns true if `value` can be stored in the index (null, bool, int, uint,
+  // double, string or bytes).
+  static bool IsIndexable(const cel::Value& value);
+
+  // Builds an index over `elements`, which must all be indexable. `list` is
+  // the same elements as a list value, used for items that can't be looked up
+  // in the index.
+  ConstantListIndex(absl::Span<const cel::Value> elements,
+                    cel::ListValue list);
+
+  // Returns whether an element is equal to `value`, or nullopt if `value` is
+  // not indexable.
+  absl::optional<bool> Contains(const cel::Value& value) const;
+
+  const cel::ListValue& list() const { return list_; }
+
+ private:
+  void AddNumber(const cel::Value& value);
+  bool ContainsNumber(const cel::Value& value) const;
+
+  cel::ListValue list_;
+  bool has_null_ = false;
+  bool has_true_ = false;
+  bool has_false_ = false;
+  absl::flat_hash_set<int64_t> ints_;
+  absl::flat_hash_set<uint64_t> uints_;
+  absl::flat_hash_set<double> doubles_;
+  absl::flat_hash_set<std::string> strings_;
+  absl::flat_hash_set<std::string> bytes_;
+};
+
+// Factory method for recursive @in step where the container is a constant
+// list.
+std::unique_ptr<DirectExpressionStep> CreateDirectConstantInStep(
+    std::unique_ptr<DirectExpressionStep> item,
+    std::shared_ptr<const ConstantListIndex> index, int64_t expr_id);
+
+// Factory method for iterative @in step where the container is a constant
+// list. Expects only the item on the value stack.
+std::unique_ptr<ExpressionStep> CreateConstantInStep(
+    std::shared_ptr<const ConstantListIndex> index, int64_t expr_id);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_CONSTANT_IN_STEP_H_
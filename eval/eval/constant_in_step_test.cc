@@ -0,0 +1,125 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/constant_in_step.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/status/status_matchers.h"
+#include "absl/types/optional.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "eval/eval/attribute_trail.h"
+#include "eval/eval/const_value_step.h"
+#include "eval/eval/evaluator_core.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "internal/testing_message_factory.h"
+#include "runtime/activation.h"
+#include "runtime/internal/runtime_type_provider.h"
+#include "runtime/runtime_options.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::cel::BoolValue;
+using ::cel::BytesValue;
+using ::cel::DoubleValue;
+using ::cel::IntValue;
+using ::cel::NullValue;
+using ::cel::StringValue;
+using ::cel::UintValue;
+using ::cel::Value;
+using ::cel::test::BoolValueIs;
+using ::testing::Optional;
+
+std::shared_ptr<const ConstantListIndex> MakeIndex(
+    std::vector<Value> elements, google::protobuf::Arena* arena) {
+  auto builder = cel::NewListValueBuilder(arena);
+  for (const Value& element : elements) {
+    ABSL_CHECK_OK(builder->Add(element));
+  }
+  return std::make_shared<const ConstantListIndex>(elements,
+                                                   std::move(*builder).Build());
+}
+
+TEST(ConstantListIndexTest, HeterogeneousNumbers) {
+  google::protobuf::Arena arena;
+  auto index = MakeIndex(
+      {IntValue(1), UintValue(std::numeric_limits<uint64_t>::max()),
+       DoubleValue(2.5), DoubleValue(-0.0), DoubleValue(std::nan(""))},
+      &arena);
+
+  EXPECT_THAT(index->Contains(IntValue(1)), Optional(true));
+  EXPECT_THAT(index->Contains(UintValue(1)), Optional(true));
+  EXPECT_THAT(index->Contains(DoubleValue(1.0)), Optional(true));
+  EXPECT_THAT(index->Contains(DoubleValue(0.0)), Optional(true));
+  EXPECT_THAT(index->Contains(IntValue(0)), Optional(true));
+  EXPECT_THAT(index->Contains(DoubleValue(2.5)), Optional(true));
+  EXPECT_THAT(index->Contains(
+                  DoubleValue(static_cast<double>(
+                      std::numeric_limits<uint64_t>::max()))),
+              Optional(false));
+  EXPECT_THAT(index->Contains(UintValue(std::numeric_limits<uint64_t>::max())),
+              Optional(true));
+  EXPECT_THAT(index->Contains(DoubleValue(std::nan(""))), Optional(false));
+  EXPECT_THAT(index->Contains(IntValue(2)), Optional(false));
+}
+
+TEST(ConstantListIndexTest, Primitives) {
+  google::protobuf::Arena arena;
+  auto index = MakeIndex({NullValue(), BoolValue(false), StringValue("US"),
+                          BytesValue("CA")},
+                         &arena);
+
+  EXPECT_THAT(index->Contains(NullValue()), Optional(true));
+  EXPECT_THAT(index->Contains(BoolValue(false)), Optional(true));
+  EXPECT_THAT(index->Contains(BoolValue(true)), Optional(false));
+  EXPECT_THAT(index->Contains(StringValue("US")), Optional(true));
+  EXPECT_THAT(index->Contains(StringValue("CA")), Optional(false));
+  EXPECT_THAT(index->Contains(BytesValue("CA")), Optional(true));
+  EXPECT_THAT(index->Contains(IntValue(0)), Optional(false));
+  EXPECT_EQ(index->Contains(index->list()), absl::nullopt);
+}
+
+TEST(ConstantInStepTest, Recursive) {
+  google::protobuf::Arena arena;
+  cel::Activation activation;
+  cel::RuntimeOptions options;
+  cel::runtime_internal::RuntimeTypeProvider type_provider(
+      cel::internal::GetTestingDescriptorPool());
+  ExecutionFrameBase frame(activation, options, type_provider,
+                           cel::internal::GetTestingDescriptorPool(),
+                           cel::internal::GetTestingMessageFactory(), &arena);
+
+  auto step = CreateDirectConstantInStep(
+      CreateConstValueDirectStep(IntValue(3)),
+      MakeIndex({DoubleValue(1.5), DoubleValue(3.0)}, &arena), -1);
+
+  Value result;
+  AttributeTrail attribute_trail;
+  ASSERT_THAT(step->Evaluate(frame, result, attribute_trail), IsOk());
+  EXPECT_THAT(result, BoolValueIs(true));
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
@@ -18,10 +18,14 @@
 #include <cstdint>
 #include <memory>
 #include <utility>
+#include <vector>
 
+#include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
 #include "base/builtins.h"
+#include "common/kind.h"
 #include "common/value.h"
 #include "common/value_kind.h"
 #include "eval/eval/attribute_trail.h"
@@ -107,6 +111,60 @@ class DirectEqualityStep : public DirectExpressionStep {
   bool negation_;
 };
 
+// Recursive _==_/_!=_ step for operands the type checker proved to be the same
+// numeric kind. Compares the native values directly when both operands
+// evaluate to that kind, otherwise defers to EvaluateEquality.
+class DirectTypedEqualityStep : public DirectExpressionStep {
+ public:
+  DirectTypedEqualityStep(std::unique_ptr<DirectExpressionStep> lhs,
+                          std::unique_ptr<DirectExpressionStep> rhs,
+                          bool negation, ValueKind kind, int64_t expr_id)
+      : DirectExpressionStep(expr_id),
+        lhs_(std::move(lhs)),
+        rhs_(std::move(rhs)),
+        negation_(negation),
+        kind_(kind) {}
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
+                        AttributeTrail& attribute_trail) const override {
+    AttributeTrail lhs_attr;
+    CEL_RETURN_IF_ERROR(lhs_->Evaluate(frame, result, lhs_attr));
+
+    Value rhs_result;
+    AttributeTrail rhs_attr;
+    CEL_RETURN_IF_ERROR(rhs_->Evaluate(frame, rhs_result, rhs_attr));
+
+    if (result.kind() == kind_ && rhs_result.kind() == kind_ &&
+        (!frame.unknown_processing_enabled() ||
+         (lhs_attr.empty() && rhs_attr.empty()))) {
+      result = BoolValue(NativeEqual(result, rhs_result) != negation_);
+      return absl::OkStatus();
+    }
+
+    CEL_ASSIGN_OR_RETURN(
+        result, EvaluateEquality(frame, result, lhs_attr, rhs_result, rhs_attr,
+                                 negation_));
+    return absl::OkStatus();
+  }
+
+ private:
+  bool NativeEqual(const Value& lhs, const Value& rhs) const {
+    switch (kind_) {
+      case ValueKind::kInt:
+        return lhs.GetInt().NativeValue() == rhs.GetInt().NativeValue();
+      case ValueKind::kUint:
+        return lhs.GetUint().NativeValue() == rhs.GetUint().NativeValue();
+      default:
+        return lhs.GetDouble().NativeValue() == rhs.GetDouble().NativeValue();
+    }
+  }
+
+  std::unique_ptr<DirectExpressionStep> lhs_;
+  std::unique_ptr<DirectExpressionStep> rhs_;
+  bool negation_;
+  ValueKind kind_;
+};
+
 class IterativeEqualityStep : public ExpressionStepBase {
  public:
   explicit IterativeEqualityStep(bool negation, int64_t expr_id)
@@ -245,6 +303,21 @@ class DirectInStep : public DirectExpressionStep {
     return absl::OkStatus();
   }
 
+  absl::optional<std::vector<const DirectExpressionStep*>> GetDependencies()
+      const override {
+    return std::vector<const DirectExpressionStep*>{item_.get(),
+                                                    container_.get()};
+  }
+
+  absl::optional<std::vector<std::unique_ptr<DirectExpressionStep>>>
+  ExtractDependencies() override {
+    std::vector<std::unique_ptr<DirectExpressionStep>> dependencies;
+    dependencies.reserve(2);
+    dependencies.push_back(std::move(item_));
+    dependencies.push_back(std::move(container_));
+    return dependencies;
+  }
+
  private:
   std::unique_ptr<DirectExpressionStep> item_;
   std::unique_ptr<DirectExpressionStep> container_;
@@ -279,6 +352,19 @@ std::unique_ptr<DirectExpressionStep> CreateDirectEqualityStep(
                                               negation, expr_id);
 }
 
+// Factory method for recursive _==_ and _!=_ Execution step with typed operands
+std::unique_ptr<DirectExpressionStep> CreateDirectTypedEqualityStep(
+    std::unique_ptr<DirectExpressionStep> lhs,
+    std::unique_ptr<DirectExpressionStep> rhs, bool negation,
+    cel::Kind operand_kind, int64_t expr_id) {
+  ABSL_DCHECK(operand_kind == cel::Kind::kInt ||
+              operand_kind == cel::Kind::kUint ||
+              operand_kind == cel::Kind::kDouble);
+  return std::make_unique<DirectTypedEqualityStep>(
+      std::move(lhs), std::move(rhs), negation,
+      cel::KindToValueKind(operand_kind), expr_id);
+}
+
 // Factory method for iterative _==_ and _!=_ Execution step
 std::unique_ptr<ExpressionStep> CreateEqualityStep(bool negation,
                                                    int64_t expr_id) {
@@ -18,6 +18,7 @@
 #include <cstdint>
 #include <memory>
 
+#include "common/kind.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 
@@ -28,6 +29,14 @@ std::unique_ptr<DirectExpressionStep> CreateDirectEqualityStep(
     std::unique_ptr<DirectExpressionStep> lhs,
     std::unique_ptr<DirectExpressionStep> rhs, bool negation, int64_t expr_id);
 
+// Factory method for recursive _==_/_!=_ Execution step where the type checker
+// proved both operands are `operand_kind` (int, uint or double). The native
+// values are compared directly when both operands evaluate to that kind.
+std::unique_ptr<DirectExpressionStep> CreateDirectTypedEqualityStep(
+    std::unique_ptr<DirectExpressionStep> lhs,
+    std::unique_ptr<DirectExpressionStep> rhs, bool negation,
+    cel::Kind operand_kind, int64_t expr_id);
+
 // Factory method for iterative _==_/_!=_ Execution step
 std::unique_ptr<ExpressionStep> CreateEqualityStep(bool negation,
                                                    int64_t expr_id);
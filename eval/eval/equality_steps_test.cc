@@ -23,6 +23,7 @@
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "base/attribute.h"
+#include "common/kind.h"
 #include "common/value.h"
 #include "common/value_kind.h"
 #include "common/value_testing.h"
@@ -269,6 +270,46 @@ TEST_P(EqualsTest, Recursive) {
   }
 }
 
+// The typed step must agree with the generic one, including when operands
+// don't match the checked kind.
+TEST_P(EqualsTest, RecursiveTyped) {
+  const EqualsTestCase& test_case = GetParam();
+  cel::Activation activation;
+  google::protobuf::Arena arena;
+  cel::RuntimeOptions opts;
+  opts.unknown_processing = cel::UnknownProcessingOptions::kAttributeOnly;
+  cel::runtime_internal::RuntimeTypeProvider type_provider(
+      cel::internal::GetTestingDescriptorPool());
+
+  auto plan = CreateDirectTypedEqualityStep(
+      std::make_unique<ValueStep>(MakeValue(test_case.lhs, &arena)),
+      std::make_unique<ValueStep>(MakeValue(test_case.rhs, &arena)),
+      test_case.negation, cel::Kind::kInt, -1);
+
+  ExecutionFrameBase frame(activation, opts, type_provider,
+                           cel::internal::GetTestingDescriptorPool(),
+                           cel::internal::GetTestingMessageFactory(), &arena);
+
+  cel::Value result;
+  AttributeTrail attribute_trail;
+  ASSERT_THAT(plan->Evaluate(frame, result, attribute_trail), IsOk());
+
+  switch (test_case.expected_result) {
+    case OutputType::kBoolTrue:
+      EXPECT_THAT(result, BoolValueIs(true));
+      break;
+    case OutputType::kBoolFalse:
+      EXPECT_THAT(result, BoolValueIs(false));
+      break;
+    case OutputType::kError:
+      EXPECT_THAT(result, ValueKindIs(ValueKind::kError));
+      break;
+    case OutputType::kUnknown:
+      EXPECT_THAT(result, ValueKindIs(ValueKind::kUnknown));
+      break;
+  }
+}
+
 TEST_P(EqualsTest, Iterative) {
   const EqualsTestCase& test_case = GetParam();
   cel::Activation activation;
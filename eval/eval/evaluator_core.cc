@@ -26,6 +26,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "common/value.h"
+#include "eval/eval/comprehension_slots.h"
 #include "runtime/activation_interface.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
@@ -53,6 +54,7 @@ const ExpressionStep* ExecutionFrame::Next() {
         SubFrame& subframe = call_stack_.back();
         pc_ = subframe.return_pc;
         execution_path_ = subframe.return_expression;
+        lowered_path_ = subframe.return_lowered_expression;
         ABSL_DCHECK_EQ(value_stack().size(), subframe.expected_stack_size);
         comprehension_slots().Set(subframe.slot_index, value_stack().Peek(),
                                   value_stack().PeekAttribute());
@@ -103,11 +105,71 @@ class EvaluationStatus final {
 
 }  // namespace
 
+absl::Status ExecutionFrame::EvaluateLowered() {
+  for (const ExpressionStep* expr = Next(); ABSL_PREDICT_TRUE(expr != nullptr);
+       expr = Next()) {
+    // Next() keeps lowered_path_ in sync with execution_path_ and has already
+    // advanced pc_ past the current step.
+    const Instruction& instruction = lowered_path_[pc_ - 1];
+    switch (instruction.opcode) {
+      case Opcode::kConstant:
+        value_stack().Push(*instruction.constant);
+        continue;
+      case Opcode::kSlot: {
+        const ComprehensionSlots::Slot* slot =
+            comprehension_slots().Get(instruction.operand);
+        if (ABSL_PREDICT_TRUE(slot->Has())) {
+          value_stack().Push(slot->value(), slot->attribute());
+          continue;
+        }
+        // Let the step report the out of scope access.
+        break;
+      }
+      case Opcode::kJump:
+        if (EvaluationStatus status(JumpTo(instruction.operand));
+            !status.ok()) {
+          return std::move(status).Consume();
+        }
+        continue;
+      case Opcode::kCondJump: {
+        if (ABSL_PREDICT_FALSE(!value_stack().HasEnough(1))) {
+          // Let the step report the underflow.
+          break;
+        }
+        const cel::Value& value = value_stack().Peek();
+        const bool should_jump =
+            value.Is<cel::BoolValue>() &&
+            instruction.jump_condition == value.GetBool().NativeValue();
+        if (!instruction.leave_on_stack) {
+          value_stack().Pop(1);
+        }
+        if (should_jump) {
+          if (EvaluationStatus status(JumpTo(instruction.operand));
+              !status.ok()) {
+            return std::move(status).Consume();
+          }
+        }
+        continue;
+      }
+      case Opcode::kStep:
+        break;
+    }
+    if (EvaluationStatus status(expr->Evaluate(this)); !status.ok()) {
+      return std::move(status).Consume();
+    }
+  }
+  return absl::OkStatus();
+}
+
 absl::StatusOr<cel::Value> ExecutionFrame::Evaluate(
     EvaluationListener& listener) {
   const size_t initial_stack_size = value_stack().size();
 
-  if (!listener) {
+  if (!listener && !lowered_subexpressions_.empty()) {
+    if (EvaluationStatus status(EvaluateLowered()); !status.ok()) {
+      return std::move(status).Consume();
+    }
+  } else if (!listener) {
     for (const ExpressionStep* expr = Next();
          ABSL_PREDICT_TRUE(expr != nullptr); expr = Next()) {
       if (EvaluationStatus status(expr->Evaluate(this)); !status.ok()) {
@@ -168,6 +230,12 @@ absl::StatusOr<cel::Value> FlatExpression::EvaluateWithCallback(
     FlatExpressionEvaluatorState& state) const {
   state.Reset();
 
+  if (!lowered_subexpressions_.empty()) {
+    ExecutionFrame frame(subexpressions_, lowered_subexpressions_, activation,
+                         options_, state, std::move(listener));
+    return frame.Evaluate(frame.callback());
+  }
+
   ExecutionFrame frame(subexpressions_, activation, options_, state,
                        std::move(listener));
 
@@ -15,6 +15,7 @@
 #ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATOR_CORE_H_
 #define THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATOR_CORE_H_
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -97,6 +98,45 @@ using ExecutionPath = std::vector<std::unique_ptr<const ExpressionStep>>;
 using ExecutionPathView =
     absl::Span<const std::unique_ptr<const ExpressionStep>>;
 
+// Opcodes for the lowered form of an ExecutionPath.
+//
+// Trivial steps are lowered to an opcode with inline operands that the
+// evaluation loop handles directly, avoiding a virtual call per step. Any
+// other step is lowered to kStep and evaluated through
+// ExpressionStep::Evaluate.
+enum class Opcode : uint8_t {
+  // Evaluate `step` via virtual dispatch.
+  kStep,
+  // Push `*constant`.
+  kConstant,
+  // Push the value and attribute held in comprehension slot `operand`.
+  kSlot,
+  // Jump by `operand`.
+  kJump,
+  // Jump by `operand` if the top of the stack is a bool equal to
+  // `jump_condition`. Pops the top of the stack unless `leave_on_stack`.
+  kCondJump,
+};
+
+// Single instruction in a lowered ExecutionPath.
+//
+// Instructions correspond one to one with the steps in the source path, so
+// program counters and jump offsets are shared between the two forms.
+struct Instruction {
+  Opcode opcode = Opcode::kStep;
+  bool jump_condition = false;
+  bool leave_on_stack = false;
+  // Jump offset or slot index, depending on opcode.
+  int32_t operand = 0;
+  const cel::Value* absl_nullable constant = nullptr;
+  // The step this instruction was lowered from. Always set, used for
+  // fallback evaluation.
+  const ExpressionStep* absl_nonnull step = nullptr;
+};
+
+using LoweredExecutionPath = std::vector<Instruction>;
+using LoweredExecutionPathView = absl::Span<const Instruction>;
+
 // Class that wraps the state that needs to be allocated for expression
 // evaluation. This can be reused to save on allocations.
 class FlatExpressionEvaluatorState {
@@ -120,6 +160,16 @@ class FlatExpressionEvaluatorState {
 
   void Reset();
 
+  // Points the state at a new evaluation context so that it can be reused
+  // across evaluations (see EvaluatorStatePool).
+  void Rebind(const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+              google::protobuf::MessageFactory* absl_nonnull message_factory,
+              google::protobuf::Arena* absl_nonnull arena) {
+    descriptor_pool_ = descriptor_pool;
+    message_factory_ = message_factory;
+    arena_ = arena;
+  }
+
   EvaluatorStack& value_stack() { return value_stack_; }
 
   cel::runtime_internal::IteratorStack& iterator_stack() {
@@ -262,14 +312,46 @@ class ExecutionFrameBase {
     if (max_iterations_ == 0) {
       return absl::OkStatus();
     }
-    iterations_++;
-    if (iterations_ >= max_iterations_) {
+    int iterations;
+    if (shared_iterations_ != nullptr) {
+      iterations =
+          shared_iterations_->fetch_add(1, std::memory_order_relaxed) + 1;
+    } else {
+      iterations = ++iterations_;
+    }
+    if (iterations >= max_iterations_) {
       return absl::Status(absl::StatusCode::kInternal,
                           "Iteration budget exceeded");
     }
     return absl::OkStatus();
   }
 
+  // Counts iterations in `counter`, starting from the iterations counted so
+  // far, until `UnshareIterations` is called. Frames of concurrently evaluated
+  // branches count in the same counter (see `set_shared_iterations`), so the
+  // iteration budget applies to the evaluation as a whole.
+  void ShareIterations(std::atomic<int>& counter) {
+    counter.store(iterations_, std::memory_order_relaxed);
+    shared_iterations_ = &counter;
+  }
+
+  // Resumes counting iterations in this frame, including those counted in the
+  // shared counter. Every frame sharing the counter must have completed.
+  void UnshareIterations() {
+    iterations_ = shared_iterations_->load(std::memory_order_relaxed);
+    shared_iterations_ = nullptr;
+  }
+
+  // The counter shared with other frames, or null if this frame counts its
+  // own iterations.
+  std::atomic<int>* absl_nullable shared_iterations() const {
+    return shared_iterations_;
+  }
+
+  void set_shared_iterations(std::atomic<int>* absl_nullable counter) {
+    shared_iterations_ = counter;
+  }
+
  protected:
   const cel::ActivationInterface* absl_nonnull activation_;
   EvaluationListener callback_;
@@ -282,6 +364,7 @@ class ExecutionFrameBase {
   ComprehensionSlots* absl_nonnull slots_;
   const int max_iterations_;
   int iterations_;
+  std::atomic<int>* absl_nullable shared_iterations_ = nullptr;
 };
 
 // ExecutionFrame manages the context needed for expression evaluation.
@@ -325,6 +408,22 @@ class ExecutionFrame : public ExecutionFrameBase {
     ABSL_DCHECK(!subexpressions.empty());
   }
 
+  // Variant that evaluates the lowered form of the program when no listener
+  // is provided. lowered_subexpressions must correspond one to one with
+  // subexpressions.
+  ExecutionFrame(
+      absl::Span<const ExecutionPathView> subexpressions,
+      absl::Span<const LoweredExecutionPathView> lowered_subexpressions,
+      const cel::ActivationInterface& activation,
+      const cel::RuntimeOptions& options, FlatExpressionEvaluatorState& state,
+      EvaluationListener callback = EvaluationListener())
+      : ExecutionFrame(subexpressions, activation, options, state,
+                       std::move(callback)) {
+    ABSL_DCHECK_EQ(subexpressions.size(), lowered_subexpressions.size());
+    lowered_subexpressions_ = lowered_subexpressions;
+    lowered_path_ = lowered_subexpressions[0];
+  }
+
   // Returns next expression to evaluate.
   const ExpressionStep* Next();
 
@@ -367,9 +466,12 @@ class ExecutionFrame : public ExecutionFrameBase {
     // return pc == size() is supported (a tail call).
     ABSL_DCHECK_LE(return_pc, execution_path_.size());
     call_stack_.push_back(SubFrame{return_pc, slot_index, execution_path_,
-                                   value_stack().size() + 1});
+                                   lowered_path_, value_stack().size() + 1});
     pc_ = 0UL;
     execution_path_ = subexpression;
+    if (!lowered_subexpressions_.empty()) {
+      lowered_path_ = lowered_subexpressions_[subexpression_index];
+    }
   }
 
   EvaluatorStack& value_stack() { return *value_stack_; }
@@ -410,14 +512,22 @@ class ExecutionFrame : public ExecutionFrameBase {
     size_t return_pc;
     size_t slot_index;
     ExecutionPathView return_expression;
+    LoweredExecutionPathView return_lowered_expression;
     size_t expected_stack_size;
   };
 
+  // Evaluation loop for the lowered program.
+  absl::Status EvaluateLowered();
+
   size_t pc_;  // pc_ - Program Counter. Current position on execution path.
   ExecutionPathView execution_path_;
   EvaluatorStack* absl_nonnull const value_stack_;
   cel::runtime_internal::IteratorStack* absl_nonnull const iterator_stack_;
   absl::Span<const ExecutionPathView> subexpressions_;
+  // Lowered form of execution_path_ and subexpressions_. Empty if the
+  // program was not lowered.
+  LoweredExecutionPathView lowered_path_;
+  absl::Span<const LoweredExecutionPathView> lowered_subexpressions_;
   std::vector<SubFrame> call_stack_;
 };
 
@@ -480,6 +590,21 @@ class FlatExpression {
     return subexpressions_;
   }
 
+  // Sets the lowered form of the program. Instructions must correspond one
+  // to one with the steps in path(), with the same subexpression ranges.
+  void set_lowered_path(LoweredExecutionPath lowered_path,
+                        std::vector<LoweredExecutionPathView>
+                            lowered_subexpressions) {
+    ABSL_DCHECK_EQ(lowered_path.size(), path_.size());
+    ABSL_DCHECK_EQ(lowered_subexpressions.size(), subexpressions_.size());
+    lowered_path_ = std::move(lowered_path);
+    lowered_subexpressions_ = std::move(lowered_subexpressions);
+  }
+
+  absl::Span<const LoweredExecutionPathView> lowered_subexpressions() const {
+    return lowered_subexpressions_;
+  }
+
   const cel::RuntimeOptions& options() const { return options_; }
 
   size_t comprehension_slots_size() const { return comprehension_slots_size_; }
@@ -489,6 +614,8 @@ class FlatExpression {
  private:
   ExecutionPath path_;
   std::vector<ExecutionPathView> subexpressions_;
+  LoweredExecutionPath lowered_path_;
+  std::vector<LoweredExecutionPathView> lowered_subexpressions_;
   size_t comprehension_slots_size_;
   const cel::TypeProvider& type_provider_;
   cel::RuntimeOptions options_;
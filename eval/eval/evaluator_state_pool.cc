@@ -0,0 +1,123 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/evaluator_state_pool.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "absl/base/nullability.h"
+#include "absl/synchronization/mutex.h"
+#include "eval/eval/evaluator_core.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace google::api::expr::runtime {
+
+// Per-thread cache holding at most one idle state.
+struct EvaluatorStatePoolThreadCache {
+  using FreeList = EvaluatorStatePool::FreeList;
+
+  ~EvaluatorStatePoolThreadCache() {
+    // Give the state back to its pool if the pool is still alive.
+    if (state == nullptr) {
+      return;
+    }
+    if (std::shared_ptr<FreeList> free_list = owner.lock();
+        free_list != nullptr) {
+      absl::MutexLock lock(&free_list->mutex);
+      if (free_list->states.size() < free_list->max_size) {
+        free_list->states.push_back(std::move(state));
+      }
+    }
+  }
+
+  // Returns true if the cached state belongs to `free_list`.
+  //
+  // Compares control blocks rather than pointers: the weak reference keeps the
+  // control block alive, so it cannot be reused by a newer pool.
+  bool IsOwnedBy(const std::shared_ptr<FreeList>& free_list) const {
+    return !owner.owner_before(free_list) && !free_list.owner_before(owner);
+  }
+
+  std::weak_ptr<FreeList> owner;
+  std::unique_ptr<FlatExpressionEvaluatorState> state;
+};
+
+namespace {
+
+EvaluatorStatePoolThreadCache& GetThreadCache() {
+  thread_local EvaluatorStatePoolThreadCache cache;
+  return cache;
+}
+
+}  // namespace
+
+EvaluatorStatePool::EvaluatorStatePool(const FlatExpression& expression,
+                                       size_t max_size)
+    : expression_(expression),
+      free_list_(std::make_shared<FreeList>(max_size)) {}
+
+EvaluatorStatePool::Lease EvaluatorStatePool::Acquire(
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena) const {
+  std::unique_ptr<FlatExpressionEvaluatorState> state;
+
+  EvaluatorStatePoolThreadCache& cache = GetThreadCache();
+  if (cache.state != nullptr && cache.IsOwnedBy(free_list_)) {
+    state = std::move(cache.state);
+  } else {
+    absl::MutexLock lock(&free_list_->mutex);
+    if (!free_list_->states.empty()) {
+      state = std::move(free_list_->states.back());
+      free_list_->states.pop_back();
+    }
+  }
+
+  if (state != nullptr) {
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    state->Rebind(descriptor_pool, message_factory, arena);
+  } else {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    state = std::make_unique<FlatExpressionEvaluatorState>(
+        expression_.path().size(), expression_.comprehension_slots_size(),
+        expression_.type_provider(), descriptor_pool, message_factory, arena);
+  }
+  return Lease(this, std::move(state));
+}
+
+void EvaluatorStatePool::Release(
+    std::unique_ptr<FlatExpressionEvaluatorState> state) const {
+  // Drop any values from the finished evaluation before the arena that owns
+  // them goes away.
+  state->Reset();
+
+  EvaluatorStatePoolThreadCache& cache = GetThreadCache();
+  if (cache.state == nullptr || cache.owner.expired()) {
+    cache.owner = free_list_;
+    cache.state = std::move(state);
+    return;
+  }
+
+  absl::MutexLock lock(&free_list_->mutex);
+  if (free_list_->states.size() < free_list_->max_size) {
+    free_list_->states.push_back(std::move(state));
+  }
+}
+
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,123 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATOR_STATE_POOL_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATOR_STATE_POOL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "eval/eval/evaluator_core.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace google::api::expr::runtime {
+
+// Thread-safe pool of evaluator states for a single FlatExpression.
+//
+// Each state is sized for the expression when it is first created. It is
+// reset and returned to the pool when the evaluation that leased it ends, so
+// in steady state evaluations do not allocate a value stack, iterator stack
+// or comprehension slots.
+//
+// Each thread caches one idle state, which avoids taking the pool lock when a
+// thread repeatedly evaluates the same program. Other idle states are kept in
+// a shared free list of at most `max_size` entries.
+//
+// The pool must not outlive the FlatExpression it was created for.
+class EvaluatorStatePool {
+ public:
+  struct Stats {
+    // Acquisitions served by an idle state.
+    uint64_t hits = 0;
+    // Acquisitions that required allocating a new state.
+    uint64_t misses = 0;
+  };
+
+  // Move-only handle to a leased state. Returns the state to the pool on
+  // destruction.
+  class Lease {
+   public:
+    Lease(Lease&&) = default;
+    Lease& operator=(Lease&&) = delete;
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+
+    ~Lease() {
+      if (state_ != nullptr) {
+        pool_->Release(std::move(state_));
+      }
+    }
+
+    FlatExpressionEvaluatorState& state() { return *state_; }
+
+   private:
+    friend class EvaluatorStatePool;
+
+    Lease(const EvaluatorStatePool* absl_nonnull pool,
+          std::unique_ptr<FlatExpressionEvaluatorState> state)
+        : pool_(pool), state_(std::move(state)) {}
+
+    const EvaluatorStatePool* absl_nonnull pool_;
+    std::unique_ptr<FlatExpressionEvaluatorState> state_;
+  };
+
+  EvaluatorStatePool(const FlatExpression& expression, size_t max_size);
+
+  EvaluatorStatePool(const EvaluatorStatePool&) = delete;
+  EvaluatorStatePool& operator=(const EvaluatorStatePool&) = delete;
+
+  // Leases a state bound to the given evaluation context.
+  Lease Acquire(const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+                google::protobuf::MessageFactory* absl_nonnull message_factory,
+                google::protobuf::Arena* absl_nonnull arena) const;
+
+  Stats stats() const {
+    return Stats{hits_.load(std::memory_order_relaxed),
+                 misses_.load(std::memory_order_relaxed)};
+  }
+
+ private:
+  // Idle states shared by all threads. Held by shared_ptr so that thread
+  // caches can detect when the owning pool has been destroyed.
+  struct FreeList {
+    explicit FreeList(size_t max_size) : max_size(max_size) {}
+
+    const size_t max_size;
+    absl::Mutex mutex;
+    std::vector<std::unique_ptr<FlatExpressionEvaluatorState>> states
+        ABSL_GUARDED_BY(mutex);
+  };
+
+  friend struct EvaluatorStatePoolThreadCache;
+
+  void Release(std::unique_ptr<FlatExpressionEvaluatorState> state) const;
+
+  const FlatExpression& expression_;
+  const std::shared_ptr<FreeList> free_list_;
+  mutable std::atomic<uint64_t> hits_{0};
+  mutable std::atomic<uint64_t> misses_{0};
+};
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_EVALUATOR_STATE_POOL_H_
@@ -0,0 +1,124 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/evaluator_state_pool.h"
+
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+
+#include "common/value.h"
+#include "eval/eval/evaluator_core.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "internal/testing_message_factory.h"
+#include "runtime/internal/runtime_type_provider.h"
+#include "runtime/runtime_options.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::internal::GetTestingDescriptorPool;
+using ::cel::internal::GetTestingMessageFactory;
+using ::cel::runtime_internal::RuntimeTypeProvider;
+using ::testing::Eq;
+using ::testing::Ne;
+
+class EvaluatorStatePoolTest : public testing::Test {
+ public:
+  EvaluatorStatePoolTest()
+      : type_provider_(GetTestingDescriptorPool()),
+        expression_(ExecutionPath(), /*comprehension_slots_size=*/2,
+                    type_provider_, cel::RuntimeOptions()) {}
+
+ protected:
+  RuntimeTypeProvider type_provider_;
+  FlatExpression expression_;
+  google::protobuf::Arena arena_;
+};
+
+TEST_F(EvaluatorStatePoolTest, ReusesReleasedState) {
+  EvaluatorStatePool pool(expression_, /*max_size=*/4);
+
+  FlatExpressionEvaluatorState* first = nullptr;
+  {
+    auto lease = pool.Acquire(GetTestingDescriptorPool(),
+                              GetTestingMessageFactory(), &arena_);
+    first = &lease.state();
+    lease.state().value_stack().Push(cel::IntValue(1));
+  }
+
+  google::protobuf::Arena other_arena;
+  auto lease = pool.Acquire(GetTestingDescriptorPool(),
+                            GetTestingMessageFactory(), &other_arena);
+  EXPECT_THAT(&lease.state(), Eq(first));
+  EXPECT_THAT(lease.state().arena(), Eq(&other_arena));
+  EXPECT_TRUE(lease.state().value_stack().empty());
+  EXPECT_THAT(lease.state().comprehension_slots().size(), Eq(2));
+
+  EXPECT_THAT(pool.stats().hits, Eq(1));
+  EXPECT_THAT(pool.stats().misses, Eq(1));
+}
+
+TEST_F(EvaluatorStatePoolTest, ConcurrentLeasesUseDistinctStates) {
+  EvaluatorStatePool pool(expression_, /*max_size=*/4);
+
+  auto lease1 = pool.Acquire(GetTestingDescriptorPool(),
+                             GetTestingMessageFactory(), &arena_);
+  auto lease2 = pool.Acquire(GetTestingDescriptorPool(),
+                             GetTestingMessageFactory(), &arena_);
+
+  EXPECT_THAT(&lease1.state(), Ne(&lease2.state()));
+  EXPECT_THAT(pool.stats().hits, Eq(0));
+  EXPECT_THAT(pool.stats().misses, Eq(2));
+}
+
+TEST_F(EvaluatorStatePoolTest, SharesStatesAcrossThreads) {
+  EvaluatorStatePool pool(expression_, /*max_size=*/4);
+
+  std::thread thread([&]() {
+    google::protobuf::Arena arena;
+    auto lease = pool.Acquire(GetTestingDescriptorPool(),
+                              GetTestingMessageFactory(), &arena);
+  });
+  thread.join();
+
+  // The exiting thread returns its cached state to the shared free list.
+  auto lease = pool.Acquire(GetTestingDescriptorPool(),
+                            GetTestingMessageFactory(), &arena_);
+  EXPECT_THAT(pool.stats().hits, Eq(1));
+  EXPECT_THAT(pool.stats().misses, Eq(1));
+}
+
+TEST_F(EvaluatorStatePoolTest, ThreadCacheIgnoresDestroyedPool) {
+  {
+    EvaluatorStatePool pool(expression_, /*max_size=*/4);
+    auto lease = pool.Acquire(GetTestingDescriptorPool(),
+                              GetTestingMessageFactory(), &arena_);
+  }
+
+  EvaluatorStatePool pool(expression_, /*max_size=*/4);
+  {
+    auto lease = pool.Acquire(GetTestingDescriptorPool(),
+                              GetTestingMessageFactory(), &arena_);
+  }
+  auto lease = pool.Acquire(GetTestingDescriptorPool(),
+                            GetTestingMessageFactory(), &arena_);
+  EXPECT_THAT(pool.stats().hits, Eq(1));
+  EXPECT_THAT(pool.stats().misses, Eq(1));
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
@@ -3,18 +3,23 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "absl/container/fixed_array.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
+#include "base/builtins.h"
 #include "common/casting.h"
 #include "common/expr.h"
 #include "common/function_descriptor.h"
@@ -25,9 +30,12 @@
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 #include "eval/eval/expression_step_base.h"
+#include "eval/eval/parallel_evaluation.h"
 #include "eval/internal/errors.h"
+#include "internal/overflow.h"
 #include "internal/status_macros.h"
 #include "runtime/activation_interface.h"
+#include "runtime/executor.h"
 #include "runtime/function.h"
 #include "runtime/function_overload_reference.h"
 #include "runtime/function_provider.h"
@@ -406,8 +414,8 @@ class DirectFunctionStepImpl : public DirectExpressionStep {
       std::vector<std::unique_ptr<DirectExpressionStep>> arg_steps,
       Resolver&& resolver)
       : DirectExpressionStep(expr_id),
-        name_(name),
         arg_steps_(std::move(arg_steps)),
+        name_(name),
         resolver_(std::forward<Resolver>(resolver)) {}
 
   absl::Status Evaluate(ExecutionFrameBase& frame, cel::Value& result,
@@ -423,6 +431,30 @@ class DirectFunctionStepImpl : public DirectExpressionStep {
           arg_steps_[i]->Evaluate(frame, args[i], arg_trails[i]));
     }
 
+    return Apply(frame, args, arg_trails, result);
+  }
+
+  absl::optional<std::vector<const DirectExpressionStep*>> GetDependencies()
+      const override {
+    std::vector<const DirectExpressionStep*> dependencies;
+    dependencies.reserve(arg_steps_.size());
+    for (const auto& arg_step : arg_steps_) {
+      dependencies.push_back(arg_step.get());
+    }
+    return dependencies;
+  }
+
+  absl::optional<std::vector<std::unique_ptr<DirectExpressionStep>>>
+  ExtractDependencies() override {
+    return std::move(arg_steps_);
+  }
+
+ protected:
+  // Resolves and invokes the function on the evaluated arguments.
+  absl::Status Apply(ExecutionFrameBase& frame,
+                     absl::InlinedVector<Value, 2>& args,
+                     absl::Span<const AttributeTrail> arg_trails,
+                     cel::Value& result) const {
     if (frame.unknown_processing_enabled()) {
       for (size_t i = 0; i < arg_trails.size(); i++) {
         if (frame.attribute_utility().CheckForUnknown(arg_trails[i],
@@ -449,28 +481,264 @@ class DirectFunctionStepImpl : public DirectExpressionStep {
     return absl::OkStatus();
   }
 
-  absl::optional<std::vector<const DirectExpressionStep*>> GetDependencies()
-      const override {
-    std::vector<const DirectExpressionStep*> dependencies;
-    dependencies.reserve(arg_steps_.size());
-    for (const auto& arg_step : arg_steps_) {
-      dependencies.push_back(arg_step.get());
-    }
-    return dependencies;
-  }
-
-  absl::optional<std::vector<std::unique_ptr<DirectExpressionStep>>>
-  ExtractDependencies() override {
-    return std::move(arg_steps_);
-  }
+  std::vector<std::unique_ptr<DirectExpressionStep>> arg_steps_;
 
  private:
   friend Resolver;
   std::string name_;
-  std::vector<std::unique_ptr<DirectExpressionStep>> arg_steps_;
   Resolver resolver_;
 };
 
+// Function step that evaluates the flagged arguments concurrently on an
+// executor before resolving the overload.
+class ParallelDirectFunctionStep final
+    : public DirectFunctionStepImpl<StaticResolver> {
+ public:
+  ParallelDirectFunctionStep(
+      int64_t expr_id, const std::string& name,
+      std::vector<std::unique_ptr<DirectExpressionStep>> arg_steps,
+      StaticResolver&& resolver, absl::Span<const bool> concurrent_args,
+      std::shared_ptr<cel::Executor> executor)
+      : DirectFunctionStepImpl<StaticResolver>(
+            expr_id, name, std::move(arg_steps), std::move(resolver)),
+        concurrent_args_(concurrent_args.begin(), concurrent_args.end()),
+        executor_(std::move(executor)) {
+    ABSL_DCHECK_EQ(concurrent_args_.size(), arg_steps_.size());
+  }
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, cel::Value& result,
+                        AttributeTrail& trail) const override {
+    absl::InlinedVector<Value, 2> args;
+    absl::InlinedVector<AttributeTrail, 2> arg_trails;
+
+    args.resize(arg_steps_.size());
+    arg_trails.resize(arg_steps_.size());
+
+    CEL_RETURN_IF_ERROR(EvaluateConcurrently(
+        frame, *executor_, arg_steps_, concurrent_args_, absl::MakeSpan(args),
+        absl::MakeSpan(arg_trails)));
+
+    return Apply(frame, args, arg_trails, result);
+  }
+
+ private:
+  absl::FixedArray<bool, 4> concurrent_args_;
+  std::shared_ptr<cel::Executor> executor_;
+};
+
+// Accessors for the operand types supported by TypedBinaryFunctionStep.
+template <typename T>
+struct TypedOperand;
+
+template <>
+struct TypedOperand<int64_t> {
+  static bool Is(const Value& value) { return value.IsInt(); }
+  static int64_t Get(const Value& value) {
+    return value.GetInt().NativeValue();
+  }
+  static Value Wrap(int64_t value) { return cel::IntValue(value); }
+};
+
+template <>
+struct TypedOperand<uint64_t> {
+  static bool Is(const Value& value) { return value.IsUint(); }
+  static uint64_t Get(const Value& value) {
+    return value.GetUint().NativeValue();
+  }
+  static Value Wrap(uint64_t value) { return cel::UintValue(value); }
+};
+
+template <>
+struct TypedOperand<double> {
+  static bool Is(const Value& value) { return value.IsDouble(); }
+  static double Get(const Value& value) {
+    return value.GetDouble().NativeValue();
+  }
+  static Value Wrap(double value) { return cel::DoubleValue(value); }
+};
+
+template <typename T>
+Value FromChecked(absl::StatusOr<T> result) {
+  if (!result.ok()) {
+    return cel::ErrorValue(std::move(result).status());
+  }
+  return TypedOperand<T>::Wrap(*result);
+}
+
+// Arithmetic operators matching the standard overloads in
+// runtime/standard/arithmetic_functions.cc: integer operations report
+// overflow and division by zero as errors, double operations follow IEEE 754.
+struct TypedAdd {
+  template <typename T>
+  Value operator()(T lhs, T rhs) const {
+    if constexpr (std::is_floating_point_v<T>) {
+      return cel::DoubleValue(lhs + rhs);
+    } else {
+      return FromChecked(cel::internal::CheckedAdd(lhs, rhs));
+    }
+  }
+};
+
+struct TypedSubtract {
+  template <typename T>
+  Value operator()(T lhs, T rhs) const {
+    if constexpr (std::is_floating_point_v<T>) {
+      return cel::DoubleValue(lhs - rhs);
+    } else {
+      return FromChecked(cel::internal::CheckedSub(lhs, rhs));
+    }
+  }
+};
+
+struct TypedMultiply {
+  template <typename T>
+  Value operator()(T lhs, T rhs) const {
+    if constexpr (std::is_floating_point_v<T>) {
+      return cel::DoubleValue(lhs * rhs);
+    } else {
+      return FromChecked(cel::internal::CheckedMul(lhs, rhs));
+    }
+  }
+};
+
+struct TypedDivide {
+  template <typename T>
+  Value operator()(T lhs, T rhs) const {
+    if constexpr (std::is_floating_point_v<T>) {
+      return cel::DoubleValue(lhs / rhs);
+    } else {
+      return FromChecked(cel::internal::CheckedDiv(lhs, rhs));
+    }
+  }
+};
+
+struct TypedModulo {
+  template <typename T>
+  Value operator()(T lhs, T rhs) const {
+    static_assert(!std::is_floating_point_v<T>, "no modulo for double");
+    return FromChecked(cel::internal::CheckedMod(lhs, rhs));
+  }
+};
+
+template <typename Compare>
+struct TypedComparison {
+  template <typename T>
+  Value operator()(T lhs, T rhs) const {
+    return cel::BoolValue(Compare()(lhs, rhs));
+  }
+};
+
+// Function step for a builtin binary operator whose operands the type checker
+// proved to be `T`.
+//
+// Applies `Op` directly when both operands evaluate to `T`, skipping overload
+// resolution. Anything else (errors, unknowns or values that don't match the
+// checked type) is handled by the resolved overloads as usual.
+template <typename T, typename Op>
+class TypedBinaryFunctionStep final
+    : public DirectFunctionStepImpl<StaticResolver> {
+ public:
+  using DirectFunctionStepImpl<StaticResolver>::DirectFunctionStepImpl;
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, cel::Value& result,
+                        AttributeTrail& trail) const override {
+    Value lhs;
+    Value rhs;
+    AttributeTrail lhs_trail;
+    AttributeTrail rhs_trail;
+    CEL_RETURN_IF_ERROR(arg_steps_[0]->Evaluate(frame, lhs, lhs_trail));
+    CEL_RETURN_IF_ERROR(arg_steps_[1]->Evaluate(frame, rhs, rhs_trail));
+
+    if (TypedOperand<T>::Is(lhs) && TypedOperand<T>::Is(rhs) &&
+        (!frame.unknown_processing_enabled() ||
+         (lhs_trail.empty() && rhs_trail.empty()))) {
+      result = Op()(TypedOperand<T>::Get(lhs), TypedOperand<T>::Get(rhs));
+      return absl::OkStatus();
+    }
+
+    absl::InlinedVector<Value, 2> args;
+    args.push_back(std::move(lhs));
+    args.push_back(std::move(rhs));
+    AttributeTrail arg_trails[] = {std::move(lhs_trail), std::move(rhs_trail)};
+    return Apply(frame, args, arg_trails, result);
+  }
+};
+
+// Builtin binary operators with a typed fast path. _==_ and _!=_ are planned as
+// equality steps instead (see CreateDirectTypedEqualityStep).
+enum class TypedOperator {
+  kAdd,
+  kSubtract,
+  kMultiply,
+  kDivide,
+  kModulo,
+  kLess,
+  kLessOrEqual,
+  kGreater,
+  kGreaterOrEqual,
+};
+
+absl::optional<TypedOperator> GetTypedOperator(absl::string_view function) {
+  if (function == cel::builtin::kAdd) return TypedOperator::kAdd;
+  if (function == cel::builtin::kSubtract) return TypedOperator::kSubtract;
+  if (function == cel::builtin::kMultiply) return TypedOperator::kMultiply;
+  if (function == cel::builtin::kDivide) return TypedOperator::kDivide;
+  if (function == cel::builtin::kModulo) return TypedOperator::kModulo;
+  if (function == cel::builtin::kLess) return TypedOperator::kLess;
+  if (function == cel::builtin::kLessOrEqual) {
+    return TypedOperator::kLessOrEqual;
+  }
+  if (function == cel::builtin::kGreater) return TypedOperator::kGreater;
+  if (function == cel::builtin::kGreaterOrEqual) {
+    return TypedOperator::kGreaterOrEqual;
+  }
+  return absl::nullopt;
+}
+
+template <typename T>
+std::unique_ptr<DirectExpressionStep> CreateTypedBinaryFunctionStep(
+    TypedOperator op, int64_t expr_id, const std::string& name,
+    std::vector<std::unique_ptr<DirectExpressionStep>> deps,
+    StaticResolver&& resolver) {
+  switch (op) {
+    case TypedOperator::kAdd:
+      return std::make_unique<TypedBinaryFunctionStep<T, TypedAdd>>(
+          expr_id, name, std::move(deps), std::move(resolver));
+    case TypedOperator::kSubtract:
+      return std::make_unique<TypedBinaryFunctionStep<T, TypedSubtract>>(
+          expr_id, name, std::move(deps), std::move(resolver));
+    case TypedOperator::kMultiply:
+      return std::make_unique<TypedBinaryFunctionStep<T, TypedMultiply>>(
+          expr_id, name, std::move(deps), std::move(resolver));
+    case TypedOperator::kDivide:
+      return std::make_unique<TypedBinaryFunctionStep<T, TypedDivide>>(
+          expr_id, name, std::move(deps), std::move(resolver));
+    case TypedOperator::kModulo:
+      if constexpr (!std::is_floating_point_v<T>) {
+        return std::make_unique<TypedBinaryFunctionStep<T, TypedModulo>>(
+            expr_id, name, std::move(deps), std::move(resolver));
+      }
+      break;
+    case TypedOperator::kLess:
+      return std::make_unique<
+          TypedBinaryFunctionStep<T, TypedComparison<std::less<T>>>>(
+          expr_id, name, std::move(deps), std::move(resolver));
+    case TypedOperator::kLessOrEqual:
+      return std::make_unique<
+          TypedBinaryFunctionStep<T, TypedComparison<std::less_equal<T>>>>(
+          expr_id, name, std::move(deps), std::move(resolver));
+    case TypedOperator::kGreater:
+      return std::make_unique<
+          TypedBinaryFunctionStep<T, TypedComparison<std::greater<T>>>>(
+          expr_id, name, std::move(deps), std::move(resolver));
+    case TypedOperator::kGreaterOrEqual:
+      return std::make_unique<
+          TypedBinaryFunctionStep<T, TypedComparison<std::greater_equal<T>>>>(
+          expr_id, name, std::move(deps), std::move(resolver));
+  }
+  return nullptr;
+}
+
 }  // namespace
 
 std::unique_ptr<DirectExpressionStep> CreateDirectFunctionStep(
@@ -482,6 +750,57 @@ std::unique_ptr<DirectExpressionStep> CreateDirectFunctionStep(
       StaticResolver(std::move(overloads)));
 }
 
+std::unique_ptr<DirectExpressionStep> CreateDirectParallelFunctionStep(
+    int64_t expr_id, const cel::CallExpr& call,
+    std::vector<std::unique_ptr<DirectExpressionStep>> deps,
+    std::vector<cel::FunctionOverloadReference> overloads,
+    absl::Span<const bool> concurrent_args,
+    std::shared_ptr<cel::Executor> executor) {
+  return std::make_unique<ParallelDirectFunctionStep>(
+      expr_id, call.function(), std::move(deps),
+      StaticResolver(std::move(overloads)), concurrent_args,
+      std::move(executor));
+}
+
+bool HasTypedBinaryFunctionStep(absl::string_view function,
+                                cel::Kind operand_kind) {
+  absl::optional<TypedOperator> op = GetTypedOperator(function);
+  if (!op.has_value()) {
+    return false;
+  }
+  switch (operand_kind) {
+    case cel::Kind::kInt:
+    case cel::Kind::kUint:
+      return true;
+    case cel::Kind::kDouble:
+      return *op != TypedOperator::kModulo;
+    default:
+      return false;
+  }
+}
+
+std::unique_ptr<DirectExpressionStep> CreateDirectTypedBinaryFunctionStep(
+    int64_t expr_id, const cel::CallExpr& call,
+    std::vector<std::unique_ptr<DirectExpressionStep>> deps,
+    std::vector<cel::FunctionOverloadReference> overloads,
+    cel::Kind operand_kind) {
+  ABSL_DCHECK(HasTypedBinaryFunctionStep(call.function(), operand_kind));
+  ABSL_DCHECK(deps.size() == 2);
+  TypedOperator op = *GetTypedOperator(call.function());
+  StaticResolver resolver(std::move(overloads));
+  switch (operand_kind) {
+    case cel::Kind::kInt:
+      return CreateTypedBinaryFunctionStep<int64_t>(
+          op, expr_id, call.function(), std::move(deps), std::move(resolver));
+    case cel::Kind::kUint:
+      return CreateTypedBinaryFunctionStep<uint64_t>(
+          op, expr_id, call.function(), std::move(deps), std::move(resolver));
+    default:
+      return CreateTypedBinaryFunctionStep<double>(
+          op, expr_id, call.function(), std::move(deps), std::move(resolver));
+  }
+}
+
 std::unique_ptr<DirectExpressionStep> CreateDirectLazyFunctionStep(
     int64_t expr_id, const cel::CallExpr& call,
     std::vector<std::unique_ptr<DirectExpressionStep>> deps,
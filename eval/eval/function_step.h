@@ -6,9 +6,13 @@
 #include <vector>
 
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "common/expr.h"
+#include "common/kind.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
+#include "runtime/executor.h"
 #include "runtime/function_overload_reference.h"
 #include "runtime/function_registry.h"
 
@@ -22,6 +26,34 @@ std::unique_ptr<DirectExpressionStep> CreateDirectFunctionStep(
     std::vector<std::unique_ptr<DirectExpressionStep>> deps,
     std::vector<cel::FunctionOverloadReference> overloads);
 
+// Factory method for Call-based execution step where the function has been
+// statically resolved from a set of eagerly functions configured in the
+// CelFunctionRegistry. Arguments flagged in `concurrent_args` are evaluated
+// concurrently on `executor`.
+std::unique_ptr<DirectExpressionStep> CreateDirectParallelFunctionStep(
+    int64_t expr_id, const cel::CallExpr& call,
+    std::vector<std::unique_ptr<DirectExpressionStep>> deps,
+    std::vector<cel::FunctionOverloadReference> overloads,
+    absl::Span<const bool> concurrent_args,
+    std::shared_ptr<cel::Executor> executor);
+
+// Returns whether CreateDirectTypedBinaryFunctionStep has a fast path for the
+// builtin `function` applied to two operands of `operand_kind`.
+bool HasTypedBinaryFunctionStep(absl::string_view function,
+                                cel::Kind operand_kind);
+
+// Factory method for a builtin arithmetic or comparison operator whose operands
+// the type checker proved to be `operand_kind`. The operator is applied
+// directly when both operands evaluate to the checked type, otherwise the call
+// is dispatched to `overloads` as in CreateDirectFunctionStep.
+//
+// Requires HasTypedBinaryFunctionStep(call.function(), operand_kind).
+std::unique_ptr<DirectExpressionStep> CreateDirectTypedBinaryFunctionStep(
+    int64_t expr_id, const cel::CallExpr& call,
+    std::vector<std::unique_ptr<DirectExpressionStep>> deps,
+    std::vector<cel::FunctionOverloadReference> overloads,
+    cel::Kind operand_kind);
+
 // Factory method for Call-based execution step where the function has been
 // statically resolved from a set of lazy functions configured in the
 // CelFunctionRegistry.
@@ -2,6 +2,7 @@
 
 #include <cmath>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -1183,5 +1184,128 @@ TEST_F(DirectFunctionStepTest, NoOverload0Args) {
   EXPECT_THAT(value, Truly(CheckNoMatchingOverloadError));
 }
 
+TEST_F(DirectFunctionStepTest, TypedBinaryCall) {
+  CallExpr call;
+  call.set_function(cel::builtin::kMultiply);
+  call.mutable_args().emplace_back();
+  call.mutable_args().emplace_back();
+
+  auto expr = CreateDirectTypedBinaryFunctionStep(
+      -1, call,
+      MakeDeps(CreateConstValueDirectStep(cel::IntValue(6)),
+               CreateConstValueDirectStep(cel::IntValue(7))),
+      GetOverloads(cel::builtin::kMultiply, 2), cel::Kind::kInt);
+
+  auto plan = CreateExpressionImpl(options_, std::move(expr));
+
+  Activation activation;
+  ASSERT_OK_AND_ASSIGN(auto value, plan->Evaluate(activation, &arena_));
+
+  EXPECT_THAT(value, test::IsCelInt64(42));
+}
+
+TEST_F(DirectFunctionStepTest, TypedBinaryComparison) {
+  CallExpr call;
+  call.set_function(cel::builtin::kLessOrEqual);
+  call.mutable_args().emplace_back();
+  call.mutable_args().emplace_back();
+
+  auto expr = CreateDirectTypedBinaryFunctionStep(
+      -1, call,
+      MakeDeps(CreateConstValueDirectStep(cel::DoubleValue(1.5)),
+               CreateConstValueDirectStep(cel::DoubleValue(1.5))),
+      GetOverloads(cel::builtin::kLessOrEqual, 2), cel::Kind::kDouble);
+
+  auto plan = CreateExpressionImpl(options_, std::move(expr));
+
+  Activation activation;
+  ASSERT_OK_AND_ASSIGN(auto value, plan->Evaluate(activation, &arena_));
+
+  EXPECT_THAT(value, test::IsCelBool(true));
+}
+
+TEST_F(DirectFunctionStepTest, TypedBinaryCallOverflow) {
+  CallExpr call;
+  call.set_function(cel::builtin::kAdd);
+  call.mutable_args().emplace_back();
+  call.mutable_args().emplace_back();
+
+  auto expr = CreateDirectTypedBinaryFunctionStep(
+      -1, call,
+      MakeDeps(CreateConstValueDirectStep(
+                   cel::UintValue(std::numeric_limits<uint64_t>::max())),
+               CreateConstValueDirectStep(cel::UintValue(1))),
+      GetOverloads(cel::builtin::kAdd, 2), cel::Kind::kUint);
+
+  auto plan = CreateExpressionImpl(options_, std::move(expr));
+
+  Activation activation;
+  ASSERT_OK_AND_ASSIGN(auto value, plan->Evaluate(activation, &arena_));
+
+  EXPECT_THAT(value,
+              test::IsCelError(StatusIs(absl::StatusCode::kOutOfRange,
+                                        testing::HasSubstr("overflow"))));
+}
+
+TEST_F(DirectFunctionStepTest, TypedBinaryCallFallsBackOnUncheckedType) {
+  CallExpr call;
+  call.set_function(cel::builtin::kAdd);
+  call.mutable_args().emplace_back();
+  call.mutable_args().emplace_back();
+
+  // Operands that don't match the checked kind are dispatched to the
+  // overloads.
+  auto expr = CreateDirectTypedBinaryFunctionStep(
+      -1, call,
+      MakeDeps(CreateConstValueDirectStep(cel::DoubleValue(1.5)),
+               CreateConstValueDirectStep(cel::DoubleValue(1))),
+      GetOverloads(cel::builtin::kAdd, 2), cel::Kind::kInt);
+
+  auto plan = CreateExpressionImpl(options_, std::move(expr));
+
+  Activation activation;
+  ASSERT_OK_AND_ASSIGN(auto value, plan->Evaluate(activation, &arena_));
+
+  EXPECT_THAT(value, test::IsCelDouble(2.5));
+}
+
+TEST_F(DirectFunctionStepTest, TypedBinaryCallNoOverload) {
+  CallExpr call;
+  call.set_function(cel::builtin::kAdd);
+  call.mutable_args().emplace_back();
+  call.mutable_args().emplace_back();
+
+  auto expr = CreateDirectTypedBinaryFunctionStep(
+      -1, call,
+      MakeDeps(CreateConstValueDirectStep(cel::IntValue(1)),
+               CreateConstValueDirectStep(cel::StringValue("2"))),
+      GetOverloads(cel::builtin::kAdd, 2), cel::Kind::kInt);
+
+  auto plan = CreateExpressionImpl(options_, std::move(expr));
+
+  Activation activation;
+  ASSERT_OK_AND_ASSIGN(auto value, plan->Evaluate(activation, &arena_));
+
+  EXPECT_THAT(value, Truly(CheckNoMatchingOverloadError));
+}
+
+TEST(TypedBinaryFunctionStepTest, HasTypedBinaryFunctionStep) {
+  EXPECT_TRUE(HasTypedBinaryFunctionStep(cel::builtin::kAdd, cel::Kind::kInt));
+  EXPECT_TRUE(
+      HasTypedBinaryFunctionStep(cel::builtin::kModulo, cel::Kind::kUint));
+  EXPECT_TRUE(
+      HasTypedBinaryFunctionStep(cel::builtin::kLess, cel::Kind::kDouble));
+  EXPECT_FALSE(
+      HasTypedBinaryFunctionStep(cel::builtin::kModulo, cel::Kind::kDouble));
+  EXPECT_FALSE(
+      HasTypedBinaryFunctionStep(cel::builtin::kAdd, cel::Kind::kString));
+  EXPECT_FALSE(HasTypedBinaryFunctionStep("max", cel::Kind::kInt));
+  // Equality is planned as an equality step.
+  EXPECT_FALSE(
+      HasTypedBinaryFunctionStep(cel::builtin::kEqual, cel::Kind::kInt));
+  EXPECT_FALSE(
+      HasTypedBinaryFunctionStep(cel::builtin::kInequal, cel::Kind::kInt));
+}
+
 }  // namespace
 }  // namespace google::api::expr::runtime
@@ -11,7 +11,9 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "common/expr.h"
+#include "common/native_type.h"
 #include "common/value.h"
 #include "eval/eval/attribute_trail.h"
 #include "eval/eval/comprehension_slots.h"
@@ -19,6 +21,7 @@
 #include "eval/eval/evaluator_core.h"
 #include "eval/eval/expression_step_base.h"
 #include "eval/internal/errors.h"
+#include "internal/casts.h"
 #include "internal/status_macros.h"
 
 namespace google::api::expr::runtime {
@@ -106,6 +109,12 @@ class SlotStep : public ExpressionStepBase {
     return absl::OkStatus();
   }
 
+  cel::NativeTypeId GetNativeTypeId() const override {
+    return cel::NativeTypeId::For<SlotStep>();
+  }
+
+  size_t slot_index() const { return slot_index_; }
+
  private:
   std::string name_;
 
@@ -173,4 +182,11 @@ absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateIdentStepForSlot(
   return std::make_unique<SlotStep>(ident_expr.name(), slot_index, expr_id);
 }
 
+absl::optional<size_t> GetIdentStepSlotIndex(const ExpressionStep& step) {
+  if (step.GetNativeTypeId() != cel::NativeTypeId::For<SlotStep>()) {
+    return absl::nullopt;
+  }
+  return cel::internal::down_cast<const SlotStep&>(step).slot_index();
+}
+
 }  // namespace google::api::expr::runtime
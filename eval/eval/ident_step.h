@@ -1,11 +1,13 @@
 #ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_IDENT_STEP_H_
 #define THIRD_PARTY_CEL_CPP_EVAL_EVAL_IDENT_STEP_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "common/expr.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
@@ -26,6 +28,10 @@ absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateIdentStep(
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateIdentStepForSlot(
     const cel::IdentExpr& ident_expr, size_t slot_index, int64_t expr_id);
 
+// Returns the slot index read by `step` if it was created by
+// CreateIdentStepForSlot. Returns nullopt otherwise.
+absl::optional<size_t> GetIdentStepSlotIndex(const ExpressionStep& step);
+
 }  // namespace google::api::expr::runtime
 
 #endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_IDENT_STEP_H_
@@ -21,8 +21,11 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/optional.h"
+#include "common/native_type.h"
 #include "common/value.h"
+#include "eval/eval/evaluator_core.h"
 #include "eval/internal/errors.h"
+#include "internal/casts.h"
 
 namespace google::api::expr::runtime {
 
@@ -43,6 +46,10 @@ class JumpStep : public JumpStepBase {
   absl::Status Evaluate(ExecutionFrame* frame) const override {
     return Jump(frame);
   }
+
+  cel::NativeTypeId GetNativeTypeId() const override {
+    return cel::NativeTypeId::For<JumpStep>();
+  }
 };
 
 class CondJumpStep : public JumpStepBase {
@@ -75,6 +82,14 @@ class CondJumpStep : public JumpStepBase {
     return absl::OkStatus();
   }
 
+  cel::NativeTypeId GetNativeTypeId() const override {
+    return cel::NativeTypeId::For<CondJumpStep>();
+  }
+
+  bool jump_condition() const { return jump_condition_; }
+
+  bool leave_on_stack() const { return leave_on_stack_; }
+
  private:
   const bool jump_condition_;
   const bool leave_on_stack_;
@@ -144,4 +159,26 @@ std::unique_ptr<JumpStepBase> CreateBoolCheckJumpStep(
   return std::make_unique<BoolCheckJumpStep>(jump_offset, expr_id);
 }
 
+absl::optional<JumpStepOperands> GetJumpStepOperands(
+    const ExpressionStep& step) {
+  if (step.GetNativeTypeId() == cel::NativeTypeId::For<JumpStep>()) {
+    const auto& jump_step = cel::internal::down_cast<const JumpStep&>(step);
+    if (!jump_step.jump_offset().has_value()) {
+      return absl::nullopt;
+    }
+    return JumpStepOperands{/*conditional=*/false, /*jump_condition=*/false,
+                            /*leave_on_stack=*/false, *jump_step.jump_offset()};
+  }
+  if (step.GetNativeTypeId() == cel::NativeTypeId::For<CondJumpStep>()) {
+    const auto& jump_step = cel::internal::down_cast<const CondJumpStep&>(step);
+    if (!jump_step.jump_offset().has_value()) {
+      return absl::nullopt;
+    }
+    return JumpStepOperands{/*conditional=*/true, jump_step.jump_condition(),
+                            jump_step.leave_on_stack(),
+                            *jump_step.jump_offset()};
+  }
+  return absl::nullopt;
+}
+
 }  // namespace google::api::expr::runtime
@@ -33,6 +33,8 @@ class JumpStepBase : public ExpressionStepBase {
 
   void set_jump_offset(int offset) { jump_offset_ = offset; }
 
+  absl::optional<int> jump_offset() const { return jump_offset_; }
+
   absl::Status Jump(ExecutionFrame* frame) const {
     if (!jump_offset_.has_value()) {
       return absl::Status(absl::StatusCode::kInternal, "Jump offset not set");
@@ -63,6 +65,20 @@ std::unique_ptr<JumpStepBase> CreateCondJumpStep(
 std::unique_ptr<JumpStepBase> CreateBoolCheckJumpStep(
     absl::optional<int> jump_offset, int64_t expr_id);
 
+// Operands of a jump step, used when lowering an ExecutionPath.
+struct JumpStepOperands {
+  // False for an unconditional jump.
+  bool conditional;
+  bool jump_condition;
+  bool leave_on_stack;
+  int offset;
+};
+
+// Returns the operands of `step` if it was created by CreateJumpStep or
+// CreateCondJumpStep and has a jump offset set. Returns nullopt otherwise.
+absl::optional<JumpStepOperands> GetJumpStepOperands(
+    const ExpressionStep& step);
+
 }  // namespace google::api::expr::runtime
 
 #endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_JUMP_STEP_H_
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -17,8 +18,10 @@
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 #include "eval/eval/expression_step_base.h"
+#include "eval/eval/parallel_evaluation.h"
 #include "eval/internal/errors.h"
 #include "internal/status_macros.h"
+#include "runtime/executor.h"
 #include "runtime/internal/errors.h"
 
 namespace google::api::expr::runtime {
@@ -94,44 +97,116 @@ class ExhaustiveDirectLogicStep : public DirectExpressionStep {
   absl::Status Evaluate(ExecutionFrameBase& frame, cel::Value& result,
                         AttributeTrail& attribute_trail) const override;
 
+  absl::optional<std::vector<const DirectExpressionStep*>> GetDependencies()
+      const override {
+    return std::vector<const DirectExpressionStep*>{lhs_.get(), rhs_.get()};
+  }
+
+  absl::optional<std::vector<std::unique_ptr<DirectExpressionStep>>>
+  ExtractDependencies() override {
+    std::vector<std::unique_ptr<DirectExpressionStep>> dependencies;
+    dependencies.push_back(std::move(lhs_));
+    dependencies.push_back(std::move(rhs_));
+    return dependencies;
+  }
+
  private:
   std::unique_ptr<DirectExpressionStep> lhs_;
   std::unique_ptr<DirectExpressionStep> rhs_;
   OpType op_type_;
 };
 
+// Shared logic for combining the results of both operands once both have been
+// evaluated.
+absl::Status CombineLogicResults(ExecutionFrameBase& frame, OpType op_type,
+                                 Value& lhs_result, Value& rhs_result,
+                                 AttributeTrail& attribute_trail,
+                                 AttributeTrail& rhs_attr) {
+  if (lhs_result.kind() == ValueKind::kBool) {
+    bool lhs_bool = Cast<BoolValue>(lhs_result).NativeValue();
+    if ((op_type == OpType::kOr && lhs_bool) ||
+        (op_type == OpType::kAnd && !lhs_bool)) {
+      return absl::OkStatus();
+    }
+  }
+
+  if (rhs_result.kind() == ValueKind::kBool) {
+    bool rhs_bool = Cast<BoolValue>(rhs_result).NativeValue();
+    if ((op_type == OpType::kOr && rhs_bool) ||
+        (op_type == OpType::kAnd && !rhs_bool)) {
+      lhs_result = std::move(rhs_result);
+      attribute_trail = std::move(rhs_attr);
+      return absl::OkStatus();
+    }
+  }
+
+  return ReturnLogicResult(frame, op_type, lhs_result, rhs_result,
+                           attribute_trail, rhs_attr);
+}
+
 absl::Status ExhaustiveDirectLogicStep::Evaluate(
     ExecutionFrameBase& frame, cel::Value& result,
     AttributeTrail& attribute_trail) const {
   CEL_RETURN_IF_ERROR(lhs_->Evaluate(frame, result, attribute_trail));
-  ValueKind lhs_kind = result.kind();
 
   Value rhs_result;
   AttributeTrail rhs_attr;
   CEL_RETURN_IF_ERROR(rhs_->Evaluate(frame, rhs_result, attribute_trail));
 
-  ValueKind rhs_kind = rhs_result.kind();
-  if (lhs_kind == ValueKind::kBool) {
-    bool lhs_bool = Cast<BoolValue>(result).NativeValue();
-    if ((op_type_ == OpType::kOr && lhs_bool) ||
-        (op_type_ == OpType::kAnd && !lhs_bool)) {
-      return absl::OkStatus();
-    }
+  return CombineLogicResults(frame, op_type_, result, rhs_result,
+                             attribute_trail, rhs_attr);
+}
+
+// Evaluates both operands concurrently on an executor.
+//
+// Both operands are always evaluated, so the result matches the exhaustive
+// (non-short-circuiting) evaluation, which CEL guarantees is the same as the
+// short-circuiting one for side-effect free operands.
+class ParallelDirectLogicStep : public DirectExpressionStep {
+ public:
+  ParallelDirectLogicStep(std::unique_ptr<DirectExpressionStep> lhs,
+                          std::unique_ptr<DirectExpressionStep> rhs,
+                          OpType op_type, int64_t expr_id,
+                          std::shared_ptr<cel::Executor> executor)
+      : DirectExpressionStep(expr_id),
+        op_type_(op_type),
+        executor_(std::move(executor)) {
+    operands_[0] = std::move(lhs);
+    operands_[1] = std::move(rhs);
   }
 
-  if (rhs_kind == ValueKind::kBool) {
-    bool rhs_bool = Cast<BoolValue>(rhs_result).NativeValue();
-    if ((op_type_ == OpType::kOr && rhs_bool) ||
-        (op_type_ == OpType::kAnd && !rhs_bool)) {
-      result = std::move(rhs_result);
-      attribute_trail = std::move(rhs_attr);
-      return absl::OkStatus();
-    }
+  absl::Status Evaluate(ExecutionFrameBase& frame, cel::Value& result,
+                        AttributeTrail& attribute_trail) const override {
+    static constexpr bool kConcurrent[2] = {true, true};
+    Value results[2];
+    AttributeTrail attributes[2];
+    CEL_RETURN_IF_ERROR(EvaluateConcurrently(frame, *executor_, operands_,
+                                             kConcurrent, results, attributes));
+    result = std::move(results[0]);
+    attribute_trail = std::move(attributes[0]);
+    return CombineLogicResults(frame, op_type_, result, results[1],
+                               attribute_trail, attributes[1]);
   }
 
-  return ReturnLogicResult(frame, op_type_, result, rhs_result, attribute_trail,
-                           rhs_attr);
-}
+  absl::optional<std::vector<const DirectExpressionStep*>> GetDependencies()
+      const override {
+    return std::vector<const DirectExpressionStep*>{operands_[0].get(),
+                                                    operands_[1].get()};
+  }
+
+  absl::optional<std::vector<std::unique_ptr<DirectExpressionStep>>>
+  ExtractDependencies() override {
+    std::vector<std::unique_ptr<DirectExpressionStep>> dependencies;
+    dependencies.push_back(std::move(operands_[0]));
+    dependencies.push_back(std::move(operands_[1]));
+    return dependencies;
+  }
+
+ private:
+  std::unique_ptr<DirectExpressionStep> operands_[2];
+  OpType op_type_;
+  std::shared_ptr<cel::Executor> executor_;
+};
 
 class DirectLogicStep : public DirectExpressionStep {
  public:
@@ -146,6 +221,19 @@ class DirectLogicStep : public DirectExpressionStep {
   absl::Status Evaluate(ExecutionFrameBase& frame, cel::Value& result,
                         AttributeTrail& attribute_trail) const override;
 
+  absl::optional<std::vector<const DirectExpressionStep*>> GetDependencies()
+      const override {
+    return std::vector<const DirectExpressionStep*>{lhs_.get(), rhs_.get()};
+  }
+
+  absl::optional<std::vector<std::unique_ptr<DirectExpressionStep>>>
+  ExtractDependencies() override {
+    std::vector<std::unique_ptr<DirectExpressionStep>> dependencies;
+    dependencies.push_back(std::move(lhs_));
+    dependencies.push_back(std::move(rhs_));
+    return dependencies;
+  }
+
  private:
   std::unique_ptr<DirectExpressionStep> lhs_;
   std::unique_ptr<DirectExpressionStep> rhs_;
@@ -282,6 +370,14 @@ std::unique_ptr<DirectExpressionStep> CreateDirectLogicStep(
   }
 }
 
+std::unique_ptr<DirectExpressionStep> CreateDirectParallelLogicStep(
+    std::unique_ptr<DirectExpressionStep> lhs,
+    std::unique_ptr<DirectExpressionStep> rhs, int64_t expr_id, OpType op_type,
+    std::shared_ptr<cel::Executor> executor) {
+  return std::make_unique<ParallelDirectLogicStep>(
+      std::move(lhs), std::move(rhs), op_type, expr_id, std::move(executor));
+}
+
 class DirectNotStep : public DirectExpressionStep {
  public:
   explicit DirectNotStep(std::unique_ptr<DirectExpressionStep> operand,
@@ -451,6 +547,22 @@ std::unique_ptr<DirectExpressionStep> CreateDirectOrStep(
                                OpType::kOr, shortcircuiting);
 }
 
+std::unique_ptr<DirectExpressionStep> CreateDirectParallelAndStep(
+    std::unique_ptr<DirectExpressionStep> lhs,
+    std::unique_ptr<DirectExpressionStep> rhs, int64_t expr_id,
+    std::shared_ptr<cel::Executor> executor) {
+  return CreateDirectParallelLogicStep(std::move(lhs), std::move(rhs), expr_id,
+                                       OpType::kAnd, std::move(executor));
+}
+
+std::unique_ptr<DirectExpressionStep> CreateDirectParallelOrStep(
+    std::unique_ptr<DirectExpressionStep> lhs,
+    std::unique_ptr<DirectExpressionStep> rhs, int64_t expr_id,
+    std::shared_ptr<cel::Executor> executor) {
+  return CreateDirectParallelLogicStep(std::move(lhs), std::move(rhs), expr_id,
+                                       OpType::kOr, std::move(executor));
+}
+
 // Factory method for "And" Execution step
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateAndStep(int64_t expr_id) {
   return std::make_unique<LogicalOpStep>(OpType::kAnd, expr_id);
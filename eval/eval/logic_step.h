@@ -7,6 +7,7 @@
 #include "absl/status/statusor.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
+#include "runtime/executor.h"
 
 namespace google::api::expr::runtime {
 
@@ -22,6 +23,20 @@ std::unique_ptr<DirectExpressionStep> CreateDirectOrStep(
     std::unique_ptr<DirectExpressionStep> rhs, int64_t expr_id,
     bool shortcircuiting);
 
+// Factory method for recursive "And" Execution step that evaluates both
+// operands concurrently on `executor`.
+std::unique_ptr<DirectExpressionStep> CreateDirectParallelAndStep(
+    std::unique_ptr<DirectExpressionStep> lhs,
+    std::unique_ptr<DirectExpressionStep> rhs, int64_t expr_id,
+    std::shared_ptr<cel::Executor> executor);
+
+// Factory method for recursive "Or" Execution step that evaluates both
+// operands concurrently on `executor`.
+std::unique_ptr<DirectExpressionStep> CreateDirectParallelOrStep(
+    std::unique_ptr<DirectExpressionStep> lhs,
+    std::unique_ptr<DirectExpressionStep> rhs, int64_t expr_id,
+    std::shared_ptr<cel::Executor> executor);
+
 // Factory method for "And" Execution step
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateAndStep(int64_t expr_id);
 
@@ -0,0 +1,209 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/parallel_evaluation.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/fixed_array.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "common/value.h"
+#include "eval/eval/attribute_trail.h"
+#include "eval/eval/comprehension_slots.h"
+#include "eval/eval/direct_expression_step.h"
+#include "eval/eval/evaluator_core.h"
+#include "runtime/executor.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+// State shared between the evaluating thread and the tasks scheduled on the
+// executor.
+//
+// Reference counted since a task may only get to run after the evaluation that
+// scheduled it has returned, in which case it finds its branch already claimed
+// and does nothing.
+class ConcurrentEvaluation {
+ public:
+  ConcurrentEvaluation(ExecutionFrameBase& frame, size_t size)
+      : frame_(frame), branches_(size) {}
+
+  // Prepare the branch at `index` for concurrent evaluation. Must be called
+  // before the branch is scheduled.
+  void Prepare(size_t index, const DirectExpressionStep* step,
+               cel::Value* result, AttributeTrail* attribute) {
+    Branch& branch = branches_[index];
+    branch.step = step;
+    branch.result = result;
+    branch.attribute = attribute;
+
+    // Copy the visible comprehension variables so that lazily initialized
+    // bindings evaluated in the branch don't race with the caller's frame.
+    ComprehensionSlots& source = frame_.comprehension_slots();
+    ComprehensionSlots& slots = branch.slots.emplace(source.size());
+    for (size_t i = 0; i < source.size(); ++i) {
+      const ComprehensionSlots::Slot* slot = source.Get(i);
+      if (slot->Has()) {
+        slots.Set(i, slot->value(), slot->attribute());
+      }
+    }
+
+    absl::MutexLock lock(&mutex_);
+    ++pending_;
+  }
+
+  // Evaluate the branch at `index` unless another thread already claimed it.
+  void RunIfUnclaimed(size_t index) {
+    Branch& branch = branches_[index];
+    if (branch.claimed.exchange(true, std::memory_order_acq_rel)) {
+      return;
+    }
+    ExecutionFrameBase frame(frame_.activation(), EvaluationListener(),
+                             frame_.options(), frame_.type_provider(),
+                             frame_.descriptor_pool(), frame_.message_factory(),
+                             frame_.arena(), *branch.slots);
+    frame.set_shared_iterations(frame_.shared_iterations());
+    branch.status = branch.step->Evaluate(frame, *branch.result,
+                                          *branch.attribute);
+    Complete();
+  }
+
+  // Skip the branch at `index` unless another thread already claimed it.
+  void CancelIfUnclaimed(size_t index) {
+    if (branches_[index].claimed.exchange(true, std::memory_order_acq_rel)) {
+      return;
+    }
+    Complete();
+  }
+
+  // Block until every prepared branch has completed or was cancelled.
+  void Wait() {
+    absl::MutexLock lock(&mutex_);
+    mutex_.Await(absl::Condition(this, &ConcurrentEvaluation::Done));
+  }
+
+  absl::Status& status(size_t index) { return branches_[index].status; }
+
+  // Iteration counter shared by the caller's frame and the branches, unless
+  // the caller's frame already shares one.
+  std::atomic<int>& iterations() { return iterations_; }
+
+ private:
+  struct Branch {
+    const DirectExpressionStep* step = nullptr;
+    cel::Value* result = nullptr;
+    AttributeTrail* attribute = nullptr;
+    absl::optional<ComprehensionSlots> slots;
+    absl::Status status;
+    std::atomic<bool> claimed{false};
+  };
+
+  void Complete() {
+    absl::MutexLock lock(&mutex_);
+    --pending_;
+  }
+
+  bool Done() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return pending_ == 0;
+  }
+
+  ExecutionFrameBase& frame_;
+  absl::FixedArray<Branch> branches_;
+  absl::Mutex mutex_;
+  size_t pending_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::atomic<int> iterations_{0};
+};
+
+}  // namespace
+
+absl::Status EvaluateConcurrently(
+    ExecutionFrameBase& frame, cel::Executor& executor,
+    absl::Span<const std::unique_ptr<DirectExpressionStep>> steps,
+    absl::Span<const bool> concurrent, absl::Span<cel::Value> results,
+    absl::Span<AttributeTrail> attributes) {
+  ABSL_DCHECK_EQ(steps.size(), concurrent.size());
+  ABSL_DCHECK_EQ(steps.size(), results.size());
+  ABSL_DCHECK_EQ(steps.size(), attributes.size());
+
+  if (frame.callback()) {
+    for (size_t i = 0; i < steps.size(); ++i) {
+      absl::Status status =
+          steps[i]->Evaluate(frame, results[i], attributes[i]);
+      if (!status.ok()) {
+        return status;
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  auto evaluation =
+      std::make_shared<ConcurrentEvaluation>(frame, steps.size());
+  // Nested concurrent evaluations keep counting in the outermost counter.
+  const bool owns_iterations = frame.shared_iterations() == nullptr;
+  if (owns_iterations) {
+    frame.ShareIterations(evaluation->iterations());
+  }
+  for (size_t i = 0; i < steps.size(); ++i) {
+    if (concurrent[i]) {
+      evaluation->Prepare(i, steps[i].get(), &results[i], &attributes[i]);
+    }
+  }
+  for (size_t i = 0; i < steps.size(); ++i) {
+    if (concurrent[i]) {
+      executor.Schedule(
+          [evaluation, i]() { evaluation->RunIfUnclaimed(i); });
+    }
+  }
+
+  bool failed = false;
+  for (size_t i = 0; i < steps.size() && !failed; ++i) {
+    if (!concurrent[i]) {
+      absl::Status& status = evaluation->status(i);
+      status = steps[i]->Evaluate(frame, results[i], attributes[i]);
+      failed = !status.ok();
+    }
+  }
+  for (size_t i = 0; i < steps.size(); ++i) {
+    if (!concurrent[i]) {
+      continue;
+    }
+    if (failed) {
+      evaluation->CancelIfUnclaimed(i);
+    } else {
+      evaluation->RunIfUnclaimed(i);
+    }
+  }
+  evaluation->Wait();
+  if (owns_iterations) {
+    frame.UnshareIterations();
+  }
+
+  for (size_t i = 0; i < steps.size(); ++i) {
+    if (absl::Status& status = evaluation->status(i); !status.ok()) {
+      return std::move(status);
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace google::api::expr::runtime
@@ -0,0 +1,57 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_PARALLEL_EVALUATION_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_PARALLEL_EVALUATION_H_
+
+#include <memory>
+
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+#include "common/value.h"
+#include "eval/eval/attribute_trail.h"
+#include "eval/eval/direct_expression_step.h"
+#include "eval/eval/evaluator_core.h"
+#include "runtime/executor.h"
+
+namespace google::api::expr::runtime {
+
+// Evaluates `steps`, assigning to the corresponding elements of `results` and
+// `attributes`.
+//
+// Steps flagged in `concurrent` are scheduled on `executor`. The remaining
+// steps are evaluated in order on the calling thread, after which any
+// concurrent step the executor has not started yet is run inline. The call
+// never blocks on a task that has not started.
+//
+// Concurrent steps are evaluated in their own frame against a copy of the
+// caller's comprehension slots, so they must not declare comprehension
+// variables. The planner only flags steps that satisfy this. The frames share
+// the caller's iteration budget through an atomic counter, so
+// `comprehension_max_iterations` still applies to the evaluation as a whole
+// (e.g. to lazily initialized bindings evaluated in a branch).
+//
+// If the frame has an evaluation listener, all steps are evaluated in order on
+// the calling thread so that callbacks are not invoked concurrently.
+//
+// Returns the first non-ok status in step order.
+absl::Status EvaluateConcurrently(
+    ExecutionFrameBase& frame, cel::Executor& executor,
+    absl::Span<const std::unique_ptr<DirectExpressionStep>> steps,
+    absl::Span<const bool> concurrent, absl::Span<cel::Value> results,
+    absl::Span<AttributeTrail> attributes);
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_PARALLEL_EVALUATION_H_
@@ -19,10 +19,14 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "common/value.h"
 #include "eval/eval/attribute_trail.h"
 #include "eval/eval/direct_expression_step.h"
@@ -30,9 +34,53 @@
 #include "eval/eval/expression_step_base.h"
 #include "internal/status_macros.h"
 #include "re2/re2.h"
+#include "re2/set.h"
 
 namespace google::api::expr::runtime {
 
+class RegexSet final {
+ public:
+  explicit RegexSet(std::vector<std::shared_ptr<const RE2>> programs)
+      : set_(RE2::Options(), RE2::UNANCHORED), programs_(std::move(programs)) {}
+
+  absl::Status Compile() {
+    for (const auto& program : programs_) {
+      std::string error;
+      if (set_.Add(program->pattern(), &error) < 0) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("cannot add pattern to RE2 set: ", error));
+      }
+    }
+    if (!set_.Compile()) {
+      return absl::ResourceExhaustedError("cannot compile RE2 set");
+    }
+    return absl::OkStatus();
+  }
+
+  bool PartialMatch(absl::string_view subject) const {
+    RE2::Set::ErrorInfo error_info;
+    if (set_.Match(subject, /*v=*/nullptr, &error_info)) {
+      return true;
+    }
+    if (error_info.kind == RE2::Set::kNoError) {
+      return false;
+    }
+    // The DFA ran out of memory on this subject, fall back to matching the
+    // patterns one at a time.
+    for (const auto& program : programs_) {
+      if (RE2::PartialMatch(subject, *program)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  RE2::Set set_;
+  // The individual programs, in the order of their patterns in `set_`.
+  const std::vector<std::shared_ptr<const RE2>> programs_;
+};
+
 namespace {
 
 using ::cel::BoolValue;
@@ -57,6 +105,21 @@ struct MatchesVisitor final {
   }
 };
 
+struct SetMatchesVisitor final {
+  const RegexSet& regex_set;
+
+  bool operator()(const absl::Cord& value) const {
+    if (auto flat = value.TryFlat(); flat.has_value()) {
+      return regex_set.PartialMatch(*flat);
+    }
+    return regex_set.PartialMatch(static_cast<std::string>(value));
+  }
+
+  bool operator()(absl::string_view value) const {
+    return regex_set.PartialMatch(value);
+  }
+};
+
 class RegexMatchStep final : public ExpressionStepBase {
  public:
   RegexMatchStep(int64_t expr_id, std::shared_ptr<const RE2> re2)
@@ -113,11 +176,103 @@ class RegexMatchDirectStep final : public DirectExpressionStep {
     return absl::OkStatus();
   }
 
+  absl::optional<std::vector<const DirectExpressionStep*>> GetDependencies()
+      const override {
+    return std::vector<const DirectExpressionStep*>{subject_.get()};
+  }
+
+  absl::optional<std::vector<std::unique_ptr<DirectExpressionStep>>>
+  ExtractDependencies() override {
+    std::vector<std::unique_ptr<DirectExpressionStep>> dependencies;
+    dependencies.push_back(std::move(subject_));
+    return dependencies;
+  }
+
  private:
   std::unique_ptr<DirectExpressionStep> subject_;
   const std::shared_ptr<const RE2> re2_;
 };
 
+// Matches the subject against a set of patterns, in place of a disjunction of
+// `matches` calls on it. Error and unknown subjects are passed through, which
+// is what the disjunction evaluates to for them.
+class RegexSetMatchStep final : public ExpressionStepBase {
+ public:
+  RegexSetMatchStep(int64_t expr_id, std::shared_ptr<const RegexSet> regex_set)
+      : ExpressionStepBase(expr_id, /*comes_from_ast=*/true),
+        regex_set_(std::move(regex_set)) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    if (!frame->value_stack().HasEnough(kNumRegexMatchArguments)) {
+      return absl::Status(absl::StatusCode::kInternal,
+                          "Insufficient arguments supplied for regular "
+                          "expression match");
+    }
+    const auto& subject = frame->value_stack().Peek();
+    if (subject.IsError() || subject.IsUnknown()) {
+      return absl::OkStatus();
+    }
+    if (!subject.IsString()) {
+      return absl::Status(absl::StatusCode::kInternal,
+                          "First argument for regular "
+                          "expression match must be a string");
+    }
+    bool match =
+        subject.GetString().NativeValue(SetMatchesVisitor{*regex_set_});
+    frame->value_stack().PopAndPush(kNumRegexMatchArguments,
+                                    cel::BoolValue(match));
+    return absl::OkStatus();
+  }
+
+ private:
+  const std::shared_ptr<const RegexSet> regex_set_;
+};
+
+class RegexSetMatchDirectStep final : public DirectExpressionStep {
+ public:
+  RegexSetMatchDirectStep(int64_t expr_id,
+                          std::unique_ptr<DirectExpressionStep> subject,
+                          std::shared_ptr<const RegexSet> regex_set)
+      : DirectExpressionStep(expr_id),
+        subject_(std::move(subject)),
+        regex_set_(std::move(regex_set)) {}
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
+                        AttributeTrail& attribute) const override {
+    AttributeTrail subject_attr;
+    CEL_RETURN_IF_ERROR(subject_->Evaluate(frame, result, subject_attr));
+    if (result.IsError() || result.IsUnknown()) {
+      return absl::OkStatus();
+    }
+
+    if (!result.IsString()) {
+      return absl::Status(absl::StatusCode::kInternal,
+                          "First argument for regular "
+                          "expression match must be a string");
+    }
+    bool match =
+        result.GetString().NativeValue(SetMatchesVisitor{*regex_set_});
+    result = BoolValue(match);
+    return absl::OkStatus();
+  }
+
+  absl::optional<std::vector<const DirectExpressionStep*>> GetDependencies()
+      const override {
+    return std::vector<const DirectExpressionStep*>{subject_.get()};
+  }
+
+  absl::optional<std::vector<std::unique_ptr<DirectExpressionStep>>>
+  ExtractDependencies() override {
+    std::vector<std::unique_ptr<DirectExpressionStep>> dependencies;
+    dependencies.push_back(std::move(subject_));
+    return dependencies;
+  }
+
+ private:
+  std::unique_ptr<DirectExpressionStep> subject_;
+  const std::shared_ptr<const RegexSet> regex_set_;
+};
+
 }  // namespace
 
 std::unique_ptr<DirectExpressionStep> CreateDirectRegexMatchStep(
@@ -132,4 +287,23 @@ absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateRegexMatchStep(
   return std::make_unique<RegexMatchStep>(expr_id, std::move(re2));
 }
 
+absl::StatusOr<std::shared_ptr<const RegexSet>> CompileRegexSet(
+    std::vector<std::shared_ptr<const RE2>> programs) {
+  auto regex_set = std::make_shared<RegexSet>(std::move(programs));
+  CEL_RETURN_IF_ERROR(regex_set->Compile());
+  return regex_set;
+}
+
+std::unique_ptr<DirectExpressionStep> CreateDirectRegexSetMatchStep(
+    int64_t expr_id, std::unique_ptr<DirectExpressionStep> subject,
+    std::shared_ptr<const RegexSet> regex_set) {
+  return std::make_unique<RegexSetMatchDirectStep>(
+      expr_id, std::move(subject), std::move(regex_set));
+}
+
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateRegexSetMatchStep(
+    std::shared_ptr<const RegexSet> regex_set, int64_t expr_id) {
+  return std::make_unique<RegexSetMatchStep>(expr_id, std::move(regex_set));
+}
+
 }  // namespace google::api::expr::runtime
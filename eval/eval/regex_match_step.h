@@ -17,6 +17,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "absl/status/statusor.h"
 #include "eval/eval/direct_expression_step.h"
@@ -32,6 +33,24 @@ std::unique_ptr<DirectExpressionStep> CreateDirectRegexMatchStep(
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateRegexMatchStep(
     std::shared_ptr<const RE2> re2, int64_t expr_id);
 
-}
+// Regular expressions matched against a subject in a single pass, for
+// disjunctions of `matches` calls on the same subject and `exists` over a list
+// of patterns.
+class RegexSet;
+
+// Compiles `programs` into a `RegexSet`. Returns an error if the patterns
+// cannot be combined, in which case they should be matched individually.
+absl::StatusOr<std::shared_ptr<const RegexSet>> CompileRegexSet(
+    std::vector<std::shared_ptr<const RE2>> programs);
+
+// Evaluates to whether `subject` matches any of the patterns in `regex_set`.
+std::unique_ptr<DirectExpressionStep> CreateDirectRegexSetMatchStep(
+    int64_t expr_id, std::unique_ptr<DirectExpressionStep> subject,
+    std::shared_ptr<const RegexSet> regex_set);
+
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateRegexSetMatchStep(
+    std::shared_ptr<const RegexSet> regex_set, int64_t expr_id);
+
+}  // namespace google::api::expr::runtime
 
 #endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_REGEX_MATCH_STEP_H_
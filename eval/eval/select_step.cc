@@ -515,9 +515,18 @@ std::unique_ptr<DirectExpressionStep> CreateDirectSelectStep(
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateSelectStep(
     const cel::SelectExpr& select_expr, int64_t expr_id,
     bool enable_wrapper_type_null_unboxing, bool enable_optional_types) {
-  return std::make_unique<SelectStep>(
-      cel::StringValue(select_expr.field()), select_expr.test_only(), expr_id,
-      enable_wrapper_type_null_unboxing, enable_optional_types);
+  return CreateSelectStep(cel::StringValue(select_expr.field()),
+                          select_expr.test_only(), expr_id,
+                          enable_wrapper_type_null_unboxing,
+                          enable_optional_types);
+}
+
+std::unique_ptr<ExpressionStep> CreateSelectStep(
+    cel::StringValue field, bool test_only, int64_t expr_id,
+    bool enable_wrapper_type_null_unboxing, bool enable_optional_types) {
+  return std::make_unique<SelectStep>(std::move(field), test_only, expr_id,
+                                      enable_wrapper_type_null_unboxing,
+                                      enable_optional_types);
 }
 
 }  // namespace google::api::expr::runtime
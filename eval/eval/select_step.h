@@ -23,6 +23,12 @@ absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateSelectStep(
     const cel::SelectExpr& select_expr, int64_t expr_id,
     bool enable_wrapper_type_null_unboxing, bool enable_optional_types = false);
 
+// Factory method for Select - based Execution step with a preallocated (e.g.
+// interned) field name.
+std::unique_ptr<ExpressionStep> CreateSelectStep(
+    cel::StringValue field, bool test_only, int64_t expr_id,
+    bool enable_wrapper_type_null_unboxing, bool enable_optional_types = false);
+
 }  // namespace google::api::expr::runtime
 
 #endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_SELECT_STEP_H_
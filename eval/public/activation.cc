@@ -8,6 +8,7 @@
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
 #include "eval/public/cel_function.h"
+#include "runtime/internal/indexed_attribute_matcher.h"
 
 namespace google {
 namespace api {
@@ -113,6 +114,20 @@ int Activation::ClearCachedValues() {
   return n;
 }
 
+void Activation::set_index_attribute_patterns(bool enabled) {
+  if (!enabled) {
+    pattern_index_.reset();
+  } else if (pattern_index_ == nullptr) {
+    RebuildPatternIndex();
+  }
+}
+
+void Activation::RebuildPatternIndex() {
+  pattern_index_ =
+      std::make_unique<cel::runtime_internal::IndexedAttributeMatcher>(
+          unknown_attribute_patterns_, missing_attribute_patterns_);
+}
+
 }  // namespace runtime
 }  // namespace expr
 }  // namespace api
@@ -16,6 +16,7 @@
 #include "eval/public/cel_value.h"
 #include "eval/public/cel_value_producer.h"
 #include "runtime/internal/attribute_matcher.h"
+#include "runtime/internal/indexed_attribute_matcher.h"
 #include "google/protobuf/arena.h"
 
 namespace cel::runtime_internal {
@@ -80,6 +81,9 @@ class Activation : public BaseActivation {
   void set_missing_attribute_patterns(
       std::vector<CelAttributePattern> missing_attribute_patterns) {
     missing_attribute_patterns_ = std::move(missing_attribute_patterns);
+    if (pattern_index_ != nullptr) {
+      RebuildPatternIndex();
+    }
   }
 
   const std::vector<CelAttributePattern>& missing_attribute_patterns()
@@ -92,6 +96,9 @@ class Activation : public BaseActivation {
   void set_unknown_attribute_patterns(
       std::vector<CelAttributePattern> unknown_attribute_patterns) {
     unknown_attribute_patterns_ = std::move(unknown_attribute_patterns);
+    if (pattern_index_ != nullptr) {
+      RebuildPatternIndex();
+    }
   }
 
   // Return the collection of attribute patterns that determine "unknown"
@@ -101,6 +108,16 @@ class Activation : public BaseActivation {
     return unknown_attribute_patterns_;
   }
 
+  // Whether attributes are matched against the unknown and missing patterns
+  // through an index keyed by variable name and qualifiers, instead of by
+  // checking every pattern. This speeds up evaluations against many patterns
+  // at the cost of rebuilding the index whenever the patterns are set.
+  //
+  // Disabled by default.
+  void set_index_attribute_patterns(bool enabled);
+
+  bool index_attribute_patterns() const { return pattern_index_ != nullptr; }
+
  private:
   class ValueEntry {
    public:
@@ -150,9 +167,14 @@ class Activation : public BaseActivation {
 
   const cel::runtime_internal::AttributeMatcher* absl_nullable
   GetAttributeMatcher() const override {
-    return attribute_matcher_;
+    // A matcher installed through `ActivationAttributeMatcherAccess` takes
+    // precedence over the index.
+    return attribute_matcher_ != nullptr ? attribute_matcher_
+                                         : pattern_index_.get();
   }
 
+  void RebuildPatternIndex();
+
   absl::flat_hash_map<std::string, ValueEntry> value_map_;
   absl::flat_hash_map<std::string, std::vector<std::unique_ptr<CelFunction>>>
       function_map_;
@@ -163,6 +185,9 @@ class Activation : public BaseActivation {
   const cel::runtime_internal::AttributeMatcher* attribute_matcher_ = nullptr;
   std::unique_ptr<const cel::runtime_internal::AttributeMatcher>
       owned_attribute_matcher_;
+  // Index of the unknown and missing attribute patterns, if enabled.
+  std::unique_ptr<cel::runtime_internal::IndexedAttributeMatcher>
+      pattern_index_;
 };
 
 }  // namespace google::api::expr::runtime
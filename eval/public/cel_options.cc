@@ -30,6 +30,7 @@ cel::RuntimeOptions ConvertToRuntimeOptions(const InterpreterOptions& options) {
                              options.enable_comprehension_mutable_map,
                              options.enable_regex,
                              options.regex_max_program_size,
+                             options.regex_cache_capacity,
                              options.enable_string_conversion,
                              options.enable_string_concat,
                              options.enable_list_concat,
@@ -41,7 +42,9 @@ cel::RuntimeOptions ConvertToRuntimeOptions(const InterpreterOptions& options) {
                              options.enable_lazy_bind_initialization,
                              options.max_recursion_depth,
                              options.enable_recursive_tracing,
-                             options.enable_fast_builtins};
+                             options.enable_fast_builtins,
+                             options.enable_instruction_lowering,
+                             options.evaluator_state_pool_size};
 }
 
 }  // namespace google::api::expr::runtime
@@ -84,6 +84,12 @@ struct InterpreterOptions {
   // upper bound.
   int regex_max_program_size = 0;
 
+  // Maximum number of compiled regular expressions retained for reuse by the
+  // regex functions, for patterns which are not constant and therefore not
+  // compiled when planning. Shared by all programs of a runtime. Use value 0
+  // to compile the pattern on every call.
+  int regex_cache_capacity = 256;
+
   // Enable string() overloads.
   bool enable_string_conversion = true;
 
@@ -204,7 +210,30 @@ struct InterpreterOptions {
   // if they exist.
   //
   // Currently applies to !_, @not_strictly_false, _==_, _!=_, @in
+  //
+  // For recursively planned programs over type-checked expressions, also
+  // applies to the arithmetic (_+_, _-_, _*_, _/_, _%_) and comparison
+  // operators when both operands were checked to the same int, uint or double
+  // type.
   bool enable_fast_builtins = true;
+
+  // Enable lowering of stack machine programs to a compact instruction array.
+  //
+  // Trivial steps (constants, comprehension variable reads and jumps) are
+  // interpreted inline by the evaluation loop instead of through a virtual
+  // call per step. Other steps are evaluated as usual.
+  //
+  // Has no effect on recursively planned programs or traced evaluations.
+  bool enable_instruction_lowering = false;
+
+  // Maximum number of idle evaluator states (value stack, iterator stack and
+  // comprehension slots) retained per program for reuse by later
+  // evaluations. In addition, each thread caches one idle state.
+  //
+  // 0 disables pooling: each evaluation allocates a new state.
+  //
+  // Only applies to stack machine programs created from a cel::Runtime.
+  int evaluator_state_pool_size = 0;
 };
 // LINT.ThenChange(//depot/google3/runtime/runtime_options.h)
 
@@ -411,5 +411,45 @@ void BM_StringConcat32Concurrent(benchmark::State& state) {
 
 BENCHMARK(BM_StringConcat32Concurrent)->ThreadRange(1, 32);
 
+// Plans 10k distinct expressions drawn from a small vocabulary of identifiers
+// and field names, split across threads sharing one builder.
+void BM_PlanManyExpressionsConcurrent(benchmark::State& state) {
+  constexpr int kExpressions = 10000;
+  static const std::vector<ParsedExpr>* exprs = [] {
+    auto* exprs = new std::vector<ParsedExpr>();
+    exprs->reserve(kExpressions);
+    for (int i = 0; i < kExpressions; ++i) {
+      auto expr = parser::Parse(absl::StrCat(
+          "request.field_", i % 64, ".sub_", i % 16, " == 'value_", i,
+          "' || request.field_", (i + 1) % 64, ".size() > ", i));
+      ABSL_CHECK_OK(expr.status());
+      exprs->push_back(*std::move(expr));
+    }
+    return exprs;
+  }();
+  static const CelExpressionBuilder* builder = [] {
+    InterpreterOptions options;
+    auto builder = CreateCelExpressionBuilder(options);
+    auto reg_status = RegisterBuiltinFunctions(builder->GetRegistry());
+    ABSL_CHECK_OK(reg_status);
+    return builder.release();
+  }();
+
+  const int begin = kExpressions * state.thread_index() / state.threads();
+  const int end = kExpressions * (state.thread_index() + 1) / state.threads();
+  for (auto _ : state) {
+    for (int i = begin; i < end; ++i) {
+      const ParsedExpr& expr = (*exprs)[i];
+      ASSERT_OK_AND_ASSIGN(
+          auto expression,
+          builder->CreateExpression(&expr.expr(), &expr.source_info()));
+      benchmark::DoNotOptimize(expression);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * (end - begin));
+}
+
+BENCHMARK(BM_PlanManyExpressionsConcurrent)->ThreadRange(1, 32);
+
 }  // namespace
 }  // namespace google::api::expr::runtime
@@ -0,0 +1,178 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//       https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Benchmarks reporting heap allocations per evaluation. These replace the
+// global operator new, so they are kept out of the other benchmark binaries.
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "cel/expr/syntax.pb.h"
+#include "common/value.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/benchmark.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/arena_recycler.h"
+#include "runtime/internal/runtime_impl.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+
+namespace {
+
+// Counts calls to the global operator new so benchmarks can report heap
+// allocations per evaluation.
+std::atomic<int64_t> heap_allocation_count{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  heap_allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    std::abort();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::expr::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+
+// Evaluates a simple expression with the modern API, reporting heap
+// allocations per evaluation. The argument is the evaluator state pool size;
+// with pooling enabled the steady state should not allocate.
+static void BM_EvaluatorStatePool(benchmark::State& state) {
+  google::protobuf::Arena arena;
+  cel::RuntimeOptions options;
+  options.evaluator_state_pool_size = state.range(0);
+  ASSERT_OK_AND_ASSIGN(
+      auto builder,
+      cel::CreateStandardRuntimeBuilder(
+          google::protobuf::DescriptorPool::generated_pool(), options));
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr, Parse("x + 1 > 2 && x < 10"));
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<cel::Program> program,
+                       cel::extensions::ProtobufRuntimeAdapter::CreateProgram(
+                           *runtime, parsed_expr));
+
+  cel::Activation activation;
+  activation.InsertOrAssignValue("x", cel::IntValue(2));
+
+  // Warm up the pool.
+  ASSERT_OK(program->Evaluate(&arena, activation));
+
+  const int64_t allocations_before =
+      heap_allocation_count.load(std::memory_order_relaxed);
+  for (auto _ : state) {
+    ASSERT_OK_AND_ASSIGN(cel::Value result,
+                         program->Evaluate(&arena, activation));
+    ASSERT_TRUE(result.IsBool() && result.GetBool().NativeValue());
+  }
+  const int64_t allocations =
+      heap_allocation_count.load(std::memory_order_relaxed) -
+      allocations_before;
+
+  state.counters["heap_allocs_per_eval"] = benchmark::Counter(
+      static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+  if (auto stats = cel::runtime_internal::GetEvaluatorStatePoolStats(*program);
+      stats.has_value()) {
+    state.counters["pool_hits"] = static_cast<double>(stats->hits);
+    state.counters["pool_misses"] = static_cast<double>(stats->misses);
+  }
+}
+BENCHMARK(BM_EvaluatorStatePool)->Arg(0)->Arg(1);
+
+// Evaluates an expression which allocates from the arena on each evaluation.
+//   Arg 0: a fresh arena per evaluation.
+//   Arg 1: arenas from an `ArenaRecycler`.
+//   Arg 2: arenas from an `ArenaRecycler` using the thread-local block cache.
+static void BM_ArenaRecycler(benchmark::State& state) {
+  const int mode = state.range(0);
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       cel::CreateStandardRuntimeBuilder(
+                           google::protobuf::DescriptorPool::generated_pool(), {}));
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(
+      ParsedExpr parsed_expr,
+      Parse("[x, x + 1, x + 2].map(y, string(y) + s).size() == 3"));
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<cel::Program> program,
+                       cel::extensions::ProtobufRuntimeAdapter::CreateProgram(
+                           *runtime, parsed_expr));
+
+  cel::Activation activation;
+  activation.InsertOrAssignValue("x", cel::IntValue(2));
+  activation.InsertOrAssignValue("s", cel::StringValue(std::string(64, 'a')));
+
+  cel::ArenaRecyclerOptions recycler_options;
+  recycler_options.use_thread_local_block_cache = mode == 2;
+  cel::ArenaRecycler recycler(recycler_options);
+
+  auto evaluate = [&]() {
+    if (mode == 0) {
+      google::protobuf::Arena arena;
+      ASSERT_OK_AND_ASSIGN(cel::Value result,
+                           program->Evaluate(&arena, activation));
+      ASSERT_TRUE(result.IsBool() && result.GetBool().NativeValue());
+      return;
+    }
+    cel::ArenaRecycler::Lease lease = recycler.Acquire();
+    ASSERT_OK_AND_ASSIGN(cel::Value result,
+                         program->Evaluate(lease.arena(), activation));
+    ASSERT_TRUE(result.IsBool() && result.GetBool().NativeValue());
+  };
+
+  // Warm up the recycler.
+  evaluate();
+
+  const int64_t allocations_before =
+      heap_allocation_count.load(std::memory_order_relaxed);
+  for (auto _ : state) {
+    evaluate();
+  }
+  const int64_t allocations =
+      heap_allocation_count.load(std::memory_order_relaxed) -
+      allocations_before;
+
+  state.counters["heap_allocs_per_eval"] = benchmark::Counter(
+      static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+  if (mode != 0) {
+    const cel::ArenaRecyclerStats stats = recycler.stats();
+    state.counters["arena_reuses"] = static_cast<double>(stats.reuses);
+    state.counters["block_cache_hits"] =
+        static_cast<double>(stats.block_cache_hits);
+    state.counters["peak_space_allocated"] =
+        static_cast<double>(stats.peak_space_allocated);
+  }
+}
+BENCHMARK(BM_ArenaRecycler)->Arg(0)->Arg(1)->Arg(2);
+
+}  // namespace
+}  // namespace google::api::expr::runtime
@@ -19,6 +19,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
 #include <vector>
 
@@ -31,15 +32,28 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/node_hash_set.h"
 #include "absl/flags/flag.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "base/attribute.h"
+#include "checker/standard_library.h"
 #include "common/allocator.h"
+#include "common/ast.h"
 #include "common/casting.h"
+#include "common/decl.h"
 #include "common/native_type.h"
+#include "common/type.h"
 #include "common/value.h"
+#include "compiler/compiler_factory.h"
 #include "eval/tests/request_context.pb.h"
 #include "extensions/comprehensions_v2_functions.h"
 #include "extensions/comprehensions_v2_macros.h"
@@ -52,7 +66,18 @@
 #include "parser/macro_registry.h"
 #include "parser/parser.h"
 #include "runtime/activation.h"
+#include "runtime/activation_interface.h"
+#include "runtime/common_subexpression_elimination.h"
 #include "runtime/constant_folding.h"
+#include "runtime/constant_list_membership.h"
+#include "runtime/executor.h"
+#include "runtime/function_adapter.h"
+#include "runtime/function_registry.h"
+#include "runtime/memoized_program.h"
+#include "runtime/parallel_evaluation.h"
+#include "runtime/partial_evaluation.h"
+#include "runtime/regex_cache_stats.h"
+#include "runtime/regex_precompilation.h"
 #include "runtime/runtime.h"
 #include "runtime/runtime_options.h"
 #include "runtime/standard_runtime_builder_factory.h"
@@ -62,6 +87,8 @@
 #include "google/protobuf/text_format.h"
 
 ABSL_FLAG(bool, enable_recursive_planning, false, "enable recursive planning");
+ABSL_FLAG(bool, enable_instruction_lowering, false,
+          "enable lowering stack machine programs to instructions");
 
 namespace cel {
 
@@ -85,6 +112,10 @@ RuntimeOptions GetOptions() {
     options.max_recursion_depth = -1;
   }
 
+  if (absl::GetFlag(FLAGS_enable_instruction_lowering)) {
+    options.enable_instruction_lowering = true;
+  }
+
   return options;
 }
 
@@ -1084,6 +1115,43 @@ void BM_ListComprehension_Trace(benchmark::State& state) {
 
 BENCHMARK(BM_ListComprehension_Trace)->Range(1, 1 << 16);
 
+// Without `enable_comprehension_list_append` the accumulator of `filter` is
+// extended by concatenation on each iteration, which shares the elements of
+// the previous accumulator instead of copying them.
+void BM_ListComprehensionConcat(benchmark::State& state) {
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr,
+                       Parse("list_var.filter(x, x > 0)"));
+
+  RuntimeOptions options = GetOptions();
+  options.comprehension_max_iterations = 10000000;
+  auto runtime = StandardRuntimeOrDie(options);
+
+  ASSERT_OK_AND_ASSIGN(auto cel_expr, ProtobufRuntimeAdapter::CreateProgram(
+                                          *runtime, parsed_expr));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+
+  auto list_builder = cel::NewListValueBuilder(&arena);
+
+  int len = state.range(0);
+  list_builder->Reserve(len);
+  for (int i = 0; i < len; i++) {
+    ASSERT_THAT(list_builder->Add(IntValue(1)), IsOk());
+  }
+
+  activation.InsertOrAssignValue("list_var", std::move(*list_builder).Build());
+
+  for (auto _ : state) {
+    ASSERT_OK_AND_ASSIGN(cel::Value result,
+                         cel_expr->Evaluate(&arena, activation));
+    ASSERT_TRUE(InstanceOf<ListValue>(result));
+    ASSERT_THAT(Cast<ListValue>(result).Size(), IsOkAndHolds(len));
+  }
+}
+
+BENCHMARK(BM_ListComprehensionConcat)->Range(1, 1 << 14);
+
 void BM_ExistsComprehensionBestCase(benchmark::State& state) {
   ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr,
                        Parse("my_int_list.exists(x, x == 1)"));
@@ -1330,6 +1398,619 @@ void BM_MapTransformComprehension(benchmark::State& state) {
 
 BENCHMARK(BM_MapTransformComprehension)->Range(1, 1 << 16);
 
+// Like `BM_MapTransformComprehension`, but the accumulator is an unmodifiable
+// map which shares the entries of the previous accumulator on each insertion.
+void BM_MapTransformComprehensionImmutable(benchmark::State& state) {
+  ASSERT_OK_AND_ASSIGN(auto source,
+                       NewSource("map_var.transformMapEntry(k, v, {v:k})"));
+
+  MacroRegistry registry;
+  ASSERT_THAT(
+      extensions::RegisterComprehensionsV2Macros(registry, ParserOptions()),
+      IsOk());
+
+  ASSERT_OK_AND_ASSIGN(auto parsed_expr,
+                       EnrichedParse(*source, registry, ParserOptions()));
+
+  RuntimeOptions options = GetOptions();
+  options.comprehension_max_iterations = 10000000;
+
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       CreateStandardRuntimeBuilder(
+                           internal::GetTestingDescriptorPool(), options));
+
+  ASSERT_THAT(extensions::RegisterComprehensionsV2Functions(
+                  builder.function_registry(), options),
+              IsOk());
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  google::protobuf::Arena arena;
+  Activation activation;
+
+  auto map_builder = cel::NewMapValueBuilder(&arena);
+
+  int len = state.range(0);
+  map_builder->Reserve(len);
+  for (int i = 0; i < len; i++) {
+    ASSERT_THAT(map_builder->Put(IntValue(i), IntValue(i)), IsOk());
+  }
+
+  activation.InsertOrAssignValue("map_var", std::move(*map_builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(auto cel_expr, ProtobufRuntimeAdapter::CreateProgram(
+                                          *runtime, parsed_expr.parsed_expr()));
+
+  for (auto _ : state) {
+    ASSERT_OK_AND_ASSIGN(cel::Value result,
+                         cel_expr->Evaluate(&arena, activation));
+    ASSERT_TRUE(InstanceOf<MapValue>(result));
+    ASSERT_THAT(Cast<MapValue>(result).Size(), IsOkAndHolds(len));
+  }
+}
+
+BENCHMARK(BM_MapTransformComprehensionImmutable)->Range(1, 1 << 14);
+
+constexpr absl::string_view kBatchExpr =
+    "x > 100 && (x % 3 == 0 || [1, 2, 3].exists(i, i == x))";
+
+std::vector<Activation> MakeBatchActivations(int len) {
+  std::vector<Activation> activations(len);
+  for (int i = 0; i < len; i++) {
+    activations[i].InsertOrAssignValue("x", IntValue(i));
+  }
+  return activations;
+}
+
+// Baseline for BM_EvaluateBatch: evaluates each activation with a separate
+// call to Program::Evaluate.
+void BM_EvaluateLooped(benchmark::State& state) {
+  RuntimeOptions options = GetOptions();
+  auto runtime = StandardRuntimeOrDie(options);
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr, Parse(kBatchExpr));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr, ProtobufRuntimeAdapter::CreateProgram(
+                                          *runtime, parsed_expr));
+
+  int len = state.range(0);
+  std::vector<Activation> activations = MakeBatchActivations(len);
+
+  for (auto _ : state) {
+    google::protobuf::Arena arena;
+    for (const Activation& activation : activations) {
+      ASSERT_OK_AND_ASSIGN(cel::Value result,
+                           cel_expr->Evaluate(&arena, activation));
+      benchmark::DoNotOptimize(result);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * len);
+}
+
+BENCHMARK(BM_EvaluateLooped)->Range(1, 1 << 12);
+
+// Evaluates the same expression as BM_EvaluateLooped using
+// Program::EvaluateBatch, which shares evaluator state across the batch.
+void BM_EvaluateBatch(benchmark::State& state) {
+  RuntimeOptions options = GetOptions();
+  auto runtime = StandardRuntimeOrDie(options);
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr, Parse(kBatchExpr));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr, ProtobufRuntimeAdapter::CreateProgram(
+                                          *runtime, parsed_expr));
+
+  int len = state.range(0);
+  std::vector<Activation> activations = MakeBatchActivations(len);
+  std::vector<const ActivationInterface*> activation_ptrs;
+  activation_ptrs.reserve(len);
+  for (const Activation& activation : activations) {
+    activation_ptrs.push_back(&activation);
+  }
+  std::vector<Value> results(len);
+
+  for (auto _ : state) {
+    google::protobuf::Arena arena;
+    ASSERT_THAT(cel_expr->EvaluateBatch(&arena, activation_ptrs,
+                                        absl::MakeSpan(results)),
+                IsOk());
+    benchmark::DoNotOptimize(results);
+  }
+  state.SetItemsProcessed(state.iterations() * len);
+}
+
+BENCHMARK(BM_EvaluateBatch)->Range(1, 1 << 12);
+
+
+// Compiles `expression` with variables `x` and `y` declared as `type`, so that
+// operand types are known to the planner.
+std::unique_ptr<Ast> CompileWithNumericVariables(absl::string_view expression,
+                                                 const Type& type) {
+  auto builder = NewCompilerBuilder(internal::GetTestingDescriptorPool());
+  ABSL_CHECK_OK(builder.status());
+  ABSL_CHECK_OK((*builder)->AddLibrary(StandardCheckerLibrary()));
+  ABSL_CHECK_OK((*builder)->GetCheckerBuilder().AddVariable(
+      MakeVariableDecl("x", type)));
+  ABSL_CHECK_OK((*builder)->GetCheckerBuilder().AddVariable(
+      MakeVariableDecl("y", type)));
+  auto compiler = std::move(**builder).Build();
+  ABSL_CHECK_OK(compiler.status());
+
+  auto result = (*compiler)->Compile(expression);
+  ABSL_CHECK_OK(result.status());
+  ABSL_CHECK(result->IsValid());
+  auto ast = result->ReleaseAst();
+  ABSL_CHECK_OK(ast.status());
+  return std::move(*ast);
+}
+
+// Evaluates an arithmetic-heavy, type-checked expression. Arg 1 enables the
+// typed operator fast paths (enable_fast_builtins), arg 0 dispatches every
+// operator through the function registry.
+void BM_CheckedIntArithmetic(benchmark::State& state) {
+  RuntimeOptions options = GetOptions();
+  options.max_recursion_depth = -1;
+  options.enable_fast_builtins = state.range(0) == 1;
+  auto runtime = StandardRuntimeOrDie(options);
+
+  ASSERT_OK_AND_ASSIGN(
+      auto program,
+      runtime->CreateProgram(CompileWithNumericVariables(
+          "(x * 3 + y * 5 - (x - y) * 7) % 11 < x + y && x * y != y * x + 1",
+          IntType())));
+
+  Activation activation;
+  activation.InsertOrAssignValue("x", IntValue(42));
+  activation.InsertOrAssignValue("y", IntValue(17));
+
+  for (auto _ : state) {
+    google::protobuf::Arena arena;
+    ASSERT_OK_AND_ASSIGN(cel::Value result,
+                         program->Evaluate(&arena, activation));
+    ASSERT_TRUE(result.GetBool().NativeValue());
+  }
+}
+
+BENCHMARK(BM_CheckedIntArithmetic)->Arg(0)->Arg(1);
+
+void BM_CheckedDoubleArithmetic(benchmark::State& state) {
+  RuntimeOptions options = GetOptions();
+  options.max_recursion_depth = -1;
+  options.enable_fast_builtins = state.range(0) == 1;
+  auto runtime = StandardRuntimeOrDie(options);
+
+  ASSERT_OK_AND_ASSIGN(
+      auto program,
+      runtime->CreateProgram(CompileWithNumericVariables(
+          "(x * 3.0 + y * 5.0 - (x - y) * 7.0) / 11.0 < x + y && "
+          "x * y != y * x + 1.0",
+          DoubleType())));
+
+  Activation activation;
+  activation.InsertOrAssignValue("x", DoubleValue(42.5));
+  activation.InsertOrAssignValue("y", DoubleValue(17.25));
+
+  for (auto _ : state) {
+    google::protobuf::Arena arena;
+    ASSERT_OK_AND_ASSIGN(cel::Value result,
+                         program->Evaluate(&arena, activation));
+    ASSERT_TRUE(result.GetBool().NativeValue());
+  }
+}
+
+BENCHMARK(BM_CheckedDoubleArithmetic)->Arg(0)->Arg(1);
+
+// Evaluates `x in [...]` against a constant list of strings that doesn't
+// contain `x`. The second argument enables the hash indexed membership
+// optimization, otherwise the list is scanned.
+void BM_ConstantListMembership(benchmark::State& state) {
+  RuntimeOptions options = GetOptions();
+  auto builder = CreateStandardRuntimeBuilder(
+      internal::GetTestingDescriptorPool(), options);
+  ABSL_CHECK_OK(builder.status());
+  if (state.range(1) == 1) {
+    ABSL_CHECK_OK(extensions::EnableConstantListMembership(*builder));
+  }
+  auto runtime = std::move(builder).value().Build();
+  ABSL_CHECK_OK(runtime.status());
+
+  int len = state.range(0);
+  std::vector<std::string> elements;
+  elements.reserve(len);
+  for (int i = 0; i < len; i++) {
+    elements.push_back(absl::StrCat("'value", i, "'"));
+  }
+  ASSERT_OK_AND_ASSIGN(
+      ParsedExpr parsed_expr,
+      Parse(absl::StrCat("x in [", absl::StrJoin(elements, ", "), "]")));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr, ProtobufRuntimeAdapter::CreateProgram(
+                                          **runtime, parsed_expr));
+
+  Activation activation;
+  activation.InsertOrAssignValue("x", StringValue("missing"));
+
+  for (auto _ : state) {
+    google::protobuf::Arena arena;
+    ASSERT_OK_AND_ASSIGN(cel::Value result,
+                         cel_expr->Evaluate(&arena, activation));
+    ASSERT_FALSE(result.GetBool().NativeValue());
+  }
+}
+
+BENCHMARK(BM_ConstantListMembership)
+    ->ArgsProduct({{10, 100, 1000}, {0, 1}});
+
+// Runs each task on a new, detached thread.
+class DetachedThreadExecutor : public Executor {
+ public:
+  void Schedule(absl::AnyInvocable<void() &&> task) override {
+    std::thread([task = std::move(task)]() mutable { std::move(task)(); })
+        .detach();
+  }
+};
+
+// Evaluates a conjunction of artificially slow function calls. With parallel
+// evaluation enabled (arg 1) the latency approaches that of a single call
+// rather than the sum of all four.
+void BM_ParallelSlowCalls(benchmark::State& state) {
+  RuntimeOptions options = GetOptions();
+  options.max_recursion_depth = -1;
+
+  auto builder = CreateStandardRuntimeBuilder(
+      internal::GetTestingDescriptorPool(), options);
+  ABSL_CHECK_OK(builder.status());
+
+  using Adapter = UnaryFunctionAdapter<bool, int64_t>;
+  FunctionDescriptor descriptor = Adapter::CreateDescriptor("slow", false);
+  ABSL_CHECK_OK(builder->function_registry().Register(
+      descriptor, Adapter::WrapFunction([](int64_t x) -> bool {
+        absl::SleepFor(absl::Milliseconds(1));
+        return x > 0;
+      })));
+  ABSL_CHECK_OK(builder->function_registry().MarkParallelSafe(descriptor));
+
+  if (state.range(0) == 1) {
+    ABSL_CHECK_OK(extensions::EnableParallelEvaluation(
+        *builder, std::make_shared<DetachedThreadExecutor>()));
+  }
+
+  auto runtime = std::move(builder).value().Build();
+  ABSL_CHECK_OK(runtime.status());
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr,
+                       Parse("slow(1) && slow(2) && slow(3) && slow(4)"));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr, ProtobufRuntimeAdapter::CreateProgram(
+                                          **runtime, parsed_expr));
+
+  Activation activation;
+  for (auto _ : state) {
+    google::protobuf::Arena arena;
+    ASSERT_OK_AND_ASSIGN(cel::Value result,
+                         cel_expr->Evaluate(&arena, activation));
+    ASSERT_TRUE(result.GetBool().NativeValue());
+  }
+}
+
+BENCHMARK(BM_ParallelSlowCalls)->Arg(0)->Arg(1)->UseRealTime();
+
+// Evaluates a comprehension-heavy rule against a small, repeating set of
+// inputs. Arg 1 wraps the program with a result cache.
+void BM_MemoizedEvaluate(benchmark::State& state) {
+  RuntimeOptions options = GetOptions();
+  auto runtime = StandardRuntimeOrDie(options);
+
+  auto ast = CompileWithNumericVariables(
+      "[1, 2, 3, 4, 5, 6, 7, 8].all(i, "
+      "[1, 2, 3, 4, 5, 6, 7, 8].exists(j, i * j != x + y))",
+      IntType());
+  std::unique_ptr<Program> program;
+  if (state.range(0) == 1) {
+    ASSERT_OK_AND_ASSIGN(
+        program, extensions::CreateMemoizedProgram(*runtime, std::move(ast)));
+  } else {
+    ASSERT_OK_AND_ASSIGN(program, runtime->CreateProgram(std::move(ast)));
+  }
+
+  constexpr int kInputs = 16;
+  std::vector<Activation> activations(kInputs);
+  for (int i = 0; i < kInputs; i++) {
+    activations[i].InsertOrAssignValue("x", IntValue(i));
+    activations[i].InsertOrAssignValue("y", IntValue(i % 4));
+  }
+
+  int i = 0;
+  for (auto _ : state) {
+    google::protobuf::Arena arena;
+    ASSERT_OK_AND_ASSIGN(cel::Value result,
+                         program->Evaluate(&arena, activations[i++ % kInputs]));
+    ASSERT_TRUE(result.GetBool().NativeValue());
+  }
+}
+
+BENCHMARK(BM_MemoizedEvaluate)->Arg(0)->Arg(1);
+
+// Evaluates a policy that repeatedly selects the same fields of a nested map.
+// Arg 1 enables common subexpression elimination.
+void BM_RepeatedSelects(benchmark::State& state) {
+  RuntimeOptions options = GetOptions();
+  auto builder = CreateStandardRuntimeBuilder(
+      internal::GetTestingDescriptorPool(), options);
+  ABSL_CHECK_OK(builder.status());
+  if (state.range(0) == 1) {
+    ABSL_CHECK_OK(extensions::EnableCommonSubexpressionElimination(*builder));
+  }
+  auto runtime = std::move(builder).value().Build();
+  ABSL_CHECK_OK(runtime.status());
+
+  ASSERT_OK_AND_ASSIGN(
+      ParsedExpr parsed_expr,
+      Parse("request.auth.claims.email != '' && "
+            "request.auth.claims.email.endsWith('@example.com') && "
+            "!request.auth.claims.email.startsWith('admin') && "
+            "request.auth.claims.email.size() < 64 && "
+            "request.auth.claims.email != request.auth.principal && "
+            "request.auth.principal.startsWith('user/') && "
+            "request.auth.principal.size() < 64 && "
+            "request.auth.claims.email.contains('@')"));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr, ProtobufRuntimeAdapter::CreateProgram(
+                                          **runtime, parsed_expr));
+
+  google::protobuf::Arena arena;
+  auto claims = cel::NewMapValueBuilder(&arena);
+  ASSERT_THAT(claims->Put(cel::StringValue("email"),
+                          cel::StringValue("someone@example.com")),
+              IsOk());
+  auto auth = cel::NewMapValueBuilder(&arena);
+  ASSERT_THAT(
+      auth->Put(cel::StringValue("claims"), std::move(*claims).Build()),
+      IsOk());
+  ASSERT_THAT(auth->Put(cel::StringValue("principal"),
+                        cel::StringValue("user/someone")),
+              IsOk());
+  auto request = cel::NewMapValueBuilder(&arena);
+  ASSERT_THAT(
+      request->Put(cel::StringValue("auth"), std::move(*auth).Build()),
+      IsOk());
+  Activation activation;
+  activation.InsertOrAssignValue("request", std::move(*request).Build());
+
+  for (auto _ : state) {
+    ASSERT_OK_AND_ASSIGN(cel::Value result,
+                         cel_expr->Evaluate(&arena, activation));
+    ASSERT_TRUE(result.GetBool().NativeValue());
+  }
+}
+
+BENCHMARK(BM_RepeatedSelects)->Arg(0)->Arg(1);
+
+// Evaluates `matches` with a pattern supplied through the activation, so that
+// it cannot be precompiled by the planner. The argument is the number of
+// distinct patterns cycled through; beyond the capacity of the regex cache
+// patterns are evicted and recompiled.
+void BM_RegexMatchFromActivation(benchmark::State& state) {
+  RuntimeOptions options = GetOptions();
+  auto builder = CreateStandardRuntimeBuilder(
+      internal::GetTestingDescriptorPool(), options);
+  ABSL_CHECK_OK(builder.status());
+  // The registry is owned by the runtime and outlives the builder.
+  const FunctionRegistry& registry = builder->function_registry();
+  auto runtime = std::move(builder).value().Build();
+  ABSL_CHECK_OK(runtime.status());
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr,
+                       Parse("target.matches(pattern)"));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr, ProtobufRuntimeAdapter::CreateProgram(
+                                          **runtime, parsed_expr));
+
+  google::protobuf::Arena arena;
+  const int pattern_count = state.range(0);
+  std::vector<StringValue> patterns;
+  patterns.reserve(pattern_count);
+  for (int i = 0; i < pattern_count; ++i) {
+    patterns.push_back(StringValue(
+        &arena,
+        absl::StrCat("^[a-z]+@(example|test)\\.(com|org)/", i, "$")));
+  }
+
+  Activation activation;
+  activation.InsertOrAssignValue("target",
+                                 StringValue("someone@example.com/0"));
+  size_t i = 0;
+  for (auto _ : state) {
+    activation.InsertOrAssignValue("pattern",
+                                   patterns[i++ % patterns.size()]);
+    ASSERT_OK_AND_ASSIGN(cel::Value result,
+                         cel_expr->Evaluate(&arena, activation));
+    ASSERT_TRUE(result.IsBool());
+  }
+
+  const RegexCacheStats stats = registry.regex_cache_stats();
+  state.counters["regex_cache_hits"] = static_cast<double>(stats.hits);
+  state.counters["regex_cache_misses"] = static_cast<double>(stats.misses);
+  state.counters["regex_cache_evictions"] =
+      static_cast<double>(stats.evictions);
+}
+
+BENCHMARK(BM_RegexMatchFromActivation)->Arg(1)->Arg(64)->Arg(1024);
+
+// Evaluates a disjunction of `matches` calls with constant patterns on the same
+// string, none of which match. The second argument enables regex
+// precompilation, which matches all of the patterns in a single pass.
+// Otherwise each call looks up its pattern in the regex cache.
+void BM_RegexMatchDisjunction(benchmark::State& state) {
+  RuntimeOptions options = GetOptions();
+  auto builder = CreateStandardRuntimeBuilder(
+      internal::GetTestingDescriptorPool(), options);
+  ABSL_CHECK_OK(builder.status());
+  if (state.range(1) == 1) {
+    ABSL_CHECK_OK(extensions::EnableRegexPrecompilation(*builder));
+  }
+  auto runtime = std::move(builder).value().Build();
+  ABSL_CHECK_OK(runtime.status());
+
+  int len = state.range(0);
+  std::vector<std::string> calls;
+  calls.reserve(len);
+  for (int i = 0; i < len; i++) {
+    calls.push_back(absl::StrCat(
+        "target.matches(r'^user", i, "@(example|test)\\.(com|org)$')"));
+  }
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr,
+                       Parse(absl::StrJoin(calls, " || ")));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr, ProtobufRuntimeAdapter::CreateProgram(
+                                          **runtime, parsed_expr));
+
+  Activation activation;
+  activation.InsertOrAssignValue("target",
+                                 StringValue("someone@example.com"));
+
+  for (auto _ : state) {
+    google::protobuf::Arena arena;
+    ASSERT_OK_AND_ASSIGN(cel::Value result,
+                         cel_expr->Evaluate(&arena, activation));
+    ASSERT_FALSE(result.GetBool().NativeValue());
+  }
+}
+
+BENCHMARK(BM_RegexMatchDisjunction)->ArgsProduct({{10, 50, 200}, {0, 1}});
+
+// Evaluates a policy with unknown processing enabled against an activation
+// with many unknown patterns, none of which match the attributes referenced by
+// the policy. The second argument selects the trie indexed attribute matcher,
+// otherwise every attribute is checked against every pattern.
+void BM_UnknownPatternMatching(benchmark::State& state) {
+  RuntimeOptions options = GetOptions();
+  options.unknown_processing = UnknownProcessingOptions::kAttributeOnly;
+  auto runtime = StandardRuntimeOrDie(options);
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr, Parse(R"cel(
+    request.path.startsWith("/v1") && request.token in ["v1", "admin"] &&
+    request.headers["x-user"] == "alice" && request.a.b.c.d.e)cel"));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr, ProtobufRuntimeAdapter::CreateProgram(
+                                          *runtime, parsed_expr));
+
+  google::protobuf::Arena arena;
+  RequestContext request;
+  request.set_path("/v1/resource");
+  request.set_token("admin");
+  (*request.mutable_headers())["x-user"] = "alice";
+  request.mutable_a()->mutable_b()->mutable_c()->mutable_d()->set_e(true);
+
+  Activation activation;
+  activation.InsertOrAssignValue("request", WrapMessageOrDie(request, &arena));
+  // Half of the patterns share a prefix with the referenced attributes.
+  const int pattern_count = state.range(0);
+  std::vector<AttributePattern> patterns;
+  patterns.reserve(pattern_count);
+  for (int i = 0; i < pattern_count; ++i) {
+    if (i % 2 == 0) {
+      patterns.push_back(AttributePattern(
+          "request",
+          {AttributeQualifierPattern::OfString("headers"),
+           AttributeQualifierPattern::OfString(absl::StrCat("x-header-", i))}));
+    } else {
+      patterns.push_back(AttributePattern(absl::StrCat("var", i), {}));
+    }
+  }
+  activation.set_index_attribute_patterns(state.range(1) == 1);
+  activation.SetUnknownPatterns(std::move(patterns));
+
+  for (auto _ : state) {
+    ASSERT_OK_AND_ASSIGN(cel::Value result,
+                         cel_expr->Evaluate(&arena, activation));
+    ASSERT_TRUE(result.IsBool() && result.GetBool().NativeValue());
+  }
+}
+
+BENCHMARK(BM_UnknownPatternMatching)
+    ->ArgsProduct({{10, 100, 1000, 10000}, {0, 1}});
+
+// Evaluates a disjunction (or, with the second argument set, a conjunction) of
+// comparisons against unknown variables, so every logical operator merges the
+// attribute sets of its operands into the final unknown result.
+void BM_UnknownPropagation(benchmark::State& state) {
+  RuntimeOptions options = GetOptions();
+  options.unknown_processing = UnknownProcessingOptions::kAttributeOnly;
+  auto runtime = StandardRuntimeOrDie(options);
+
+  const int width = state.range(0);
+  std::vector<std::string> terms;
+  std::vector<AttributePattern> patterns;
+  terms.reserve(width);
+  patterns.reserve(width);
+  for (int i = 0; i < width; ++i) {
+    std::string variable = absl::StrCat("var", i);
+    terms.push_back(absl::StrCat(variable, ".value == 1"));
+    patterns.push_back(AttributePattern(std::move(variable), {}));
+  }
+  ASSERT_OK_AND_ASSIGN(
+      ParsedExpr parsed_expr,
+      Parse(absl::StrJoin(terms, state.range(1) == 1 ? " && " : " || ")));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr, ProtobufRuntimeAdapter::CreateProgram(
+                                          *runtime, parsed_expr));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  activation.SetUnknownPatterns(std::move(patterns));
+
+  for (auto _ : state) {
+    ASSERT_OK_AND_ASSIGN(cel::Value result,
+                         cel_expr->Evaluate(&arena, activation));
+    ASSERT_TRUE(result.IsUnknown());
+    ASSERT_EQ(result.GetUnknown().attribute_set().size(), width);
+  }
+}
+
+BENCHMARK(BM_UnknownPropagation)->ArgsProduct({{2, 4, 16, 64}, {0, 1}});
+
+// Evaluates a rule whose expensive part only depends on `x`, once `y` is
+// known. Arg 0 re-evaluates the whole expression, arg 1 evaluates the residual
+// of a prior partial evaluation with `y` unknown.
+void BM_ResidualEvaluation(benchmark::State& state) {
+  RuntimeOptions options = GetOptions();
+  options.unknown_processing = UnknownProcessingOptions::kAttributeAndFunction;
+  auto runtime = StandardRuntimeOrDie(options);
+
+  std::vector<int> elements;
+  for (int i = 0; i < 100; ++i) {
+    elements.push_back(i);
+  }
+  std::string list = absl::StrCat("[", absl::StrJoin(elements, ", "), "]");
+  ASSERT_OK_AND_ASSIGN(
+      auto partial_program,
+      extensions::CreatePartialEvaluationProgram(
+          *runtime, CompileWithNumericVariables(
+                        absl::StrCat(list, ".filter(e, e % 3 == x % 3).size() "
+                                     "> 10 && ",
+                                     list, ".exists(e, e * x == 42) && y > 0"),
+                        IntType())));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  activation.InsertOrAssignValue("x", IntValue(2));
+  std::unique_ptr<Program> program;
+  if (state.range(0) == 1) {
+    activation.SetUnknownPatterns({AttributePattern("y", {})});
+    ASSERT_OK_AND_ASSIGN(
+        extensions::PartialEvaluationResult partial_result,
+        partial_program->PartiallyEvaluate(&arena, activation));
+    ASSERT_TRUE(partial_result.value.IsUnknown());
+    ASSERT_OK_AND_ASSIGN(
+        program, runtime->CreateProgram(std::move(partial_result.residual)));
+    activation = Activation();
+  } else {
+    program = std::move(partial_program);
+  }
+  activation.InsertOrAssignValue("y", IntValue(1));
+
+  for (auto _ : state) {
+    google::protobuf::Arena eval_arena;
+    ASSERT_OK_AND_ASSIGN(cel::Value result,
+                         program->Evaluate(&eval_arena, activation));
+    ASSERT_TRUE(result.IsBool() && result.GetBool().NativeValue());
+  }
+}
+
+BENCHMARK(BM_ResidualEvaluation)->Arg(0)->Arg(1);
+
 }  // namespace
 
 }  // namespace cel
@@ -258,6 +258,37 @@ TEST_F(UnknownsTest, UnknownAttributesCustomMatcher) {
       UnorderedElementsAre(AttributeIs("var1"), AttributeIs("var1.foo")));
 }
 
+TEST_F(UnknownsTest, UnknownAttributesIndexedPatterns) {
+  PrepareBuilder(UnknownProcessingOptions::kAttributeOnly);
+
+  ASSERT_OK_AND_ASSIGN(auto var1, MakeCelMap("{'bar': 1}", &arena_));
+  activation_.InsertValue("var1", var1);
+  activation_.set_index_attribute_patterns(true);
+  activation_.set_unknown_attribute_patterns(
+      {CelAttributePattern("var1", {CreateCelAttributeQualifierPattern(
+                                       CelValue::CreateStringView("foo"))}),
+       CelAttributePattern("var2", {})});
+
+  ASSERT_THAT(activation_.InsertFunction(std::make_unique<FunctionImpl>(
+                  "F1", FunctionResponse::kTrue, CelValue::Type::kMap)),
+              IsOk());
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr expr,
+                       Parse("F1(var1) || var1.foo || var1.bar == 2"));
+  auto plan = builder_->CreateExpression(&expr.expr(), nullptr);
+  ASSERT_THAT(plan, IsOk());
+
+  ASSERT_OK_AND_ASSIGN(CelValue response,
+                       plan.value()->Evaluate(activation_, &arena_));
+
+  // `var1` partially matches a pattern, so it is unknown as a function
+  // argument, but `var1.bar` is not.
+  ASSERT_TRUE(response.IsUnknownSet()) << response.DebugString();
+  EXPECT_THAT(
+      response.UnknownSetOrDie()->unknown_attributes(),
+      UnorderedElementsAre(AttributeIs("var1"), AttributeIs("var1.foo")));
+}
+
 TEST_F(UnknownsTest, UnknownFunctionsWithoutOptionError) {
   PrepareBuilder(UnknownProcessingOptions::kAttributeOnly);
   activation_.InsertValue("var1", CelValue::CreateInt64(5));
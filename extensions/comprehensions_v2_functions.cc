@@ -48,24 +48,13 @@ absl::StatusOr<Value> MapInsertKeyValue(
         .With(ErrorValueReturn());
     return map;
   }
-  // Slow path, we have to make a copy.
-  auto builder = NewMapValueBuilder(arena);
-  if (auto size = map.Size(); size.ok()) {
-    builder->Reserve(*size + 1);
-  } else {
-    size.IgnoreError();
-  }
-  CEL_RETURN_IF_ERROR(
-      map.ForEach(
-          [&builder](const Value& key,
-                     const Value& value) -> absl::StatusOr<bool> {
-            CEL_RETURN_IF_ERROR(builder->Put(key, value));
-            return true;
-          },
-          descriptor_pool, message_factory, arena))
-      .With(ErrorValueReturn());
-  CEL_RETURN_IF_ERROR(builder->Put(key, value)).With(ErrorValueReturn());
-  return std::move(*builder).Build();
+  // Slow path, the result shares the entries of `map` instead of copying them.
+  CEL_ASSIGN_OR_RETURN(
+      auto result,
+      common_internal::MapValueWithEntry(map, key, value, descriptor_pool,
+                                         message_factory, arena),
+      _.With(ErrorValueReturn()));
+  return result;
 }
 
 absl::StatusOr<Value> MapInsertMap(
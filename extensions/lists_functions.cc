@@ -14,6 +14,7 @@
 
 #include "extensions/lists_functions.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <numeric>
@@ -40,6 +41,7 @@
 #include "common/type.h"
 #include "common/value.h"
 #include "common/value_kind.h"
+#include "common/values/list_value_builder.h"
 #include "compiler/compiler.h"
 #include "internal/status_macros.h"
 #include "parser/macro.h"
@@ -477,11 +479,40 @@ Macro ListSortByMacro() {
   return *sortby_macro;
 }
 
+// Sorts the unboxed elements of a list directly, rather than sorting a
+// permutation of indices and fetching each element by index.
+template <typename ValueType, typename T>
+Value ListSortPacked(absl::Span<const T> elements,
+                     google::protobuf::Arena* absl_nonnull arena) {
+  std::vector<T> sorted(elements.begin(), elements.end());
+  std::sort(sorted.begin(), sorted.end());
+  auto builder = NewListValueBuilder(arena);
+  builder->Reserve(sorted.size());
+  for (const T& element : sorted) {
+    builder->UnsafeAdd(ValueType(element));
+  }
+  return std::move(*builder).Build();
+}
+
 absl::StatusOr<Value> ListSort(
     const ListValue& list,
     const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
     google::protobuf::MessageFactory* absl_nonnull message_factory,
     google::protobuf::Arena* absl_nonnull arena) {
+  if (auto packed = common_internal::AsPackedListElements(list); packed) {
+    switch (packed->kind) {
+      case ValueKind::kInt:
+        return ListSortPacked<IntValue>(packed->As<int64_t>(), arena);
+      case ValueKind::kUint:
+        return ListSortPacked<UintValue>(packed->As<uint64_t>(), arena);
+      case ValueKind::kDouble:
+        return ListSortPacked<DoubleValue>(packed->As<double>(), arena);
+      case ValueKind::kBool:
+        return ListSortPacked<BoolValue>(packed->As<bool>(), arena);
+      default:
+        break;
+    }
+  }
   return ListSortByAssociatedKeys(list, list, descriptor_pool, message_factory,
                                   arena);
 }
@@ -19,7 +19,11 @@
 #include "absl/base/nullability.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "common/value.h"
+#include "extensions/protobuf/lazy_message_value.h"
 #include "internal/status_macros.h"
 #include "runtime/activation.h"
 #include "google/protobuf/arena.h"
@@ -90,3 +94,54 @@ absl::Status BindProtoToActivation(
 }
 
 }  // namespace cel::extensions::protobuf_internal
+
+namespace cel::extensions {
+
+absl::Status BindSerializedProtoToActivation(
+    const google::protobuf::Descriptor& descriptor, absl::string_view serialized,
+    BindProtoUnsetFieldBehavior unset_field_behavior,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, Activation* absl_nonnull activation) {
+  if (descriptor.well_known_type() !=
+      google::protobuf::Descriptor::WELLKNOWNTYPE_UNSPECIFIED) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("context is a well-known type: ", descriptor.full_name()));
+  }
+  if (message_factory->GetPrototype(&descriptor) == nullptr) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "context missing prototype: ", descriptor.full_name()));
+  }
+
+  StructValue struct_value =
+      NewLazyMessageValue(&descriptor, serialized, arena);
+  for (int i = 0; i < descriptor.field_count(); i++) {
+    const google::protobuf::FieldDescriptor* field_desc = descriptor.field(i);
+    activation->InsertOrAssignValueProvider(
+        field_desc->name(),
+        [field_desc, struct_value, unset_field_behavior](
+            absl::string_view,
+            const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+            google::protobuf::MessageFactory* absl_nonnull message_factory,
+            google::protobuf::Arena* absl_nonnull arena)
+            -> absl::StatusOr<absl::optional<Value>> {
+          CEL_ASSIGN_OR_RETURN(
+              bool should_bind,
+              protobuf_internal::ShouldBindField(field_desc, struct_value,
+                                                 unset_field_behavior));
+          if (!should_bind) {
+            return absl::nullopt;
+          }
+          CEL_ASSIGN_OR_RETURN(
+              Value field,
+              protobuf_internal::GetFieldValue(field_desc, struct_value,
+                                               descriptor_pool,
+                                               message_factory, arena));
+          return field;
+        });
+  }
+
+  return absl::OkStatus();
+}
+
+}  // namespace cel::extensions
@@ -19,6 +19,7 @@
 
 #include "absl/base/nullability.h"
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
 #include "common/casting.h"
 #include "common/value.h"
 #include "extensions/protobuf/value.h"
@@ -125,6 +126,29 @@ absl::Status BindProtoToActivation(
                                activation);
 }
 
+// Like `BindProtoToActivation`, but for a context message of type `descriptor`
+// given in its wire format `serialized`, which is copied to `arena`.
+//
+// Instead of parsing the message, each field is bound as a value provider
+// backed by `NewLazyMessageValue`, so only the fields referenced by the
+// evaluated expression are decoded. Malformed input is reported when the first
+// field is accessed. `descriptor` must outlive `activation`.
+absl::Status BindSerializedProtoToActivation(
+    const google::protobuf::Descriptor& descriptor, absl::string_view serialized,
+    BindProtoUnsetFieldBehavior unset_field_behavior,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, Activation* absl_nonnull activation);
+inline absl::Status BindSerializedProtoToActivation(
+    const google::protobuf::Descriptor& descriptor, absl::string_view serialized,
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, Activation* absl_nonnull activation) {
+  return BindSerializedProtoToActivation(
+      descriptor, serialized, BindProtoUnsetFieldBehavior::kSkip,
+      descriptor_pool, message_factory, arena, activation);
+}
+
 }  // namespace cel::extensions
 
 #endif  // THIRD_PARTY_CEL_CPP_EXTENSIONS_PROTOBUF_BIND_PROTO_TO_ACTIVATION_H_
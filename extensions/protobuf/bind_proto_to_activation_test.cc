@@ -15,6 +15,8 @@
 #include "extensions/protobuf/bind_proto_to_activation.h"
 
 #include "google/protobuf/wrappers.pb.h"
+#include "absl/base/nullability.h"
+#include "absl/log/die_if_null.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "absl/types/optional.h"
@@ -25,6 +27,7 @@
 #include "runtime/activation.h"
 #include "cel/expr/conformance/proto2/test_all_types.pb.h"
 #include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
 
 namespace cel::extensions {
 namespace {
@@ -40,6 +43,12 @@ using ::testing::Optional;
 
 using BindProtoToActivationTest = common_internal::ValueTest<>;
 
+const google::protobuf::Descriptor* absl_nonnull GetTestAllTypesDescriptor(
+    const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool) {
+  return ABSL_DIE_IF_NULL(descriptor_pool->FindMessageTypeByName(  // Crash OK
+      "cel.expr.conformance.proto2.TestAllTypes"));
+}
+
 TEST_F(BindProtoToActivationTest, BindProtoToActivation) {
   TestAllTypes test_all_types;
   test_all_types.set_single_int64(123);
@@ -103,6 +112,69 @@ TEST_F(BindProtoToActivationTest, BindProtoToActivationDefault) {
               IsOkAndHolds(Optional(IntValueIs(0))));
 }
 
+TEST_F(BindProtoToActivationTest, BindSerializedProtoToActivation) {
+  TestAllTypes test_all_types;
+  test_all_types.set_single_int64(123);
+  Activation activation;
+
+  ASSERT_THAT(BindSerializedProtoToActivation(
+                  *GetTestAllTypesDescriptor(descriptor_pool()),
+                  test_all_types.SerializeAsString(), descriptor_pool(),
+                  message_factory(), arena(), &activation),
+              IsOk());
+
+  EXPECT_THAT(activation.FindVariable("single_int64", descriptor_pool(),
+                                      message_factory(), arena()),
+              IsOkAndHolds(Optional(IntValueIs(123))));
+  EXPECT_THAT(activation.FindVariable("single_int32", descriptor_pool(),
+                                      message_factory(), arena()),
+              IsOkAndHolds(Eq(absl::nullopt)));
+}
+
+TEST_F(BindProtoToActivationTest, BindSerializedProtoToActivationDefault) {
+  Activation activation;
+
+  ASSERT_THAT(BindSerializedProtoToActivation(
+                  *GetTestAllTypesDescriptor(descriptor_pool()), "",
+                  BindProtoUnsetFieldBehavior::kBindDefaultValue,
+                  descriptor_pool(), message_factory(), arena(), &activation),
+              IsOk());
+
+  EXPECT_THAT(activation.FindVariable("single_int32", descriptor_pool(),
+                                      message_factory(), arena()),
+              IsOkAndHolds(Optional(IntValueIs(-32))));
+  EXPECT_THAT(activation.FindVariable("single_any", descriptor_pool(),
+                                      message_factory(), arena()),
+              IsOkAndHolds(Optional(test::IsNullValue())));
+}
+
+TEST_F(BindProtoToActivationTest, BindSerializedProtoToActivationMalformed) {
+  Activation activation;
+
+  ASSERT_THAT(BindSerializedProtoToActivation(
+                  *GetTestAllTypesDescriptor(descriptor_pool()), "\x08",
+                  descriptor_pool(), message_factory(), arena(), &activation),
+              IsOk());
+
+  EXPECT_THAT(activation.FindVariable("single_int64", descriptor_pool(),
+                                      message_factory(), arena()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(BindProtoToActivationTest,
+       BindSerializedProtoToActivationWktUnsupported) {
+  Activation activation;
+
+  EXPECT_THAT(BindSerializedProtoToActivation(
+                  *ABSL_DIE_IF_NULL(  // Crash OK
+                      descriptor_pool()->FindMessageTypeByName(
+                          "google.protobuf.Int64Value")),
+                  "",
+                  descriptor_pool(), message_factory(), arena(), &activation),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("google.protobuf.Int64Value")));
+}
+
 // Special case any fields. Mirrors go evaluator behavior.
 TEST_F(BindProtoToActivationTest, BindProtoToActivationDefaultAny) {
   TestAllTypes test_all_types;
@@ -0,0 +1,471 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "extensions/protobuf/lazy_message_value.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/call_once.h"
+#include "absl/base/nullability.h"
+#include "absl/base/optimization.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "common/native_type.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "internal/json.h"
+#include "internal/status_macros.h"
+#include "runtime/runtime_options.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/dynamic_message.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/wire_format_lite.h"
+
+namespace cel::extensions {
+
+namespace {
+
+using ::google::protobuf::internal::WireFormatLite;
+
+// The location of one record, that is a tag and its payload, in the wire
+// format of a message.
+struct FieldRecord {
+  int32_t number;
+  uint32_t begin;
+  uint32_t end;
+};
+
+struct FieldRecordNumberLess {
+  bool operator()(const FieldRecord& lhs, int32_t rhs) const {
+    return lhs.number < rhs;
+  }
+
+  bool operator()(int32_t lhs, const FieldRecord& rhs) const {
+    return lhs < rhs.number;
+  }
+};
+
+class LazyMessageValue final : public CustomStructValueInterface {
+ public:
+  LazyMessageValue(const google::protobuf::Descriptor* absl_nonnull descriptor,
+                   absl::string_view serialized)
+      : descriptor_(descriptor), serialized_(serialized) {}
+
+  absl::string_view GetTypeName() const override {
+    return descriptor_->full_name();
+  }
+
+  StructType GetRuntimeType() const override {
+    return MessageType(descriptor_);
+  }
+
+  std::string DebugString() const override {
+    google::protobuf::DynamicMessageFactory message_factory(descriptor_->file()->pool());
+    std::unique_ptr<google::protobuf::Message> message(
+        message_factory.GetPrototype(descriptor_)->New());
+    if (!message->ParsePartialFromString(serialized_)) {
+      return absl::StrCat(GetTypeName(), "{<malformed>}");
+    }
+    return absl::StrCat(*message);
+  }
+
+  bool IsZeroValue() const override {
+    return Index().ok() && index_.empty();
+  }
+
+  absl::Status SerializeTo(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::io::ZeroCopyOutputStream* absl_nonnull output) const override {
+    ABSL_DCHECK(output != nullptr);
+
+    google::protobuf::io::CodedOutputStream coded_output(output);
+    coded_output.WriteRaw(serialized_.data(),
+                          static_cast<int>(serialized_.size()));
+    coded_output.Trim();
+    if (coded_output.HadError()) {
+      return absl::UnknownError(
+          absl::StrCat("failed to serialize message: ", GetTypeName()));
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status ConvertToJsonObject(
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Message* absl_nonnull json) const override {
+    ABSL_DCHECK(descriptor_pool != nullptr);
+    ABSL_DCHECK(message_factory != nullptr);
+    ABSL_DCHECK(json != nullptr);
+
+    google::protobuf::Arena arena;
+    CEL_ASSIGN_OR_RETURN(const google::protobuf::Message* absl_nonnull prototype,
+                         GetPrototype(message_factory));
+    google::protobuf::Message* absl_nonnull message = prototype->New(&arena);
+    if (!message->ParsePartialFromString(serialized_)) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("failed to parse message: ", GetTypeName()));
+    }
+    return internal::MessageToJson(*message, descriptor_pool, message_factory,
+                                   json);
+  }
+
+  absl::Status GetFieldByName(
+      absl::string_view name, ProtoWrapperTypeOptions unboxing_options,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull result) const override {
+    const google::protobuf::FieldDescriptor* absl_nullable field = FindField(name);
+    if (field == nullptr) {
+      *result = NoSuchFieldError(name);
+      return absl::OkStatus();
+    }
+    return GetField(field, unboxing_options, descriptor_pool, message_factory,
+                    arena, result);
+  }
+
+  absl::Status GetFieldByNumber(
+      int64_t number, ProtoWrapperTypeOptions unboxing_options,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena,
+      Value* absl_nonnull result) const override {
+    const google::protobuf::FieldDescriptor* absl_nullable field = FindField(number);
+    if (field == nullptr) {
+      *result = NoSuchFieldError(absl::StrCat(number));
+      return absl::OkStatus();
+    }
+    return GetField(field, unboxing_options, descriptor_pool, message_factory,
+                    arena, result);
+  }
+
+  absl::StatusOr<bool> HasFieldByName(absl::string_view name) const override {
+    const google::protobuf::FieldDescriptor* absl_nullable field = FindField(name);
+    if (field == nullptr) {
+      return NoSuchFieldError(name).NativeValue();
+    }
+    return HasField(field);
+  }
+
+  absl::StatusOr<bool> HasFieldByNumber(int64_t number) const override {
+    const google::protobuf::FieldDescriptor* absl_nullable field = FindField(number);
+    if (field == nullptr) {
+      return NoSuchFieldError(absl::StrCat(number)).NativeValue();
+    }
+    return HasField(field);
+  }
+
+  absl::Status ForEachField(
+      ForEachFieldCallback callback,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena) const override {
+    for (int i = 0; i < descriptor_->field_count(); ++i) {
+      const google::protobuf::FieldDescriptor* absl_nonnull field = descriptor_->field(i);
+      CEL_ASSIGN_OR_RETURN(bool present, HasField(field));
+      if (!present) {
+        continue;
+      }
+      Value value;
+      CEL_RETURN_IF_ERROR(GetField(field, ProtoWrapperTypeOptions::kUnsetNull,
+                                   descriptor_pool, message_factory, arena,
+                                   &value));
+      CEL_ASSIGN_OR_RETURN(bool ok, callback(field->name(), value));
+      if (!ok) {
+        break;
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  CustomStructValue Clone(google::protobuf::Arena* absl_nonnull arena) const override {
+    return NewLazyMessageValue(descriptor_, serialized_, arena);
+  }
+
+ private:
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<LazyMessageValue>();
+  }
+
+  const google::protobuf::FieldDescriptor* absl_nullable FindField(
+      absl::string_view name) const {
+    const google::protobuf::FieldDescriptor* field = descriptor_->FindFieldByName(name);
+    if (field == nullptr) {
+      field = descriptor_->file()->pool()->FindExtensionByPrintableName(
+          descriptor_, name);
+    }
+    return field;
+  }
+
+  const google::protobuf::FieldDescriptor* absl_nullable FindField(int64_t number) const {
+    if (number < std::numeric_limits<int32_t>::min() ||
+        number > std::numeric_limits<int32_t>::max()) {
+      return nullptr;
+    }
+    return descriptor_->FindFieldByNumber(static_cast<int>(number));
+  }
+
+  absl::StatusOr<const google::protobuf::Message* absl_nonnull> GetPrototype(
+      google::protobuf::MessageFactory* absl_nonnull message_factory) const {
+    const google::protobuf::Message* prototype =
+        message_factory->GetPrototype(descriptor_);
+    if (ABSL_PREDICT_FALSE(prototype == nullptr)) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("missing prototype for message: ", GetTypeName()));
+    }
+    return prototype;
+  }
+
+  // Builds `index_` on first use, returning any error encountered while doing
+  // so.
+  absl::Status Index() const {
+    absl::call_once(index_once_, [this]() { index_status_ = BuildIndex(); });
+    return index_status_;
+  }
+
+  absl::Status BuildIndex() const {
+    if (serialized_.size() >
+        static_cast<size_t>(std::numeric_limits<int>::max())) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("message too large: ", GetTypeName()));
+    }
+    google::protobuf::io::CodedInputStream input(
+        reinterpret_cast<const uint8_t*>(serialized_.data()),
+        static_cast<int>(serialized_.size()));
+    while (input.CurrentPosition() < static_cast<int>(serialized_.size())) {
+      const int begin = input.CurrentPosition();
+      const uint32_t tag = input.ReadTag();
+      if (ABSL_PREDICT_FALSE(
+              tag == 0 || WireFormatLite::GetTagWireType(tag) ==
+                              WireFormatLite::WIRETYPE_END_GROUP ||
+              !WireFormatLite::SkipField(&input, tag))) {
+        index_.clear();
+        return absl::InvalidArgumentError(
+            absl::StrCat("failed to parse message: ", GetTypeName()));
+      }
+      index_.push_back(FieldRecord{
+          static_cast<int32_t>(WireFormatLite::GetTagFieldNumber(tag)),
+          static_cast<uint32_t>(begin),
+          static_cast<uint32_t>(input.CurrentPosition())});
+    }
+    std::stable_sort(index_.begin(), index_.end(),
+                     [](const FieldRecord& lhs, const FieldRecord& rhs) {
+                       return lhs.number < rhs.number;
+                     });
+    return absl::OkStatus();
+  }
+
+  absl::Span<const FieldRecord> RecordsOf(int32_t number) const {
+    auto range = std::equal_range(index_.begin(), index_.end(), number,
+                                  FieldRecordNumberLess{});
+    return absl::MakeConstSpan(index_.data() + (range.first - index_.begin()),
+                               range.second - range.first);
+  }
+
+  // Returns the records which contribute to `field` when parsing the whole
+  // message. For members of a oneof, only the member occurring last is set,
+  // and setting another member clears it, so only its records following the
+  // last record of another member contribute.
+  absl::StatusOr<absl::Span<const FieldRecord>> RecordsOf(
+      const google::protobuf::FieldDescriptor* absl_nonnull field) const {
+    CEL_RETURN_IF_ERROR(Index());
+    absl::Span<const FieldRecord> records = RecordsOf(field->number());
+    if (const google::protobuf::OneofDescriptor* oneof = field->real_containing_oneof();
+        oneof != nullptr && !records.empty()) {
+      uint32_t cleared_at = 0;
+      for (int i = 0; i < oneof->field_count(); ++i) {
+        if (oneof->field(i) == field) {
+          continue;
+        }
+        absl::Span<const FieldRecord> other_records =
+            RecordsOf(oneof->field(i)->number());
+        if (other_records.empty()) {
+          continue;
+        }
+        if (other_records.back().end > records.back().end) {
+          return absl::Span<const FieldRecord>();
+        }
+        cleared_at = std::max(cleared_at, other_records.back().end);
+      }
+      // Records of the same field number are in wire order.
+      records.remove_prefix(
+          std::partition_point(records.begin(), records.end(),
+                               [cleared_at](const FieldRecord& record) {
+                                 return record.begin < cleared_at;
+                               }) -
+          records.begin());
+    }
+    return records;
+  }
+
+  // Returns a message in which only `field` is set, decoded from its records.
+  absl::StatusOr<const google::protobuf::Message* absl_nonnull> DecodeField(
+      const google::protobuf::FieldDescriptor* absl_nonnull field,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena) const {
+    CEL_ASSIGN_OR_RETURN(absl::Span<const FieldRecord> records,
+                         RecordsOf(field));
+    CEL_ASSIGN_OR_RETURN(const google::protobuf::Message* absl_nonnull prototype,
+                         GetPrototype(message_factory));
+    if (records.empty()) {
+      return prototype;
+    }
+    google::protobuf::Message* absl_nonnull message = prototype->New(arena);
+    for (const FieldRecord& record : records) {
+      google::protobuf::io::CodedInputStream input(
+          reinterpret_cast<const uint8_t*>(serialized_.data()) + record.begin,
+          static_cast<int>(record.end - record.begin));
+      input.SetExtensionRegistry(descriptor_pool, message_factory);
+      if (ABSL_PREDICT_FALSE(!message->MergePartialFromCodedStream(&input))) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("failed to parse field: ", field->full_name()));
+      }
+    }
+    return message;
+  }
+
+  absl::Status GetField(
+      const google::protobuf::FieldDescriptor* absl_nonnull field,
+      ProtoWrapperTypeOptions unboxing_options,
+      const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+      google::protobuf::MessageFactory* absl_nonnull message_factory,
+      google::protobuf::Arena* absl_nonnull arena, Value* absl_nonnull result) const {
+    ABSL_DCHECK(descriptor_pool != nullptr);
+    ABSL_DCHECK(message_factory != nullptr);
+    ABSL_DCHECK(arena != nullptr);
+    ABSL_DCHECK(result != nullptr);
+
+    CEL_ASSIGN_OR_RETURN(
+        const google::protobuf::Message* absl_nonnull message,
+        DecodeField(field, descriptor_pool, message_factory, arena));
+    *result = Value::WrapField(unboxing_options, message, field,
+                               descriptor_pool, message_factory, arena);
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<bool> HasField(
+      const google::protobuf::FieldDescriptor* absl_nonnull field) const {
+    CEL_ASSIGN_OR_RETURN(absl::Span<const FieldRecord> records,
+                         RecordsOf(field));
+    if (records.empty()) {
+      return false;
+    }
+    if (field->is_repeated()) {
+      if (field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_STRING ||
+          field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE) {
+        return true;
+      }
+      // Packed scalars may be encoded as empty records.
+      return std::any_of(
+          records.begin(), records.end(), [this](const FieldRecord& record) {
+            RecordPayload payload = ReadPayload(record);
+            return payload.wire_type !=
+                       WireFormatLite::WIRETYPE_LENGTH_DELIMITED ||
+                   !payload.zero;
+          });
+    }
+    if (field->has_presence()) {
+      return true;
+    }
+    // Fields without presence are only set if the last record is not zero.
+    return !ReadPayload(records.back()).zero;
+  }
+
+  struct RecordPayload {
+    WireFormatLite::WireType wire_type;
+    // Whether the payload is zero or, if length delimited, empty.
+    bool zero;
+  };
+
+  RecordPayload ReadPayload(const FieldRecord& record) const {
+    google::protobuf::io::CodedInputStream input(
+        reinterpret_cast<const uint8_t*>(serialized_.data()) + record.begin,
+        static_cast<int>(record.end - record.begin));
+    const uint32_t tag = input.ReadTag();
+    RecordPayload payload{WireFormatLite::GetTagWireType(tag), false};
+    // The records were validated when building the index.
+    switch (payload.wire_type) {
+      case WireFormatLite::WIRETYPE_VARINT: {
+        uint64_t value = 0;
+        payload.zero = input.ReadVarint64(&value) && value == 0;
+        break;
+      }
+      case WireFormatLite::WIRETYPE_FIXED64: {
+        uint64_t value = 0;
+        payload.zero = input.ReadLittleEndian64(&value) && value == 0;
+        break;
+      }
+      case WireFormatLite::WIRETYPE_FIXED32: {
+        uint32_t value = 0;
+        payload.zero = input.ReadLittleEndian32(&value) && value == 0;
+        break;
+      }
+      case WireFormatLite::WIRETYPE_LENGTH_DELIMITED: {
+        uint32_t length = 0;
+        payload.zero = input.ReadVarint32(&length) && length == 0;
+        break;
+      }
+      default:
+        break;
+    }
+    return payload;
+  }
+
+  const google::protobuf::Descriptor* absl_nonnull const descriptor_;
+  const absl::string_view serialized_;
+  mutable absl::once_flag index_once_;
+  mutable absl::Status index_status_;
+  // The records of `serialized_` ordered by field number, and for each field in
+  // the order they occur.
+  mutable std::vector<FieldRecord> index_;
+};
+
+}  // namespace
+
+CustomStructValue NewLazyMessageValue(
+    const google::protobuf::Descriptor* absl_nonnull descriptor,
+    absl::string_view serialized, google::protobuf::Arena* absl_nonnull arena) {
+  ABSL_DCHECK(descriptor != nullptr);
+  ABSL_DCHECK(arena != nullptr);
+
+  char* data = nullptr;
+  if (!serialized.empty()) {
+    data = static_cast<char*>(arena->AllocateAligned(serialized.size()));
+    std::memcpy(data, serialized.data(), serialized.size());
+  }
+  LazyMessageValue* absl_nonnull value =
+      ::new (arena->AllocateAligned(sizeof(LazyMessageValue),
+                                    alignof(LazyMessageValue)))
+          LazyMessageValue(descriptor,
+                           absl::string_view(data, serialized.size()));
+  arena->OwnDestructor(value);
+  return CustomStructValue(value, arena);
+}
+
+}  // namespace cel::extensions
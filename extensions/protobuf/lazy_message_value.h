@@ -0,0 +1,48 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EXTENSIONS_PROTOBUF_LAZY_MESSAGE_VALUE_H_
+#define THIRD_PARTY_CEL_CPP_EXTENSIONS_PROTOBUF_LAZY_MESSAGE_VALUE_H_
+
+#include "absl/base/attributes.h"
+#include "absl/base/nullability.h"
+#include "absl/strings/string_view.h"
+#include "common/value.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+
+namespace cel::extensions {
+
+// Returns a struct value for the message of type `descriptor` whose wire format
+// is `serialized`, which is copied to `arena`.
+//
+// Unlike parsing the message up front and wrapping it as a
+// `ParsedMessageValue`, fields are decoded on demand. The first access records
+// where each field occurs in `serialized`, after which accessing a field only
+// decodes the records of that field. This is cheaper when expressions touch a
+// few fields of a large message. Message typed fields are decoded as a whole
+// when accessed.
+//
+// Malformed input is reported as an error by the first field access.
+// `descriptor` must outlive the result, and the message factories passed to its
+// accessors must provide prototypes for `descriptor`.
+CustomStructValue NewLazyMessageValue(
+    const google::protobuf::Descriptor* absl_nonnull descriptor
+        ABSL_ATTRIBUTE_LIFETIME_BOUND,
+    absl::string_view serialized,
+    google::protobuf::Arena* absl_nonnull arena ABSL_ATTRIBUTE_LIFETIME_BOUND);
+
+}  // namespace cel::extensions
+
+#endif  // THIRD_PARTY_CEL_CPP_EXTENSIONS_PROTOBUF_LAZY_MESSAGE_VALUE_H_
@@ -0,0 +1,123 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "cel/expr/syntax.pb.h"
+#include "absl/log/absl_check.h"
+#include "absl/log/die_if_null.h"
+#include "absl/strings/string_view.h"
+#include "common/value.h"
+#include "extensions/protobuf/bind_proto_to_activation.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/benchmark.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "internal/testing_message_factory.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "cel/expr/conformance/proto3/test_all_types.pb.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+
+namespace cel::extensions {
+namespace {
+
+using ::cel::expr::conformance::proto3::TestAllTypes;
+using ::google::api::expr::parser::Parse;
+
+// The expression touches 3 fields of the context message.
+constexpr absl::string_view kExpression =
+    "single_int64 > 0 && single_string.startsWith('a') && "
+    "single_nested_message.bb == 3";
+
+// Returns a serialized context message of about 5 KiB, most of which is in
+// fields not referenced by `kExpression`.
+std::string MakeSerializedMessage() {
+  TestAllTypes message;
+  message.set_single_int64(1);
+  message.set_single_string("abc");
+  message.mutable_single_nested_message()->set_bb(3);
+  for (int i = 0; i < 50; ++i) {
+    message.add_repeated_string(std::string(100, 'x'));
+  }
+  for (int i = 0; i < 50; ++i) {
+    message.add_repeated_int64(i);
+  }
+  std::string serialized = message.SerializeAsString();
+  ABSL_CHECK_GE(serialized.size(), 5000u);
+  return serialized;
+}
+
+std::unique_ptr<Program> MakeProgram() {
+  RuntimeOptions options;
+  auto builder = CreateStandardRuntimeBuilder(
+      internal::GetTestingDescriptorPool(), options);
+  ABSL_CHECK_OK(builder);
+  auto runtime = std::move(*builder).Build();
+  ABSL_CHECK_OK(runtime);
+  auto expr = Parse(kExpression);
+  ABSL_CHECK_OK(expr);
+  auto program = ProtobufRuntimeAdapter::CreateProgram(**runtime, *expr);
+  ABSL_CHECK_OK(program);
+  return std::move(*program);
+}
+
+void BM_ParseThenEval(benchmark::State& state) {
+  std::unique_ptr<Program> program = MakeProgram();
+  const std::string serialized = MakeSerializedMessage();
+  for (auto _ : state) {
+    google::protobuf::Arena arena;
+    auto* message = google::protobuf::Arena::Create<TestAllTypes>(&arena);
+    ABSL_CHECK(message->ParseFromString(serialized));
+    Activation activation;
+    ABSL_CHECK_OK(BindProtoToActivation(
+        *message, internal::GetTestingDescriptorPool(),
+        internal::GetTestingMessageFactory(), &arena, &activation));
+    auto result = program->Evaluate(&arena, activation);
+    ABSL_CHECK_OK(result);
+    ABSL_CHECK(result->IsTrue());
+  }
+  state.SetBytesProcessed(state.iterations() * serialized.size());
+}
+BENCHMARK(BM_ParseThenEval);
+
+void BM_LazyDecode(benchmark::State& state) {
+  std::unique_ptr<Program> program = MakeProgram();
+  const std::string serialized = MakeSerializedMessage();
+  const google::protobuf::Descriptor* descriptor =
+      ABSL_DIE_IF_NULL(internal::GetTestingDescriptorPool()  // Crash OK
+                           ->FindMessageTypeByName(
+                               "cel.expr.conformance.proto3.TestAllTypes"));
+  for (auto _ : state) {
+    google::protobuf::Arena arena;
+    Activation activation;
+    ABSL_CHECK_OK(BindSerializedProtoToActivation(
+        *descriptor, serialized, internal::GetTestingDescriptorPool(),
+        internal::GetTestingMessageFactory(), &arena, &activation));
+    auto result = program->Evaluate(&arena, activation);
+    ABSL_CHECK_OK(result);
+    ABSL_CHECK(result->IsTrue());
+  }
+  state.SetBytesProcessed(state.iterations() * serialized.size());
+}
+BENCHMARK(BM_LazyDecode);
+
+}  // namespace
+}  // namespace cel::extensions
@@ -0,0 +1,201 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "extensions/protobuf/lazy_message_value.h"
+
+#include <string>
+#include <utility>
+
+#include "absl/log/die_if_null.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "internal/testing.h"
+#include "cel/expr/conformance/proto3/test_all_types.pb.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+
+namespace cel::extensions {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::cel::expr::conformance::proto3::TestAllTypes;
+using ::cel::test::BoolValueIs;
+using ::cel::test::ErrorValueIs;
+using ::cel::test::IntValueIs;
+using ::cel::test::ListValueElements;
+using ::cel::test::ListValueIs;
+using ::cel::test::StringValueIs;
+using ::cel::test::StructValueFieldHas;
+using ::cel::test::StructValueFieldIs;
+using ::testing::ElementsAre;
+using ::testing::IsFalse;
+using ::testing::IsTrue;
+
+class LazyMessageValueTest : public common_internal::ValueTest<> {
+ public:
+  StructValue MakeLazy(absl::string_view serialized) {
+    return NewLazyMessageValue(
+        ABSL_DIE_IF_NULL(descriptor_pool()->FindMessageTypeByName(  // Crash OK
+            "cel.expr.conformance.proto3.TestAllTypes")),
+        serialized, arena());
+  }
+};
+
+TEST_F(LazyMessageValueTest, GetFields) {
+  TestAllTypes message;
+  message.set_single_int64(5);
+  message.set_single_string("foo");
+  message.add_repeated_int32(1);
+  message.add_repeated_int32(2);
+  message.mutable_single_nested_message()->set_bb(3);
+  StructValue value = MakeLazy(message.SerializeAsString());
+
+  EXPECT_EQ(value.GetTypeName(), "cel.expr.conformance.proto3.TestAllTypes");
+  EXPECT_THAT(value, StructValueFieldIs("single_int64", IntValueIs(5),
+                                        descriptor_pool(), message_factory(),
+                                        arena()));
+  EXPECT_THAT(value, StructValueFieldIs("single_string", StringValueIs("foo"),
+                                        descriptor_pool(), message_factory(),
+                                        arena()));
+  EXPECT_THAT(value,
+              StructValueFieldIs(
+                  "repeated_int32",
+                  ListValueIs(ListValueElements(
+                      ElementsAre(IntValueIs(1), IntValueIs(2)),
+                      descriptor_pool(), message_factory(), arena())),
+                  descriptor_pool(), message_factory(), arena()));
+  ASSERT_OK_AND_ASSIGN(Value nested, value.GetFieldByName(
+                                         "single_nested_message",
+                                         descriptor_pool(), message_factory(),
+                                         arena()));
+  EXPECT_THAT(nested, StructValueFieldIs("bb", IntValueIs(3),
+                                         descriptor_pool(), message_factory(),
+                                         arena()));
+  EXPECT_THAT(value, StructValueFieldIs("single_int32", IntValueIs(0),
+                                        descriptor_pool(), message_factory(),
+                                        arena()));
+}
+
+TEST_F(LazyMessageValueTest, HasFields) {
+  TestAllTypes message;
+  message.set_single_int64(5);
+  message.mutable_single_nested_message();
+  StructValue value = MakeLazy(message.SerializeAsString());
+
+  EXPECT_THAT(value, StructValueFieldHas("single_int64", IsTrue()));
+  EXPECT_THAT(value, StructValueFieldHas("single_nested_message", IsTrue()));
+  EXPECT_THAT(value, StructValueFieldHas("single_int32", IsFalse()));
+  EXPECT_THAT(value, StructValueFieldHas("repeated_int32", IsFalse()));
+  EXPECT_FALSE(value.IsZeroValue());
+  EXPECT_TRUE(MakeLazy("").IsZeroValue());
+}
+
+TEST_F(LazyMessageValueTest, ExplicitlyEncodedDefaults) {
+  // single_int32 = 0 followed by an empty packed repeated_int32.
+  StructValue value = MakeLazy(absl::string_view("\x08\x00\xfa\x01\x00", 5));
+
+  EXPECT_THAT(value, StructValueFieldHas("single_int32", IsFalse()));
+  EXPECT_THAT(value, StructValueFieldHas("repeated_int32", IsFalse()));
+}
+
+TEST_F(LazyMessageValueTest, LastRecordWins) {
+  // single_int32 = 1 followed by single_int32 = 2.
+  StructValue value = MakeLazy("\x08\x01\x08\x02");
+
+  EXPECT_THAT(value, StructValueFieldIs("single_int32", IntValueIs(2),
+                                        descriptor_pool(), message_factory(),
+                                        arena()));
+}
+
+TEST_F(LazyMessageValueTest, LastOneofMemberWins) {
+  TestAllTypes first;
+  first.set_oneof_bool(true);
+  TestAllTypes second;
+  second.mutable_oneof_msg()->set_bb(1);
+  StructValue value =
+      MakeLazy(first.SerializeAsString() + second.SerializeAsString());
+
+  EXPECT_THAT(value, StructValueFieldHas("oneof_bool", IsFalse()));
+  EXPECT_THAT(value, StructValueFieldHas("oneof_msg", IsTrue()));
+  EXPECT_THAT(value, StructValueFieldIs("oneof_bool", BoolValueIs(false),
+                                        descriptor_pool(), message_factory(),
+                                        arena()));
+}
+
+TEST_F(LazyMessageValueTest, OtherOneofMemberClearsEarlierRecords) {
+  // oneof_msg, oneof_bool, then oneof_msg again: parsing the whole message
+  // discards the first oneof_msg when oneof_bool is set.
+  TestAllTypes first;
+  first.mutable_oneof_msg()->set_bb(1);
+  TestAllTypes second;
+  second.set_oneof_bool(true);
+  TestAllTypes third;
+  third.mutable_oneof_msg();
+  StructValue value =
+      MakeLazy(first.SerializeAsString() + second.SerializeAsString() +
+               third.SerializeAsString());
+
+  EXPECT_THAT(value, StructValueFieldHas("oneof_bool", IsFalse()));
+  EXPECT_THAT(value, StructValueFieldHas("oneof_msg", IsTrue()));
+  ASSERT_OK_AND_ASSIGN(
+      Value nested, value.GetFieldByName("oneof_msg", descriptor_pool(),
+                                         message_factory(), arena()));
+  EXPECT_THAT(nested, StructValueFieldIs("bb", IntValueIs(0),
+                                         descriptor_pool(), message_factory(),
+                                         arena()));
+}
+
+TEST_F(LazyMessageValueTest, NoSuchField) {
+  StructValue value = MakeLazy("");
+
+  EXPECT_THAT(value.GetFieldByName("does_not_exist", descriptor_pool(),
+                                   message_factory(), arena()),
+              IsOkAndHolds(ErrorValueIs(
+                  StatusIs(absl::StatusCode::kNotFound))));
+  EXPECT_THAT(value.HasFieldByName("does_not_exist"),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST_F(LazyMessageValueTest, MalformedInput) {
+  // A truncated varint.
+  StructValue value = MakeLazy("\x08");
+
+  EXPECT_THAT(value.GetFieldByName("single_int64", descriptor_pool(),
+                                   message_factory(), arena()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(value.HasFieldByName("single_int64"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(LazyMessageValueTest, SerializeTo) {
+  TestAllTypes message;
+  message.set_single_int64(5);
+  message.set_single_string("foo");
+  StructValue value = MakeLazy(message.SerializeAsString());
+
+  google::protobuf::io::CordOutputStream output;
+  ASSERT_THAT(
+      value.SerializeTo(descriptor_pool(), message_factory(), &output),
+      IsOk());
+  EXPECT_EQ(std::move(output).Consume(), message.SerializeAsString());
+}
+
+}  // namespace
+}  // namespace cel::extensions
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <utility>
 
@@ -37,9 +38,12 @@
 #include "internal/status_macros.h"
 #include "runtime/function_adapter.h"
 #include "runtime/function_registry.h"
+#include "runtime/internal/regex_cache.h"
+#include "runtime/internal/regex_cache_access.h"
 #include "runtime/internal/runtime_friend_access.h"
 #include "runtime/internal/runtime_impl.h"
 #include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
@@ -49,8 +53,13 @@ namespace cel::extensions {
 namespace {
 
 using ::cel::checker_internal::BuiltinsArena;
+using ::cel::runtime_internal::BindRegexCache;
+using ::cel::runtime_internal::ExceedsMaxProgramSize;
+using ::cel::runtime_internal::RegexCache;
+using ::cel::runtime_internal::RegexCacheAccess;
 
-Value Extract(const StringValue& target, const StringValue& regex,
+Value Extract(RegexCache& cache, int max_program_size,
+              const StringValue& target, const StringValue& regex,
               const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
               google::protobuf::MessageFactory* absl_nonnull message_factory,
               google::protobuf::Arena* absl_nonnull arena) {
@@ -58,7 +67,13 @@ Value Extract(const StringValue& target, const StringValue& regex,
   std::string regex_scratch;
   absl::string_view target_view = target.ToStringView(&target_scratch);
   absl::string_view regex_view = regex.ToStringView(&regex_scratch);
-  RE2 re2(regex_view);
+  std::shared_ptr<const RE2> compiled =
+      cache.Get(regex_view, max_program_size);
+  const RE2& re2 = *compiled;
+  if (ExceedsMaxProgramSize(re2, max_program_size)) {
+    return ErrorValue(
+        absl::InvalidArgumentError("exceeded RE2 max program size"));
+  }
   if (!re2.ok()) {
     return ErrorValue(absl::InvalidArgumentError(
         absl::StrFormat("given regex is invalid: %s", re2.error())));
@@ -83,7 +98,8 @@ Value Extract(const StringValue& target, const StringValue& regex,
   return OptionalValue::None();
 }
 
-Value ExtractAll(const StringValue& target, const StringValue& regex,
+Value ExtractAll(RegexCache& cache, int max_program_size,
+                 const StringValue& target, const StringValue& regex,
                  const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
                  google::protobuf::MessageFactory* absl_nonnull message_factory,
                  google::protobuf::Arena* absl_nonnull arena) {
@@ -91,7 +107,13 @@ Value ExtractAll(const StringValue& target, const StringValue& regex,
   std::string regex_scratch;
   absl::string_view target_view = target.ToStringView(&target_scratch);
   absl::string_view regex_view = regex.ToStringView(&regex_scratch);
-  RE2 re2(regex_view);
+  std::shared_ptr<const RE2> compiled =
+      cache.Get(regex_view, max_program_size);
+  const RE2& re2 = *compiled;
+  if (ExceedsMaxProgramSize(re2, max_program_size)) {
+    return ErrorValue(
+        absl::InvalidArgumentError("exceeded RE2 max program size"));
+  }
   if (!re2.ok()) {
     return ErrorValue(absl::InvalidArgumentError(
         absl::StrFormat("given regex is invalid: %s", re2.error())));
@@ -142,7 +164,8 @@ Value ExtractAll(const StringValue& target, const StringValue& regex,
   return std::move(*builder).Build();
 }
 
-Value ReplaceAll(const StringValue& target, const StringValue& regex,
+Value ReplaceAll(RegexCache& cache, int max_program_size,
+                 const StringValue& target, const StringValue& regex,
                  const StringValue& replacement,
                  const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
                  google::protobuf::MessageFactory* absl_nonnull message_factory,
@@ -154,7 +177,13 @@ Value ReplaceAll(const StringValue& target, const StringValue& regex,
   absl::string_view regex_view = regex.ToStringView(&regex_scratch);
   absl::string_view replacement_view =
       replacement.ToStringView(&replacement_scratch);
-  RE2 re2(regex_view);
+  std::shared_ptr<const RE2> compiled =
+      cache.Get(regex_view, max_program_size);
+  const RE2& re2 = *compiled;
+  if (ExceedsMaxProgramSize(re2, max_program_size)) {
+    return ErrorValue(
+        absl::InvalidArgumentError("exceeded RE2 max program size"));
+  }
   if (!re2.ok()) {
     return ErrorValue(absl::InvalidArgumentError(
         absl::StrFormat("given regex is invalid: %s", re2.error())));
@@ -172,7 +201,8 @@ Value ReplaceAll(const StringValue& target, const StringValue& regex,
   return StringValue::From(std::move(output), arena);
 }
 
-Value ReplaceN(const StringValue& target, const StringValue& regex,
+Value ReplaceN(RegexCache& cache, int max_program_size,
+               const StringValue& target, const StringValue& regex,
                const StringValue& replacement, int64_t count,
                const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
                google::protobuf::MessageFactory* absl_nonnull message_factory,
@@ -181,7 +211,7 @@ Value ReplaceN(const StringValue& target, const StringValue& regex,
     return target;
   }
   if (count < 0) {
-    return ReplaceAll(target, regex, replacement, descriptor_pool,
+    return ReplaceAll(cache, target, regex, replacement, descriptor_pool,
                       message_factory, arena);
   }
 
@@ -192,7 +222,13 @@ Value ReplaceN(const StringValue& target, const StringValue& regex,
   absl::string_view regex_view = regex.ToStringView(&regex_scratch);
   absl::string_view replacement_view =
       replacement.ToStringView(&replacement_scratch);
-  RE2 re2(regex_view);
+  std::shared_ptr<const RE2> compiled =
+      cache.Get(regex_view, max_program_size);
+  const RE2& re2 = *compiled;
+  if (ExceedsMaxProgramSize(re2, max_program_size)) {
+    return ErrorValue(
+        absl::InvalidArgumentError("exceeded RE2 max program size"));
+  }
   if (!re2.ok()) {
     return ErrorValue(absl::InvalidArgumentError(
         absl::StrFormat("given regex is invalid: %s", re2.error())));
@@ -233,25 +269,38 @@ Value ReplaceN(const StringValue& target, const StringValue& regex,
 }
 
 absl::Status RegisterRegexExtensionFunctions(FunctionRegistry& registry,
-                                             bool disable_extract) {
+                                             bool disable_extract,
+                                             int max_program_size,
+                                             int cache_capacity) {
+  std::shared_ptr<RegexCache> cache =
+      RegexCacheAccess::GetOrCreate(registry, cache_capacity);
   if (!disable_extract) {
-    CEL_RETURN_IF_ERROR((
-        BinaryFunctionAdapter<absl::StatusOr<Value>, StringValue, StringValue>::
-            RegisterGlobalOverload("regex.extract", &Extract, registry)));
+    CEL_RETURN_IF_ERROR(
+        (BinaryFunctionAdapter<absl::StatusOr<Value>, StringValue,
+                               StringValue>::
+             RegisterGlobalOverload(
+                 "regex.extract",
+                 BindRegexCache(cache, max_program_size, &Extract), registry)));
   }
   CEL_RETURN_IF_ERROR(
       (BinaryFunctionAdapter<absl::StatusOr<Value>, StringValue, StringValue>::
-           RegisterGlobalOverload("regex.extractAll", &ExtractAll, registry)));
+           RegisterGlobalOverload(
+               "regex.extractAll",
+               BindRegexCache(cache, max_program_size, &ExtractAll),
+               registry)));
   CEL_RETURN_IF_ERROR(
-      (TernaryFunctionAdapter<
-          absl::StatusOr<Value>, StringValue, StringValue,
-          StringValue>::RegisterGlobalOverload("regex.replace", &ReplaceAll,
-                                               registry)));
+      (TernaryFunctionAdapter<absl::StatusOr<Value>, StringValue, StringValue,
+                              StringValue>::
+           RegisterGlobalOverload(
+               "regex.replace",
+               BindRegexCache(cache, max_program_size, &ReplaceAll),
+               registry)));
   CEL_RETURN_IF_ERROR(
-      (QuaternaryFunctionAdapter<
-          absl::StatusOr<Value>, StringValue, StringValue, StringValue,
-          int64_t>::RegisterGlobalOverload("regex.replace", &ReplaceN,
-                                           registry)));
+      (QuaternaryFunctionAdapter<absl::StatusOr<Value>, StringValue,
+                                 StringValue, StringValue, int64_t>::
+           RegisterGlobalOverload(
+               "regex.replace",
+               BindRegexCache(cache, max_program_size, &ReplaceN), registry)));
   return absl::OkStatus();
 }
 
@@ -307,10 +356,12 @@ absl::Status RegisterRegexExtensionFunctions(RuntimeBuilder& builder) {
     return absl::InvalidArgumentError(
         "regex extensions requires the optional types to be enabled");
   }
-  if (runtime.expr_builder().options().enable_regex) {
-    CEL_RETURN_IF_ERROR(
-        RegisterRegexExtensionFunctions(builder.function_registry(),
-                                        /*disable_extract=*/false));
+  const RuntimeOptions& options = runtime.expr_builder().options();
+  if (options.enable_regex) {
+    CEL_RETURN_IF_ERROR(RegisterRegexExtensionFunctions(
+        builder.function_registry(),
+        /*disable_extract=*/false, options.regex_max_program_size,
+        options.regex_cache_capacity));
   }
   return absl::OkStatus();
 }
@@ -320,7 +371,9 @@ absl::Status RegisterRegexExtensionFunctions(
     const google::api::expr::runtime::InterpreterOptions& options) {
   if (options.enable_regex) {
     return RegisterRegexExtensionFunctions(registry->InternalGetRegistry(),
-                                           /*disable_extract=*/true);
+                                           /*disable_extract=*/true,
+                                           options.regex_max_program_size,
+                                           options.regex_cache_capacity);
   }
   return absl::OkStatus();
 }
@@ -169,6 +169,71 @@ TEST(RegexExtTest, FollowsRegexOption) {
       IsEmpty());
 }
 
+TEST(RegexExtTest, FollowsMaxProgramSizeOption) {
+  RuntimeOptions options;
+  options.enable_regex = true;
+  options.enable_qualified_type_identifiers = true;
+  options.regex_max_program_size = 100;
+
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       CreateStandardRuntimeBuilder(
+                           internal::GetTestingDescriptorPool(), options));
+  ASSERT_THAT(
+      EnableReferenceResolver(builder, ReferenceResolverEnabled::kAlways),
+      IsOk());
+  ASSERT_THAT(EnableOptionalTypes(builder), IsOk());
+  ASSERT_THAT(RegisterRegexExtensionFunctions(builder), IsOk());
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  google::protobuf::Arena arena;
+  auto evaluate = [&](absl::string_view expr) -> absl::StatusOr<Value> {
+    CEL_ASSIGN_OR_RETURN(auto parsed_expr, Parse(expr));
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<cel::Program> program,
+                         ProtobufRuntimeAdapter::CreateProgram(*runtime,
+                                                               parsed_expr));
+    Activation activation;
+    return program->Evaluate(&arena, activation);
+  };
+
+  EXPECT_THAT(evaluate("regex.extract('hello', 'h(e)')"),
+              IsOkAndHolds(OptionalValueIs(StringValueIs("e"))));
+  for (absl::string_view expr : {
+           "regex.extract('hello', '[a-z]{1,100}')",
+           "regex.extractAll('hello', '[a-z]{1,100}')",
+           "regex.replace('hello', '[a-z]{1,100}', 'x')",
+           "regex.replace('hello', '[a-z]{1,100}', 'x', 1)",
+       }) {
+    EXPECT_THAT(evaluate(expr),
+                IsOkAndHolds(ErrorValueIs(
+                    StatusIs(absl::StatusCode::kInvalidArgument,
+                             HasSubstr("exceeded RE2 max program size")))))
+        << "Expression: " << expr;
+  }
+}
+
+TEST(RegexExtTest, LegacyRuntimeFollowsMaxProgramSizeOption) {
+  InterpreterOptions options;
+  options.enable_regex = true;
+  options.regex_max_program_size = 100;
+
+  std::unique_ptr<CelExpressionBuilder> builder = CreateCelExpressionBuilder(
+      internal::GetTestingDescriptorPool(), nullptr, options);
+  ASSERT_THAT(RegisterRegexExtensionFunctions(builder->GetRegistry(), options),
+              IsOk());
+
+  ASSERT_OK_AND_ASSIGN(
+      auto expr, Parse("regex.extractAll('hello world', '[a-z]{1,100}')"));
+  LegacyActivation activation;
+  google::protobuf::Arena arena;
+  ASSERT_OK_AND_ASSIGN(auto program, builder->CreateExpression(
+                                         &expr.expr(), &expr.source_info()));
+  ASSERT_OK_AND_ASSIGN(auto result, program->Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsError());
+  EXPECT_THAT(*result.ErrorOrDie(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("exceeded RE2 max program size")));
+}
+
 enum class EvaluationType {
   kBoolTrue,
   kOptionalValue,
@@ -34,6 +34,8 @@
 #include "internal/status_macros.h"
 #include "runtime/function_adapter.h"
 #include "runtime/function_registry.h"
+#include "runtime/internal/regex_cache.h"
+#include "runtime/internal/regex_cache_access.h"
 #include "runtime/runtime_options.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
@@ -44,12 +46,17 @@ namespace cel::extensions {
 namespace {
 
 using ::cel::checker_internal::BuiltinsArena;
+using ::cel::runtime_internal::BindRegexCache;
+using ::cel::runtime_internal::ExceedsMaxProgramSize;
+using ::cel::runtime_internal::RegexCache;
+using ::cel::runtime_internal::RegexCacheAccess;
 using ::google::api::expr::runtime::CelFunctionRegistry;
 using ::google::api::expr::runtime::InterpreterOptions;
 
 // Extract matched group values from the given target string and rewrite the
 // string
-Value ExtractString(const StringValue& target, const StringValue& regex,
+Value ExtractString(RegexCache& cache, int max_program_size,
+                    const StringValue& target, const StringValue& regex,
                     const StringValue& rewrite,
                     const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
                     google::protobuf::MessageFactory* absl_nonnull message_factory,
@@ -61,7 +68,13 @@ Value ExtractString(const StringValue& target, const StringValue& regex,
   absl::string_view target_view = target.ToStringView(&target_scratch);
   absl::string_view rewrite_view = rewrite.ToStringView(&rewrite_scratch);
 
-  RE2 re2(regex_view);
+  std::shared_ptr<const RE2> compiled =
+      cache.Get(regex_view, max_program_size);
+  const RE2& re2 = *compiled;
+  if (ExceedsMaxProgramSize(re2, max_program_size)) {
+    return ErrorValue(
+        absl::InvalidArgumentError("exceeded RE2 max program size"));
+  }
   if (!re2.ok()) {
     return ErrorValue(absl::InvalidArgumentError("Given Regex is Invalid"));
   }
@@ -76,7 +89,8 @@ Value ExtractString(const StringValue& target, const StringValue& regex,
 
 // Captures the first unnamed/named group value
 // NOTE: For capturing all the groups, use CaptureStringN instead
-Value CaptureString(const StringValue& target, const StringValue& regex,
+Value CaptureString(RegexCache& cache, int max_program_size,
+                    const StringValue& target, const StringValue& regex,
                     const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
                     google::protobuf::MessageFactory* absl_nonnull message_factory,
                     google::protobuf::Arena* absl_nonnull arena) {
@@ -84,7 +98,13 @@ Value CaptureString(const StringValue& target, const StringValue& regex,
   std::string target_scratch;
   absl::string_view regex_view = regex.ToStringView(&regex_scratch);
   absl::string_view target_view = target.ToStringView(&target_scratch);
-  RE2 re2(regex_view);
+  std::shared_ptr<const RE2> compiled =
+      cache.Get(regex_view, max_program_size);
+  const RE2& re2 = *compiled;
+  if (ExceedsMaxProgramSize(re2, max_program_size)) {
+    return ErrorValue(
+        absl::InvalidArgumentError("exceeded RE2 max program size"));
+  }
   if (!re2.ok()) {
     return ErrorValue(absl::InvalidArgumentError("Given Regex is Invalid"));
   }
@@ -103,7 +123,8 @@ Value CaptureString(const StringValue& target, const StringValue& regex,
 //   a. For a named group - <named_group_name, captured_string>
 //   b. For an unnamed group - <group_index, captured_string>
 absl::StatusOr<Value> CaptureStringN(
-    const StringValue& target, const StringValue& regex,
+    RegexCache& cache, int max_program_size, const StringValue& target,
+    const StringValue& regex,
     const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
     google::protobuf::MessageFactory* absl_nonnull message_factory,
     google::protobuf::Arena* absl_nonnull arena) {
@@ -111,7 +132,13 @@ absl::StatusOr<Value> CaptureStringN(
   std::string regex_scratch;
   absl::string_view target_view = target.ToStringView(&target_scratch);
   absl::string_view regex_view = regex.ToStringView(&regex_scratch);
-  RE2 re2(regex_view);
+  std::shared_ptr<const RE2> compiled =
+      cache.Get(regex_view, max_program_size);
+  const RE2& re2 = *compiled;
+  if (ExceedsMaxProgramSize(re2, max_program_size)) {
+    return ErrorValue(
+        absl::InvalidArgumentError("exceeded RE2 max program size"));
+  }
   if (!re2.ok()) {
     return ErrorValue(absl::InvalidArgumentError("Given Regex is Invalid"));
   }
@@ -148,25 +175,35 @@ absl::StatusOr<Value> CaptureStringN(
   return std::move(*builder).Build();
 }
 
-absl::Status RegisterRegexFunctions(FunctionRegistry& registry) {
+absl::Status RegisterRegexFunctions(FunctionRegistry& registry,
+                                    int max_program_size, int cache_capacity) {
+  std::shared_ptr<RegexCache> cache =
+      RegexCacheAccess::GetOrCreate(registry, cache_capacity);
+
   // Register Regex Extract Function
   CEL_RETURN_IF_ERROR(
-      (TernaryFunctionAdapter<
-          absl::StatusOr<Value>, StringValue, StringValue,
-          StringValue>::RegisterGlobalOverload(kRegexExtract, &ExtractString,
-                                               registry)));
+      (TernaryFunctionAdapter<absl::StatusOr<Value>, StringValue, StringValue,
+                              StringValue>::
+           RegisterGlobalOverload(
+               kRegexExtract,
+               BindRegexCache(cache, max_program_size, &ExtractString),
+               registry)));
 
   // Register Regex Captures Function
-  CEL_RETURN_IF_ERROR((
-      BinaryFunctionAdapter<absl::StatusOr<Value>, StringValue,
-                            StringValue>::RegisterGlobalOverload(kRegexCapture,
-                                                                 &CaptureString,
-                                                                 registry)));
+  CEL_RETURN_IF_ERROR(
+      (BinaryFunctionAdapter<absl::StatusOr<Value>, StringValue, StringValue>::
+           RegisterGlobalOverload(
+               kRegexCapture,
+               BindRegexCache(cache, max_program_size, &CaptureString),
+               registry)));
 
   // Register Regex CaptureN Function
   CEL_RETURN_IF_ERROR(
       (BinaryFunctionAdapter<absl::StatusOr<Value>, StringValue, StringValue>::
-           RegisterGlobalOverload(kRegexCaptureN, &CaptureStringN, registry)));
+           RegisterGlobalOverload(
+               kRegexCaptureN,
+               BindRegexCache(cache, max_program_size, &CaptureStringN),
+               registry)));
   return absl::OkStatus();
 }
 
@@ -207,7 +244,9 @@ absl::Status RegisterRegexDecls(TypeCheckerBuilder& builder) {
 absl::Status RegisterRegexFunctions(FunctionRegistry& registry,
                                     const RuntimeOptions& options) {
   if (options.enable_regex) {
-    CEL_RETURN_IF_ERROR(RegisterRegexFunctions(registry));
+    CEL_RETURN_IF_ERROR(RegisterRegexFunctions(registry,
+                                               options.regex_max_program_size,
+                                               options.regex_cache_capacity));
   }
   return absl::OkStatus();
 }
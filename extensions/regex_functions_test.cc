@@ -23,6 +23,7 @@
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "checker/standard_library.h"
 #include "checker/validation_result.h"
 #include "common/value.h"
@@ -177,6 +178,47 @@ TEST_F(RegexFunctionsTest, CaptureStringWithUnnamedGroups) {
               IsOkAndHolds(StringValueIs("o")));
 }
 
+TEST(RegexFunctionsMaxProgramSizeTest, FollowsMaxProgramSizeOption) {
+  RuntimeOptions options;
+  options.enable_regex = true;
+  options.enable_qualified_type_identifiers = true;
+  options.regex_max_program_size = 100;
+
+  ASSERT_OK_AND_ASSIGN(RuntimeBuilder builder,
+                       CreateStandardRuntimeBuilder(
+                           internal::GetTestingDescriptorPool(), options));
+  ASSERT_THAT(
+      EnableReferenceResolver(builder, ReferenceResolverEnabled::kAlways),
+      IsOk());
+  ASSERT_THAT(RegisterRegexFunctions(builder.function_registry(), options),
+              IsOk());
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  google::protobuf::Arena arena;
+  auto evaluate = [&](absl::string_view expr) -> absl::StatusOr<Value> {
+    CEL_ASSIGN_OR_RETURN(auto parsed_expr, Parse(expr));
+    CEL_ASSIGN_OR_RETURN(std::unique_ptr<cel::Program> program,
+                         ProtobufRuntimeAdapter::CreateProgram(*runtime,
+                                                               parsed_expr));
+    Activation activation;
+    return program->Evaluate(&arena, activation);
+  };
+
+  EXPECT_THAT(evaluate("re.capture('foo', 'fo(o)')"),
+              IsOkAndHolds(StringValueIs("o")));
+  for (absl::string_view expr : {
+           "re.extract('foo', '([a-z]{1,100})', '\\\\1')",
+           "re.capture('foo', '([a-z]{1,100})')",
+           "re.captureN('foo', '([a-z]{1,100})')",
+       }) {
+    EXPECT_THAT(evaluate(expr),
+                IsOkAndHolds(ErrorValueIs(
+                    StatusIs(absl::StatusCode::kInvalidArgument,
+                             HasSubstr("exceeded RE2 max program size")))))
+        << "Expression: " << expr;
+  }
+}
+
 std::vector<TestCase> createParams() {
   return {
       {// Extract String: Fails for mismatched regex
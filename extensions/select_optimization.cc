@@ -30,6 +30,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
@@ -58,6 +59,7 @@
 #include "runtime/internal/runtime_friend_access.h"
 #include "runtime/internal/runtime_impl.h"
 #include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
@@ -100,6 +102,75 @@ struct SelectPath {
   // TODO(uncreated-issue/54): support for optionals.
 };
 
+// A singular message field traversed by a planned select chain.
+struct FieldPathStep {
+  const google::protobuf::FieldDescriptor* absl_nonnull field;
+  // Optional accessor for generated messages, see `SelectFieldAccessorTable`.
+  SelectFieldAccessor absl_nullable accessor = nullptr;
+  const google::protobuf::Reflection* absl_nullable accessor_reflection = nullptr;
+};
+
+// A select chain of field selections resolved to field descriptors at plan
+// time, so evaluating it needs no field lookups.
+//
+// Only applies to operands whose descriptor is `root`. Empty (`root` is null)
+// if the chain could not be resolved, in which case `Qualify` is used.
+struct FieldPath {
+  const google::protobuf::Descriptor* absl_nullable root = nullptr;
+  std::vector<FieldPathStep> steps;
+  const google::protobuf::FieldDescriptor* absl_nullable leaf = nullptr;
+};
+
+// Resolves `select_path` against `descriptor`. Only chains of field selections
+// that traverse singular message fields before the last selection are
+// resolved.
+FieldPath ResolveFieldPath(
+    const google::protobuf::Descriptor* absl_nonnull descriptor,
+    absl::Span<const SelectQualifier> select_path,
+    const SelectFieldAccessorTable* absl_nullable accessors) {
+  if (select_path.empty() ||
+      descriptor->well_known_type() !=
+          google::protobuf::Descriptor::WELLKNOWNTYPE_UNSPECIFIED) {
+    return FieldPath();
+  }
+  FieldPath path;
+  path.steps.reserve(select_path.size() - 1);
+  const google::protobuf::Descriptor* current = descriptor;
+  for (size_t i = 0; i < select_path.size(); ++i) {
+    const auto* specifier = absl::get_if<FieldSpecifier>(&select_path[i]);
+    if (specifier == nullptr) {
+      return FieldPath();
+    }
+    const google::protobuf::FieldDescriptor* field =
+        current->FindFieldByNumber(specifier->number);
+    if (field == nullptr) {
+      // Possibly an extension, leave it to `Qualify`.
+      return FieldPath();
+    }
+    if (i + 1 == select_path.size()) {
+      path.leaf = field;
+      break;
+    }
+    if (field->is_repeated() ||
+        field->cpp_type() != google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE ||
+        field->message_type()->well_known_type() !=
+            google::protobuf::Descriptor::WELLKNOWNTYPE_UNSPECIFIED) {
+      return FieldPath();
+    }
+    FieldPathStep& step = path.steps.emplace_back();
+    step.field = field;
+    if (accessors != nullptr) {
+      if (const auto* entry = accessors->Find(field); entry != nullptr) {
+        step.accessor = entry->accessor;
+        step.accessor_reflection = entry->reflection;
+      }
+    }
+    current = field->message_type();
+  }
+  path.root = descriptor;
+  return path;
+}
+
 // Generates the AST representation of the qualification path for the optimized
 // select branch. I.e., the list-typed second argument of the cel.@attribute
 // call.
@@ -548,11 +619,13 @@ class OptimizedSelectImpl {
  public:
   OptimizedSelectImpl(std::vector<SelectQualifier> select_path,
                       std::vector<AttributeQualifier> qualifiers,
-                      bool presence_test, SelectOptimizationOptions options)
+                      FieldPath field_path, bool presence_test,
+                      SelectOptimizationOptions options)
       : select_path_(std::move(select_path)),
         qualifiers_(std::move(qualifiers)),
+        field_path_(std::move(field_path)),
         presence_test_(presence_test),
-        options_(options)
+        options_(std::move(options))
 
   {
     ABSL_DCHECK(!select_path_.empty());
@@ -576,9 +649,15 @@ class OptimizedSelectImpl {
   }
 
  private:
+  // Evaluates the planned field path on `message`, whose descriptor is
+  // `field_path_.root`.
+  Value ApplyFieldPath(ExecutionFrameBase& frame,
+                       const google::protobuf::Message& message) const;
+
   absl::optional<Attribute> attribute_;
   std::vector<SelectQualifier> select_path_;
   std::vector<AttributeQualifier> qualifiers_;
+  FieldPath field_path_;
   bool presence_test_;
   SelectOptimizationOptions options_;
 };
@@ -616,6 +695,13 @@ absl::StatusOr<absl::optional<Value>> CheckForMarkedAttributes(
 
 absl::StatusOr<Value> OptimizedSelectImpl::ApplySelect(
     ExecutionFrameBase& frame, const StructValue& struct_value) const {
+  if (field_path_.root != nullptr) {
+    if (auto message = struct_value.AsParsedMessage();
+        message && message->GetDescriptor() == field_path_.root) {
+      return ApplyFieldPath(frame, **message);
+    }
+  }
+
   auto value_or =
       (options_.force_fallback_implementation)
           ? absl::UnimplementedError("Forced fallback impl")
@@ -644,6 +730,30 @@ absl::StatusOr<Value> OptimizedSelectImpl::ApplySelect(
       frame.arena());
 }
 
+Value OptimizedSelectImpl::ApplyFieldPath(
+    ExecutionFrameBase& frame, const google::protobuf::Message& message) const {
+  const google::protobuf::Message* current = &message;
+  for (const FieldPathStep& step : field_path_.steps) {
+    const google::protobuf::Reflection* reflection = current->GetReflection();
+    current = step.accessor != nullptr &&
+                      reflection == step.accessor_reflection
+                  ? &step.accessor(*current)
+                  : &reflection->GetMessage(*current, step.field);
+  }
+
+  const google::protobuf::FieldDescriptor* leaf = field_path_.leaf;
+  if (presence_test_) {
+    const google::protobuf::Reflection* reflection = current->GetReflection();
+    // Repeated and map fields are present when non-empty.
+    return BoolValue(leaf->is_repeated()
+                         ? reflection->FieldSize(*current, leaf) != 0
+                         : reflection->HasField(*current, leaf));
+  }
+  return Value::WrapField(ProtoWrapperTypeOptions::kUnsetNull, current, leaf,
+                          frame.descriptor_pool(), frame.message_factory(),
+                          frame.arena());
+}
+
 AttributeTrail OptimizedSelectImpl::GetAttributeTrail(
     const AttributeTrail& operand_trail) const {
   if (operand_trail.empty()) {
@@ -780,8 +890,8 @@ absl::Status RecursiveImpl::Evaluate(ExecutionFrameBase& frame, Value& result,
 
 class SelectOptimizer : public ProgramOptimizer {
  public:
-  explicit SelectOptimizer(const SelectOptimizationOptions& options)
-      : options_(options) {}
+  SelectOptimizer(const Ast& ast, const SelectOptimizationOptions& options)
+      : ast_(ast), options_(options) {}
 
   absl::Status OnPreVisit(PlannerContext& context, const Expr& node) override {
     return absl::OkStatus();
@@ -790,9 +900,35 @@ class SelectOptimizer : public ProgramOptimizer {
   absl::Status OnPostVisit(PlannerContext& context, const Expr& node) override;
 
  private:
+  // Returns the field path for `instructions` if the checker resolved
+  // `operand` to a message type known to the runtime.
+  FieldPath PlanFieldPath(PlannerContext& context, const Expr& operand,
+                          absl::Span<const SelectQualifier> instructions) const;
+
+  const Ast& ast_;
   SelectOptimizationOptions options_;
 };
 
+FieldPath SelectOptimizer::PlanFieldPath(
+    PlannerContext& context, const Expr& operand,
+    absl::Span<const SelectQualifier> instructions) const {
+  if (options_.force_fallback_implementation) {
+    return FieldPath();
+  }
+  const TypeSpec checker_type = ast_.GetTypeOrDyn(operand.id());
+  if (!checker_type.has_message_type()) {
+    return FieldPath();
+  }
+  const google::protobuf::Descriptor* descriptor =
+      context.descriptor_pool()->FindMessageTypeByName(
+          checker_type.message_type().type());
+  if (descriptor == nullptr) {
+    return FieldPath();
+  }
+  return ResolveFieldPath(descriptor, instructions,
+                          options_.field_accessors.get());
+}
+
 absl::Status SelectOptimizer::OnPostVisit(PlannerContext& context,
                                           const Expr& node) {
   if (!node.has_call_expr()) {
@@ -856,8 +992,9 @@ absl::Status SelectOptimizer::OnPostVisit(PlannerContext& context,
     return absl::OkStatus();
   }
 
+  FieldPath field_path = PlanFieldPath(context, operand, instructions);
   OptimizedSelectImpl impl(std::move(instructions), std::move(qualifiers),
-                           presence_test, options_);
+                           std::move(field_path), presence_test, options_);
 
   if (subexpression->IsRecursive()) {
     auto program = subexpression->ExtractRecursiveProgram();
@@ -903,6 +1040,35 @@ google::api::expr::runtime::FlatExprBuilder* GetFlatExprBuilder(
 
 }  // namespace
 
+absl::Status SelectFieldAccessorTable::Register(
+    const google::protobuf::Descriptor* absl_nonnull descriptor,
+    const google::protobuf::Reflection* absl_nonnull reflection,
+    absl::string_view field_name, SelectFieldAccessor absl_nonnull accessor) {
+  const google::protobuf::FieldDescriptor* field =
+      descriptor->FindFieldByName(field_name);
+  if (field == nullptr) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "no such field: ", descriptor->full_name(), ".", field_name));
+  }
+  if (field->is_repeated() ||
+      field->cpp_type() != google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("not a singular message field: ", field->full_name()));
+  }
+  if (!accessors_.try_emplace(field, Entry{accessor, reflection}).second) {
+    return absl::AlreadyExistsError(
+        absl::StrCat("accessor already registered: ", field->full_name()));
+  }
+  return absl::OkStatus();
+}
+
+const SelectFieldAccessorTable::Entry* absl_nullable
+SelectFieldAccessorTable::Find(
+    const google::protobuf::FieldDescriptor* absl_nonnull field) const {
+  auto it = accessors_.find(field);
+  return it != accessors_.end() ? &it->second : nullptr;
+}
+
 absl::Status SelectOptimizationAstUpdater::UpdateAst(PlannerContext& context,
                                                      Ast& ast) const {
   RewriterImpl rewriter(ast, context);
@@ -914,7 +1080,7 @@ google::api::expr::runtime::ProgramOptimizerFactory
 CreateSelectOptimizationProgramOptimizer(
     const SelectOptimizationOptions& options) {
   return [=](PlannerContext& context, const Ast& ast) {
-    return std::make_unique<SelectOptimizer>(options);
+    return std::make_unique<SelectOptimizer>(ast, options);
   };
 }
 
@@ -15,16 +15,71 @@
 #ifndef THIRD_PARTY_CEL_CPP_EXTENSIONS_SELECT_OPTIMIZATION_H_
 #define THIRD_PARTY_CEL_CPP_EXTENSIONS_SELECT_OPTIMIZATION_H_
 
+#include <memory>
+
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
 #include "common/ast.h"
 #include "eval/compiler/flat_expr_builder_extensions.h"
 #include "runtime/runtime_builder.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
 
 namespace cel::extensions {
 
 constexpr char kCelAttribute[] = "cel.@attribute";
 constexpr char kCelHasField[] = "cel.@hasField";
 
+// Returns the value of a singular message field of a generated message without
+// going through reflection.
+using SelectFieldAccessor =
+    const google::protobuf::Message& (*)(const google::protobuf::Message& message);
+
+// Accessors for singular message fields of generated messages.
+//
+// When the checker resolved the operand of an optimized select chain to a
+// message type, the chain is planned as a fixed sequence of field descriptors.
+// Traversing a field with a registered accessor calls the accessor instead of
+// reflection whenever the message is an instance of the generated type.
+//
+//   SelectFieldAccessorTable accessors;
+//   CEL_RETURN_IF_ERROR(accessors.Register<NestedTestAllTypes>(
+//       "child",
+//       [](const google::protobuf::Message& message) -> const google::protobuf::Message& {
+//         return static_cast<const NestedTestAllTypes&>(message).child();
+//       }));
+class SelectFieldAccessorTable {
+ public:
+  struct Entry {
+    SelectFieldAccessor accessor;
+    // Reflection of the generated type the accessor was registered for.
+    const google::protobuf::Reflection* absl_nonnull reflection;
+  };
+
+  // Registers `accessor` for the field named `field_name` of the generated
+  // message type `T`.
+  template <typename T>
+  absl::Status Register(absl::string_view field_name,
+                        SelectFieldAccessor accessor) {
+    return Register(T::descriptor(), T::default_instance().GetReflection(),
+                    field_name, accessor);
+  }
+
+  absl::Status Register(
+      const google::protobuf::Descriptor* absl_nonnull descriptor,
+      const google::protobuf::Reflection* absl_nonnull reflection,
+      absl::string_view field_name, SelectFieldAccessor absl_nonnull accessor);
+
+  // Returns the accessor registered for `field`, or `nullptr` if there is none.
+  const Entry* absl_nullable Find(
+      const google::protobuf::FieldDescriptor* absl_nonnull field) const;
+
+ private:
+  absl::flat_hash_map<const google::protobuf::FieldDescriptor*, Entry> accessors_;
+};
+
 // Configuration options for the select optimization.
 struct SelectOptimizationOptions {
   // Force the program to use the fallback implementation for the select.
@@ -35,11 +90,22 @@ struct SelectOptimizationOptions {
   // unimplemented for a given StructType. This option is exposed for testing or
   // to more closely match behavior of unoptimized expressions.
   bool force_fallback_implementation = false;
+
+  // Accessors used in place of reflection when traversing message typed
+  // fields of generated messages. Optional.
+  //
+  // Only applies when the runtime's descriptor pool is the one the generated
+  // messages are defined in, i.e. the generated pool.
+  std::shared_ptr<const SelectFieldAccessorTable> field_accessors;
 };
 
 // Enable select optimization on the given RuntimeBuilder, replacing long
 // select chains with a single operation.
 //
+// Chains of field selections on an operand the checker resolved to a message
+// type are resolved to field descriptors at plan time, so evaluating them
+// performs no field lookups.
+//
 // This assumes that the type information at check time agrees with the
 // configured types at runtime.
 //
@@ -0,0 +1,157 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/log/absl_check.h"
+#include "absl/strings/str_cat.h"
+#include "checker/standard_library.h"
+#include "checker/validation_result.h"
+#include "common/decl.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "compiler/compiler.h"
+#include "compiler/compiler_factory.h"
+#include "extensions/select_optimization.h"
+#include "internal/benchmark.h"
+#include "internal/testing.h"
+#include "runtime/activation.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "cel/expr/conformance/proto3/test_all_types.pb.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel::extensions {
+namespace {
+
+using ::cel::expr::conformance::proto3::NestedTestAllTypes;
+
+enum class Mode {
+  kUnoptimized,
+  // Collapses the chain into one step that calls the field accessors of the
+  // struct value.
+  kFallback,
+  kFieldPath,
+  kFieldAccessors,
+};
+
+const google::protobuf::Message& GetChild(const google::protobuf::Message& message) {
+  return static_cast<const NestedTestAllTypes&>(message).child();
+}
+
+const google::protobuf::Message& GetPayload(const google::protobuf::Message& message) {
+  return static_cast<const NestedTestAllTypes&>(message).payload();
+}
+
+// Returns `msg.child.child...payload.single_int64` with `depth` children.
+std::string MakeExpression(int depth) {
+  std::string expression = "msg";
+  for (int i = 0; i < depth; ++i) {
+    absl::StrAppend(&expression, ".child");
+  }
+  absl::StrAppend(&expression, ".payload.single_int64");
+  return expression;
+}
+
+std::unique_ptr<Program> MakeProgram(int depth, Mode mode) {
+  const google::protobuf::DescriptorPool* pool =
+      google::protobuf::DescriptorPool::generated_pool();
+  RuntimeOptions options;
+  auto builder = CreateStandardRuntimeBuilder(pool, options);
+  ABSL_CHECK_OK(builder);
+  if (mode != Mode::kUnoptimized) {
+    SelectOptimizationOptions select_options;
+    select_options.force_fallback_implementation = mode == Mode::kFallback;
+    if (mode == Mode::kFieldAccessors) {
+      auto accessors = std::make_shared<SelectFieldAccessorTable>();
+      ABSL_CHECK_OK(
+          accessors->Register<NestedTestAllTypes>("child", &GetChild));
+      ABSL_CHECK_OK(
+          accessors->Register<NestedTestAllTypes>("payload", &GetPayload));
+      select_options.field_accessors = std::move(accessors);
+    }
+    ABSL_CHECK_OK(EnableSelectOptimization(*builder, select_options));
+  }
+  auto runtime = std::move(*builder).Build();
+  ABSL_CHECK_OK(runtime);
+
+  auto compiler_builder = NewCompilerBuilder(pool);
+  ABSL_CHECK_OK(compiler_builder);
+  ABSL_CHECK_OK((*compiler_builder)->AddLibrary(StandardCheckerLibrary()));
+  ABSL_CHECK_OK((*compiler_builder)
+                    ->GetCheckerBuilder()
+                    .AddVariable(MakeVariableDecl(
+                        "msg", MessageType(NestedTestAllTypes::descriptor()))));
+  auto compiler = std::move(**compiler_builder).Build();
+  ABSL_CHECK_OK(compiler);
+  auto result = (*compiler)->Compile(MakeExpression(depth));
+  ABSL_CHECK_OK(result);
+  ABSL_CHECK(result->IsValid());
+  auto ast = result->ReleaseAst();
+  ABSL_CHECK_OK(ast);
+  auto program = (*runtime)->CreateProgram(std::move(*ast));
+  ABSL_CHECK_OK(program);
+  return std::move(*program);
+}
+
+void RunBenchmark(benchmark::State& state, Mode mode) {
+  const int depth = state.range(0);
+  std::unique_ptr<Program> program = MakeProgram(depth, mode);
+  NestedTestAllTypes message;
+  NestedTestAllTypes* leaf = &message;
+  for (int i = 0; i < depth; ++i) {
+    leaf = leaf->mutable_child();
+  }
+  leaf->mutable_payload()->set_single_int64(42);
+
+  google::protobuf::Arena activation_arena;
+  Activation activation;
+  activation.InsertOrAssignValue(
+      "msg", ParsedMessageValue(&message, &activation_arena));
+  for (auto _ : state) {
+    google::protobuf::Arena arena;
+    auto result = program->Evaluate(&arena, activation);
+    ABSL_CHECK_OK(result);
+    ABSL_CHECK(result->IsInt() && result->GetInt().NativeValue() == 42);
+  }
+}
+
+void BM_SelectChainUnoptimized(benchmark::State& state) {
+  RunBenchmark(state, Mode::kUnoptimized);
+}
+BENCHMARK(BM_SelectChainUnoptimized)->Arg(1)->Arg(4)->Arg(16);
+
+void BM_SelectChainFallback(benchmark::State& state) {
+  RunBenchmark(state, Mode::kFallback);
+}
+BENCHMARK(BM_SelectChainFallback)->Arg(1)->Arg(4)->Arg(16);
+
+void BM_SelectChainFieldPath(benchmark::State& state) {
+  RunBenchmark(state, Mode::kFieldPath);
+}
+BENCHMARK(BM_SelectChainFieldPath)->Arg(1)->Arg(4)->Arg(16);
+
+void BM_SelectChainFieldAccessors(benchmark::State& state) {
+  RunBenchmark(state, Mode::kFieldAccessors);
+}
+BENCHMARK(BM_SelectChainFieldAccessors)->Arg(1)->Arg(4)->Arg(16);
+
+}  // namespace
+}  // namespace cel::extensions
@@ -0,0 +1,182 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "extensions/select_optimization.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "checker/standard_library.h"
+#include "checker/validation_result.h"
+#include "common/ast.h"
+#include "common/decl.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "compiler/compiler.h"
+#include "compiler/compiler_factory.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "runtime/activation.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "cel/expr/conformance/proto3/test_all_types.pb.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel::extensions {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::cel::expr::conformance::proto3::NestedTestAllTypes;
+using ::cel::expr::conformance::proto3::TestAllTypes;
+using ::cel::test::BoolValueIs;
+using ::cel::test::IntValueIs;
+
+int child_accessor_calls = 0;
+
+const google::protobuf::Message& GetChild(const google::protobuf::Message& message) {
+  ++child_accessor_calls;
+  return static_cast<const NestedTestAllTypes&>(message).child();
+}
+
+absl::StatusOr<std::unique_ptr<Ast>> CompileAst(absl::string_view expression) {
+  CEL_ASSIGN_OR_RETURN(
+      auto builder,
+      NewCompilerBuilder(google::protobuf::DescriptorPool::generated_pool()));
+  CEL_RETURN_IF_ERROR(builder->AddLibrary(StandardCheckerLibrary()));
+  CEL_RETURN_IF_ERROR(builder->GetCheckerBuilder().AddVariable(
+      MakeVariableDecl("msg", MessageType(NestedTestAllTypes::descriptor()))));
+  CEL_ASSIGN_OR_RETURN(auto compiler, std::move(*builder).Build());
+  CEL_ASSIGN_OR_RETURN(ValidationResult result, compiler->Compile(expression));
+  if (!result.IsValid()) {
+    return absl::InvalidArgumentError(result.FormatError());
+  }
+  return result.ReleaseAst();
+}
+
+class SelectOptimizationTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    message_.mutable_child()->mutable_child()->mutable_payload()
+        ->set_single_int64(42);
+    message_.mutable_child()->mutable_payload()->add_repeated_int32(1);
+    child_accessor_calls = 0;
+  }
+
+  absl::StatusOr<Value> Evaluate(absl::string_view expression,
+                                 const SelectOptimizationOptions& options) {
+    RuntimeOptions runtime_options;
+    CEL_ASSIGN_OR_RETURN(
+        RuntimeBuilder builder,
+        CreateStandardRuntimeBuilder(
+            google::protobuf::DescriptorPool::generated_pool(), runtime_options));
+    CEL_RETURN_IF_ERROR(EnableSelectOptimization(builder, options));
+    CEL_ASSIGN_OR_RETURN(auto runtime, std::move(builder).Build());
+    CEL_ASSIGN_OR_RETURN(auto ast, CompileAst(expression));
+    CEL_ASSIGN_OR_RETURN(auto program, runtime->CreateProgram(std::move(ast)));
+    Activation activation;
+    activation.InsertOrAssignValue("msg",
+                                   ParsedMessageValue(&message_, &arena_));
+    return program->Evaluate(&arena_, activation);
+  }
+
+  google::protobuf::Arena arena_;
+  NestedTestAllTypes message_;
+};
+
+TEST_F(SelectOptimizationTest, FieldPath) {
+  SelectOptimizationOptions options;
+
+  EXPECT_THAT(Evaluate("msg.child.child.payload.single_int64", options),
+              IsOkAndHolds(IntValueIs(42)));
+  EXPECT_THAT(Evaluate("msg.child.payload.single_int64", options),
+              IsOkAndHolds(IntValueIs(0)));
+  EXPECT_THAT(Evaluate("has(msg.child.child.payload.single_int64)", options),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(Evaluate("has(msg.child.payload.single_int64)", options),
+              IsOkAndHolds(BoolValueIs(false)));
+  EXPECT_THAT(Evaluate("has(msg.child.payload.repeated_int32)", options),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(Evaluate("has(msg.child.child.payload.repeated_int32)", options),
+              IsOkAndHolds(BoolValueIs(false)));
+  EXPECT_THAT(Evaluate("msg.child.payload.repeated_int32[0]", options),
+              IsOkAndHolds(IntValueIs(1)));
+}
+
+TEST_F(SelectOptimizationTest, FieldAccessors) {
+  auto accessors = std::make_shared<SelectFieldAccessorTable>();
+  ASSERT_THAT(accessors->Register<NestedTestAllTypes>("child", &GetChild),
+              IsOk());
+  SelectOptimizationOptions options;
+  options.field_accessors = std::move(accessors);
+
+  EXPECT_THAT(Evaluate("msg.child.child.payload.single_int64", options),
+              IsOkAndHolds(IntValueIs(42)));
+  EXPECT_EQ(child_accessor_calls, 2);
+  EXPECT_THAT(Evaluate("has(msg.child.child.payload.single_int64)", options),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_EQ(child_accessor_calls, 4);
+}
+
+TEST_F(SelectOptimizationTest, ForceFallbackImplementation) {
+  auto accessors = std::make_shared<SelectFieldAccessorTable>();
+  ASSERT_THAT(accessors->Register<NestedTestAllTypes>("child", &GetChild),
+              IsOk());
+  SelectOptimizationOptions options;
+  options.force_fallback_implementation = true;
+  options.field_accessors = std::move(accessors);
+
+  EXPECT_THAT(Evaluate("msg.child.child.payload.single_int64", options),
+              IsOkAndHolds(IntValueIs(42)));
+  EXPECT_EQ(child_accessor_calls, 0);
+}
+
+TEST(SelectFieldAccessorTableTest, Register) {
+  SelectFieldAccessorTable accessors;
+
+  EXPECT_THAT(accessors.Register<NestedTestAllTypes>("child", &GetChild),
+              IsOk());
+  EXPECT_THAT(accessors.Register<NestedTestAllTypes>("child", &GetChild),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+  EXPECT_THAT(accessors.Register<NestedTestAllTypes>("missing", &GetChild),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(accessors.Register<TestAllTypes>("single_int64", &GetChild),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(accessors.Register<TestAllTypes>("repeated_nested_message",
+                                               &GetChild),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  const google::protobuf::FieldDescriptor* child =
+      NestedTestAllTypes::descriptor()->FindFieldByName("child");
+  ASSERT_NE(accessors.Find(child), nullptr);
+  EXPECT_EQ(accessors.Find(child)->accessor, &GetChild);
+  EXPECT_EQ(accessors.Find(child)->reflection,
+            NestedTestAllTypes::default_instance().GetReflection());
+  EXPECT_EQ(accessors.Find(
+                NestedTestAllTypes::descriptor()->FindFieldByName("payload")),
+            nullptr);
+}
+
+}  // namespace
+}  // namespace cel::extensions
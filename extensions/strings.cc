@@ -28,6 +28,7 @@
 #include "absl/strings/ascii.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "checker/internal/builtins_arena.h"
 #include "checker/type_checker_builder.h"
 #include "common/decl.h"
@@ -52,14 +53,34 @@ namespace {
 
 using ::cel::checker_internal::BuiltinsArena;
 
-struct AppendToStringVisitor {
-  std::string& append_to;
-
-  void operator()(absl::string_view string) const { append_to.append(string); }
+// Accumulates the result of `join()`. Elements are appended to a flat string
+// until the first cord-backed element, after which the result is built as a
+// cord so that large elements are shared rather than copied.
+class JoinAccumulator final {
+ public:
+  void Append(const StringValue& value) {
+    if (!cord_.has_value()) {
+      if (auto flat = value.TryFlat(); flat) {
+        string_.append(*flat);
+        return;
+      }
+      cord_.emplace(std::move(string_));
+    }
+    value.AppendToCord(&*cord_);
+  }
 
-  void operator()(const absl::Cord& cord) const {
-    append_to.append(static_cast<std::string>(cord));
+  StringValue Build(google::protobuf::Arena* absl_nonnull arena) && {
+    // We assume the original strings were well-formed.
+    if (cord_.has_value()) {
+      return StringValue::From(*cord_);
+    }
+    string_.shrink_to_fit();
+    return StringValue(arena, std::move(string_));
   }
+
+ private:
+  std::string string_;
+  absl::optional<absl::Cord> cord_;
 };
 
 absl::StatusOr<Value> Join2(
@@ -67,35 +88,31 @@ absl::StatusOr<Value> Join2(
     const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
     google::protobuf::MessageFactory* absl_nonnull message_factory,
     google::protobuf::Arena* absl_nonnull arena) {
-  std::string result;
+  JoinAccumulator result;
   CEL_ASSIGN_OR_RETURN(auto iterator, value.NewIterator());
   Value element;
   if (iterator->HasNext()) {
     CEL_RETURN_IF_ERROR(
         iterator->Next(descriptor_pool, message_factory, arena, &element));
     if (auto string_element = element.AsString(); string_element) {
-      string_element->NativeValue(AppendToStringVisitor{result});
+      result.Append(*string_element);
     } else {
       return ErrorValue{
           runtime_internal::CreateNoMatchingOverloadError("join")};
     }
   }
-  std::string separator_scratch;
-  absl::string_view separator_view = separator.NativeString(separator_scratch);
   while (iterator->HasNext()) {
-    result.append(separator_view);
+    result.Append(separator);
     CEL_RETURN_IF_ERROR(
         iterator->Next(descriptor_pool, message_factory, arena, &element));
     if (auto string_element = element.AsString(); string_element) {
-      string_element->NativeValue(AppendToStringVisitor{result});
+      result.Append(*string_element);
     } else {
       return ErrorValue{
           runtime_internal::CreateNoMatchingOverloadError("join")};
     }
   }
-  result.shrink_to_fit();
-  // We assume the original string was well-formed.
-  return StringValue(arena, std::move(result));
+  return std::move(result).Build(arena);
 }
 
 absl::StatusOr<Value> Join1(
@@ -160,6 +177,34 @@ struct SplitWithEmptyDelimiter {
   }
 };
 
+absl::StatusOr<Value> SplitCord(absl::Cord content,
+                                absl::string_view delimiter, int64_t limit,
+                                ListValueBuilder& builder) {
+  while (limit > 1 && !content.empty()) {
+    absl::Cord::CharIterator it = content.Find(delimiter);
+    if (it == content.char_end()) {
+      break;
+    }
+    const size_t pos =
+        static_cast<size_t>(absl::Cord::Distance(content.char_begin(), it));
+    // We assume the original string was well-formed.
+    CEL_RETURN_IF_ERROR(
+        builder.Add(StringValue::From(content.Subcord(0, pos))));
+    --limit;
+    content.RemovePrefix(pos + delimiter.size());
+    if (content.empty()) {
+      // We found the delimiter at the end of the string. Add an empty string
+      // to the end of the list.
+      CEL_RETURN_IF_ERROR(builder.Add(StringValue{}));
+      return std::move(builder).Build();
+    }
+  }
+  // We have one left in the limit or do not have any more matches. Add
+  // whatever is left as the remaining entry.
+  CEL_RETURN_IF_ERROR(builder.Add(StringValue::From(content)));
+  return std::move(builder).Build();
+}
+
 absl::StatusOr<Value> Split3(
     const StringValue& string, const StringValue& delimiter, int64_t limit,
     const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
@@ -189,6 +234,10 @@ absl::StatusOr<Value> Split3(
   // empty.
   std::string delimiter_scratch;
   absl::string_view delimiter_view = delimiter.NativeString(delimiter_scratch);
+  if (!string.TryFlat().has_value()) {
+    // Split cords chunk-wise, sharing the pieces with the original cord.
+    return SplitCord(string.ToCord(), delimiter_view, limit, *builder);
+  }
   std::string content_scratch;
   absl::string_view content_view = string.NativeString(content_scratch);
   while (limit > 1 && !content_view.empty()) {
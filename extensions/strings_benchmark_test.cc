@@ -0,0 +1,119 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "cel/expr/syntax.pb.h"
+#include "absl/log/absl_check.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "common/value.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "extensions/strings.h"
+#include "internal/benchmark.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::extensions {
+namespace {
+
+using ::google::api::expr::parser::Parse;
+
+constexpr size_t kBodySize = 1 << 20;
+
+// Builds a 1 MiB cord of comma separated fields out of 4 KiB chunks, similar
+// to a request body read from the network.
+absl::Cord MakeBody() {
+  std::string chunk;
+  while (chunk.size() < 4096) {
+    chunk.append("field,");
+  }
+  chunk.resize(4096);
+  absl::Cord body;
+  while (body.size() < kBodySize) {
+    body.Append(chunk);
+  }
+  return body;
+}
+
+std::unique_ptr<Program> MakeProgram(absl::string_view expression) {
+  RuntimeOptions options;
+  auto builder = CreateStandardRuntimeBuilder(
+      internal::GetTestingDescriptorPool(), options);
+  ABSL_CHECK_OK(builder);
+  ABSL_CHECK_OK(
+      RegisterStringsFunctions(builder->function_registry(), options));
+  auto runtime = std::move(*builder).Build();
+  ABSL_CHECK_OK(runtime);
+  auto expr = Parse(expression);
+  ABSL_CHECK_OK(expr);
+  auto program = ProtobufRuntimeAdapter::CreateProgram(**runtime, *expr);
+  ABSL_CHECK_OK(program);
+  return std::move(*program);
+}
+
+void RunBenchmark(benchmark::State& state, absl::string_view expression) {
+  std::unique_ptr<Program> program = MakeProgram(expression);
+  Activation activation;
+  activation.InsertOrAssignValue("body", StringValue::From(MakeBody()));
+  for (auto _ : state) {
+    google::protobuf::Arena arena;
+    auto result = program->Evaluate(&arena, activation);
+    ABSL_CHECK_OK(result);
+    benchmark::DoNotOptimize(*result);
+  }
+  state.SetBytesProcessed(state.iterations() * kBodySize);
+}
+
+void BM_CordContains(benchmark::State& state) {
+  RunBenchmark(state, "body.contains('missing')");
+}
+BENCHMARK(BM_CordContains);
+
+void BM_CordStartsWith(benchmark::State& state) {
+  RunBenchmark(state, "body.startsWith('field,field')");
+}
+BENCHMARK(BM_CordStartsWith);
+
+void BM_CordEndsWith(benchmark::State& state) {
+  RunBenchmark(state, "body.endsWith('field')");
+}
+BENCHMARK(BM_CordEndsWith);
+
+void BM_CordSplit(benchmark::State& state) {
+  RunBenchmark(state, "body.split(',').size()");
+}
+BENCHMARK(BM_CordSplit);
+
+void BM_CordJoin(benchmark::State& state) {
+  RunBenchmark(state, "[body, body].join(',').size()");
+}
+BENCHMARK(BM_CordJoin);
+
+void BM_CordConcat(benchmark::State& state) {
+  RunBenchmark(state, "(body + 'suffix' + body).size()");
+}
+BENCHMARK(BM_CordConcat);
+
+}  // namespace
+}  // namespace cel::extensions
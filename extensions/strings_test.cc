@@ -20,6 +20,7 @@
 #include "cel/expr/syntax.pb.h"
 #include "absl/status/status_matchers.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/cord_test_helpers.h"
 #include "checker/standard_library.h"
 #include "checker/type_checker_builder.h"
 #include "checker/validation_result.h"
@@ -77,6 +78,65 @@ TEST(Strings, SplitWithEmptyDelimiterCord) {
   EXPECT_TRUE(result.GetBool().NativeValue());
 }
 
+TEST(Strings, SplitCord) {
+  google::protobuf::Arena arena;
+  const auto options = RuntimeOptions{};
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       CreateStandardRuntimeBuilder(
+                           internal::GetTestingDescriptorPool(), options));
+  EXPECT_THAT(RegisterStringsFunctions(builder.function_registry(), options),
+              IsOk());
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(
+      ParsedExpr expr,
+      Parse("foo.split(', ') == ['hello', 'big', 'world', ''] && "
+            "foo.split(', ', 2) == ['hello', 'big, world, ']",
+            "<input>", ParserOptions{}));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  Activation activation;
+  // The delimiters straddle chunk boundaries.
+  activation.InsertOrAssignValue(
+      "foo", StringValue::From(absl::MakeFragmentedCord(
+                 {"hello,", " big", ", wor", "ld,", " "})));
+
+  ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena, activation));
+  ASSERT_TRUE(result.Is<BoolValue>());
+  EXPECT_TRUE(result.GetBool().NativeValue());
+}
+
+TEST(Strings, JoinCord) {
+  google::protobuf::Arena arena;
+  const auto options = RuntimeOptions{};
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       CreateStandardRuntimeBuilder(
+                           internal::GetTestingDescriptorPool(), options));
+  EXPECT_THAT(RegisterStringsFunctions(builder.function_registry(), options),
+              IsOk());
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr expr,
+                       Parse("['a', foo, 'b'].join('-') == 'a-hello world-b'",
+                             "<input>", ParserOptions{}));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  Activation activation;
+  activation.InsertOrAssignValue(
+      "foo",
+      StringValue::From(absl::MakeFragmentedCord({"hello", " ", "world"})));
+
+  ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena, activation));
+  ASSERT_TRUE(result.Is<BoolValue>());
+  EXPECT_TRUE(result.GetBool().NativeValue());
+}
+
 TEST(Strings, Replace) {
   google::protobuf::Arena arena;
   const auto options = RuntimeOptions{};
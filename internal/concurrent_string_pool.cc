@@ -0,0 +1,94 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/concurrent_string_pool.h"
+
+#include <climits>
+#include <cstddef>
+#include <cstring>
+
+#include "absl/base/optimization.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::internal {
+
+template <typename S>
+ConcurrentStringPool::Shard& ConcurrentStringPool::ShardFor(const S& string) {
+  // The hasher is transparent, so cords hash the same as equivalent string
+  // views. The top bits select the shard since the low bits are used by the
+  // shard's own table.
+  size_t hash = absl::flat_hash_set<absl::string_view>::hasher{}(string);
+  return shards_[hash >> (sizeof(size_t) * CHAR_BIT - kShardBits)];
+}
+
+absl::string_view ConcurrentStringPool::InternString(absl::string_view string) {
+  if (string.empty()) {
+    return "";
+  }
+  Shard& shard = ShardFor(string);
+  {
+    absl::ReaderMutexLock lock(&shard.mutex);
+    if (auto it = shard.strings.find(string);
+        ABSL_PREDICT_TRUE(it != shard.strings.end())) {
+      return *it;
+    }
+  }
+  absl::MutexLock lock(&shard.mutex);
+  return *shard.strings.lazy_emplace(string, [&](const auto& ctor) {
+    char* data =
+        reinterpret_cast<char*>(arena_.AllocateAligned(string.size()));
+    std::memcpy(data, string.data(), string.size());
+    ctor(absl::string_view(data, string.size()));
+  });
+}
+
+absl::string_view ConcurrentStringPool::InternString(const absl::Cord& string) {
+  if (string.empty()) {
+    return "";
+  }
+  Shard& shard = ShardFor(string);
+  {
+    absl::ReaderMutexLock lock(&shard.mutex);
+    if (auto it = shard.strings.find(string);
+        ABSL_PREDICT_TRUE(it != shard.strings.end())) {
+      return *it;
+    }
+  }
+  absl::MutexLock lock(&shard.mutex);
+  return *shard.strings.lazy_emplace(string, [&](const auto& ctor) {
+    char* data =
+        reinterpret_cast<char*>(arena_.AllocateAligned(string.size()));
+    char* p = data;
+    for (absl::string_view chunk : string.Chunks()) {
+      std::memcpy(p, chunk.data(), chunk.size());
+      p += chunk.size();
+    }
+    ctor(absl::string_view(data, string.size()));
+  });
+}
+
+size_t ConcurrentStringPool::size() const {
+  size_t size = 0;
+  for (const Shard& shard : shards_) {
+    absl::ReaderMutexLock lock(&shard.mutex);
+    size += shard.strings.size();
+  }
+  return size;
+}
+
+}  // namespace cel::internal
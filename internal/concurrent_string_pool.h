@@ -0,0 +1,94 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_INTERNAL_CONCURRENT_STRING_POOL_H_
+#define THIRD_PARTY_CEL_CPP_INTERNAL_CONCURRENT_STRING_POOL_H_
+
+#include <array>
+#include <cstddef>
+
+#include "absl/base/attributes.h"
+#include "absl/base/nullability.h"
+#include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::internal {
+
+// `ConcurrentStringPool` performs string interning like `StringPool`, but may
+// be shared by multiple threads, e.g. by all programs planned from a runtime.
+//
+// Interned strings are allocated on an arena owned by the pool and remain
+// valid until the pool is destroyed, so two strings interned by the same pool
+// are equal if and only if their data pointers are equal. Strings are never
+// released, so memory usage grows with the number of distinct strings
+// interned over the lifetime of the pool. Long-lived pools should only be
+// used for strings from a bounded set.
+//
+// Strings are partitioned into shards by hash, each guarded by a reader-writer
+// lock. Lookups of strings that are already interned only take a shared lock.
+//
+// This class is thread-safe.
+class ConcurrentStringPool final {
+ public:
+  ConcurrentStringPool() = default;
+
+  ConcurrentStringPool(const ConcurrentStringPool&) = delete;
+  ConcurrentStringPool(ConcurrentStringPool&&) = delete;
+  ConcurrentStringPool& operator=(const ConcurrentStringPool&) = delete;
+  ConcurrentStringPool& operator=(ConcurrentStringPool&&) = delete;
+
+  // The arena owning the interned strings. Allocating on it is thread-safe.
+  google::protobuf::Arena* absl_nonnull arena() ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return &arena_;
+  }
+
+  absl::string_view InternString(const char* absl_nullable string)
+      ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return InternString(absl::NullSafeStringView(string));
+  }
+
+  absl::string_view InternString(absl::string_view string)
+      ABSL_ATTRIBUTE_LIFETIME_BOUND;
+
+  absl::string_view InternString(const absl::Cord& string)
+      ABSL_ATTRIBUTE_LIFETIME_BOUND;
+
+  // Number of distinct non-empty strings interned so far.
+  size_t size() const;
+
+ private:
+  static constexpr size_t kShardBits = 4;
+  static constexpr size_t kShardCount = size_t{1} << kShardBits;
+
+  struct alignas(ABSL_CACHELINE_SIZE) Shard {
+    mutable absl::Mutex mutex;
+    absl::flat_hash_set<absl::string_view> strings ABSL_GUARDED_BY(mutex);
+  };
+
+  template <typename S>
+  Shard& ShardFor(const S& string);
+
+  // Declared first so that it outlives the shards referring to it.
+  google::protobuf::Arena arena_;
+  std::array<Shard, kShardCount> shards_;
+};
+
+}  // namespace cel::internal
+
+#endif  // THIRD_PARTY_CEL_CPP_INTERNAL_CONCURRENT_STRING_POOL_H_
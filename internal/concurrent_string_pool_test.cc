@@ -0,0 +1,92 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/concurrent_string_pool.h"
+
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/strings/cord.h"
+#include "absl/strings/cord_test_helpers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "internal/testing.h"
+
+namespace cel::internal {
+namespace {
+
+TEST(ConcurrentStringPool, EmptyString) {
+  ConcurrentStringPool string_pool;
+  absl::string_view interned_string = string_pool.InternString("");
+  EXPECT_EQ(interned_string.data(), string_pool.InternString("").data());
+  EXPECT_EQ(string_pool.size(), 0);
+}
+
+TEST(ConcurrentStringPool, InternString) {
+  ConcurrentStringPool string_pool;
+  std::string string = "Hello, world!";
+  absl::string_view interned_string = string_pool.InternString(string);
+  EXPECT_EQ(interned_string, string);
+  EXPECT_NE(interned_string.data(), string.data());
+  EXPECT_EQ(interned_string.data(),
+            string_pool.InternString("Hello, world!").data());
+  EXPECT_EQ(string_pool.size(), 1);
+}
+
+TEST(ConcurrentStringPool, InternCord) {
+  ConcurrentStringPool string_pool;
+  absl::Cord cord = absl::MakeFragmentedCord({"Hello", ", ", "world", "!"});
+  absl::string_view interned_string = string_pool.InternString(cord);
+  EXPECT_EQ(interned_string, "Hello, world!");
+  EXPECT_EQ(interned_string.data(),
+            string_pool.InternString("Hello, world!").data());
+}
+
+TEST(ConcurrentStringPool, ConcurrentInterning) {
+  constexpr int kThreads = 8;
+  constexpr int kStrings = 1000;
+  ConcurrentStringPool string_pool;
+  std::vector<std::vector<absl::string_view>> interned(kThreads);
+  std::vector<std::thread> threads;
+  threads.reserve(kThreads);
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      interned[t].reserve(kStrings);
+      for (int i = 0; i < kStrings; ++i) {
+        // Each thread starts at a different offset to interleave inserts and
+        // lookups of the same strings.
+        int n = (i + t * (kStrings / kThreads)) % kStrings;
+        interned[t].push_back(
+            string_pool.InternString(absl::StrCat("field_", n)));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(string_pool.size(), kStrings);
+  for (int i = 0; i < kStrings; ++i) {
+    absl::string_view expected =
+        string_pool.InternString(absl::StrCat("field_", i));
+    for (int t = 0; t < kThreads; ++t) {
+      int index = (i - t * (kStrings / kThreads) + kStrings) % kStrings;
+      EXPECT_EQ(interned[t][index].data(), expected.data());
+    }
+  }
+}
+
+}  // namespace
+}  // namespace cel::internal
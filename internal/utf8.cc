@@ -24,10 +24,17 @@
 #include "absl/base/nullability.h"
 #include "absl/base/optimization.h"
 #include "absl/log/absl_check.h"
+#include "absl/numeric/bits.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
 #include "internal/unicode.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CEL_INTERNAL_UTF8_HAVE_SSE2 1
+#endif
+
 // Implementation is based on
 // https://go.googlesource.com/go/+/refs/heads/master/src/unicode/utf8/utf8.go
 // but adapted for C++.
@@ -94,8 +101,43 @@ constexpr std::pair<const uint8_t, const uint8_t> kAccept[16] = {
     {0x0, 0x0},    {0x0, 0x0},    {0x0, 0x0},   {0x0, 0x0},
 };
 
+// Returns the number of leading bytes of `data` which are ASCII. Text is
+// overwhelmingly ASCII, so validation and counting skip such runs in bulk
+// instead of decoding them one byte at a time. Examines 16 bytes at a time
+// using SSE2 where available and 8 bytes at a time otherwise.
+size_t AsciiPrefixLength(const char* absl_nonnull data, size_t size) {
+  size_t i = 0;
+#ifdef CEL_INTERNAL_UTF8_HAVE_SSE2
+  for (; i + 16 <= size; i += 16) {
+    const int mask = _mm_movemask_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+    if (mask != 0) {
+      return i + absl::countr_zero(static_cast<uint32_t>(mask));
+    }
+  }
+#endif
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    if ((word & uint64_t{0x8080808080808080}) != 0) {
+      // The non-ASCII byte is one of the next 8, find it below.
+      break;
+    }
+  }
+  while (i < size && static_cast<uint8_t>(data[i]) < kUtf8RuneSelf) {
+    ++i;
+  }
+  return i;
+}
+
 class StringReader final {
  public:
+  // Number of consecutive ASCII bytes to read one at a time before skipping
+  // the rest of the run in bulk. Runs between multibyte sequences are usually
+  // short (e.g. in Latin text), and reading those one byte at a time is
+  // cheaper than setting up the block scan after each of them.
+  static constexpr size_t kMinAsciiRun = 16;
+
   constexpr explicit StringReader(absl::string_view input) : input_(input) {}
 
   size_t Remaining() const { return input_.size(); }
@@ -119,6 +161,13 @@ class StringReader final {
     input_.remove_prefix(n);
   }
 
+  // Advances past any leading ASCII bytes, returning how many there were.
+  size_t SkipAscii() {
+    size_t n = AsciiPrefixLength(input_.data(), input_.size());
+    input_.remove_prefix(n);
+    return n;
+  }
+
   void Reset(absl::string_view input) { input_ = input; }
 
  private:
@@ -127,6 +176,10 @@ class StringReader final {
 
 class CordReader final {
  public:
+  // Reading a single byte from a cord costs more than scanning the rest of
+  // the chunk, so runs are skipped in bulk as soon as they start.
+  static constexpr size_t kMinAsciiRun = 1;
+
   explicit CordReader(const absl::Cord& input)
       : input_(input), size_(input_.size()), buffer_(), index_(0) {}
 
@@ -189,6 +242,29 @@ class CordReader final {
     size_ -= n;
   }
 
+  // Advances past any leading ASCII bytes, returning how many there were.
+  // Bytes already copied to the temporary buffer are left for `Read`.
+  size_t SkipAscii() {
+    if (index_ < buffer_.size()) {
+      return 0;
+    }
+    size_t skipped = 0;
+    while (size_ != 0) {
+      absl::string_view chunk = *input_.chunk_begin();
+      size_t n = AsciiPrefixLength(chunk.data(), chunk.size());
+      if (n == 0) {
+        break;
+      }
+      input_.RemovePrefix(n);
+      size_ -= n;
+      skipped += n;
+      if (n != chunk.size()) {
+        break;
+      }
+    }
+    return skipped;
+  }
+
   void Reset(const absl::Cord& input) {
     input_ = input;
     size_ = input_.size();
@@ -205,11 +281,17 @@ class CordReader final {
 
 template <typename BufferedByteReader>
 bool Utf8IsValidImpl(BufferedByteReader* reader) {
+  size_t ascii_run = 0;
   while (reader->HasRemaining()) {
     const auto b = static_cast<uint8_t>(reader->Read());
     if (b < kUtf8RuneSelf) {
+      if (++ascii_run == BufferedByteReader::kMinAsciiRun) {
+        reader->SkipAscii();
+        ascii_run = 0;
+      }
       continue;
     }
+    ascii_run = 0;
     const auto leading = kLeading[b];
     if (leading == kXX) {
       return false;
@@ -240,12 +322,20 @@ bool Utf8IsValidImpl(BufferedByteReader* reader) {
 template <typename BufferedByteReader>
 size_t Utf8CodePointCountImpl(BufferedByteReader* reader) {
   size_t count = 0;
+  // Every ASCII byte is a code point, so the current run is tracked through
+  // `count`: the rest of it is skipped once `count` reaches `skip_at`.
+  size_t skip_at = BufferedByteReader::kMinAsciiRun;
   while (reader->HasRemaining()) {
     count++;
     const auto b = static_cast<uint8_t>(reader->Read());
-    if (b < kUtf8RuneSelf) {
+    if (ABSL_PREDICT_TRUE(b < kUtf8RuneSelf)) {
+      if (count == skip_at) {
+        count += reader->SkipAscii();
+        skip_at = count + BufferedByteReader::kMinAsciiRun;
+      }
       continue;
     }
+    skip_at = count + BufferedByteReader::kMinAsciiRun;
     const auto leading = kLeading[b];
     if (leading == kXX) {
       continue;
@@ -276,10 +366,14 @@ size_t Utf8CodePointCountImpl(BufferedByteReader* reader) {
 template <typename BufferedByteReader>
 std::pair<size_t, bool> Utf8ValidateImpl(BufferedByteReader* reader) {
   size_t count = 0;
+  size_t skip_at = BufferedByteReader::kMinAsciiRun;
   while (reader->HasRemaining()) {
     const auto b = static_cast<uint8_t>(reader->Read());
-    if (b < kUtf8RuneSelf) {
-      count++;
+    if (ABSL_PREDICT_TRUE(b < kUtf8RuneSelf)) {
+      if (++count == skip_at) {
+        count += reader->SkipAscii();
+        skip_at = count + BufferedByteReader::kMinAsciiRun;
+      }
       continue;
     }
     const auto leading = kLeading[b];
@@ -308,6 +402,7 @@ std::pair<size_t, bool> Utf8ValidateImpl(BufferedByteReader* reader) {
     } else {
       count++;
     }
+    skip_at = count + BufferedByteReader::kMinAsciiRun;
     reader->Advance(size);
   }
   return {count, true};
@@ -14,15 +14,19 @@
 
 #include "internal/utf8.h"
 
+#include <cstddef>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/base/no_destructor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/cord_test_helpers.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/string_view.h"
 #include "internal/benchmark.h"
 #include "internal/testing.h"
+#include "internal/unicode.h"
 
 // Tests is based on
 // https://go.googlesource.com/go/+/refs/heads/master/src/unicode/utf8/utf8.go
@@ -31,6 +35,7 @@
 namespace cel::internal {
 namespace {
 
+
 TEST(Utf8IsValid, String) {
   EXPECT_TRUE(Utf8IsValid(""));
   EXPECT_TRUE(Utf8IsValid("a"));
@@ -96,6 +101,30 @@ TEST(Utf8CodePointCount, Cord) {
   EXPECT_EQ(Utf8CodePointCount(absl::Cord("a\xe2\x80")), 3);
 }
 
+TEST(Utf8CodePointCount, LongAsciiRuns) {
+  // Exercise the bulk ASCII path with multibyte sequences at every position
+  // relative to the 16 and 8 byte blocks it examines.
+  for (size_t prefix = 0; prefix < 40; ++prefix) {
+    std::string str(prefix, 'a');
+    str.append("\xe2\x98\xba");
+    str.append(prefix, 'b');
+    str.append("\xe2\x80");
+    EXPECT_EQ(Utf8CodePointCount(str), 2 * prefix + 3) << prefix;
+    EXPECT_EQ(Utf8CodePointCount(absl::MakeFragmentedCord(
+                  {str.substr(0, prefix / 2), str.substr(prefix / 2)})),
+              2 * prefix + 3)
+        << prefix;
+    EXPECT_FALSE(Utf8IsValid(str)) << prefix;
+    EXPECT_EQ(Utf8Validate(str), std::make_pair(2 * prefix + 1, false))
+        << prefix;
+    str.resize(str.size() - 2);
+    EXPECT_TRUE(Utf8IsValid(str)) << prefix;
+    EXPECT_TRUE(Utf8IsValid(absl::MakeFragmentedCord(
+        {str.substr(0, prefix + 1), str.substr(prefix + 1)})))
+        << prefix;
+  }
+}
+
 TEST(Utf8Validate, String) {
   EXPECT_TRUE(Utf8Validate("").second);
   EXPECT_TRUE(Utf8Validate("a").second);
@@ -417,5 +446,118 @@ void BM_Utf8Validate_Cord_JapaneseTen(benchmark::State& state) {
 
 BENCHMARK(BM_Utf8Validate_Cord_JapaneseTen);
 
+// Byte at a time implementations without the bulk ASCII skipping, as a
+// baseline for the benchmarks below.
+bool ScalarUtf8IsValid(absl::string_view str) {
+  while (!str.empty()) {
+    char32_t code_point;
+    size_t code_units = Utf8Decode(str, &code_point);
+    if (code_point == kUnicodeReplacementCharacter && code_units == 1) {
+      return false;
+    }
+    str.remove_prefix(code_units);
+  }
+  return true;
+}
+
+size_t ScalarUtf8CodePointCount(absl::string_view str) {
+  size_t count = 0;
+  while (!str.empty()) {
+    str.remove_prefix(Utf8Decode(str, nullptr));
+    ++count;
+  }
+  return count;
+}
+
+// Corpora of 4 KiB of ASCII, Latin (mostly ASCII with some 2 byte sequences)
+// and CJK (3 byte sequences) text.
+std::string MakeCorpus(absl::string_view unit) {
+  std::string corpus;
+  while (corpus.size() + unit.size() <= 4096) {
+    corpus.append(unit);
+  }
+  return corpus;
+}
+
+const std::string& AsciiCorpus() {
+  static const absl::NoDestructor<std::string> kCorpus(
+      MakeCorpus("The quick brown fox jumps over the lazy dog. "));
+  return *kCorpus;
+}
+
+const std::string& LatinCorpus() {
+  static const absl::NoDestructor<std::string> kCorpus(
+      MakeCorpus("Le c\xc5\x93ur d\xc3\xa9\xc3\xa7u mais l'\xc3\xa2me "
+                 "plut\xc3\xb4t na\xc3\xafve. "));
+  return *kCorpus;
+}
+
+const std::string& CjkCorpus() {
+  static const absl::NoDestructor<std::string> kCorpus(
+      MakeCorpus("\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe4\xb8\xad"
+                 "\xe6\x96\x87\xed\x95\x9c\xea\xb5\xad\xec\x96\xb4"));
+  return *kCorpus;
+}
+
+void BM_Utf8IsValid_Corpus(benchmark::State& state, const std::string& corpus) {
+  for (auto s : state) {
+    benchmark::DoNotOptimize(Utf8IsValid(corpus));
+  }
+  state.SetBytesProcessed(state.iterations() * corpus.size());
+}
+
+BENCHMARK_CAPTURE(BM_Utf8IsValid_Corpus, Ascii, AsciiCorpus());
+BENCHMARK_CAPTURE(BM_Utf8IsValid_Corpus, Latin, LatinCorpus());
+BENCHMARK_CAPTURE(BM_Utf8IsValid_Corpus, Cjk, CjkCorpus());
+
+void BM_ScalarUtf8IsValid_Corpus(benchmark::State& state,
+                                 const std::string& corpus) {
+  for (auto s : state) {
+    benchmark::DoNotOptimize(ScalarUtf8IsValid(corpus));
+  }
+  state.SetBytesProcessed(state.iterations() * corpus.size());
+}
+
+BENCHMARK_CAPTURE(BM_ScalarUtf8IsValid_Corpus, Ascii, AsciiCorpus());
+BENCHMARK_CAPTURE(BM_ScalarUtf8IsValid_Corpus, Latin, LatinCorpus());
+BENCHMARK_CAPTURE(BM_ScalarUtf8IsValid_Corpus, Cjk, CjkCorpus());
+
+void BM_Utf8CodePointCount_Corpus(benchmark::State& state,
+                                  const std::string& corpus) {
+  for (auto s : state) {
+    benchmark::DoNotOptimize(Utf8CodePointCount(corpus));
+  }
+  state.SetBytesProcessed(state.iterations() * corpus.size());
+}
+
+BENCHMARK_CAPTURE(BM_Utf8CodePointCount_Corpus, Ascii, AsciiCorpus());
+BENCHMARK_CAPTURE(BM_Utf8CodePointCount_Corpus, Latin, LatinCorpus());
+BENCHMARK_CAPTURE(BM_Utf8CodePointCount_Corpus, Cjk, CjkCorpus());
+
+void BM_ScalarUtf8CodePointCount_Corpus(benchmark::State& state,
+                                        const std::string& corpus) {
+  for (auto s : state) {
+    benchmark::DoNotOptimize(ScalarUtf8CodePointCount(corpus));
+  }
+  state.SetBytesProcessed(state.iterations() * corpus.size());
+}
+
+BENCHMARK_CAPTURE(BM_ScalarUtf8CodePointCount_Corpus, Ascii, AsciiCorpus());
+BENCHMARK_CAPTURE(BM_ScalarUtf8CodePointCount_Corpus, Latin, LatinCorpus());
+BENCHMARK_CAPTURE(BM_ScalarUtf8CodePointCount_Corpus, Cjk, CjkCorpus());
+
+void BM_Utf8CodePointCount_CordCorpus(benchmark::State& state,
+                                      const std::string& corpus) {
+  absl::Cord value(corpus);
+  for (auto s : state) {
+    benchmark::DoNotOptimize(Utf8CodePointCount(value));
+  }
+  state.SetBytesProcessed(state.iterations() * corpus.size());
+}
+
+BENCHMARK_CAPTURE(BM_Utf8CodePointCount_CordCorpus, Ascii, AsciiCorpus());
+BENCHMARK_CAPTURE(BM_Utf8CodePointCount_CordCorpus, Latin, LatinCorpus());
+BENCHMARK_CAPTURE(BM_Utf8CodePointCount_CordCorpus, Cjk, CjkCorpus());
+
 }  // namespace
 }  // namespace cel::internal
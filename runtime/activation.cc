@@ -30,6 +30,7 @@
 #include "internal/status_macros.h"
 #include "runtime/function.h"
 #include "runtime/function_overload_reference.h"
+#include "runtime/internal/indexed_attribute_matcher.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
@@ -126,6 +127,19 @@ bool Activation::InsertFunction(const cel::FunctionDescriptor& descriptor,
   return true;
 }
 
+void Activation::set_index_attribute_patterns(bool enabled) {
+  if (!enabled) {
+    pattern_index_.reset();
+  } else if (pattern_index_ == nullptr) {
+    RebuildPatternIndex();
+  }
+}
+
+void Activation::RebuildPatternIndex() {
+  pattern_index_ = std::make_unique<runtime_internal::IndexedAttributeMatcher>(
+      unknown_patterns_, missing_patterns_);
+}
+
 Activation::Activation(Activation&& other) {
   using std::swap;
   swap(*this, other);
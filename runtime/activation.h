@@ -35,6 +35,7 @@
 #include "runtime/function.h"
 #include "runtime/function_overload_reference.h"
 #include "runtime/internal/attribute_matcher.h"
+#include "runtime/internal/indexed_attribute_matcher.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
@@ -98,21 +99,43 @@ class Activation final : public ActivationInterface {
                                    ValueProvider provider);
 
   void AddUnknownPattern(cel::AttributePattern pattern) {
+    if (pattern_index_ != nullptr) {
+      pattern_index_->AddUnknownPattern(pattern);
+    }
     unknown_patterns_.push_back(std::move(pattern));
   }
 
   void SetUnknownPatterns(std::vector<cel::AttributePattern> patterns) {
     unknown_patterns_ = std::move(patterns);
+    if (pattern_index_ != nullptr) {
+      RebuildPatternIndex();
+    }
   }
 
   void AddMissingPattern(cel::AttributePattern pattern) {
+    if (pattern_index_ != nullptr) {
+      pattern_index_->AddMissingPattern(pattern);
+    }
     missing_patterns_.push_back(std::move(pattern));
   }
 
   void SetMissingPatterns(std::vector<cel::AttributePattern> patterns) {
     missing_patterns_ = std::move(patterns);
+    if (pattern_index_ != nullptr) {
+      RebuildPatternIndex();
+    }
   }
 
+  // Whether attributes are matched against the unknown and missing patterns
+  // through an index keyed by variable name and qualifiers, instead of by
+  // checking every pattern. This speeds up evaluations against many patterns
+  // at the cost of maintaining the index as patterns are added or set.
+  //
+  // Disabled by default.
+  void set_index_attribute_patterns(bool enabled);
+
+  bool index_attribute_patterns() const { return pattern_index_ != nullptr; }
+
   // Returns true if the function was inserted (no other registered function has
   // a matching descriptor).
   bool InsertFunction(const cel::FunctionDescriptor& descriptor,
@@ -145,15 +168,21 @@ class Activation final : public ActivationInterface {
 
   const runtime_internal::AttributeMatcher* absl_nullable GetAttributeMatcher()
       const override {
-    return attribute_matcher_;
+    // A matcher installed through `ActivationAttributeMatcherAccess` takes
+    // precedence over the index.
+    return attribute_matcher_ != nullptr ? attribute_matcher_
+                                         : pattern_index_.get();
   }
 
+  void RebuildPatternIndex();
+
   friend void swap(Activation& a, Activation& b) {
     using std::swap;
     swap(a.values_, b.values_);
     swap(a.functions_, b.functions_);
     swap(a.unknown_patterns_, b.unknown_patterns_);
     swap(a.missing_patterns_, b.missing_patterns_);
+    swap(a.pattern_index_, b.pattern_index_);
   }
 
   // Internal getter for provided values.
@@ -175,6 +204,8 @@ class Activation final : public ActivationInterface {
   const runtime_internal::AttributeMatcher* attribute_matcher_ = nullptr;
   std::unique_ptr<const runtime_internal::AttributeMatcher>
       owned_attribute_matcher_;
+  // Index of `unknown_patterns_` and `missing_patterns_`, if enabled.
+  std::unique_ptr<runtime_internal::IndexedAttributeMatcher> pattern_index_;
 
   absl::flat_hash_map<std::string, std::vector<FunctionEntry>> functions_;
 };
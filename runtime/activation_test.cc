@@ -32,6 +32,8 @@
 #include "internal/testing.h"
 #include "runtime/function.h"
 #include "runtime/function_overload_reference.h"
+#include "runtime/internal/activation_attribute_matcher_access.h"
+#include "runtime/internal/attribute_matcher.h"
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
@@ -271,6 +273,58 @@ TEST_F(ActivationTest, ClearMissingAttributes) {
   EXPECT_THAT(activation.GetMissingAttributes(), IsEmpty());
 }
 
+TEST_F(ActivationTest, IndexAttributePatterns) {
+  using MatchResult = runtime_internal::AttributeMatcher::MatchResult;
+  Activation activation;
+  activation.SetUnknownPatterns(
+      {AttributePattern("var1",
+                        {AttributeQualifierPattern::OfString("field1")})});
+  EXPECT_FALSE(activation.index_attribute_patterns());
+  EXPECT_EQ(
+      runtime_internal::ActivationAttributeMatcherAccess::GetAttributeMatcher(
+          activation),
+      nullptr);
+
+  activation.set_index_attribute_patterns(true);
+  EXPECT_TRUE(activation.index_attribute_patterns());
+  // The index covers the patterns set before enabling it, as well as the ones
+  // added or set afterwards.
+  activation.AddUnknownPattern(AttributePattern(
+      "var1", {AttributeQualifierPattern::OfString("field2")}));
+  activation.SetMissingPatterns({AttributePattern("var2", {})});
+
+  const runtime_internal::AttributeMatcher* matcher =
+      runtime_internal::ActivationAttributeMatcherAccess::GetAttributeMatcher(
+          activation);
+  ASSERT_NE(matcher, nullptr);
+  EXPECT_EQ(matcher->CheckForUnknown(Attribute("var1")), MatchResult::PARTIAL);
+  EXPECT_EQ(matcher->CheckForUnknown(
+                Attribute("var1", {AttributeQualifier::OfString("field1")})),
+            MatchResult::FULL);
+  EXPECT_EQ(matcher->CheckForUnknown(
+                Attribute("var1", {AttributeQualifier::OfString("field2")})),
+            MatchResult::FULL);
+  EXPECT_EQ(matcher->CheckForUnknown(Attribute("var2")), MatchResult::NONE);
+  EXPECT_EQ(matcher->CheckForMissing(Attribute("var2")), MatchResult::FULL);
+
+  activation.SetUnknownPatterns({});
+  matcher =
+      runtime_internal::ActivationAttributeMatcherAccess::GetAttributeMatcher(
+          activation);
+  ASSERT_NE(matcher, nullptr);
+  EXPECT_EQ(matcher->CheckForUnknown(Attribute("var1")), MatchResult::NONE);
+  EXPECT_EQ(matcher->CheckForMissing(Attribute("var2")), MatchResult::FULL);
+
+  Activation moved = std::move(activation);
+  EXPECT_TRUE(moved.index_attribute_patterns());
+
+  moved.set_index_attribute_patterns(false);
+  EXPECT_EQ(
+      runtime_internal::ActivationAttributeMatcherAccess::GetAttributeMatcher(
+          moved),
+      nullptr);
+}
+
 TEST_F(ActivationTest, InsertFunctionOk) {
   Activation activation;
 
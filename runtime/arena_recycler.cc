@@ -0,0 +1,244 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/arena_recycler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/synchronization/mutex.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+
+namespace {
+
+// Size of the blocks held by the thread-local block cache. Arenas using the
+// cache grow their blocks up to this size, and requests for smaller blocks are
+// served by a block of this size so that every block can be cached. Blocks for
+// individual allocations larger than this bypass the cache.
+constexpr size_t kCachedBlockSize = 32 * 1024;
+
+// Bounds the memory retained by the cache of each thread to 1 MiB.
+constexpr size_t kMaxCachedBlocksPerThread = 32;
+
+// Granularity of initial blocks grown to the high-water mark of an arena.
+constexpr size_t kInitialBlockGranularity = 4 * 1024;
+
+// Smallest initial block, which must at least hold the arena's own
+// bookkeeping.
+constexpr size_t kMinInitialBlockSize = 1024;
+
+std::atomic<uint64_t> block_cache_hits{0};
+std::atomic<uint64_t> block_cache_misses{0};
+
+class BlockCache final {
+ public:
+  BlockCache() { blocks_.reserve(kMaxCachedBlocksPerThread); }
+
+  BlockCache(const BlockCache&) = delete;
+  BlockCache& operator=(const BlockCache&) = delete;
+
+  ~BlockCache() {
+    for (void* block : blocks_) {
+      std::free(block);
+    }
+  }
+
+  void* absl_nullable Pop() {
+    if (blocks_.empty()) {
+      return nullptr;
+    }
+    void* block = blocks_.back();
+    blocks_.pop_back();
+    return block;
+  }
+
+  bool Push(void* absl_nonnull block) {
+    if (blocks_.size() >= kMaxCachedBlocksPerThread) {
+      return false;
+    }
+    blocks_.push_back(block);
+    return true;
+  }
+
+ private:
+  std::vector<void*> blocks_;
+};
+
+BlockCache& ThreadLocalBlockCache() {
+  thread_local BlockCache cache;
+  return cache;
+}
+
+void* AllocateCachedBlock(size_t size) {
+  if (size > kCachedBlockSize) {
+    return std::malloc(size);
+  }
+  if (void* block = ThreadLocalBlockCache().Pop(); block != nullptr) {
+    block_cache_hits.fetch_add(1, std::memory_order_relaxed);
+    return block;
+  }
+  block_cache_misses.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(kCachedBlockSize);
+}
+
+void DeallocateCachedBlock(void* block, size_t size) {
+  if (size <= kCachedBlockSize && ThreadLocalBlockCache().Push(block)) {
+    return;
+  }
+  std::free(block);
+}
+
+ArenaRecyclerOptions NormalizeOptions(ArenaRecyclerOptions options) {
+  options.initial_block_size =
+      std::max(options.initial_block_size, kMinInitialBlockSize);
+  options.max_initial_block_size =
+      std::max(options.max_initial_block_size, options.initial_block_size);
+  return options;
+}
+
+}  // namespace
+
+struct ArenaRecycler::Lease::Slot {
+  static google::protobuf::ArenaOptions MakeArenaOptions(char* absl_nonnull block,
+                                               size_t block_size,
+                                               bool use_block_cache) {
+    google::protobuf::ArenaOptions options;
+    options.initial_block = block;
+    options.initial_block_size = block_size;
+    if (use_block_cache) {
+      options.start_block_size = kCachedBlockSize;
+      options.max_block_size = kCachedBlockSize;
+      options.block_alloc = &AllocateCachedBlock;
+      options.block_dealloc = &DeallocateCachedBlock;
+    }
+    return options;
+  }
+
+  Slot(size_t block_size, bool use_block_cache)
+      : block(new char[block_size]),
+        block_size(block_size),
+        arena(MakeArenaOptions(block.get(), block_size, use_block_cache)) {}
+
+  // The initial block of `arena`, which must outlive it.
+  const std::unique_ptr<char[]> block;
+  const size_t block_size;
+  google::protobuf::Arena arena;
+};
+
+ArenaRecycler::Lease::Lease(ArenaRecycler* absl_nonnull recycler,
+                             std::unique_ptr<Slot> slot)
+    : recycler_(recycler), slot_(std::move(slot)) {}
+
+ArenaRecycler::Lease::Lease(Lease&& other) noexcept
+    : recycler_(other.recycler_), slot_(std::move(other.slot_)) {}
+
+ArenaRecycler::Lease::~Lease() {
+  if (slot_ != nullptr) {
+    recycler_->Release(std::move(slot_));
+  }
+}
+
+google::protobuf::Arena* absl_nonnull ArenaRecycler::Lease::arena() const {
+  return &slot_->arena;
+}
+
+ArenaRecycler::ArenaRecycler(ArenaRecyclerOptions options)
+    : options_(NormalizeOptions(std::move(options))) {}
+
+ArenaRecycler::~ArenaRecycler() = default;
+
+ArenaRecycler::Lease ArenaRecycler::Acquire() {
+  acquisitions_.fetch_add(1, std::memory_order_relaxed);
+  std::unique_ptr<Lease::Slot> slot;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!idle_.empty()) {
+      slot = std::move(idle_.back());
+      idle_.pop_back();
+    }
+  }
+  if (slot != nullptr) {
+    reuses_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    slot = NewSlot(options_.initial_block_size);
+  }
+  return Lease(this, std::move(slot));
+}
+
+std::unique_ptr<ArenaRecycler::Lease::Slot> ArenaRecycler::NewSlot(
+    size_t initial_block_size) const {
+  return std::make_unique<Lease::Slot>(initial_block_size,
+                                       options_.use_thread_local_block_cache);
+}
+
+void ArenaRecycler::Release(std::unique_ptr<Lease::Slot> slot) {
+  const uint64_t space_allocated = slot->arena.SpaceAllocated();
+  uint64_t peak = peak_space_allocated_.load(std::memory_order_relaxed);
+  while (space_allocated > peak &&
+         !peak_space_allocated_.compare_exchange_weak(
+             peak, space_allocated, std::memory_order_relaxed)) {
+  }
+
+  if (space_allocated > slot->block_size &&
+      slot->block_size < options_.max_initial_block_size) {
+    // The evaluation overflowed the initial block. Replace the arena by one
+    // whose initial block covers its high-water mark, so that similar
+    // evaluations fit in it next time.
+    const size_t high_water_mark = static_cast<size_t>(std::min<uint64_t>(
+        (space_allocated + kInitialBlockGranularity - 1) /
+            kInitialBlockGranularity * kInitialBlockGranularity,
+        options_.max_initial_block_size));
+    slot = NewSlot(high_water_mark);
+    initial_block_growths_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    slot->arena.Reset();
+  }
+
+  {
+    absl::MutexLock lock(&mutex_);
+    if (idle_.size() < options_.max_idle_arenas) {
+      idle_.push_back(std::move(slot));
+      return;
+    }
+  }
+  discards_.fetch_add(1, std::memory_order_relaxed);
+}
+
+ArenaRecyclerStats ArenaRecycler::stats() const {
+  ArenaRecyclerStats stats;
+  stats.acquisitions = acquisitions_.load(std::memory_order_relaxed);
+  stats.reuses = reuses_.load(std::memory_order_relaxed);
+  stats.initial_block_growths =
+      initial_block_growths_.load(std::memory_order_relaxed);
+  stats.discards = discards_.load(std::memory_order_relaxed);
+  if (options_.use_thread_local_block_cache) {
+    stats.block_cache_hits = block_cache_hits.load(std::memory_order_relaxed);
+    stats.block_cache_misses =
+        block_cache_misses.load(std::memory_order_relaxed);
+  }
+  stats.peak_space_allocated =
+      peak_space_allocated_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace cel
@@ -0,0 +1,143 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_ARENA_RECYCLER_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_ARENA_RECYCLER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/nullability.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+
+struct ArenaRecyclerOptions {
+  // Size of the block each arena starts with. Evaluations which allocate less
+  // than this from a recycled arena do not touch the heap.
+  size_t initial_block_size = 8 * 1024;
+
+  // Upper bound for the initial block. When an evaluation overflows the
+  // initial block, the block is grown to the arena's high-water mark, up to
+  // this size, before the arena is reused.
+  size_t max_initial_block_size = 256 * 1024;
+
+  // Maximum number of idle arenas kept for reuse. Together with
+  // `max_initial_block_size` this bounds the memory retained by the recycler.
+  size_t max_idle_arenas = 16;
+
+  // If true, blocks an arena allocates beyond its initial block are taken from
+  // and returned to a cache local to the calling thread instead of the heap.
+  bool use_thread_local_block_cache = false;
+};
+
+// Counters of an `ArenaRecycler`.
+struct ArenaRecyclerStats {
+  // Arenas handed out.
+  uint64_t acquisitions = 0;
+  // Acquisitions served by an idle arena.
+  uint64_t reuses = 0;
+  // Recycled arenas whose initial block was grown to their high-water mark.
+  uint64_t initial_block_growths = 0;
+  // Arenas discarded on release because `max_idle_arenas` were already idle.
+  uint64_t discards = 0;
+  // Overflow blocks served by the thread-local block cache, and those which
+  // had to be allocated from the heap. The cache is shared by all recyclers
+  // using it, so these count blocks of any of them.
+  uint64_t block_cache_hits = 0;
+  uint64_t block_cache_misses = 0;
+  // Largest `google::protobuf::Arena::SpaceAllocated()` of an arena when it was
+  // released.
+  uint64_t peak_space_allocated = 0;
+};
+
+// Hands out arenas for evaluations and recycles them afterwards, so that in
+// steady state evaluations allocate from a warm initial block instead of
+// requesting fresh blocks from the heap for every request.
+//
+//   ArenaRecycler recycler;
+//   ...
+//   ArenaRecycler::Lease lease = recycler.Acquire();
+//   CEL_ASSIGN_OR_RETURN(Value result,
+//                        program->Evaluate(lease.arena(), activation));
+//   // Consume `result` before `lease` goes out of scope.
+//
+// Releasing a lease resets its arena, running destructors registered with it
+// and freeing every block but the initial one. Values which refer to the arena
+// must not be used afterwards.
+//
+// This class is thread-safe.
+class ArenaRecycler final {
+ public:
+  // Move-only handle to an arena. Resets the arena and returns it to the
+  // recycler on destruction.
+  class Lease final {
+   public:
+    Lease(Lease&& other) noexcept;
+    Lease& operator=(Lease&&) = delete;
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+
+    ~Lease();
+
+    google::protobuf::Arena* absl_nonnull arena() const ABSL_ATTRIBUTE_LIFETIME_BOUND;
+
+   private:
+    friend class ArenaRecycler;
+
+    struct Slot;
+
+    Lease(ArenaRecycler* absl_nonnull recycler, std::unique_ptr<Slot> slot);
+
+    ArenaRecycler* absl_nonnull recycler_;
+    std::unique_ptr<Slot> slot_;
+  };
+
+  explicit ArenaRecycler(ArenaRecyclerOptions options = {});
+
+  ArenaRecycler(const ArenaRecycler&) = delete;
+  ArenaRecycler& operator=(const ArenaRecycler&) = delete;
+
+  ~ArenaRecycler();
+
+  // Leases an arena, reusing an idle one if possible. The lease must not
+  // outlive the recycler.
+  Lease Acquire() ABSL_ATTRIBUTE_LIFETIME_BOUND;
+
+  ArenaRecyclerStats stats() const;
+
+ private:
+  std::unique_ptr<Lease::Slot> NewSlot(size_t initial_block_size) const;
+
+  void Release(std::unique_ptr<Lease::Slot> slot);
+
+  const ArenaRecyclerOptions options_;
+  mutable absl::Mutex mutex_;
+  std::vector<std::unique_ptr<Lease::Slot>> idle_ ABSL_GUARDED_BY(mutex_);
+  std::atomic<uint64_t> acquisitions_{0};
+  std::atomic<uint64_t> reuses_{0};
+  std::atomic<uint64_t> initial_block_growths_{0};
+  std::atomic<uint64_t> discards_{0};
+  std::atomic<uint64_t> peak_space_allocated_{0};
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_ARENA_RECYCLER_H_
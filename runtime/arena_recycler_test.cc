@@ -0,0 +1,147 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/arena_recycler.h"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include "internal/testing.h"
+#include "google/protobuf/arena.h"
+
+namespace cel {
+namespace {
+
+// Allocates about `bytes` from `arena` in small chunks.
+void Allocate(google::protobuf::Arena* arena, size_t bytes) {
+  for (size_t allocated = 0; allocated < bytes; allocated += 64) {
+    arena->AllocateAligned(64);
+  }
+}
+
+TEST(ArenaRecyclerTest, ReusesArenas) {
+  ArenaRecycler recycler;
+  google::protobuf::Arena* arena;
+  {
+    ArenaRecycler::Lease lease = recycler.Acquire();
+    arena = lease.arena();
+    Allocate(arena, 1024);
+  }
+  {
+    ArenaRecycler::Lease lease = recycler.Acquire();
+    EXPECT_EQ(lease.arena(), arena);
+    EXPECT_EQ(lease.arena()->SpaceUsed(), 0);
+  }
+
+  ArenaRecyclerStats stats = recycler.stats();
+  EXPECT_EQ(stats.acquisitions, 2);
+  EXPECT_EQ(stats.reuses, 1);
+  EXPECT_EQ(stats.initial_block_growths, 0);
+  EXPECT_GE(stats.peak_space_allocated, 1024);
+}
+
+TEST(ArenaRecyclerTest, RunsDestructorsOnRelease) {
+  ArenaRecycler recycler;
+  bool destroyed = false;
+  struct SetOnDestruction {
+    ~SetOnDestruction() { *destroyed = true; }
+    bool* destroyed;
+  };
+  {
+    ArenaRecycler::Lease lease = recycler.Acquire();
+    google::protobuf::Arena::Create<SetOnDestruction>(lease.arena(),
+                                            SetOnDestruction{&destroyed});
+    destroyed = false;
+  }
+  EXPECT_TRUE(destroyed);
+}
+
+TEST(ArenaRecyclerTest, GrowsInitialBlockToHighWaterMark) {
+  ArenaRecyclerOptions options;
+  options.initial_block_size = 4 * 1024;
+  options.max_initial_block_size = 64 * 1024;
+  ArenaRecycler recycler(options);
+  {
+    ArenaRecycler::Lease lease = recycler.Acquire();
+    Allocate(lease.arena(), 16 * 1024);
+  }
+  EXPECT_EQ(recycler.stats().initial_block_growths, 1);
+  {
+    ArenaRecycler::Lease lease = recycler.Acquire();
+    Allocate(lease.arena(), 16 * 1024);
+  }
+  // The second evaluation fits in the grown initial block.
+  EXPECT_EQ(recycler.stats().initial_block_growths, 1);
+  {
+    ArenaRecycler::Lease lease = recycler.Acquire();
+    Allocate(lease.arena(), 1024 * 1024);
+  }
+  {
+    ArenaRecycler::Lease lease = recycler.Acquire();
+    Allocate(lease.arena(), 1024 * 1024);
+  }
+  // The initial block is capped at `max_initial_block_size`, so it is grown
+  // once more but not for the last evaluation.
+  ArenaRecyclerStats stats = recycler.stats();
+  EXPECT_EQ(stats.initial_block_growths, 2);
+  EXPECT_EQ(stats.reuses, 3);
+  EXPECT_GE(stats.peak_space_allocated, 1024 * 1024);
+}
+
+TEST(ArenaRecyclerTest, BoundsIdleArenas) {
+  ArenaRecyclerOptions options;
+  options.max_idle_arenas = 1;
+  ArenaRecycler recycler(options);
+  {
+    ArenaRecycler::Lease first = recycler.Acquire();
+    ArenaRecycler::Lease second = recycler.Acquire();
+    ArenaRecycler::Lease moved = std::move(second);
+  }
+  EXPECT_EQ(recycler.stats().discards, 1);
+  {
+    ArenaRecycler::Lease first = recycler.Acquire();
+    ArenaRecycler::Lease second = recycler.Acquire();
+  }
+
+  ArenaRecyclerStats stats = recycler.stats();
+  EXPECT_EQ(stats.acquisitions, 4);
+  EXPECT_EQ(stats.reuses, 1);
+  EXPECT_EQ(stats.discards, 2);
+}
+
+TEST(ArenaRecyclerTest, ThreadLocalBlockCache) {
+  ArenaRecyclerOptions options;
+  options.initial_block_size = 4 * 1024;
+  options.max_initial_block_size = options.initial_block_size;
+  options.use_thread_local_block_cache = true;
+  ArenaRecycler recycler(options);
+  {
+    ArenaRecycler::Lease lease = recycler.Acquire();
+    Allocate(lease.arena(), 128 * 1024);
+  }
+  const ArenaRecyclerStats before = recycler.stats();
+  EXPECT_GT(before.block_cache_misses, 0);
+  {
+    ArenaRecycler::Lease lease = recycler.Acquire();
+    Allocate(lease.arena(), 128 * 1024);
+  }
+  // The blocks freed by the first evaluation are reused by the second one.
+  const ArenaRecyclerStats after = recycler.stats();
+  EXPECT_GT(after.block_cache_hits, before.block_cache_hits);
+  EXPECT_EQ(after.block_cache_misses, before.block_cache_misses);
+}
+
+}  // namespace
+}  // namespace cel
@@ -0,0 +1,40 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_COMMON_SUBEXPRESSION_ELIMINATION_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_COMMON_SUBEXPRESSION_ELIMINATION_H_
+
+#include "absl/status/status.h"
+#include "runtime/runtime_builder.h"
+
+namespace cel::extensions {
+
+// Enables a planning pass that evaluates repeated field selections on
+// variables (e.g. `request.auth.claims.email`) at most once per evaluation.
+//
+// Repeated select chains are hoisted into lazily initialized slots, the same
+// mechanism backing `cel.bind` and `cel.@block`, so a selection that is never
+// reached by short-circuiting is still never evaluated. Results, including
+// errors and unknowns, are unchanged.
+//
+// The number of deduplicated occurrences is reported as an informational
+// RuntimeIssue to callers that collect issues via
+// `Runtime::CreateProgramOptions::issues`.
+//
+// Expressions that already use `cel.@block` are not modified.
+absl::Status EnableCommonSubexpressionElimination(RuntimeBuilder& builder);
+
+}  // namespace cel::extensions
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_COMMON_SUBEXPRESSION_ELIMINATION_H_
@@ -0,0 +1,185 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/common_subexpression_elimination.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cel/expr/syntax.pb.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "base/ast.h"
+#include "common/ast_proto.h"
+#include "common/value.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_issue.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::extensions {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::cel::expr::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+
+absl::StatusOr<std::unique_ptr<Ast>> ParseAst(absl::string_view expression) {
+  CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+  return CreateAstFromParsedExpr(parsed_expr);
+}
+
+absl::StatusOr<std::unique_ptr<Runtime>> NewRuntime(bool enable_cse,
+                                                    bool recursive) {
+  RuntimeOptions options;
+  options.enable_qualified_type_identifiers = true;
+  if (recursive) {
+    options.max_recursion_depth = -1;
+  }
+  CEL_ASSIGN_OR_RETURN(RuntimeBuilder builder,
+                       CreateStandardRuntimeBuilder(
+                           internal::GetTestingDescriptorPool(), options));
+  if (enable_cse) {
+    CEL_RETURN_IF_ERROR(EnableCommonSubexpressionElimination(builder));
+  }
+  return std::move(builder).Build();
+}
+
+// request = {"auth": {"claims": {"email": "a@example.com", "groups": [...]}},
+//            "path": "/admin"}
+Value MakeRequest(google::protobuf::Arena* arena) {
+  auto groups = NewListValueBuilder(arena);
+  ABSL_CHECK_OK(groups->Add(StringValue("admin")));
+  ABSL_CHECK_OK(groups->Add(StringValue("eng")));
+  auto claims = NewMapValueBuilder(arena);
+  ABSL_CHECK_OK(
+      claims->Put(StringValue("email"), StringValue("a@example.com")));
+  ABSL_CHECK_OK(claims->Put(StringValue("groups"), std::move(*groups).Build()));
+  auto auth = NewMapValueBuilder(arena);
+  ABSL_CHECK_OK(auth->Put(StringValue("claims"), std::move(*claims).Build()));
+  auto request = NewMapValueBuilder(arena);
+  ABSL_CHECK_OK(request->Put(StringValue("auth"), std::move(*auth).Build()));
+  ABSL_CHECK_OK(request->Put(StringValue("path"), StringValue("/admin")));
+  return std::move(*request).Build();
+}
+
+struct TestCase {
+  std::string expression;
+  bool recursive;
+};
+
+class CommonSubexpressionEliminationTest
+    : public testing::TestWithParam<TestCase> {};
+
+TEST_P(CommonSubexpressionEliminationTest, MatchesUnoptimized) {
+  const TestCase& test_case = GetParam();
+  ASSERT_OK_AND_ASSIGN(auto runtime,
+                       NewRuntime(/*enable_cse=*/false, test_case.recursive));
+  ASSERT_OK_AND_ASSIGN(auto optimized_runtime,
+                       NewRuntime(/*enable_cse=*/true, test_case.recursive));
+
+  ASSERT_OK_AND_ASSIGN(auto ast, ParseAst(test_case.expression));
+  ASSERT_OK_AND_ASSIGN(auto optimized_ast, ParseAst(test_case.expression));
+  ASSERT_OK_AND_ASSIGN(auto program, runtime->CreateProgram(std::move(ast)));
+  ASSERT_OK_AND_ASSIGN(auto optimized_program,
+                       optimized_runtime->CreateProgram(std::move(optimized_ast)));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  activation.InsertOrAssignValue("request", MakeRequest(&arena));
+
+  ASSERT_OK_AND_ASSIGN(Value expected, program->Evaluate(&arena, activation));
+  ASSERT_OK_AND_ASSIGN(Value actual,
+                       optimized_program->Evaluate(&arena, activation));
+  EXPECT_EQ(actual.DebugString(), expected.DebugString());
+}
+
+std::vector<TestCase> TestCases() {
+  std::vector<std::string> expressions = {
+      "request.auth.claims.email == 'a@example.com' && "
+      "request.auth.claims.email.endsWith('@example.com')",
+      "'admin' in request.auth.claims.groups || "
+      "'eng' in request.auth.claims.groups || request.path == '/admin'",
+      "has(request.auth.claims.email) && has(request.auth.claims.email) && "
+      "!has(request.auth.claims.phone)",
+      // Errors in hoisted selections are reported as before.
+      "request.auth.missing.email == 'x' || request.auth.missing.email == 'y'",
+      // Short-circuited selections are still never evaluated.
+      "request.path == '/admin' || request.auth.missing.x == 1 || "
+      "request.auth.missing.x == 2",
+      "request.auth.claims.groups.exists(g, g == request.auth.claims.email) "
+      "|| request.auth.claims.groups.size() > 1",
+      "[request].all(request, request.auth.claims.email != '') && "
+      "request.auth.claims.email != ''",
+  };
+  std::vector<TestCase> test_cases;
+  for (const std::string& expression : expressions) {
+    test_cases.push_back({expression, /*recursive=*/false});
+    test_cases.push_back({expression, /*recursive=*/true});
+  }
+  return test_cases;
+}
+
+INSTANTIATE_TEST_SUITE_P(CommonSubexpressionEliminationTest,
+                         CommonSubexpressionEliminationTest,
+                         testing::ValuesIn(TestCases()));
+
+TEST(CommonSubexpressionElimination, ReportsReplacedOccurrences) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, NewRuntime(/*enable_cse=*/true,
+                                                /*recursive=*/false));
+  ASSERT_OK_AND_ASSIGN(auto ast,
+                       ParseAst("request.auth.claims.email == 'x' || "
+                                "request.auth.claims.email == 'y' || "
+                                "request.auth.claims.email == 'z'"));
+
+  std::vector<RuntimeIssue> issues;
+  Runtime::CreateProgramOptions options;
+  options.issues = &issues;
+  ASSERT_THAT(runtime->CreateProgram(std::move(ast), options), IsOk());
+
+  ASSERT_EQ(issues.size(), 1);
+  EXPECT_EQ(issues[0].severity(), RuntimeIssue::Severity::kInformation);
+  EXPECT_THAT(issues[0].ToStatus(), IsOk());
+  EXPECT_THAT(issues[0].message(), HasSubstr("replaced 3 occurrences"));
+}
+
+TEST(CommonSubexpressionElimination, NoRepetition) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, NewRuntime(/*enable_cse=*/true,
+                                                /*recursive=*/false));
+  ASSERT_OK_AND_ASSIGN(auto ast, ParseAst("request.auth.claims.email == 'x'"));
+
+  std::vector<RuntimeIssue> issues;
+  Runtime::CreateProgramOptions options;
+  options.issues = &issues;
+  ASSERT_THAT(runtime->CreateProgram(std::move(ast), options), IsOk());
+
+  EXPECT_THAT(issues, IsEmpty());
+}
+
+}  // namespace
+}  // namespace cel::extensions
@@ -0,0 +1,34 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_CONSTANT_LIST_MEMBERSHIP_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_CONSTANT_LIST_MEMBERSHIP_H_
+
+#include "absl/status/status.h"
+#include "runtime/runtime_builder.h"
+
+namespace cel::extensions {
+
+// Enable hash indexed membership tests against constant lists.
+//
+// `x in [c1, c2, ...]` where every element is a null, bool, int, uint, double,
+// string or bytes literal is planned as a hash lookup instead of a linear scan.
+// Results are the same as the standard `in` operator with heterogeneous
+// equality; the extension has no effect if enable_heterogeneous_equality is
+// disabled.
+absl::Status EnableConstantListMembership(RuntimeBuilder& builder);
+
+}  // namespace cel::extensions
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_CONSTANT_LIST_MEMBERSHIP_H_
@@ -0,0 +1,146 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/constant_list_membership.h"
+
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "cel/expr/syntax.pb.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/constant_folding.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::extensions {
+namespace {
+
+using ::cel::expr::ParsedExpr;
+using ::cel::test::BoolValueIs;
+using ::cel::test::ErrorValueIs;
+using ::google::api::expr::parser::Parse;
+using ::testing::_;
+
+using ValueMatcher = testing::Matcher<Value>;
+
+struct TestCase {
+  std::string name;
+  std::string expression;
+  ValueMatcher result_matcher;
+};
+
+enum class Planner { kStackMachine, kRecursive, kConstantFolding };
+
+class ConstantListMembershipTest
+    : public testing::TestWithParam<std::tuple<TestCase, Planner>> {
+ protected:
+  absl::StatusOr<Value> Evaluate(absl::string_view expression) {
+    RuntimeOptions options;
+    Planner planner = std::get<1>(GetParam());
+    if (planner == Planner::kRecursive) {
+      options.max_recursion_depth = -1;
+    }
+    CEL_ASSIGN_OR_RETURN(
+        RuntimeBuilder builder,
+        CreateStandardRuntimeBuilder(internal::GetTestingDescriptorPool(),
+                                     options));
+    if (planner == Planner::kConstantFolding) {
+      CEL_RETURN_IF_ERROR(EnableConstantFolding(builder));
+    }
+    CEL_RETURN_IF_ERROR(EnableConstantListMembership(builder));
+    CEL_ASSIGN_OR_RETURN(auto runtime, std::move(builder).Build());
+
+    CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+    CEL_ASSIGN_OR_RETURN(auto program, ProtobufRuntimeAdapter::CreateProgram(
+                                           *runtime, parsed_expr));
+
+    Activation activation;
+    activation.InsertOrAssignValue("int_var", IntValue(2));
+    activation.InsertOrAssignValue("uint_var", UintValue(2));
+    activation.InsertOrAssignValue("double_var", DoubleValue(2.0));
+    activation.InsertOrAssignValue("fraction_var", DoubleValue(2.5));
+    activation.InsertOrAssignValue("string_var", StringValue("CA"));
+    activation.InsertOrAssignValue("bytes_var", BytesValue("CA"));
+    activation.InsertOrAssignValue("null_var", NullValue());
+    return program->Evaluate(&arena_, activation);
+  }
+
+  google::protobuf::Arena arena_;
+};
+
+TEST_P(ConstantListMembershipTest, Evaluate) {
+  const TestCase& test_case = std::get<0>(GetParam());
+  ASSERT_OK_AND_ASSIGN(Value value, Evaluate(test_case.expression));
+  EXPECT_THAT(value, test_case.result_matcher);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Cases, ConstantListMembershipTest,
+    testing::Combine(
+        testing::ValuesIn(std::vector<TestCase>{
+            {"string", "string_var in ['US', 'CA', 'MX']", BoolValueIs(true)},
+            {"string_missing", "string_var in ['US', 'MX']",
+             BoolValueIs(false)},
+            {"string_vs_bytes", "string_var in [b'CA']", BoolValueIs(false)},
+            {"bytes", "bytes_var in [b'US', b'CA']", BoolValueIs(true)},
+            {"int", "int_var in [1, 2, 3]", BoolValueIs(true)},
+            {"int_as_uint", "int_var in [1u, 2u]", BoolValueIs(true)},
+            {"int_as_double", "int_var in [1.0, 2.0]", BoolValueIs(true)},
+            {"uint_as_int", "uint_var in [2]", BoolValueIs(true)},
+            {"double_as_int", "double_var in [2]", BoolValueIs(true)},
+            {"fraction", "fraction_var in [2, 3]", BoolValueIs(false)},
+            {"fraction_found", "fraction_var in [2, 2.5]", BoolValueIs(true)},
+            {"large_uint", "18446744073709551615u in [18446744073709551615u]",
+             BoolValueIs(true)},
+            {"nan", "double('NaN') in [double('NaN')]", BoolValueIs(false)},
+            {"mixed", "string_var in [1, 'CA', true, null]",
+             BoolValueIs(true)},
+            {"bool", "true in [false, true]", BoolValueIs(true)},
+            {"null", "null_var in [null]", BoolValueIs(true)},
+            {"empty", "int_var in []", BoolValueIs(false)},
+            {"list_item", "[1] in [1, 2]", BoolValueIs(false)},
+            {"error_item", "(1 / 0) in [1, 2]", ErrorValueIs(_)},
+            {"not_constant", "int_var in [1, int_var]", BoolValueIs(true)},
+        }),
+        testing::Values(Planner::kStackMachine, Planner::kRecursive,
+                        Planner::kConstantFolding)),
+    [](const testing::TestParamInfo<std::tuple<TestCase, Planner>>& info) {
+      std::string name = std::get<0>(info.param).name;
+      switch (std::get<1>(info.param)) {
+        case Planner::kStackMachine:
+          return name + "_stack_machine";
+        case Planner::kRecursive:
+          return name + "_recursive";
+        case Planner::kConstantFolding:
+          return name + "_constant_folding";
+      }
+      return name;
+    });
+
+}  // namespace
+}  // namespace cel::extensions
@@ -0,0 +1,267 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/evaluation_profile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_replace.h"
+#include "absl/time/time.h"
+#include "absl/types/optional.h"
+#include "common/ast.h"
+#include "common/ast_traverse.h"
+#include "common/ast_visitor_base.h"
+#include "common/expr.h"
+#include "common/source.h"
+
+namespace cel {
+
+namespace {
+
+struct ActiveNode {
+  const void* profile;
+  size_t index;
+  int64_t start_nanos;
+  uint64_t start_bytes;
+  // Totals of nested nodes, subtracted to compute self cost.
+  uint64_t child_nanos;
+  uint64_t child_bytes;
+};
+
+// Nodes currently being evaluated on this thread, innermost last.
+thread_local std::vector<ActiveNode> active_nodes;
+
+int64_t NowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+std::string Label(const Expr& expr) {
+  if (expr.has_ident_expr()) {
+    return expr.ident_expr().name();
+  }
+  if (expr.has_select_expr()) {
+    if (expr.select_expr().test_only()) {
+      return absl::StrCat("has(.", expr.select_expr().field(), ")");
+    }
+    return absl::StrCat(".", expr.select_expr().field());
+  }
+  if (expr.has_call_expr()) {
+    return expr.call_expr().function();
+  }
+  if (expr.has_list_expr()) {
+    return "[]";
+  }
+  if (expr.has_map_expr()) {
+    return "{}";
+  }
+  if (expr.has_struct_expr()) {
+    return absl::StrCat(expr.struct_expr().name(), "{}");
+  }
+  if (expr.has_comprehension_expr()) {
+    return absl::StrCat("comprehension(", expr.comprehension_expr().iter_var(),
+                        ")");
+  }
+  return "const";
+}
+
+SourceLocation ComputeSourceLocation(const SourceInfo& source_info,
+                                     int64_t expr_id) {
+  auto iter = source_info.positions().find(expr_id);
+  if (iter == source_info.positions().end() || iter->second < 0) {
+    return SourceLocation{};
+  }
+  int32_t position = iter->second;
+  int32_t line_start = 0;
+  int32_t line = 1;
+  for (int32_t offset : source_info.line_offsets()) {
+    if (position < offset) {
+      break;
+    }
+    line_start = offset;
+    ++line;
+  }
+  return SourceLocation{line, position - line_start};
+}
+
+class NodeCollector : public AstVisitorBase {
+ public:
+  struct Node {
+    const Expr* expr;
+    int64_t parent;
+  };
+
+  void PreVisitExpr(const Expr& expr) override {
+    nodes_.push_back(
+        {&expr, stack_.empty() ? -1 : static_cast<int64_t>(stack_.back())});
+    stack_.push_back(nodes_.size() - 1);
+  }
+
+  void PostVisitExpr(const Expr& expr) override { stack_.pop_back(); }
+
+  const std::vector<Node>& nodes() const { return nodes_; }
+
+ private:
+  std::vector<Node> nodes_;
+  std::vector<size_t> stack_;
+};
+
+}  // namespace
+
+EvaluationProfile::EvaluationProfile(const Ast& ast) {
+  NodeCollector collector;
+  AstTraverse(ast.root_expr(), collector);
+  nodes_.reserve(collector.nodes().size());
+  for (const NodeCollector::Node& node : collector.nodes()) {
+    index_.insert({node.expr->id(), nodes_.size()});
+    nodes_.push_back(
+        {node.expr->id(), node.parent, Label(*node.expr),
+         ComputeSourceLocation(ast.source_info(), node.expr->id())});
+  }
+  counters_ = std::make_unique<Counters[]>(nodes_.size());
+}
+
+absl::optional<size_t> EvaluationProfile::NodeIndex(int64_t expr_id) const {
+  if (auto it = index_.find(expr_id); it != index_.end()) {
+    return it->second;
+  }
+  return absl::nullopt;
+}
+
+void EvaluationProfile::Enter(size_t index, uint64_t allocated_bytes) {
+  active_nodes.push_back(
+      {this, index, NowNanos(), allocated_bytes, /*child_nanos=*/0,
+       /*child_bytes=*/0});
+}
+
+void EvaluationProfile::Exit(size_t index, uint64_t allocated_bytes) {
+  int64_t now = NowNanos();
+  // Nodes above the matching start were abandoned by an operand that returned
+  // an error status.
+  auto it = std::find_if(active_nodes.rbegin(), active_nodes.rend(),
+                         [this, index](const ActiveNode& node) {
+                           return node.profile == this && node.index == index;
+                         });
+  if (it == active_nodes.rend()) {
+    return;
+  }
+  ActiveNode node = *it;
+  active_nodes.erase(std::prev(it.base()), active_nodes.end());
+
+  uint64_t total_nanos = now - node.start_nanos;
+  uint64_t total_bytes = allocated_bytes >= node.start_bytes
+                             ? allocated_bytes - node.start_bytes
+                             : 0;
+  Counters& counters = counters_[index];
+  counters.calls.fetch_add(1, std::memory_order_relaxed);
+  counters.total_nanos.fetch_add(total_nanos, std::memory_order_relaxed);
+  counters.self_nanos.fetch_add(
+      total_nanos > node.child_nanos ? total_nanos - node.child_nanos : 0,
+      std::memory_order_relaxed);
+  counters.total_bytes.fetch_add(total_bytes, std::memory_order_relaxed);
+  counters.self_bytes.fetch_add(
+      total_bytes > node.child_bytes ? total_bytes - node.child_bytes : 0,
+      std::memory_order_relaxed);
+  if (!active_nodes.empty()) {
+    active_nodes.back().child_nanos += total_nanos;
+    active_nodes.back().child_bytes += total_bytes;
+  }
+}
+
+size_t EvaluationProfile::ActiveDepth() { return active_nodes.size(); }
+
+void EvaluationProfile::Unwind(size_t depth) {
+  if (active_nodes.size() > depth) {
+    active_nodes.resize(depth);
+  }
+}
+
+std::vector<NodeProfile> EvaluationProfile::nodes() const {
+  std::vector<NodeProfile> profiles;
+  profiles.reserve(nodes_.size());
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    const Counters& counters = counters_[i];
+    NodeProfile& profile = profiles.emplace_back();
+    profile.expr_id = nodes_[i].expr_id;
+    profile.label = nodes_[i].label;
+    profile.location = nodes_[i].location;
+    profile.calls = counters.calls.load(std::memory_order_relaxed);
+    profile.total_time = absl::Nanoseconds(
+        counters.total_nanos.load(std::memory_order_relaxed));
+    profile.self_time = absl::Nanoseconds(
+        counters.self_nanos.load(std::memory_order_relaxed));
+    profile.total_allocated_bytes =
+        counters.total_bytes.load(std::memory_order_relaxed);
+    profile.self_allocated_bytes =
+        counters.self_bytes.load(std::memory_order_relaxed);
+  }
+  return profiles;
+}
+
+std::string EvaluationProfile::Frame(size_t index) const {
+  const Node& node = nodes_[index];
+  // Semicolons separate frames and the last space separates the sample count.
+  std::string label =
+      absl::StrReplaceAll(node.label, {{";", "_"}, {" ", "_"}});
+  if (node.location.line < 0) {
+    return label;
+  }
+  return absl::StrCat(label, "@", node.location.line, ":",
+                      node.location.column);
+}
+
+std::string EvaluationProfile::FormatFoldedStacks() const {
+  std::string out;
+  std::vector<std::string> frames;
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    if (counters_[i].calls.load(std::memory_order_relaxed) == 0) {
+      continue;
+    }
+    frames.clear();
+    for (int64_t node = i; node >= 0; node = nodes_[node].parent) {
+      if (counters_[node].calls.load(std::memory_order_relaxed) > 0) {
+        frames.push_back(Frame(node));
+      }
+    }
+    std::reverse(frames.begin(), frames.end());
+    absl::StrAppend(&out, absl::StrJoin(frames, ";"), " ",
+                    counters_[i].self_nanos.load(std::memory_order_relaxed),
+                    "\n");
+  }
+  return out;
+}
+
+void EvaluationProfile::Clear() {
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    Counters& counters = counters_[i];
+    counters.calls.store(0, std::memory_order_relaxed);
+    counters.total_nanos.store(0, std::memory_order_relaxed);
+    counters.self_nanos.store(0, std::memory_order_relaxed);
+    counters.total_bytes.store(0, std::memory_order_relaxed);
+    counters.self_bytes.store(0, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace cel
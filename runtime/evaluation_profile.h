@@ -0,0 +1,131 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_EVALUATION_PROFILE_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_EVALUATION_PROFILE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "absl/types/optional.h"
+#include "common/ast.h"
+#include "common/source.h"
+
+namespace cel {
+
+// Aggregated evaluation cost of a single expression node.
+struct NodeProfile {
+  int64_t expr_id = 0;
+  // Short description of the node, e.g. the function name of a call or the
+  // field name of a select.
+  std::string label;
+  // Position of the node in the expression source, if known.
+  SourceLocation location;
+
+  // Number of times the node was evaluated.
+  uint64_t calls = 0;
+  // Wall time spent evaluating the node, including its operands.
+  absl::Duration total_time;
+  // Wall time spent evaluating the node, excluding profiled operands.
+  absl::Duration self_time;
+  // Bytes allocated on the evaluation arena while evaluating the node,
+  // including its operands. Zero unless allocation tracking is enabled (see
+  // `cel::extensions::ProfilingOptions`).
+  uint64_t total_allocated_bytes = 0;
+  // Bytes allocated on the evaluation arena while evaluating the node,
+  // excluding profiled operands.
+  uint64_t self_allocated_bytes = 0;
+};
+
+// Cumulative per-node evaluation cost for one planned expression.
+//
+// Counters are updated by profiling steps inserted by the planner (see
+// `cel::extensions::CreateProfiledProgram`). Nesting is tracked per thread, so
+// time spent in an operand evaluated on another thread (e.g. with parallel
+// evaluation) is attributed to the operand but not subtracted from the self
+// time of its parent.
+//
+// Thread-safe.
+class EvaluationProfile {
+ public:
+  explicit EvaluationProfile(const Ast& ast);
+
+  EvaluationProfile(const EvaluationProfile&) = delete;
+  EvaluationProfile& operator=(const EvaluationProfile&) = delete;
+
+  // Returns the index used to record samples for `expr_id`, or nullopt if the
+  // id isn't part of the profiled expression.
+  absl::optional<size_t> NodeIndex(int64_t expr_id) const;
+
+  // Marks the start and end of an evaluation of the node at `index`.
+  // `allocated_bytes` is the arena usage at that point. Calls must be nested
+  // on a thread; unmatched starts (e.g. from an evaluation aborted by an
+  // error status) are discarded at the next matching end or by `Unwind`.
+  void Enter(size_t index, uint64_t allocated_bytes);
+  void Exit(size_t index, uint64_t allocated_bytes);
+
+  // Returns the nesting depth on the current thread, for use with `Unwind`.
+  static size_t ActiveDepth();
+  // Discards unmatched starts above `depth` on the current thread.
+  static void Unwind(size_t depth);
+
+  // Per-node profiles in pre-order. Nodes that were never evaluated (or were
+  // not profiled, e.g. constants) have zero calls.
+  std::vector<NodeProfile> nodes() const;
+
+  // Renders self time in nanoseconds in the folded stack format accepted by
+  // flame graph tools, one line per evaluated node:
+  //
+  //   _||_@1:21;_==_@1:13;.email@1:7 1250
+  //
+  // Frames are the evaluated ancestors of the node in the expression tree,
+  // labeled with their source position (line:column) when known.
+  std::string FormatFoldedStacks() const;
+
+  // Resets all counters.
+  void Clear();
+
+ private:
+  struct Node {
+    int64_t expr_id;
+    // Index of the parent node, or -1 for the root.
+    int64_t parent;
+    std::string label;
+    SourceLocation location;
+  };
+
+  struct Counters {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> total_nanos{0};
+    std::atomic<uint64_t> self_nanos{0};
+    std::atomic<uint64_t> total_bytes{0};
+    std::atomic<uint64_t> self_bytes{0};
+  };
+
+  std::string Frame(size_t index) const;
+
+  std::vector<Node> nodes_;
+  std::unique_ptr<Counters[]> counters_;
+  absl::flat_hash_map<int64_t, size_t> index_;
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_EVALUATION_PROFILE_H_
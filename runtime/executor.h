@@ -0,0 +1,39 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_EXECUTOR_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_EXECUTOR_H_
+
+#include "absl/functional/any_invocable.h"
+
+namespace cel {
+
+// Interface for a caller supplied executor used to run parts of an evaluation
+// concurrently (see runtime/parallel_evaluation.h).
+//
+// Implementations must be thread safe. Scheduled tasks must eventually run, but
+// the evaluator never blocks waiting for a task that has not started: the
+// evaluating thread runs any task that is still pending when it needs the
+// result.
+class Executor {
+ public:
+  virtual ~Executor() = default;
+
+  // Schedules `task` to run, typically on another thread.
+  virtual void Schedule(absl::AnyInvocable<void() &&> task) = 0;
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_EXECUTOR_H_
@@ -27,6 +27,10 @@ namespace cel {
 struct FunctionOverloadReference {
   const FunctionDescriptor& descriptor;
   const Function& implementation;
+  // Whether the overload was marked as expensive and safe to evaluate
+  // concurrently with sibling subexpressions (see
+  // FunctionRegistry::MarkParallelSafe).
+  bool parallel_safe = false;
 };
 
 }  // namespace cel
@@ -24,6 +24,7 @@
 #include "absl/container/node_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
@@ -33,6 +34,7 @@
 #include "runtime/function.h"
 #include "runtime/function_overload_reference.h"
 #include "runtime/function_provider.h"
+#include "runtime/internal/regex_cache.h"
 
 namespace cel {
 namespace {
@@ -115,6 +117,22 @@ absl::Status FunctionRegistry::RegisterLazyFunction(
   return absl::OkStatus();
 }
 
+absl::Status FunctionRegistry::MarkParallelSafe(
+    const cel::FunctionDescriptor& descriptor) {
+  auto overloads = functions_.find(descriptor.name());
+  if (overloads != functions_.end()) {
+    for (auto& overload : overloads->second.static_overloads) {
+      if (overload.descriptor->ShapeMatches(descriptor)) {
+        overload.parallel_safe = true;
+        return absl::OkStatus();
+      }
+    }
+  }
+  return absl::NotFoundError(
+      absl::StrCat("no static overload registered for function '",
+                   descriptor.name(), "' with the given signature"));
+}
+
 std::vector<cel::FunctionOverloadReference>
 FunctionRegistry::FindStaticOverloads(absl::string_view name,
                                       bool receiver_style,
@@ -128,7 +146,8 @@ FunctionRegistry::FindStaticOverloads(absl::string_view name,
 
   for (const auto& overload : overloads->second.static_overloads) {
     if (overload.descriptor->ShapeMatches(receiver_style, types)) {
-      matched_funcs.push_back({*overload.descriptor, *overload.implementation});
+      matched_funcs.push_back({*overload.descriptor, *overload.implementation,
+                               overload.parallel_safe});
     }
   }
 
@@ -149,7 +168,8 @@ FunctionRegistry::FindStaticOverloadsByArity(absl::string_view name,
   for (const auto& overload : overloads->second.static_overloads) {
     if (overload.descriptor->receiver_style() == receiver_style &&
         overload.descriptor->types().size() == arity) {
-      matched_funcs.push_back({*overload.descriptor, *overload.implementation});
+      matched_funcs.push_back({*overload.descriptor, *overload.implementation,
+                               overload.parallel_safe});
     }
   }
 
@@ -218,6 +238,13 @@ FunctionRegistry::ListFunctions() const {
   return descriptor_map;
 }
 
+RegexCacheStats FunctionRegistry::regex_cache_stats() const {
+  if (regex_cache_ == nullptr) {
+    return RegexCacheStats();
+  }
+  return regex_cache_->stats();
+}
+
 bool FunctionRegistry::DescriptorRegistered(
     const cel::FunctionDescriptor& descriptor) const {
   auto overloads = functions_.find(descriptor.name());
@@ -31,9 +31,15 @@
 #include "runtime/function.h"
 #include "runtime/function_overload_reference.h"
 #include "runtime/function_provider.h"
+#include "runtime/regex_cache_stats.h"
 
 namespace cel {
 
+namespace runtime_internal {
+class RegexCache;
+class RegexCacheAccess;
+}  // namespace runtime_internal
+
 // FunctionRegistry manages binding builtin or custom CEL functions to
 // implementations.
 //
@@ -69,6 +75,16 @@ class FunctionRegistry {
   // implementation of cel::ActivationInterface.
   absl::Status RegisterLazyFunction(const cel::FunctionDescriptor& descriptor);
 
+  // Mark the static overload matching `descriptor` as parallel-safe.
+  //
+  // Parallel-safe overloads are expensive and free of side effects. When
+  // parallel evaluation is enabled (see runtime/parallel_evaluation.h), the
+  // planner may evaluate subexpressions calling them concurrently with their
+  // siblings.
+  //
+  // Returns NotFound if no static overload with the same shape is registered.
+  absl::Status MarkParallelSafe(const cel::FunctionDescriptor& descriptor);
+
   // Find subset of cel::Function implementations that match overload conditions
   // As types may not be available during expression compilation,
   // further narrowing of this subset will happen at evaluation stage.
@@ -111,7 +127,14 @@ class FunctionRegistry {
   absl::node_hash_map<std::string, std::vector<const cel::FunctionDescriptor*>>
   ListFunctions() const;
 
+  // Returns the counters of the cache of compiled regular expressions shared
+  // by the regex functions registered with this registry. All counters are 0
+  // if no regex function using the cache was registered.
+  RegexCacheStats regex_cache_stats() const;
+
  private:
+  friend class runtime_internal::RegexCacheAccess;
+
   struct StaticFunctionEntry {
     StaticFunctionEntry(const cel::FunctionDescriptor& descriptor,
                         std::unique_ptr<cel::Function> impl)
@@ -122,6 +145,7 @@ class FunctionRegistry {
     // descriptors.
     std::unique_ptr<cel::FunctionDescriptor> descriptor;
     std::unique_ptr<cel::Function> implementation;
+    bool parallel_safe = false;
   };
 
   struct LazyFunctionEntry {
@@ -153,6 +177,8 @@ class FunctionRegistry {
 
   // indexed by function name (not type checker overload id).
   absl::flat_hash_map<std::string, RegistryEntry> functions_;
+
+  std::shared_ptr<runtime_internal::RegexCache> regex_cache_;
 };
 
 }  // namespace cel
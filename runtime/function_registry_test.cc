@@ -99,6 +99,34 @@ TEST(FunctionRegistryTest, FindStaticOverloadsReturns) {
       << "Expected single ConstFunction()";
 }
 
+TEST(FunctionRegistryTest, MarkParallelSafe) {
+  FunctionRegistry registry;
+  cel::FunctionDescriptor desc = ConstIntFunction::MakeDescriptor();
+  ASSERT_OK(registry.Register(desc, std::make_unique<ConstIntFunction>()));
+
+  std::vector<cel::FunctionOverloadReference> overloads =
+      registry.FindStaticOverloads(desc.name(), false, {});
+  ASSERT_THAT(overloads, SizeIs(1));
+  EXPECT_FALSE(overloads[0].parallel_safe);
+
+  ASSERT_OK(registry.MarkParallelSafe(desc));
+
+  overloads = registry.FindStaticOverloadsByArity(desc.name(), false, 0);
+  ASSERT_THAT(overloads, SizeIs(1));
+  EXPECT_TRUE(overloads[0].parallel_safe);
+}
+
+TEST(FunctionRegistryTest, MarkParallelSafeRequiresStaticOverload) {
+  FunctionRegistry registry;
+  cel::FunctionDescriptor lazy_function_desc{"LazyFunction", false, {}};
+  ASSERT_OK(registry.RegisterLazyFunction(lazy_function_desc));
+
+  EXPECT_THAT(registry.MarkParallelSafe(lazy_function_desc),
+              StatusIs(absl::StatusCode::kNotFound));
+  EXPECT_THAT(registry.MarkParallelSafe(ConstIntFunction::MakeDescriptor()),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
 TEST(FunctionRegistryTest, ListFunctions) {
   cel::FunctionDescriptor lazy_function_desc{"LazyFunction", false, {}};
   FunctionRegistry registry;
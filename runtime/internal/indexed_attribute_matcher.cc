@@ -0,0 +1,150 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/indexed_attribute_matcher.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/base/nullability.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "base/attribute.h"
+
+namespace cel::runtime_internal {
+
+namespace {
+
+template <typename Map, typename Key>
+auto* absl_nullable FindEdge(const Map& edges, const Key& key) {
+  auto it = edges.find(key);
+  return it != edges.end() ? it->second.get() : nullptr;
+}
+
+}  // namespace
+
+IndexedAttributeMatcher::IndexedAttributeMatcher(
+    absl::Span<const AttributePattern> unknown_patterns,
+    absl::Span<const AttributePattern> missing_patterns) {
+  for (const AttributePattern& pattern : unknown_patterns) {
+    Insert(unknown_index_, pattern);
+  }
+  for (const AttributePattern& pattern : missing_patterns) {
+    Insert(missing_index_, pattern);
+  }
+}
+
+IndexedAttributeMatcher::~IndexedAttributeMatcher() = default;
+
+IndexedAttributeMatcher::MatchResult IndexedAttributeMatcher::CheckForUnknown(
+    const Attribute& attr) const {
+  return Match(unknown_index_, attr);
+}
+
+IndexedAttributeMatcher::MatchResult IndexedAttributeMatcher::CheckForMissing(
+    const Attribute& attr) const {
+  return Match(missing_index_, attr);
+}
+
+void IndexedAttributeMatcher::Insert(Index& index,
+                                     const AttributePattern& pattern) {
+  std::unique_ptr<Node>& root = index[std::string(pattern.variable())];
+  if (root == nullptr) {
+    root = std::make_unique<Node>();
+  }
+  Node* node = root.get();
+  for (const AttributeQualifierPattern& qualifier_pattern :
+       pattern.qualifier_path()) {
+    std::unique_ptr<Node>* edge = nullptr;
+    if (qualifier_pattern.IsWildcard()) {
+      edge = &node->wildcard_edge;
+    } else {
+      const AttributeQualifier& qualifier = *qualifier_pattern.qualifier();
+      if (auto key = qualifier.GetStringKey(); key.has_value()) {
+        edge = &node->string_edges[std::string(*key)];
+      } else if (auto key = qualifier.GetInt64Key(); key.has_value()) {
+        edge = &node->int_edges[*key];
+      } else if (auto key = qualifier.GetUint64Key(); key.has_value()) {
+        edge = &node->uint_edges[*key];
+      } else if (auto key = qualifier.GetBoolKey(); key.has_value()) {
+        edge = &node->bool_edges[*key ? 1 : 0];
+      } else {
+        // The qualifier doesn't match any attribute qualifier, so the pattern
+        // can only partially match attributes ending at this node.
+        return;
+      }
+    }
+    if (*edge == nullptr) {
+      *edge = std::make_unique<Node>();
+    }
+    node = edge->get();
+  }
+  node->terminal = true;
+}
+
+IndexedAttributeMatcher::MatchResult IndexedAttributeMatcher::Match(
+    const Index& index, const Attribute& attr) {
+  const Node* root = FindEdge(index, attr.variable_name());
+  if (root == nullptr) {
+    return MatchResult::NONE;
+  }
+
+  const absl::Span<const AttributeQualifier> path = attr.qualifier_path();
+  struct Frame {
+    const Node* absl_nonnull node;
+    size_t depth;
+  };
+  absl::InlinedVector<Frame, 8> stack;
+  stack.push_back({root, 0});
+  MatchResult result = MatchResult::NONE;
+  while (!stack.empty()) {
+    const Frame frame = stack.back();
+    stack.pop_back();
+    const Node& node = *frame.node;
+    if (node.terminal) {
+      // A pattern no longer than the attribute matched all of its qualifiers.
+      return MatchResult::FULL;
+    }
+    if (frame.depth == path.size()) {
+      // Every node leads to at least one pattern, which is longer than the
+      // attribute.
+      result = MatchResult::PARTIAL;
+      continue;
+    }
+    if (node.wildcard_edge != nullptr) {
+      stack.push_back({node.wildcard_edge.get(), frame.depth + 1});
+    }
+    const AttributeQualifier& qualifier = path[frame.depth];
+    const Node* next = nullptr;
+    if (auto key = qualifier.GetStringKey(); key.has_value()) {
+      next = FindEdge(node.string_edges, *key);
+    } else if (auto key = qualifier.GetInt64Key(); key.has_value()) {
+      next = FindEdge(node.int_edges, *key);
+    } else if (auto key = qualifier.GetUint64Key(); key.has_value()) {
+      next = FindEdge(node.uint_edges, *key);
+    } else if (auto key = qualifier.GetBoolKey(); key.has_value()) {
+      next = node.bool_edges[*key ? 1 : 0].get();
+    }
+    if (next != nullptr) {
+      stack.push_back({next, frame.depth + 1});
+    }
+  }
+  return result;
+}
+
+}  // namespace cel::runtime_internal
@@ -0,0 +1,87 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_INDEXED_ATTRIBUTE_MATCHER_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_INDEXED_ATTRIBUTE_MATCHER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
+#include "base/attribute.h"
+#include "runtime/internal/attribute_matcher.h"
+
+namespace cel::runtime_internal {
+
+// Attribute matcher which indexes the unknown and missing patterns in a trie
+// keyed by variable name and qualifier, with a separate edge for wildcards.
+//
+// Matching an attribute only visits the patterns sharing a prefix with it,
+// instead of every pattern like the default matcher, which makes it suitable
+// for activations with many patterns. The results are the same as for
+// `cel::AttributePattern::IsMatch`.
+//
+// The patterns are copied, so the matcher is independent of the activation it
+// was built from. It needs to be updated if the activation's patterns change.
+// Activations maintain one when `set_index_attribute_patterns(true)` is
+// called, otherwise install it with
+// `ActivationAttributeMatcherAccess::SetAttributeMatcher`.
+class IndexedAttributeMatcher final : public AttributeMatcher {
+ public:
+  IndexedAttributeMatcher(absl::Span<const AttributePattern> unknown_patterns,
+                          absl::Span<const AttributePattern> missing_patterns);
+
+  IndexedAttributeMatcher(const IndexedAttributeMatcher&) = delete;
+  IndexedAttributeMatcher& operator=(const IndexedAttributeMatcher&) = delete;
+
+  ~IndexedAttributeMatcher() override;
+
+  void AddUnknownPattern(const AttributePattern& pattern) {
+    Insert(unknown_index_, pattern);
+  }
+
+  void AddMissingPattern(const AttributePattern& pattern) {
+    Insert(missing_index_, pattern);
+  }
+
+  MatchResult CheckForUnknown(const Attribute& attr) const override;
+  MatchResult CheckForMissing(const Attribute& attr) const override;
+
+ private:
+  // A node is present for every prefix of a pattern, and marked as terminal
+  // if a pattern ends there.
+  struct Node {
+    bool terminal = false;
+    absl::flat_hash_map<std::string, std::unique_ptr<Node>> string_edges;
+    absl::flat_hash_map<int64_t, std::unique_ptr<Node>> int_edges;
+    absl::flat_hash_map<uint64_t, std::unique_ptr<Node>> uint_edges;
+    std::unique_ptr<Node> bool_edges[2];
+    std::unique_ptr<Node> wildcard_edge;
+  };
+
+  using Index = absl::flat_hash_map<std::string, std::unique_ptr<Node>>;
+
+  static void Insert(Index& index, const AttributePattern& pattern);
+
+  static MatchResult Match(const Index& index, const Attribute& attr);
+
+  Index unknown_index_;
+  Index missing_index_;
+};
+
+}  // namespace cel::runtime_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_INDEXED_ATTRIBUTE_MATCHER_H_
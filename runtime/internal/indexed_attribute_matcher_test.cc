@@ -0,0 +1,178 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/indexed_attribute_matcher.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "base/attribute.h"
+#include "internal/testing.h"
+
+namespace cel::runtime_internal {
+namespace {
+
+using MatchResult = AttributeMatcher::MatchResult;
+
+// The reference behavior, as implemented by the default matcher.
+MatchResult MatchLinearly(absl::Span<const AttributePattern> patterns,
+                          const Attribute& attr) {
+  MatchResult result = MatchResult::NONE;
+  for (const AttributePattern& pattern : patterns) {
+    switch (pattern.IsMatch(attr)) {
+      case MatchResult::FULL:
+        return MatchResult::FULL;
+      case MatchResult::PARTIAL:
+        result = MatchResult::PARTIAL;
+        break;
+      case MatchResult::NONE:
+        break;
+    }
+  }
+  return result;
+}
+
+TEST(IndexedAttributeMatcherTest, MatchesQualifierPaths) {
+  std::vector<AttributePattern> patterns = {
+      AttributePattern("request", {AttributeQualifierPattern::OfString("auth"),
+                                   AttributeQualifierPattern::OfString("sub")}),
+      AttributePattern("list", {AttributeQualifierPattern::OfInt(1)}),
+      AttributePattern("var", {}),
+  };
+  IndexedAttributeMatcher matcher(patterns, {});
+
+  EXPECT_EQ(matcher.CheckForUnknown(Attribute("request")),
+            MatchResult::PARTIAL);
+  EXPECT_EQ(matcher.CheckForUnknown(
+                Attribute("request", {AttributeQualifier::OfString("auth")})),
+            MatchResult::PARTIAL);
+  EXPECT_EQ(matcher.CheckForUnknown(
+                Attribute("request", {AttributeQualifier::OfString("auth"),
+                                      AttributeQualifier::OfString("sub")})),
+            MatchResult::FULL);
+  EXPECT_EQ(matcher.CheckForUnknown(
+                Attribute("request", {AttributeQualifier::OfString("auth"),
+                                      AttributeQualifier::OfString("sub"),
+                                      AttributeQualifier::OfInt(0)})),
+            MatchResult::FULL);
+  EXPECT_EQ(matcher.CheckForUnknown(
+                Attribute("request", {AttributeQualifier::OfString("path")})),
+            MatchResult::NONE);
+  EXPECT_EQ(matcher.CheckForUnknown(
+                Attribute("list", {AttributeQualifier::OfInt(1)})),
+            MatchResult::FULL);
+  // Qualifiers of different types never match.
+  EXPECT_EQ(matcher.CheckForUnknown(
+                Attribute("list", {AttributeQualifier::OfUint(1)})),
+            MatchResult::NONE);
+  EXPECT_EQ(matcher.CheckForUnknown(
+                Attribute("var", {AttributeQualifier::OfBool(true)})),
+            MatchResult::FULL);
+  EXPECT_EQ(matcher.CheckForUnknown(Attribute("other")), MatchResult::NONE);
+  EXPECT_EQ(matcher.CheckForMissing(Attribute("var")), MatchResult::NONE);
+}
+
+TEST(IndexedAttributeMatcherTest, MatchesWildcards) {
+  std::vector<AttributePattern> patterns = {
+      AttributePattern("headers",
+                       {AttributeQualifierPattern::CreateWildcard(),
+                        AttributeQualifierPattern::OfString("value")}),
+      AttributePattern("headers", {AttributeQualifierPattern::OfString("host"),
+                                   AttributeQualifierPattern::OfString("port"),
+                                   AttributeQualifierPattern::OfInt(0)}),
+  };
+  IndexedAttributeMatcher matcher({}, patterns);
+
+  EXPECT_EQ(matcher.CheckForMissing(
+                Attribute("headers", {AttributeQualifier::OfString("host"),
+                                      AttributeQualifier::OfString("value")})),
+            MatchResult::FULL);
+  EXPECT_EQ(matcher.CheckForMissing(
+                Attribute("headers", {AttributeQualifier::OfInt(7),
+                                      AttributeQualifier::OfString("value")})),
+            MatchResult::FULL);
+  EXPECT_EQ(matcher.CheckForMissing(
+                Attribute("headers", {AttributeQualifier::OfString("host"),
+                                      AttributeQualifier::OfString("port")})),
+            MatchResult::PARTIAL);
+  EXPECT_EQ(matcher.CheckForMissing(
+                Attribute("headers", {AttributeQualifier::OfString("host"),
+                                      AttributeQualifier::OfString("name")})),
+            MatchResult::NONE);
+  EXPECT_EQ(matcher.CheckForUnknown(
+                Attribute("headers", {AttributeQualifier::OfString("host"),
+                                      AttributeQualifier::OfString("value")})),
+            MatchResult::NONE);
+}
+
+TEST(IndexedAttributeMatcherTest, AgreesWithLinearMatching) {
+  std::vector<AttributeQualifierPattern> qualifier_patterns = {
+      AttributeQualifierPattern::CreateWildcard(),
+      AttributeQualifierPattern::OfString("a"),
+      AttributeQualifierPattern::OfInt(1),
+      AttributeQualifierPattern::OfUint(1),
+      AttributeQualifierPattern::OfBool(false),
+      // Never matches a qualifier, but still matches shorter attributes
+      // partially.
+      AttributeQualifierPattern(AttributeQualifier()),
+  };
+  std::vector<AttributeQualifier> qualifiers = {
+      AttributeQualifier::OfString("a"), AttributeQualifier::OfString("b"),
+      AttributeQualifier::OfInt(1),      AttributeQualifier::OfUint(1),
+      AttributeQualifier::OfBool(false), AttributeQualifier::OfBool(true),
+  };
+
+  // Every pattern of up to two qualifiers, in turn added to the matcher.
+  std::vector<AttributePattern> all_patterns;
+  all_patterns.push_back(AttributePattern("x", {}));
+  for (const auto& first : qualifier_patterns) {
+    all_patterns.push_back(AttributePattern("x", {first}));
+    for (const auto& second : qualifier_patterns) {
+      all_patterns.push_back(AttributePattern("x", {first, second}));
+    }
+  }
+  // Every attribute of up to three qualifiers.
+  std::vector<Attribute> attributes;
+  attributes.push_back(Attribute("x"));
+  attributes.push_back(Attribute("y"));
+  for (const auto& first : qualifiers) {
+    attributes.push_back(Attribute("x", {first}));
+    for (const auto& second : qualifiers) {
+      attributes.push_back(Attribute("x", {first, second}));
+      for (const auto& third : qualifiers) {
+        attributes.push_back(Attribute("x", {first, second, third}));
+      }
+    }
+  }
+
+  for (size_t i = 0; i < all_patterns.size(); ++i) {
+    // A single pattern, and the patterns before it.
+    for (absl::Span<const AttributePattern> patterns :
+         {absl::MakeConstSpan(&all_patterns[i], 1),
+          absl::MakeConstSpan(all_patterns.data(), i)}) {
+      IndexedAttributeMatcher matcher(patterns, {});
+      for (const Attribute& attr : attributes) {
+        ASSERT_EQ(matcher.CheckForUnknown(attr), MatchLinearly(patterns, attr))
+            << "pattern " << i << ", attribute "
+            << attr.AsString().value_or("<invalid>");
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace cel::runtime_internal
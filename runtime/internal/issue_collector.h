@@ -23,6 +23,20 @@
 
 namespace cel::runtime_internal {
 
+// Rank of `severity`, increasing with the severity of the issue.
+inline int SeverityRank(RuntimeIssue::Severity severity) {
+  switch (severity) {
+    case RuntimeIssue::Severity::kInformation:
+      return 0;
+    case RuntimeIssue::Severity::kWarning:
+      return 1;
+    case RuntimeIssue::Severity::kError:
+      return 2;
+    default:
+      return 3;
+  }
+}
+
 // IssueCollector collects issues and reports absl::Status according to the
 // configured severity limit.
 class IssueCollector {
@@ -45,7 +59,8 @@ class IssueCollector {
   // a non-ok status.
   absl::Status AddIssue(RuntimeIssue issue) {
     issues_.push_back(std::move(issue));
-    if (issues_.back().severity() >= severity_limit_) {
+    if (SeverityRank(issues_.back().severity()) >=
+        SeverityRank(severity_limit_)) {
       return issues_.back().ToStatus();
     }
     return absl::OkStatus();
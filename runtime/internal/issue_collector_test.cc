@@ -90,5 +90,30 @@ TEST(IssueCollector, ReturnsStatusAtLimit) {
                        issue.ToStatus());
           })));
 }
+
+TEST(IssueCollector, InformationNeverReturnsStatus) {
+  IssueCollector issue_collector(RuntimeIssue::Severity::kInformation);
+
+  ASSERT_OK(issue_collector.AddIssue(RuntimeIssue::CreateInformation("i1")));
+
+  EXPECT_THAT(issue_collector.issues(),
+              ElementsAre(Truly([](const RuntimeIssue& issue) {
+                return issue.severity() ==
+                           RuntimeIssue::Severity::kInformation &&
+                       issue.ToStatus().ok() && issue.message() == "i1";
+              })));
+}
+
+TEST(IssueCollector, SeverityRank) {
+  EXPECT_LT(SeverityRank(RuntimeIssue::Severity::kInformation),
+            SeverityRank(RuntimeIssue::Severity::kWarning));
+  EXPECT_LT(SeverityRank(RuntimeIssue::Severity::kWarning),
+            SeverityRank(RuntimeIssue::Severity::kError));
+  EXPECT_LT(
+      SeverityRank(RuntimeIssue::Severity::kError),
+      SeverityRank(
+          RuntimeIssue::Severity::kNotForUseWithExhaustiveSwitchStatements));
+}
+
 }  // namespace
 }  // namespace cel::runtime_internal
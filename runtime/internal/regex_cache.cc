@@ -0,0 +1,100 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/regex_cache.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "re2/re2.h"
+
+namespace cel::runtime_internal {
+
+RegexCache::RegexCache(size_t capacity) : capacity_(capacity) {
+  absl::MutexLock lock(&mutex_);
+  index_.reserve(capacity_);
+  entries_.reserve(capacity_);
+}
+
+std::shared_ptr<const RE2> RegexCache::Get(absl::string_view pattern,
+                                           int max_program_size) {
+  {
+    absl::ReaderMutexLock lock(&mutex_);
+    if (auto it = index_.find(pattern); it != index_.end()) {
+      Entry& entry = *entries_[it->second];
+      entry.referenced.store(true, std::memory_order_relaxed);
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return entry.regex;
+    }
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+
+  // Compile without holding the lock. Concurrent misses on the same pattern
+  // may compile it more than once.
+  auto regex = std::make_shared<const RE2>(pattern);
+  if (capacity_ == 0 ||
+      (max_program_size > 0 && regex->ProgramSize() > max_program_size)) {
+    return regex;
+  }
+
+  absl::MutexLock lock(&mutex_);
+  if (auto it = index_.find(pattern); it != index_.end()) {
+    return entries_[it->second]->regex;
+  }
+  size_t slot;
+  if (entries_.size() < capacity_) {
+    slot = entries_.size();
+    entries_.push_back(std::make_unique<Entry>());
+  } else {
+    slot = Evict();
+  }
+  Entry& entry = *entries_[slot];
+  entry.pattern = std::string(pattern);
+  entry.regex = regex;
+  entry.referenced.store(false, std::memory_order_relaxed);
+  index_.insert({entry.pattern, slot});
+  return regex;
+}
+
+size_t RegexCache::Evict() {
+  // Sweep until an entry which was not used since the last sweep is found,
+  // giving referenced entries a second chance. Terminates within two laps.
+  while (true) {
+    const size_t slot = hand_;
+    hand_ = (hand_ + 1) % entries_.size();
+    Entry& entry = *entries_[slot];
+    if (entry.referenced.exchange(false, std::memory_order_relaxed)) {
+      continue;
+    }
+    index_.erase(entry.pattern);
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+    return slot;
+  }
+}
+
+RegexCacheStats RegexCache::stats() const {
+  RegexCacheStats stats;
+  stats.hits = hits_.load(std::memory_order_relaxed);
+  stats.misses = misses_.load(std::memory_order_relaxed);
+  stats.evictions = evictions_.load(std::memory_order_relaxed);
+  absl::ReaderMutexLock lock(&mutex_);
+  stats.size = index_.size();
+  return stats;
+}
+
+}  // namespace cel::runtime_internal
@@ -0,0 +1,104 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_REGEX_CACHE_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_REGEX_CACHE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "runtime/regex_cache_stats.h"
+#include "re2/re2.h"
+
+namespace cel::runtime_internal {
+
+// Bounded cache of compiled regular expressions keyed by pattern, for regex
+// functions whose pattern is not known at plan time and therefore cannot be
+// precompiled.
+//
+// Eviction follows the CLOCK policy: a hit only marks the entry as recently
+// used, so lookups of cached patterns proceed concurrently under a reader
+// lock.
+//
+// This class is thread-safe.
+class RegexCache final {
+ public:
+  static constexpr size_t kDefaultCapacity = 256;
+
+  // A `capacity` of 0 disables caching.
+  explicit RegexCache(size_t capacity = kDefaultCapacity);
+
+  RegexCache(const RegexCache&) = delete;
+  RegexCache& operator=(const RegexCache&) = delete;
+
+  // Returns the compiled `pattern`. The result is not necessarily `ok()`:
+  // invalid patterns are cached like valid ones so that their error is not
+  // recomputed on every call. Programs larger than `max_program_size` are not
+  // retained, unless `max_program_size` is 0. The caller remains responsible
+  // for rejecting them.
+  std::shared_ptr<const RE2> Get(absl::string_view pattern,
+                                 int max_program_size = 0);
+
+  RegexCacheStats stats() const;
+
+ private:
+  struct Entry {
+    std::string pattern;
+    std::shared_ptr<const RE2> regex;
+    std::atomic<bool> referenced{false};
+  };
+
+  // Returns the index of an entry which can be overwritten.
+  size_t Evict() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const size_t capacity_;
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, size_t> index_ ABSL_GUARDED_BY(mutex_);
+  std::vector<std::unique_ptr<Entry>> entries_ ABSL_GUARDED_BY(mutex_);
+  size_t hand_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> evictions_{0};
+};
+
+// Returns true if `regex` must be rejected for being larger than
+// `max_program_size`. A `max_program_size` of 0 means no limit.
+inline bool ExceedsMaxProgramSize(const RE2& regex, int max_program_size) {
+  return max_program_size > 0 && regex.ProgramSize() > max_program_size;
+}
+
+// Returns a callable which invokes `function` with `*cache` and
+// `max_program_size` as its first arguments followed by its own arguments, for
+// registering regex functions with the function adapters.
+template <typename R, typename... Args>
+auto BindRegexCache(std::shared_ptr<RegexCache> cache, int max_program_size,
+                    R (*function)(RegexCache&, int, Args...)) {
+  return [cache = std::move(cache), max_program_size,
+          function](Args... args) -> R {
+    return function(*cache, max_program_size, std::forward<Args>(args)...);
+  };
+}
+
+}  // namespace cel::runtime_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_REGEX_CACHE_H_
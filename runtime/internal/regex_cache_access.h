@@ -0,0 +1,48 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_REGEX_CACHE_ACCESS_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_REGEX_CACHE_ACCESS_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
+#include "runtime/function_registry.h"
+#include "runtime/internal/regex_cache.h"
+
+namespace cel::runtime_internal {
+
+// Grants the regex function registrations access to the regex cache owned by
+// a function registry.
+class RegexCacheAccess {
+ public:
+  // Returns the cache shared by the regex functions registered with
+  // `registry`, creating it with `capacity` on first use. Later registrations
+  // share the existing cache regardless of their `capacity`.
+  //
+  // Not thread-safe, intended to be called during function registration.
+  static std::shared_ptr<RegexCache> GetOrCreate(FunctionRegistry& registry,
+                                                 int capacity) {
+    if (registry.regex_cache_ == nullptr) {
+      registry.regex_cache_ = std::make_shared<RegexCache>(
+          static_cast<size_t>(std::max(capacity, 0)));
+    }
+    return registry.regex_cache_;
+  }
+};
+
+}  // namespace cel::runtime_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_REGEX_CACHE_ACCESS_H_
@@ -0,0 +1,108 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/regex_cache.h"
+
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "internal/testing.h"
+#include "re2/re2.h"
+
+namespace cel::runtime_internal {
+namespace {
+
+TEST(RegexCacheTest, ReusesCompiledPattern) {
+  RegexCache cache;
+  std::shared_ptr<const RE2> first = cache.Get("a+b");
+  std::shared_ptr<const RE2> second = cache.Get("a+b");
+
+  ASSERT_TRUE(first->ok());
+  EXPECT_EQ(first, second);
+  EXPECT_TRUE(RE2::FullMatch("aab", *second));
+  RegexCacheStats stats = cache.stats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.size, 1);
+}
+
+TEST(RegexCacheTest, CachesInvalidPattern) {
+  RegexCache cache;
+  std::shared_ptr<const RE2> first = cache.Get("(");
+  std::shared_ptr<const RE2> second = cache.Get("(");
+
+  EXPECT_FALSE(first->ok());
+  EXPECT_EQ(first, second);
+}
+
+TEST(RegexCacheTest, DoesNotRetainLargePrograms) {
+  RegexCache cache;
+  std::shared_ptr<const RE2> regex = cache.Get("[a-z]{1,100}", 10);
+  ASSERT_GT(regex->ProgramSize(), 10);
+  cache.Get("[a-z]{1,100}", 10);
+
+  RegexCacheStats stats = cache.stats();
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.size, 0);
+}
+
+TEST(RegexCacheTest, EvictsUnreferencedEntries) {
+  RegexCache cache(2);
+  cache.Get("a");
+  cache.Get("b");
+  // Mark "a" as recently used, so that "b" is evicted.
+  cache.Get("a");
+  cache.Get("c");
+
+  RegexCacheStats stats = cache.stats();
+  EXPECT_EQ(stats.evictions, 1);
+  EXPECT_EQ(stats.size, 2);
+
+  cache.Get("a");
+  EXPECT_EQ(cache.stats().hits, 2);
+  cache.Get("b");
+  EXPECT_EQ(cache.stats().misses, 4);
+}
+
+TEST(RegexCacheTest, ZeroCapacity) {
+  RegexCache cache(0);
+  EXPECT_NE(cache.Get("a"), cache.Get("a"));
+  EXPECT_EQ(cache.stats().size, 0);
+}
+
+TEST(RegexCacheTest, Concurrent) {
+  RegexCache cache(8);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&cache]() {
+      for (int j = 0; j < 1000; ++j) {
+        const std::string pattern = absl::StrCat("x", j % 16);
+        ASSERT_TRUE(RE2::FullMatch(pattern, *cache.Get(pattern)));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  RegexCacheStats stats = cache.stats();
+  EXPECT_EQ(stats.hits + stats.misses, 4000);
+  EXPECT_LE(stats.size, 8);
+}
+
+}  // namespace
+}  // namespace cel::runtime_internal
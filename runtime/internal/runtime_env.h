@@ -27,6 +27,7 @@
 #include "absl/synchronization/mutex.h"
 #include "eval/public/cel_function_registry.h"
 #include "eval/public/cel_type_registry.h"
+#include "internal/concurrent_string_pool.h"
 #include "internal/well_known_types.h"
 #include "runtime/function_registry.h"
 #include "runtime/type_registry.h"
@@ -117,6 +118,16 @@ struct RuntimeEnv final {
 
   well_known_types::Reflection well_known_types;
 
+  // Interning pool shared by all programs planned from this environment. The
+  // planner interns the names of selected fields of checked message types
+  // found in `descriptor_pool`; planner extensions may intern other strings.
+  // Thread-safe, so it may be used while planning concurrently.
+  //
+  // Strings are never released, so only strings from a bounded set (such as
+  // the field names in `descriptor_pool`) may be interned. Otherwise the pool
+  // grows with every distinct string planned over the lifetime of the runtime.
+  mutable internal::ConcurrentStringPool string_pool;
+
   google::protobuf::MessageFactory* absl_nonnull MutableMessageFactory() const
       ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
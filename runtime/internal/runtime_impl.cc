@@ -13,20 +13,26 @@
 // limitations under the License.
 #include "runtime/internal/runtime_impl.h"
 
+#include <cstddef>
 #include <memory>
 #include <utility>
 
 #include "absl/base/nullability.h"
 #include "absl/log/absl_check.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "base/ast.h"
 #include "base/type_provider.h"
 #include "common/native_type.h"
 #include "common/value.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
 #include "eval/eval/attribute_trail.h"
 #include "eval/eval/comprehension_slots.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
+#include "eval/eval/evaluator_state_pool.h"
 #include "internal/casts.h"
 #include "internal/status_macros.h"
 #include "runtime/activation_interface.h"
@@ -40,8 +46,11 @@ namespace {
 using ::google::api::expr::runtime::AttributeTrail;
 using ::google::api::expr::runtime::ComprehensionSlots;
 using ::google::api::expr::runtime::DirectExpressionStep;
+using ::google::api::expr::runtime::EvaluatorStatePool;
 using ::google::api::expr::runtime::ExecutionFrameBase;
 using ::google::api::expr::runtime::FlatExpression;
+using ::google::api::expr::runtime::FlatExpressionEvaluatorState;
+using ::google::api::expr::runtime::ProgramOptimizerFactory;
 using ::google::api::expr::runtime::WrappedDirectStep;
 
 class ProgramImpl final : public TraceableProgram {
@@ -50,7 +59,12 @@ class ProgramImpl final : public TraceableProgram {
   ProgramImpl(
       const std::shared_ptr<const RuntimeImpl::Environment>& environment,
       FlatExpression impl)
-      : environment_(environment), impl_(std::move(impl)) {}
+      : environment_(environment), impl_(std::move(impl)) {
+    if (impl_.options().evaluator_state_pool_size > 0) {
+      state_pool_ = std::make_unique<EvaluatorStatePool>(
+          impl_, impl_.options().evaluator_state_pool_size);
+    }
+  }
 
   absl::StatusOr<Value> Trace(
       google::protobuf::Arena* absl_nonnull arena,
@@ -58,23 +72,72 @@ class ProgramImpl final : public TraceableProgram {
       const ActivationInterface& activation,
       EvaluationListener evaluation_listener) const override {
     ABSL_DCHECK(arena != nullptr);
-    auto state = impl_.MakeEvaluatorState(
-        environment_->descriptor_pool.get(),
-        message_factory != nullptr ? message_factory
-                                   : environment_->MutableMessageFactory(),
-        arena);
+    if (message_factory == nullptr) {
+      message_factory = environment_->MutableMessageFactory();
+    }
+    if (state_pool_ != nullptr) {
+      auto lease = state_pool_->Acquire(environment_->descriptor_pool.get(),
+                                        message_factory, arena);
+      return impl_.EvaluateWithCallback(
+          activation, std::move(evaluation_listener), lease.state());
+    }
+    auto state = impl_.MakeEvaluatorState(environment_->descriptor_pool.get(),
+                                          message_factory, arena);
     return impl_.EvaluateWithCallback(activation,
                                       std::move(evaluation_listener), state);
   }
 
+  absl::Status EvaluateBatch(
+      google::protobuf::Arena* absl_nonnull arena,
+      google::protobuf::MessageFactory* absl_nullable message_factory,
+      absl::Span<const ActivationInterface* const> activations,
+      absl::Span<Value> results) const override {
+    ABSL_DCHECK(arena != nullptr);
+    if (activations.size() != results.size()) {
+      return absl::InvalidArgumentError(
+          "EvaluateBatch: activations and results must be the same size");
+    }
+    if (message_factory == nullptr) {
+      message_factory = environment_->MutableMessageFactory();
+    }
+    // The evaluator state is reset at the start of each evaluation, so a
+    // single instance can be shared by the whole batch.
+    if (state_pool_ != nullptr) {
+      auto lease = state_pool_->Acquire(environment_->descriptor_pool.get(),
+                                        message_factory, arena);
+      return EvaluateBatchWithState(activations, results, lease.state());
+    }
+    auto state = impl_.MakeEvaluatorState(environment_->descriptor_pool.get(),
+                                          message_factory, arena);
+    return EvaluateBatchWithState(activations, results, state);
+  }
+
   const TypeProvider& GetTypeProvider() const override {
     return environment_->type_registry.GetComposedTypeProvider();
   }
 
+  const EvaluatorStatePool* absl_nullable state_pool() const {
+    return state_pool_.get();
+  }
+
  private:
+  absl::Status EvaluateBatchWithState(
+      absl::Span<const ActivationInterface* const> activations,
+      absl::Span<Value> results, FlatExpressionEvaluatorState& state) const {
+    for (size_t i = 0; i < activations.size(); ++i) {
+      CEL_ASSIGN_OR_RETURN(
+          results[i], impl_.EvaluateWithCallback(*activations[i],
+                                                 EvaluationListener(), state));
+    }
+    return absl::OkStatus();
+  }
+
   // Keep the Runtime environment alive while programs reference it.
   std::shared_ptr<const RuntimeImpl::Environment> environment_;
   FlatExpression impl_;
+  // Optional pool of evaluator states. Must be declared after impl_, which it
+  // references.
+  absl_nullable std::unique_ptr<EvaluatorStatePool> state_pool_;
 };
 
 class RecursiveProgramImpl final : public TraceableProgram {
@@ -106,6 +169,33 @@ class RecursiveProgramImpl final : public TraceableProgram {
     return result;
   }
 
+  absl::Status EvaluateBatch(
+      google::protobuf::Arena* absl_nonnull arena,
+      google::protobuf::MessageFactory* absl_nullable message_factory,
+      absl::Span<const ActivationInterface* const> activations,
+      absl::Span<Value> results) const override {
+    ABSL_DCHECK(arena != nullptr);
+    if (activations.size() != results.size()) {
+      return absl::InvalidArgumentError(
+          "EvaluateBatch: activations and results must be the same size");
+    }
+    if (message_factory == nullptr) {
+      message_factory = environment_->MutableMessageFactory();
+    }
+    ComprehensionSlots slots(impl_.comprehension_slots_size());
+    AttributeTrail attribute;
+    for (size_t i = 0; i < activations.size(); ++i) {
+      slots.Reset();
+      ExecutionFrameBase frame(*activations[i], EvaluationListener(),
+                               impl_.options(), GetTypeProvider(),
+                               environment_->descriptor_pool.get(),
+                               message_factory, arena, slots);
+      attribute = AttributeTrail();
+      CEL_RETURN_IF_ERROR(root_->Evaluate(frame, results[i], attribute));
+    }
+    return absl::OkStatus();
+  }
+
   const TypeProvider& GetTypeProvider() const override {
     return environment_->type_registry.GetComposedTypeProvider();
   }
@@ -129,8 +219,18 @@ absl::StatusOr<std::unique_ptr<TraceableProgram>>
 RuntimeImpl::CreateTraceableProgram(
     std::unique_ptr<Ast> ast,
     const Runtime::CreateProgramOptions& options) const {
-  CEL_ASSIGN_OR_RETURN(auto flat_expr, expr_builder_.CreateExpressionImpl(
-                                           std::move(ast), options.issues));
+  return CreateTraceableProgram(std::move(ast), options,
+                                /*additional_optimizers=*/{});
+}
+
+absl::StatusOr<std::unique_ptr<TraceableProgram>>
+RuntimeImpl::CreateTraceableProgram(
+    std::unique_ptr<Ast> ast, const Runtime::CreateProgramOptions& options,
+    absl::Span<const ProgramOptimizerFactory> additional_optimizers) const {
+  CEL_ASSIGN_OR_RETURN(
+      auto flat_expr,
+      expr_builder_.CreateExpressionImpl(std::move(ast), options.issues,
+                                         additional_optimizers));
 
   // Special case if the program is fully recursive.
   //
@@ -157,4 +257,13 @@ bool TestOnly_IsRecursiveImpl(const Program* program) {
   return dynamic_cast<const RecursiveProgramImpl*>(program) != nullptr;
 }
 
+absl::optional<EvaluatorStatePool::Stats> GetEvaluatorStatePoolStats(
+    const Program& program) {
+  const auto* program_impl = dynamic_cast<const ProgramImpl*>(&program);
+  if (program_impl == nullptr || program_impl->state_pool() == nullptr) {
+    return absl::nullopt;
+  }
+  return program_impl->state_pool()->stats();
+}
+
 }  // namespace cel::runtime_internal
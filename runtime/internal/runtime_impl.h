@@ -22,10 +22,14 @@
 #include "absl/base/nullability.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "base/ast.h"
 #include "base/type_provider.h"
 #include "common/native_type.h"
 #include "eval/compiler/flat_expr_builder.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+#include "eval/eval/evaluator_state_pool.h"
 #include "internal/well_known_types.h"
 #include "runtime/function_registry.h"
 #include "runtime/internal/runtime_env.h"
@@ -84,6 +88,14 @@ class RuntimeImpl : public Runtime {
       std::unique_ptr<Ast> ast,
       const Runtime::CreateProgramOptions& options) const override;
 
+  // Plans `ast` with `additional_optimizers` applied after the runtime's
+  // configured program optimizers. Used by extensions that instrument a
+  // single program.
+  absl::StatusOr<std::unique_ptr<TraceableProgram>> CreateTraceableProgram(
+      std::unique_ptr<Ast> ast, const Runtime::CreateProgramOptions& options,
+      absl::Span<const google::api::expr::runtime::ProgramOptimizerFactory>
+          additional_optimizers) const;
+
   const TypeProvider& GetTypeProvider() const override {
     return environment_->type_registry.GetComposedTypeProvider();
   }
@@ -102,6 +114,10 @@ class RuntimeImpl : public Runtime {
       ABSL_ATTRIBUTE_LIFETIME_BOUND {
     return expr_builder_;
   }
+  const google::api::expr::runtime::FlatExprBuilder& expr_builder() const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return expr_builder_;
+  }
 
  private:
   NativeTypeId GetNativeTypeId() const override {
@@ -120,6 +136,14 @@ class RuntimeImpl : public Runtime {
 // Uses dynamic_casts to test.
 bool TestOnly_IsRecursiveImpl(const Program* program);
 
+// Returns the evaluator state pool counters for `program`.
+//
+// Returns nullopt if `program` was not created by a RuntimeImpl with
+// RuntimeOptions::evaluator_state_pool_size set, or if it was planned
+// recursively (recursive programs do not use a value stack).
+absl::optional<google::api::expr::runtime::EvaluatorStatePool::Stats>
+GetEvaluatorStatePoolStats(const Program& program);
+
 }  // namespace cel::runtime_internal
 
 #endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_RUNTIME_IMPL_H_
@@ -0,0 +1,595 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/memoized_program.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/hash/hash.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/optional.h"
+#include "base/ast.h"
+#include "common/ast_traverse.h"
+#include "common/ast_visitor_base.h"
+#include "common/expr.h"
+#include "common/native_type.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "internal/casts.h"
+#include "internal/status_macros.h"
+#include "runtime/activation_interface.h"
+#include "runtime/internal/runtime_friend_access.h"
+#include "runtime/internal/runtime_impl.h"
+#include "runtime/runtime.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/message.h"
+
+namespace cel::extensions {
+namespace {
+
+using ::cel::internal::down_cast;
+using ::cel::runtime_internal::RuntimeFriendAccess;
+using ::cel::runtime_internal::RuntimeImpl;
+
+// Returns the dotted name for a select chain rooted at an identifier, e.g.
+// "a.b.c" for `a.b.c`.
+absl::optional<std::string> QualifiedPath(const Expr& expr) {
+  std::vector<absl::string_view> segments;
+  const Expr* current = &expr;
+  while (current->has_select_expr()) {
+    segments.push_back(current->select_expr().field());
+    current = &current->select_expr().operand();
+  }
+  if (!current->has_ident_expr()) {
+    return absl::nullopt;
+  }
+  segments.push_back(current->ident_expr().name());
+  std::reverse(segments.begin(), segments.end());
+  return absl::StrJoin(segments, ".");
+}
+
+// Collects the (possibly qualified) names that may be resolved as variables or
+// functions.
+//
+// Comprehension variables are included as well: looking them up in the
+// activation can only make the fingerprint more specific.
+class ReferencedNameCollector : public AstVisitorBase {
+ public:
+  void PostVisitIdent(const Expr& expr, const IdentExpr& ident) override {
+    variables_.insert(ident.name());
+  }
+
+  void PostVisitSelect(const Expr& expr, const SelectExpr& select) override {
+    if (absl::optional<std::string> path = QualifiedPath(expr); path) {
+      variables_.insert(*std::move(path));
+    }
+  }
+
+  void PostVisitCall(const Expr& expr, const CallExpr& call) override {
+    functions_.insert(call.function());
+    if (!call.has_target()) {
+      return;
+    }
+    if (absl::optional<std::string> path = QualifiedPath(call.target());
+        path) {
+      functions_.insert(absl::StrCat(*path, ".", call.function()));
+    }
+  }
+
+  absl::btree_set<std::string>& variables() { return variables_; }
+  absl::btree_set<std::string>& functions() { return functions_; }
+
+ private:
+  absl::btree_set<std::string> variables_;
+  absl::btree_set<std::string> functions_;
+};
+
+// Adds the names `name` may resolve to within `container`, following the
+// runtime's namespace resolution rules.
+void AddCandidates(absl::string_view name, absl::string_view container,
+                   absl::btree_set<std::string>& out) {
+  if (absl::ConsumePrefix(&name, ".")) {
+    out.insert(std::string(name));
+    return;
+  }
+  while (!container.empty()) {
+    out.insert(absl::StrCat(container, ".", name));
+    size_t pos = container.rfind('.');
+    container = container.substr(0, pos == absl::string_view::npos ? 0 : pos);
+  }
+  out.insert(std::string(name));
+}
+
+void AppendFixed64(uint64_t value, std::string& out) {
+  char buffer[sizeof(value)];
+  std::memcpy(buffer, &value, sizeof(value));
+  out.append(buffer, sizeof(value));
+}
+
+void AppendBytes(absl::string_view value, std::string& out) {
+  AppendFixed64(value.size(), out);
+  out.append(value.data(), value.size());
+}
+
+void AppendDuration(absl::Duration value, std::string& out) {
+  absl::Duration remainder;
+  int64_t seconds = absl::IDivDuration(value, absl::Seconds(1), &remainder);
+  AppendFixed64(static_cast<uint64_t>(seconds), out);
+  AppendFixed64(static_cast<uint64_t>(absl::ToInt64Nanoseconds(remainder)),
+                out);
+}
+
+// Appends an unambiguous encoding of `value` to `out`. Returns false if the
+// value kind isn't supported, in which case the evaluation is not memoized.
+//
+// Equal encodings imply equal values. The converse doesn't hold (e.g. for
+// 0.0 and -0.0), which only costs a cache miss.
+absl::StatusOr<bool> AppendFingerprint(
+    const Value& value, const google::protobuf::DescriptorPool* absl_nonnull pool,
+    google::protobuf::MessageFactory* absl_nonnull message_factory,
+    google::protobuf::Arena* absl_nonnull arena, std::string& out) {
+  switch (value.kind()) {
+    case ValueKind::kNull:
+      out.push_back('n');
+      return true;
+    case ValueKind::kBool:
+      out.push_back(value.GetBool().NativeValue() ? 'T' : 'F');
+      return true;
+    case ValueKind::kInt:
+      out.push_back('i');
+      AppendFixed64(static_cast<uint64_t>(value.GetInt().NativeValue()), out);
+      return true;
+    case ValueKind::kUint:
+      out.push_back('u');
+      AppendFixed64(value.GetUint().NativeValue(), out);
+      return true;
+    case ValueKind::kDouble: {
+      double native = value.GetDouble().NativeValue();
+      uint64_t bits;
+      std::memcpy(&bits, &native, sizeof(bits));
+      out.push_back('d');
+      AppendFixed64(bits, out);
+      return true;
+    }
+    case ValueKind::kString: {
+      std::string scratch;
+      out.push_back('s');
+      AppendBytes(value.GetString().ToStringView(&scratch), out);
+      return true;
+    }
+    case ValueKind::kBytes: {
+      std::string scratch;
+      out.push_back('b');
+      AppendBytes(value.GetBytes().ToStringView(&scratch), out);
+      return true;
+    }
+    case ValueKind::kDuration:
+      out.push_back('D');
+      AppendDuration(value.GetDuration().ToDuration(), out);
+      return true;
+    case ValueKind::kTimestamp:
+      out.push_back('t');
+      AppendDuration(value.GetTimestamp().ToTime() - absl::UnixEpoch(),
+                     out);
+      return true;
+    case ValueKind::kList: {
+      ListValue list = value.GetList();
+      CEL_ASSIGN_OR_RETURN(size_t size, list.Size());
+      out.push_back('l');
+      AppendFixed64(size, out);
+      bool supported = true;
+      CEL_RETURN_IF_ERROR(list.ForEach(
+          [&](const Value& element) -> absl::StatusOr<bool> {
+            CEL_ASSIGN_OR_RETURN(supported,
+                                 AppendFingerprint(element, pool,
+                                                   message_factory, arena,
+                                                   out));
+            return supported;
+          },
+          pool, message_factory, arena));
+      return supported;
+    }
+    case ValueKind::kMap: {
+      // Map iteration order is unspecified, so entries are sorted by their
+      // encoded key.
+      std::vector<std::pair<std::string, std::string>> entries;
+      bool supported = true;
+      CEL_RETURN_IF_ERROR(value.GetMap().ForEach(
+          [&](const Value& key, const Value& entry) -> absl::StatusOr<bool> {
+            auto& encoded = entries.emplace_back();
+            CEL_ASSIGN_OR_RETURN(supported,
+                                 AppendFingerprint(key, pool, message_factory,
+                                                   arena, encoded.first));
+            if (!supported) {
+              return false;
+            }
+            CEL_ASSIGN_OR_RETURN(supported,
+                                 AppendFingerprint(entry, pool,
+                                                   message_factory, arena,
+                                                   encoded.second));
+            return supported;
+          },
+          pool, message_factory, arena));
+      if (!supported) {
+        return false;
+      }
+      std::sort(entries.begin(), entries.end());
+      out.push_back('m');
+      AppendFixed64(entries.size(), out);
+      for (const auto& entry : entries) {
+        out.append(entry.first);
+        out.append(entry.second);
+      }
+      return true;
+    }
+    case ValueKind::kStruct: {
+      if (!value.IsParsedMessage()) {
+        return false;
+      }
+      const google::protobuf::Message& message = *value.GetParsedMessage();
+      std::string serialized;
+      {
+        google::protobuf::io::StringOutputStream stream(&serialized);
+        google::protobuf::io::CodedOutputStream coded(&stream);
+        coded.SetSerializationDeterministic(true);
+        if (!message.SerializeToCodedStream(&coded)) {
+          return false;
+        }
+      }
+      out.push_back('M');
+      AppendBytes(message.GetDescriptor()->full_name(), out);
+      AppendBytes(serialized, out);
+      return true;
+    }
+    case ValueKind::kOpaque: {
+      if (!value.IsOptional()) {
+        return false;
+      }
+      const OptionalValue& optional = value.GetOptional();
+      if (!optional.HasValue()) {
+        out.push_back('o');
+        return true;
+      }
+      out.push_back('O');
+      return AppendFingerprint(optional.Value(), pool, message_factory, arena,
+                               out);
+    }
+    default:
+      return false;
+  }
+}
+
+// A result that can be restored on any arena.
+class CachedResult {
+ public:
+  static absl::optional<CachedResult> From(const Value& value) {
+    CachedResult result;
+    result.kind_ = value.kind();
+    switch (value.kind()) {
+      case ValueKind::kNull:
+      case ValueKind::kBool:
+      case ValueKind::kInt:
+      case ValueKind::kUint:
+      case ValueKind::kDouble:
+      case ValueKind::kDuration:
+      case ValueKind::kTimestamp:
+        // Held inline, no arena references.
+        result.scalar_ = value;
+        return result;
+      case ValueKind::kString:
+        result.data_ = value.GetString().ToString();
+        return result;
+      case ValueKind::kBytes:
+        result.data_ = value.GetBytes().ToString();
+        return result;
+      case ValueKind::kError:
+        result.error_ = value.GetError().ToStatus();
+        return result;
+      default:
+        return absl::nullopt;
+    }
+  }
+
+  Value Restore(google::protobuf::Arena* absl_nonnull arena) const {
+    switch (kind_) {
+      case ValueKind::kString:
+        return StringValue::From(data_, arena);
+      case ValueKind::kBytes:
+        return BytesValue::From(data_, arena);
+      case ValueKind::kError:
+        return ErrorValue(error_);
+      default:
+        return scalar_;
+    }
+  }
+
+ private:
+  CachedResult() = default;
+
+  ValueKind kind_ = ValueKind::kNull;
+  Value scalar_;
+  std::string data_;
+  absl::Status error_;
+};
+
+// Bounded LRU cache split into independently locked shards.
+class ResultCache {
+ public:
+  ResultCache(size_t max_entries, size_t shards)
+      : shards_(std::max<size_t>(shards, 1)),
+        shard_capacity_((max_entries + shards_.size() - 1) / shards_.size()) {}
+
+  absl::optional<Value> Find(const std::string& key,
+                             google::protobuf::Arena* absl_nonnull arena) {
+    Shard& shard = ShardFor(key);
+    absl::MutexLock lock(&shard.mutex);
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+      return absl::nullopt;
+    }
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    return it->second->second.Restore(arena);
+  }
+
+  // Returns the number of evicted entries.
+  size_t Insert(std::string key, CachedResult result) {
+    if (shard_capacity_ == 0) {
+      return 0;
+    }
+    Shard& shard = ShardFor(key);
+    absl::MutexLock lock(&shard.mutex);
+    if (shard.index.contains(key)) {
+      // Inserted by a concurrent evaluation.
+      return 0;
+    }
+    shard.entries.emplace_front(std::move(key), std::move(result));
+    shard.index.insert({shard.entries.front().first, shard.entries.begin()});
+    size_t evicted = 0;
+    while (shard.entries.size() > shard_capacity_) {
+      shard.index.erase(shard.entries.back().first);
+      shard.entries.pop_back();
+      ++evicted;
+    }
+    return evicted;
+  }
+
+  void Clear() {
+    for (Shard& shard : shards_) {
+      absl::MutexLock lock(&shard.mutex);
+      shard.index.clear();
+      shard.entries.clear();
+    }
+  }
+
+ private:
+  using Entry = std::pair<std::string, CachedResult>;
+
+  struct Shard {
+    absl::Mutex mutex;
+    // Most recently used first.
+    std::list<Entry> entries ABSL_GUARDED_BY(mutex);
+    // Keys point into `entries`.
+    absl::flat_hash_map<absl::string_view, std::list<Entry>::iterator> index
+        ABSL_GUARDED_BY(mutex);
+  };
+
+  Shard& ShardFor(absl::string_view key) {
+    return shards_[absl::HashOf(key) % shards_.size()];
+  }
+
+  std::vector<Shard> shards_;
+  size_t shard_capacity_;
+};
+
+}  // namespace
+
+class MemoizedProgram::Impl {
+ public:
+  Impl(std::vector<std::string> variables, std::vector<std::string> functions,
+       bool enabled, const google::protobuf::DescriptorPool* absl_nonnull pool,
+       google::protobuf::MessageFactory* absl_nonnull message_factory,
+       const MemoizationOptions& options)
+      : variables_(std::move(variables)),
+        functions_(std::move(functions)),
+        enabled_(enabled),
+        pool_(pool),
+        message_factory_(message_factory),
+        cache_(options.max_entries, options.shards) {}
+
+  // Computes the cache key for `activation`. Returns false if the evaluation
+  // shouldn't be memoized.
+  bool Fingerprint(const ActivationInterface& activation,
+                   google::protobuf::MessageFactory* absl_nullable message_factory,
+                   google::protobuf::Arena* absl_nonnull arena,
+                   std::string& key) const {
+    if (!enabled_ || !activation.GetUnknownAttributes().empty() ||
+        !activation.GetMissingAttributes().empty()) {
+      return false;
+    }
+    for (const std::string& function : functions_) {
+      if (!activation.FindFunctionOverloads(function).empty()) {
+        return false;
+      }
+    }
+    if (message_factory == nullptr) {
+      message_factory = message_factory_;
+    }
+    for (const std::string& variable : variables_) {
+      Value value;
+      absl::StatusOr<bool> found = activation.FindVariable(
+          variable, pool_, message_factory, arena, &value);
+      if (!found.ok()) {
+        // Let the evaluation surface the error.
+        return false;
+      }
+      if (!*found) {
+        key.push_back('_');
+        continue;
+      }
+      key.push_back('=');
+      absl::StatusOr<bool> supported =
+          AppendFingerprint(value, pool_, message_factory, arena, key);
+      if (!supported.ok() || !*supported) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool enabled() const { return enabled_; }
+
+  ResultCache& cache() const { return cache_; }
+
+  std::atomic<uint64_t>& hits() const { return hits_; }
+  std::atomic<uint64_t>& misses() const { return misses_; }
+  std::atomic<uint64_t>& bypassed() const { return bypassed_; }
+  std::atomic<uint64_t>& evictions() const { return evictions_; }
+
+ private:
+  // Sorted, so that the fingerprint is independent of the AST shape.
+  const std::vector<std::string> variables_;
+  const std::vector<std::string> functions_;
+  const bool enabled_;
+  const google::protobuf::DescriptorPool* absl_nonnull pool_;
+  google::protobuf::MessageFactory* absl_nonnull message_factory_;
+
+  mutable ResultCache cache_;
+  mutable std::atomic<uint64_t> hits_ = 0;
+  mutable std::atomic<uint64_t> misses_ = 0;
+  mutable std::atomic<uint64_t> bypassed_ = 0;
+  mutable std::atomic<uint64_t> evictions_ = 0;
+};
+
+MemoizedProgram::MemoizedProgram(std::unique_ptr<Program> program,
+                                 std::unique_ptr<Impl> impl)
+    : program_(std::move(program)), impl_(std::move(impl)) {}
+
+MemoizedProgram::~MemoizedProgram() = default;
+
+absl::StatusOr<Value> MemoizedProgram::Evaluate(
+    google::protobuf::Arena* absl_nonnull arena,
+    google::protobuf::MessageFactory* absl_nullable message_factory,
+    const ActivationInterface& activation) const {
+  std::string key;
+  if (!impl_->Fingerprint(activation, message_factory, arena, key)) {
+    impl_->bypassed().fetch_add(1, std::memory_order_relaxed);
+    return program_->Evaluate(arena, message_factory, activation);
+  }
+  if (absl::optional<Value> cached = impl_->cache().Find(key, arena); cached) {
+    impl_->hits().fetch_add(1, std::memory_order_relaxed);
+    return *std::move(cached);
+  }
+  impl_->misses().fetch_add(1, std::memory_order_relaxed);
+  CEL_ASSIGN_OR_RETURN(Value result,
+                       program_->Evaluate(arena, message_factory, activation));
+  if (absl::optional<CachedResult> cached = CachedResult::From(result);
+      cached) {
+    size_t evicted =
+        impl_->cache().Insert(std::move(key), *std::move(cached));
+    impl_->evictions().fetch_add(evicted, std::memory_order_relaxed);
+  }
+  return result;
+}
+
+bool MemoizedProgram::memoization_enabled() const { return impl_->enabled(); }
+
+MemoizationStats MemoizedProgram::stats() const {
+  MemoizationStats stats;
+  stats.hits = impl_->hits().load(std::memory_order_relaxed);
+  stats.misses = impl_->misses().load(std::memory_order_relaxed);
+  stats.bypassed = impl_->bypassed().load(std::memory_order_relaxed);
+  stats.evictions = impl_->evictions().load(std::memory_order_relaxed);
+  return stats;
+}
+
+void MemoizedProgram::Clear() { impl_->cache().Clear(); }
+
+absl::StatusOr<std::unique_ptr<MemoizedProgram>> CreateMemoizedProgram(
+    const Runtime& runtime, std::unique_ptr<Ast> ast,
+    const MemoizationOptions& options) {
+  if (ast == nullptr) {
+    return absl::InvalidArgumentError("ast must not be null");
+  }
+
+  absl::string_view container;
+  if (RuntimeFriendAccess::RuntimeTypeId(runtime) ==
+      NativeTypeId::For<RuntimeImpl>()) {
+    container =
+        down_cast<const RuntimeImpl&>(runtime).expr_builder().container();
+  } else if (!ast->is_checked()) {
+    // Without the container, variables the runtime would resolve under a
+    // namespace can't be fingerprinted.
+    return absl::UnimplementedError(
+        "memoization of parsed-only expressions is only supported on the "
+        "default cel::Runtime implementation.");
+  }
+
+  ReferencedNameCollector collector;
+  AstTraverse(ast->root_expr(), collector);
+
+  absl::btree_set<std::string> variables;
+  for (const std::string& path : collector.variables()) {
+    AddCandidates(path, container, variables);
+  }
+  for (const auto& [id, reference] : ast->reference_map()) {
+    if (reference.overload_id().empty() && !reference.has_value()) {
+      variables.insert(reference.name());
+    }
+  }
+
+  absl::btree_set<std::string> functions;
+  for (const std::string& function : collector.functions()) {
+    AddCandidates(function, container, functions);
+  }
+  bool enabled = std::none_of(
+      functions.begin(), functions.end(), [&](const std::string& function) {
+        return options.non_deterministic_functions.contains(function);
+      });
+
+  auto impl = std::make_unique<MemoizedProgram::Impl>(
+      std::vector<std::string>(variables.begin(), variables.end()),
+      std::vector<std::string>(functions.begin(), functions.end()), enabled,
+      runtime.GetDescriptorPool(), runtime.GetMessageFactory(), options);
+
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<Program> program,
+                       runtime.CreateProgram(std::move(ast)));
+  return std::unique_ptr<MemoizedProgram>(
+      new MemoizedProgram(std::move(program), std::move(impl)));
+}
+
+}  // namespace cel::extensions
@@ -0,0 +1,142 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_MEMOIZED_PROGRAM_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_MEMOIZED_PROGRAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/base/attributes.h"
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "base/ast.h"
+#include "base/type_provider.h"
+#include "common/value.h"
+#include "runtime/activation_interface.h"
+#include "runtime/runtime.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/message.h"
+
+namespace cel::extensions {
+
+struct MemoizationOptions {
+  // Maximum number of results retained across all shards. Least recently used
+  // results are evicted first.
+  size_t max_entries = 4096;
+
+  // Number of independently locked cache shards. More shards reduce lock
+  // contention between concurrent evaluations.
+  size_t shards = 16;
+
+  // Names of functions whose result may change between calls with the same
+  // arguments (e.g. a function returning the current time). Programs that
+  // call any of them are never memoized.
+  absl::flat_hash_set<std::string> non_deterministic_functions;
+};
+
+struct MemoizationStats {
+  // Evaluations served from the cache.
+  uint64_t hits = 0;
+  // Evaluations that were fingerprinted but not found in the cache.
+  uint64_t misses = 0;
+  // Evaluations that bypassed the cache, e.g. because the activation declares
+  // unknown attributes or binds a referenced variable that can't be
+  // fingerprinted.
+  uint64_t bypassed = 0;
+  // Results dropped to respect `MemoizationOptions::max_entries`.
+  uint64_t evictions = 0;
+
+  // Fraction of evaluations served from the cache.
+  double hit_rate() const {
+    uint64_t total = hits + misses + bypassed;
+    return total == 0 ? 0.0 : static_cast<double>(hits) / total;
+  }
+};
+
+// A Program that caches results keyed by the values of the variables the
+// expression references.
+//
+// The fingerprint is computed from the activation bindings for each variable
+// name the expression may resolve (using the reference map for checked
+// expressions and the runtime's container for parsed-only ones), so unrelated
+// bindings in the activation don't affect cache hits.
+//
+// Only results that don't depend on the evaluation arena are cached: null,
+// bool, int, uint, double, string, bytes, duration, timestamp and errors.
+// Unknown results, and evaluations with unknown or missing attribute patterns
+// or with context functions bound to a called function name, are never
+// cached. Results are rebuilt on the caller's arena on a hit.
+//
+// Thread-safe if the wrapped program is.
+class MemoizedProgram final : public Program {
+ public:
+  using Program::Evaluate;
+
+  absl::StatusOr<Value> Evaluate(
+      google::protobuf::Arena* absl_nonnull arena ABSL_ATTRIBUTE_LIFETIME_BOUND,
+      google::protobuf::MessageFactory* absl_nullable message_factory
+          ABSL_ATTRIBUTE_LIFETIME_BOUND,
+      const ActivationInterface& activation) const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND override;
+
+  const TypeProvider& GetTypeProvider() const override {
+    return program_->GetTypeProvider();
+  }
+
+  // Whether results may be served from the cache. False if the expression
+  // calls a function listed in
+  // `MemoizationOptions::non_deterministic_functions`.
+  bool memoization_enabled() const;
+
+  MemoizationStats stats() const;
+
+  // Drops all cached results. Statistics are preserved.
+  void Clear();
+
+  ~MemoizedProgram() override;
+
+ private:
+  class Impl;
+
+  friend absl::StatusOr<std::unique_ptr<MemoizedProgram>> CreateMemoizedProgram(
+      const Runtime& runtime, std::unique_ptr<Ast> ast,
+      const MemoizationOptions& options);
+
+  MemoizedProgram(std::unique_ptr<Program> program, std::unique_ptr<Impl> impl);
+
+  std::unique_ptr<Program> program_;
+  std::unique_ptr<Impl> impl_;
+};
+
+// Plan `ast` with `runtime` and wrap the resulting program with a result
+// cache.
+//
+// The runtime must outlive the returned program.
+absl::StatusOr<std::unique_ptr<MemoizedProgram>> CreateMemoizedProgram(
+    const Runtime& runtime, std::unique_ptr<Ast> ast,
+    const MemoizationOptions& options);
+
+inline absl::StatusOr<std::unique_ptr<MemoizedProgram>> CreateMemoizedProgram(
+    const Runtime& runtime, std::unique_ptr<Ast> ast) {
+  return CreateMemoizedProgram(runtime, std::move(ast), MemoizationOptions());
+}
+
+}  // namespace cel::extensions
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_MEMOIZED_PROGRAM_H_
@@ -0,0 +1,311 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/memoized_program.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "cel/expr/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "base/ast.h"
+#include "base/attribute.h"
+#include "checker/standard_library.h"
+#include "checker/validation_result.h"
+#include "common/ast_proto.h"
+#include "common/decl.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "compiler/compiler.h"
+#include "compiler/compiler_factory.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/function_adapter.h"
+#include "runtime/function_registry.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::extensions {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::cel::expr::ParsedExpr;
+using ::cel::test::BoolValueIs;
+using ::cel::test::ErrorValueIs;
+using ::cel::test::IntValueIs;
+using ::cel::test::StringValueIs;
+using ::google::api::expr::parser::Parse;
+using ::testing::DoubleEq;
+using ::testing::HasSubstr;
+
+absl::StatusOr<std::unique_ptr<Ast>> ParseAst(absl::string_view expression) {
+  CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+  return CreateAstFromParsedExpr(parsed_expr);
+}
+
+absl::StatusOr<std::unique_ptr<Ast>> CompileAst(absl::string_view expression) {
+  CEL_ASSIGN_OR_RETURN(auto builder,
+                       NewCompilerBuilder(internal::GetTestingDescriptorPool()));
+  CEL_RETURN_IF_ERROR(builder->AddLibrary(StandardCheckerLibrary()));
+  builder->GetCheckerBuilder().set_container("com.example");
+  CEL_RETURN_IF_ERROR(builder->GetCheckerBuilder().AddVariable(
+      MakeVariableDecl("com.example.x", IntType())));
+  CEL_ASSIGN_OR_RETURN(auto compiler, std::move(*builder).Build());
+  CEL_ASSIGN_OR_RETURN(ValidationResult result, compiler->Compile(expression));
+  if (!result.IsValid()) {
+    return absl::InvalidArgumentError(result.FormatError());
+  }
+  return result.ReleaseAst();
+}
+
+class MemoizedProgramTest : public testing::Test {
+ protected:
+  absl::StatusOr<std::unique_ptr<Runtime>> MakeRuntime() {
+    CEL_ASSIGN_OR_RETURN(
+        RuntimeBuilder builder,
+        CreateStandardRuntimeBuilder(internal::GetTestingDescriptorPool(),
+                                     options_));
+    using Adapter = UnaryFunctionAdapter<int64_t, int64_t>;
+    CEL_RETURN_IF_ERROR(builder.function_registry().Register(
+        Adapter::CreateDescriptor("counted", false),
+        Adapter::WrapFunction([this](int64_t x) -> int64_t {
+          ++calls_;
+          return x;
+        })));
+    return std::move(builder).Build();
+  }
+
+  google::protobuf::Arena arena_;
+  RuntimeOptions options_;
+  int calls_ = 0;
+};
+
+TEST_F(MemoizedProgramTest, ServesRepeatedInputsFromCache) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime());
+  ASSERT_OK_AND_ASSIGN(auto ast, ParseAst("counted(x) + 1"));
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       CreateMemoizedProgram(*runtime, std::move(ast)));
+  EXPECT_TRUE(program->memoization_enabled());
+
+  Activation activation;
+  activation.InsertOrAssignValue("x", IntValue(1));
+  activation.InsertOrAssignValue("unrelated", IntValue(0));
+
+  EXPECT_THAT(program->Evaluate(&arena_, activation),
+              IsOkAndHolds(IntValueIs(2)));
+  // Variables the expression doesn't reference don't affect the fingerprint.
+  activation.InsertOrAssignValue("unrelated", IntValue(1));
+  EXPECT_THAT(program->Evaluate(&arena_, activation),
+              IsOkAndHolds(IntValueIs(2)));
+  EXPECT_EQ(calls_, 1);
+
+  activation.InsertOrAssignValue("x", IntValue(2));
+  EXPECT_THAT(program->Evaluate(&arena_, activation),
+              IsOkAndHolds(IntValueIs(3)));
+  EXPECT_EQ(calls_, 2);
+
+  MemoizationStats stats = program->stats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.bypassed, 0);
+  EXPECT_THAT(stats.hit_rate(), DoubleEq(1.0 / 3));
+}
+
+TEST_F(MemoizedProgramTest, FingerprintsCompositeValues) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime());
+  ASSERT_OK_AND_ASSIGN(auto ast,
+                       ParseAst("m.size() + counted(size(l)) == 5"));
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       CreateMemoizedProgram(*runtime, std::move(ast)));
+
+  Activation activation;
+  ASSERT_OK_AND_ASSIGN(auto inputs_ast,
+                       ParseAst("[{'a': 1, 'b': 2}, [1, 2, 3]]"));
+  ASSERT_OK_AND_ASSIGN(auto inputs_program,
+                       runtime->CreateProgram(std::move(inputs_ast)));
+  ASSERT_OK_AND_ASSIGN(Value inputs,
+                       inputs_program->Evaluate(&arena_, activation));
+  ASSERT_OK_AND_ASSIGN(
+      Value map,
+      inputs.GetList().Get(0, runtime->GetDescriptorPool(),
+                           runtime->GetMessageFactory(), &arena_));
+  ASSERT_OK_AND_ASSIGN(
+      Value l, inputs.GetList().Get(1, runtime->GetDescriptorPool(),
+                                    runtime->GetMessageFactory(), &arena_));
+  activation.InsertOrAssignValue("m", map);
+  activation.InsertOrAssignValue("l", l);
+
+  EXPECT_THAT(program->Evaluate(&arena_, activation),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(program->Evaluate(&arena_, activation),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_EQ(calls_, 1);
+  EXPECT_EQ(program->stats().hits, 1);
+
+  activation.InsertOrAssignValue("l", map);
+  EXPECT_THAT(program->Evaluate(&arena_, activation),
+              IsOkAndHolds(BoolValueIs(false)));
+  EXPECT_EQ(calls_, 2);
+}
+
+TEST_F(MemoizedProgramTest, RestoresResultsOnCallerArena) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime());
+  ASSERT_OK_AND_ASSIGN(auto ast, ParseAst("s + string(counted(1))"));
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       CreateMemoizedProgram(*runtime, std::move(ast)));
+
+  Activation activation;
+  activation.InsertOrAssignValue("s", StringValue("abc"));
+  {
+    google::protobuf::Arena arena;
+    EXPECT_THAT(program->Evaluate(&arena, activation),
+                IsOkAndHolds(StringValueIs("abc1")));
+  }
+  google::protobuf::Arena arena;
+  EXPECT_THAT(program->Evaluate(&arena, activation),
+              IsOkAndHolds(StringValueIs("abc1")));
+  EXPECT_EQ(calls_, 1);
+}
+
+TEST_F(MemoizedProgramTest, CachesErrors) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime());
+  ASSERT_OK_AND_ASSIGN(auto ast, ParseAst("counted(x) / 0"));
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       CreateMemoizedProgram(*runtime, std::move(ast)));
+
+  Activation activation;
+  activation.InsertOrAssignValue("x", IntValue(1));
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_THAT(program->Evaluate(&arena_, activation),
+                IsOkAndHolds(ErrorValueIs(
+                    StatusIs(absl::StatusCode::kInvalidArgument,
+                             HasSubstr("divide by zero")))));
+  }
+  EXPECT_EQ(calls_, 1);
+}
+
+TEST_F(MemoizedProgramTest, EvictsLeastRecentlyUsed) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime());
+  ASSERT_OK_AND_ASSIGN(auto ast, ParseAst("counted(x)"));
+  MemoizationOptions options;
+  options.max_entries = 2;
+  options.shards = 1;
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       CreateMemoizedProgram(*runtime, std::move(ast), options));
+
+  Activation activation;
+  for (int64_t x : {1, 2, 1, 3, 1, 2}) {
+    activation.InsertOrAssignValue("x", IntValue(x));
+    ASSERT_THAT(program->Evaluate(&arena_, activation),
+                IsOkAndHolds(IntValueIs(x)));
+  }
+  // 1, 2 and 3 miss once each; 2 misses again after being evicted by 3.
+  EXPECT_EQ(calls_, 4);
+  MemoizationStats stats = program->stats();
+  EXPECT_EQ(stats.hits, 2);
+  EXPECT_EQ(stats.evictions, 2);
+
+  program->Clear();
+  activation.InsertOrAssignValue("x", IntValue(2));
+  ASSERT_THAT(program->Evaluate(&arena_, activation),
+              IsOkAndHolds(IntValueIs(2)));
+  EXPECT_EQ(calls_, 5);
+}
+
+TEST_F(MemoizedProgramTest, NonDeterministicFunctionsDisableMemoization) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime());
+  ASSERT_OK_AND_ASSIGN(auto ast, ParseAst("counted(x) == 1"));
+  MemoizationOptions options;
+  options.non_deterministic_functions.insert("counted");
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       CreateMemoizedProgram(*runtime, std::move(ast), options));
+  EXPECT_FALSE(program->memoization_enabled());
+
+  Activation activation;
+  activation.InsertOrAssignValue("x", IntValue(1));
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_THAT(program->Evaluate(&arena_, activation),
+                IsOkAndHolds(BoolValueIs(true)));
+  }
+  EXPECT_EQ(calls_, 2);
+  EXPECT_EQ(program->stats().bypassed, 2);
+}
+
+TEST_F(MemoizedProgramTest, UnknownPatternsBypassCache) {
+  options_.unknown_processing = UnknownProcessingOptions::kAttributeOnly;
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime());
+  ASSERT_OK_AND_ASSIGN(auto ast, ParseAst("counted(x) == 1"));
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       CreateMemoizedProgram(*runtime, std::move(ast)));
+
+  Activation activation;
+  activation.InsertOrAssignValue("x", IntValue(1));
+  activation.SetUnknownPatterns({AttributePattern("x", {})});
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena_, activation));
+    EXPECT_TRUE(result.IsUnknown());
+  }
+  EXPECT_EQ(program->stats().bypassed, 2);
+  EXPECT_EQ(program->stats().misses, 0);
+}
+
+TEST_F(MemoizedProgramTest, FingerprintsContainerQualifiedNames) {
+  options_.container = "com.example";
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime());
+  ASSERT_OK_AND_ASSIGN(auto ast, ParseAst("counted(x)"));
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       CreateMemoizedProgram(*runtime, std::move(ast)));
+
+  Activation activation;
+  activation.InsertOrAssignValue("com.example.x", IntValue(1));
+  EXPECT_THAT(program->Evaluate(&arena_, activation),
+              IsOkAndHolds(IntValueIs(1)));
+  activation.InsertOrAssignValue("com.example.x", IntValue(2));
+  EXPECT_THAT(program->Evaluate(&arena_, activation),
+              IsOkAndHolds(IntValueIs(2)));
+  EXPECT_EQ(program->stats().hits, 0);
+}
+
+TEST_F(MemoizedProgramTest, CheckedExpressionUsesReferences) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime());
+  ASSERT_OK_AND_ASSIGN(auto ast, CompileAst("x + 1"));
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       CreateMemoizedProgram(*runtime, std::move(ast)));
+
+  Activation activation;
+  activation.InsertOrAssignValue("com.example.x", IntValue(1));
+  EXPECT_THAT(program->Evaluate(&arena_, activation),
+              IsOkAndHolds(IntValueIs(2)));
+  activation.InsertOrAssignValue("com.example.x", IntValue(2));
+  EXPECT_THAT(program->Evaluate(&arena_, activation),
+              IsOkAndHolds(IntValueIs(3)));
+  EXPECT_THAT(program->Evaluate(&arena_, activation),
+              IsOkAndHolds(IntValueIs(3)));
+  EXPECT_EQ(program->stats().hits, 1);
+}
+
+}  // namespace
+}  // namespace cel::extensions
@@ -0,0 +1,48 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_PARALLEL_EVALUATION_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_PARALLEL_EVALUATION_H_
+
+#include <memory>
+
+#include "absl/base/nullability.h"
+#include "absl/status/status.h"
+#include "runtime/executor.h"
+#include "runtime/runtime_builder.h"
+
+namespace cel::extensions {
+
+// Enable concurrent evaluation of independent subexpressions.
+//
+// Functions are opted in by marking their overloads with
+// `FunctionRegistry::MarkParallelSafe`. When both operands of a `&&` or `||`,
+// or at least two arguments of a call, invoke parallel-safe functions, the
+// planned program evaluates them concurrently on `executor` instead of in
+// sequence. Logical operators evaluated this way don't short-circuit, but
+// produce the same result, including for errors and unknowns.
+//
+// Subexpressions that declare comprehension variables are always evaluated
+// on the calling thread. Evaluations with a trace listener are not
+// parallelized.
+//
+// Only applies to recursively planned programs (see
+// `RuntimeOptions::max_recursion_depth`); returns FailedPrecondition
+// otherwise. The executor must outlive any program created by the runtime.
+absl::Status EnableParallelEvaluation(
+    RuntimeBuilder& builder, absl_nonnull std::shared_ptr<Executor> executor);
+
+}  // namespace cel::extensions
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_PARALLEL_EVALUATION_H_
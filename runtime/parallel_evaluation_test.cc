@@ -0,0 +1,266 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/parallel_evaluation.h"
+
+#include <cstdint>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "cel/expr/syntax.pb.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "extensions/bindings_ext.h"
+#include "extensions/protobuf/runtime_adapter.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "parser/macro.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/executor.h"
+#include "runtime/function_adapter.h"
+#include "runtime/function_registry.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::extensions {
+namespace {
+
+using ::absl_testing::StatusIs;
+using ::cel::expr::ParsedExpr;
+using ::cel::test::BoolValueIs;
+using ::cel::test::ErrorValueIs;
+using ::google::api::expr::parser::ParseWithMacros;
+using ::testing::Gt;
+
+// Runs each task on a new thread.
+class ThreadPerTaskExecutor : public Executor {
+ public:
+  ~ThreadPerTaskExecutor() override { Join(); }
+
+  void Schedule(absl::AnyInvocable<void() &&> task) override {
+    absl::MutexLock lock(&mutex_);
+    ++scheduled_;
+    threads_.emplace_back(
+        [task = std::move(task)]() mutable { std::move(task)(); });
+  }
+
+  void Join() {
+    std::vector<std::thread> threads;
+    {
+      absl::MutexLock lock(&mutex_);
+      threads.swap(threads_);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  int scheduled() const {
+    absl::MutexLock lock(&mutex_);
+    return scheduled_;
+  }
+
+ private:
+  mutable absl::Mutex mutex_;
+  std::vector<std::thread> threads_ ABSL_GUARDED_BY(mutex_);
+  int scheduled_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+// Blocks callers until `parties` of them have arrived. Returns false if the
+// others don't arrive in time, i.e. the calls were not concurrent.
+class Rendezvous {
+ public:
+  explicit Rendezvous(int parties) : remaining_(parties) {}
+
+  bool Arrive() {
+    absl::MutexLock lock(&mutex_);
+    --remaining_;
+    return mutex_.AwaitWithTimeout(absl::Condition(this, &Rendezvous::Done),
+                                   absl::Seconds(10));
+  }
+
+ private:
+  bool Done() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return remaining_ <= 0;
+  }
+
+  absl::Mutex mutex_;
+  int remaining_ ABSL_GUARDED_BY(mutex_);
+};
+
+template <typename T, typename F>
+absl::Status RegisterIntFunction(FunctionRegistry& registry,
+                                 absl::string_view name, F function,
+                                 bool parallel_safe = true) {
+  using Adapter = UnaryFunctionAdapter<T, int64_t>;
+  FunctionDescriptor descriptor = Adapter::CreateDescriptor(name, false);
+  CEL_RETURN_IF_ERROR(
+      registry.Register(descriptor, Adapter::WrapFunction(std::move(function))));
+  if (parallel_safe) {
+    return registry.MarkParallelSafe(descriptor);
+  }
+  return absl::OkStatus();
+}
+
+class ParallelEvaluationTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    options_.max_recursion_depth = -1;
+    executor_ = std::make_shared<ThreadPerTaskExecutor>();
+  }
+
+  absl::StatusOr<RuntimeBuilder> MakeBuilder() {
+    CEL_ASSIGN_OR_RETURN(
+        RuntimeBuilder builder,
+        CreateStandardRuntimeBuilder(internal::GetTestingDescriptorPool(),
+                                     options_));
+    FunctionRegistry& registry = builder.function_registry();
+    CEL_RETURN_IF_ERROR(RegisterIntFunction<bool>(
+        registry, "rendezvous",
+        [this](int64_t) -> bool { return rendezvous_.Arrive(); }));
+    CEL_RETURN_IF_ERROR(RegisterIntFunction<int64_t>(
+        registry, "rendezvous_int", [this](int64_t) -> int64_t {
+          return rendezvous_.Arrive() ? 1 : 0;
+        }));
+    CEL_RETURN_IF_ERROR(RegisterIntFunction<int64_t>(
+        registry, "slow_id", [](int64_t x) -> int64_t { return x; }));
+    CEL_RETURN_IF_ERROR(RegisterIntFunction<bool>(
+        registry, "slow_bool", [](int64_t x) -> bool { return x != 0; }));
+    CEL_RETURN_IF_ERROR(RegisterIntFunction<Value>(
+        registry, "slow_error", [](int64_t) -> Value {
+          return ErrorValue(absl::InvalidArgumentError("slow_error"));
+        }));
+    CEL_RETURN_IF_ERROR(RegisterIntFunction<bool>(
+        registry, "unmarked", [](int64_t x) -> bool { return x != 0; },
+        /*parallel_safe=*/false));
+    return builder;
+  }
+
+  absl::StatusOr<Value> Evaluate(absl::string_view expression) {
+    CEL_ASSIGN_OR_RETURN(RuntimeBuilder builder, MakeBuilder());
+    CEL_RETURN_IF_ERROR(EnableParallelEvaluation(builder, executor_));
+    CEL_ASSIGN_OR_RETURN(auto runtime, std::move(builder).Build());
+    std::vector<Macro> macros = Macro::AllMacros();
+    std::vector<Macro> bindings = bindings_macros();
+    macros.insert(macros.end(), bindings.begin(), bindings.end());
+    CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr,
+                         ParseWithMacros(expression, macros));
+    CEL_ASSIGN_OR_RETURN(auto program, ProtobufRuntimeAdapter::CreateProgram(
+                                           *runtime, parsed_expr));
+    Activation activation;
+    CEL_ASSIGN_OR_RETURN(Value result, program->Evaluate(&arena_, activation));
+    executor_->Join();
+    return result;
+  }
+
+  google::protobuf::Arena arena_;
+  RuntimeOptions options_;
+  std::shared_ptr<ThreadPerTaskExecutor> executor_;
+  Rendezvous rendezvous_{2};
+};
+
+TEST_F(ParallelEvaluationTest, LogicalAndEvaluatesOperandsConcurrently) {
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       Evaluate("rendezvous(1) && rendezvous(2)"));
+  EXPECT_THAT(result, BoolValueIs(true));
+  EXPECT_THAT(executor_->scheduled(), Gt(0));
+}
+
+TEST_F(ParallelEvaluationTest, CallArgumentsEvaluatedConcurrently) {
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       Evaluate("rendezvous_int(1) + rendezvous_int(2) == 2"));
+  EXPECT_THAT(result, BoolValueIs(true));
+  EXPECT_THAT(executor_->scheduled(), Gt(0));
+}
+
+TEST_F(ParallelEvaluationTest, LogicalOperatorsAreCommutativeForErrors) {
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       Evaluate("slow_error(1) || slow_bool(1)"));
+  EXPECT_THAT(result, BoolValueIs(true));
+
+  ASSERT_OK_AND_ASSIGN(result, Evaluate("slow_bool(0) && slow_error(1)"));
+  EXPECT_THAT(result, BoolValueIs(false));
+
+  ASSERT_OK_AND_ASSIGN(result, Evaluate("slow_error(1) && slow_bool(1)"));
+  EXPECT_THAT(result, ErrorValueIs(StatusIs(absl::StatusCode::kInvalidArgument,
+                                            "slow_error")));
+
+  ASSERT_OK_AND_ASSIGN(result, Evaluate("slow_bool(0) || slow_error(1)"));
+  EXPECT_THAT(result, ErrorValueIs(StatusIs(absl::StatusCode::kInvalidArgument,
+                                            "slow_error")));
+}
+
+TEST_F(ParallelEvaluationTest, ReadsComprehensionVariables) {
+  ASSERT_OK_AND_ASSIGN(
+      Value result,
+      Evaluate("[1, 2, 3].all(x, slow_id(x) + slow_id(x) == 2 * x)"));
+  EXPECT_THAT(result, BoolValueIs(true));
+  EXPECT_THAT(executor_->scheduled(), Gt(0));
+}
+
+TEST_F(ParallelEvaluationTest, BranchesShareIterationBudget) {
+  // Each operand lazily initializes its own copy of the binding, which takes
+  // three iterations. Only the total exceeds the budget.
+  options_.comprehension_max_iterations = 5;
+  EXPECT_THAT(Evaluate("cel.bind(l, [1, 2, 3].map(x, x), "
+                       "slow_bool(size(l)) && slow_bool(size(l)))"),
+              StatusIs(absl::StatusCode::kInternal,
+                       "Iteration budget exceeded"));
+
+  options_.comprehension_max_iterations = 10;
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       Evaluate("cel.bind(l, [1, 2, 3].map(x, x), "
+                                "slow_bool(size(l)) && slow_bool(size(l)))"));
+  EXPECT_THAT(result, BoolValueIs(true));
+}
+
+TEST_F(ParallelEvaluationTest, UnmarkedFunctionsEvaluatedSequentially) {
+  ASSERT_OK_AND_ASSIGN(Value result, Evaluate("unmarked(1) && unmarked(2)"));
+  EXPECT_THAT(result, BoolValueIs(true));
+  EXPECT_EQ(executor_->scheduled(), 0);
+}
+
+TEST_F(ParallelEvaluationTest, RequiresRecursivePlanning) {
+  options_.max_recursion_depth = 0;
+  ASSERT_OK_AND_ASSIGN(RuntimeBuilder builder, MakeBuilder());
+  EXPECT_THAT(EnableParallelEvaluation(builder, executor_),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST(ParallelEvaluationExtensionTest, RequiresExecutor) {
+  ASSERT_OK_AND_ASSIGN(
+      RuntimeBuilder builder,
+      CreateStandardRuntimeBuilder(internal::GetTestingDescriptorPool(),
+                                   RuntimeOptions{}));
+  EXPECT_THAT(EnableParallelEvaluation(builder, nullptr),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace cel::extensions
@@ -0,0 +1,444 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/partial_evaluation.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "base/ast.h"
+#include "base/attribute.h"
+#include "base/builtins.h"
+#include "common/ast.h"
+#include "common/ast_rewrite.h"
+#include "common/ast_traverse.h"
+#include "common/ast_visitor.h"
+#include "common/ast_visitor_base.h"
+#include "common/expr.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "internal/status_macros.h"
+#include "runtime/activation_interface.h"
+#include "runtime/runtime.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel::extensions {
+namespace {
+
+class ExprIdCollector : public AstVisitorBase {
+ public:
+  void PreVisitExpr(const Expr& expr) override { ids_.insert(expr.id()); }
+
+  const absl::flat_hash_set<int64_t>& ids() const { return ids_; }
+
+ private:
+  absl::flat_hash_set<int64_t> ids_;
+};
+
+// Subexpressions that are evaluated once per iteration, so the recorded value
+// is only that of the last iteration.
+bool IsLoopScoped(ComprehensionArg comprehension_arg) {
+  return comprehension_arg == LOOP_CONDITION || comprehension_arg == LOOP_STEP;
+}
+
+// Builds the attribute `expr` refers to, the way the evaluator tracks it:
+// an identifier followed by field selections and indexes with constant keys.
+// Returns false if `expr` is not such a path.
+bool BuildAttributePath(const Ast& ast, const Expr& expr, std::string& variable,
+                        std::vector<AttributeQualifier>& qualifiers) {
+  if (expr.has_ident_expr() || expr.has_select_expr()) {
+    // Checked expressions refer to the resolved name of (possibly qualified)
+    // identifiers.
+    const Reference* reference = ast.GetReference(expr.id());
+    if (reference != nullptr && !reference->has_value()) {
+      variable = reference->name();
+      return true;
+    }
+  }
+  if (expr.has_ident_expr()) {
+    variable = expr.ident_expr().name();
+    return true;
+  }
+  if (expr.has_select_expr()) {
+    const SelectExpr& select = expr.select_expr();
+    if (select.test_only() ||
+        !BuildAttributePath(ast, select.operand(), variable, qualifiers)) {
+      return false;
+    }
+    qualifiers.push_back(AttributeQualifier::OfString(select.field()));
+    return true;
+  }
+  if (!expr.has_call_expr()) {
+    return false;
+  }
+  const CallExpr& call = expr.call_expr();
+  if (call.function() != builtin::kIndex || call.has_target() ||
+      call.args().size() != 2 || !call.args()[1].has_const_expr()) {
+    return false;
+  }
+  const Constant& key = call.args()[1].const_expr();
+  if (!key.has_int_value() && !key.has_uint_value() &&
+      !key.has_string_value() && !key.has_bool_value()) {
+    return false;
+  }
+  if (!BuildAttributePath(ast, call.args()[0], variable, qualifiers)) {
+    return false;
+  }
+  if (key.has_int_value()) {
+    qualifiers.push_back(AttributeQualifier::OfInt(key.int_value()));
+  } else if (key.has_uint_value()) {
+    qualifiers.push_back(AttributeQualifier::OfUint(key.uint_value()));
+  } else if (key.has_string_value()) {
+    qualifiers.push_back(AttributeQualifier::OfString(key.string_value()));
+  } else {
+    qualifiers.push_back(AttributeQualifier::OfBool(key.bool_value()));
+  }
+  return true;
+}
+
+// Folds the subexpressions with recorded values into literals, then
+// simplifies the operators which no longer depend on all of their operands.
+class ResidualRewriter : public AstRewriterBase {
+ public:
+  ResidualRewriter(const Ast& ast,
+                   const absl::flat_hash_map<int64_t, Value>& values,
+                   absl::Span<const AttributePattern> unknown_patterns,
+                   absl::Span<const AttributePattern> missing_patterns,
+                   const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
+                   google::protobuf::MessageFactory* absl_nonnull message_factory,
+                   google::protobuf::Arena* absl_nonnull arena, int64_t next_id)
+      : ast_(ast),
+        values_(values),
+        unknown_patterns_(unknown_patterns),
+        missing_patterns_(missing_patterns),
+        descriptor_pool_(descriptor_pool),
+        message_factory_(message_factory),
+        arena_(arena),
+        next_id_(next_id) {}
+
+  bool PreVisitRewrite(Expr& expr) override {
+    if (!status_.ok() || loop_depth_ > 0 || expr.has_const_expr()) {
+      return false;
+    }
+    auto it = values_.find(expr.id());
+    if (it == values_.end() || IsPatternQualified(expr)) {
+      return false;
+    }
+    Expr literal;
+    absl::StatusOr<bool> converted = ToLiteral(it->second, literal);
+    if (!converted.ok()) {
+      status_ = std::move(converted).status();
+      return false;
+    }
+    if (!*converted) {
+      return false;
+    }
+    literal.set_id(expr.id());
+    expr = std::move(literal);
+    folded_ids_.insert(expr.id());
+    return true;
+  }
+
+  bool PostVisitRewrite(Expr& expr) override {
+    if (!status_.ok() || !expr.has_call_expr()) {
+      return false;
+    }
+    const CallExpr& call = expr.call_expr();
+    if (call.function() == builtin::kTernary && call.args().size() == 3) {
+      const Expr& condition = call.args()[0];
+      if (!condition.has_const_expr() ||
+          !condition.const_expr().has_bool_value()) {
+        return false;
+      }
+      return ReplaceWithArg(expr, condition.const_expr().bool_value() ? 1 : 2);
+    }
+
+    bool identity;
+    if (call.function() == builtin::kAnd) {
+      identity = true;
+    } else if (call.function() == builtin::kOr) {
+      identity = false;
+    } else {
+      return false;
+    }
+    if (call.args().size() != 2) {
+      return false;
+    }
+    for (int i = 0; i < 2; ++i) {
+      const Expr& operand = call.args()[i];
+      if (operand.has_const_expr() && operand.const_expr().has_bool_value() &&
+          operand.const_expr().bool_value() == identity &&
+          IsBool(call.args()[1 - i])) {
+        return ReplaceWithArg(expr, 1 - i);
+      }
+    }
+    return false;
+  }
+
+  void PreVisitComprehensionSubexpression(
+      const Expr&, const ComprehensionExpr&,
+      ComprehensionArg comprehension_arg) override {
+    if (IsLoopScoped(comprehension_arg)) {
+      ++loop_depth_;
+    }
+  }
+
+  void PostVisitComprehensionSubexpression(
+      const Expr&, const ComprehensionExpr&,
+      ComprehensionArg comprehension_arg) override {
+    if (IsLoopScoped(comprehension_arg)) {
+      --loop_depth_;
+    }
+  }
+
+  const absl::Status& status() const { return status_; }
+
+  const absl::flat_hash_set<int64_t>& folded_ids() const {
+    return folded_ids_;
+  }
+
+ private:
+  // Builds the literal for `value` into `expr`, except for its id. Returns
+  // false if `value` has no literal representation.
+  absl::StatusOr<bool> ToLiteral(const Value& value, Expr& expr) {
+    switch (value.kind()) {
+      case ValueKind::kNull:
+        expr.mutable_const_expr().set_null_value();
+        return true;
+      case ValueKind::kBool:
+        expr.mutable_const_expr().set_bool_value(
+            value.GetBool().NativeValue());
+        return true;
+      case ValueKind::kInt:
+        expr.mutable_const_expr().set_int_value(value.GetInt().NativeValue());
+        return true;
+      case ValueKind::kUint:
+        expr.mutable_const_expr().set_uint_value(
+            value.GetUint().NativeValue());
+        return true;
+      case ValueKind::kDouble:
+        expr.mutable_const_expr().set_double_value(
+            value.GetDouble().NativeValue());
+        return true;
+      case ValueKind::kString:
+        expr.mutable_const_expr().set_string_value(
+            value.GetString().ToString());
+        return true;
+      case ValueKind::kBytes:
+        expr.mutable_const_expr().set_bytes_value(value.GetBytes().ToString());
+        return true;
+      case ValueKind::kList: {
+        ListExpr& list_expr = expr.mutable_list_expr();
+        bool supported = true;
+        CEL_RETURN_IF_ERROR(value.GetList().ForEach(
+            [&](const Value& element) -> absl::StatusOr<bool> {
+              Expr& element_expr = list_expr.add_elements().mutable_expr();
+              element_expr.set_id(next_id_++);
+              CEL_ASSIGN_OR_RETURN(supported,
+                                   ToLiteral(element, element_expr));
+              return supported;
+            },
+            descriptor_pool_, message_factory_, arena_));
+        return supported;
+      }
+      case ValueKind::kMap: {
+        MapExpr& map_expr = expr.mutable_map_expr();
+        bool supported = true;
+        CEL_RETURN_IF_ERROR(value.GetMap().ForEach(
+            [&](const Value& key, const Value& entry) -> absl::StatusOr<bool> {
+              MapExprEntry& entry_expr = map_expr.add_entries();
+              entry_expr.set_id(next_id_++);
+              entry_expr.mutable_key().set_id(next_id_++);
+              entry_expr.mutable_value().set_id(next_id_++);
+              CEL_ASSIGN_OR_RETURN(
+                  supported, ToLiteral(key, entry_expr.mutable_key()));
+              if (!supported) {
+                return false;
+              }
+              CEL_ASSIGN_OR_RETURN(
+                  supported, ToLiteral(entry, entry_expr.mutable_value()));
+              return supported;
+            },
+            descriptor_pool_, message_factory_, arena_));
+        return supported;
+      }
+      default:
+        return false;
+    }
+  }
+
+  // Whether `expr` is known to evaluate to a bool, error or unknown, in which
+  // case `true && expr` and `false || expr` are equivalent to `expr`.
+  bool IsBool(const Expr& expr) const {
+    if (expr.has_const_expr()) {
+      return expr.const_expr().has_bool_value();
+    }
+    const TypeSpec* type = ast_.GetType(expr.id());
+    return type != nullptr && type->has_primitive() &&
+           type->primitive() == PrimitiveType::kBool;
+  }
+
+  // Whether `expr` refers to an attribute that an unknown or missing pattern
+  // matches, or to a value containing one. The evaluator only checks the
+  // attributes it reads, so the recorded value may include the parts of the
+  // attribute that are unknown (e.g. the map `a` for the pattern `a.b`).
+  bool IsPatternQualified(const Expr& expr) const {
+    if (unknown_patterns_.empty() && missing_patterns_.empty()) {
+      return false;
+    }
+    std::string variable;
+    std::vector<AttributeQualifier> qualifiers;
+    if (!BuildAttributePath(ast_, expr, variable, qualifiers)) {
+      return false;
+    }
+    Attribute attribute(std::move(variable), std::move(qualifiers));
+    for (absl::Span<const AttributePattern> patterns :
+         {unknown_patterns_, missing_patterns_}) {
+      for (const AttributePattern& pattern : patterns) {
+        if (pattern.IsMatch(attribute) !=
+            AttributePattern::MatchType::NONE) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  static bool ReplaceWithArg(Expr& expr, int index) {
+    Expr arg = std::move(expr.mutable_call_expr().mutable_args()[index]);
+    expr = std::move(arg);
+    return true;
+  }
+
+  const Ast& ast_;
+  const absl::flat_hash_map<int64_t, Value>& values_;
+  absl::Span<const AttributePattern> unknown_patterns_;
+  absl::Span<const AttributePattern> missing_patterns_;
+  const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool_;
+  google::protobuf::MessageFactory* absl_nonnull message_factory_;
+  google::protobuf::Arena* absl_nonnull arena_;
+  int64_t next_id_;
+  int loop_depth_ = 0;
+  absl::flat_hash_set<int64_t> folded_ids_;
+  absl::Status status_;
+};
+
+// Drops the metadata of the expressions removed from `ast`, and the
+// references and macro calls of the ones replaced by literals.
+void PruneMetadata(Ast& ast, const absl::flat_hash_set<int64_t>& folded_ids) {
+  ExprIdCollector collector;
+  AstTraverse(ast.root_expr(), collector);
+  const auto& ids = collector.ids();
+  auto is_removed = [&](int64_t id) { return !ids.contains(id); };
+  auto is_removed_or_folded = [&](int64_t id) {
+    return !ids.contains(id) || folded_ids.contains(id);
+  };
+
+  absl::erase_if(ast.mutable_reference_map(), [&](const auto& entry) {
+    return is_removed_or_folded(entry.first);
+  });
+  absl::erase_if(ast.mutable_type_map(), [&](const auto& entry) {
+    return is_removed(entry.first);
+  });
+  absl::erase_if(ast.mutable_source_info().mutable_positions(),
+                 [&](const auto& entry) { return is_removed(entry.first); });
+  absl::erase_if(ast.mutable_source_info().mutable_macro_calls(),
+                 [&](const auto& entry) {
+                   return is_removed_or_folded(entry.first);
+                 });
+}
+
+}  // namespace
+
+absl::StatusOr<PartialEvaluationResult>
+PartialEvaluationProgram::PartiallyEvaluate(
+    google::protobuf::Arena* absl_nonnull arena,
+    google::protobuf::MessageFactory* absl_nullable message_factory,
+    const ActivationInterface& activation) const {
+  // Only values that may be folded are recorded. The pool and factory are the
+  // ones the evaluation used, which are needed to iterate lists and maps.
+  absl::flat_hash_map<int64_t, Value> values;
+  const google::protobuf::DescriptorPool* descriptor_pool = nullptr;
+  google::protobuf::MessageFactory* evaluation_message_factory = nullptr;
+  CEL_ASSIGN_OR_RETURN(
+      Value value,
+      program_->Trace(
+          arena, message_factory, activation,
+          [&](int64_t expr_id, const Value& node_value,
+              const google::protobuf::DescriptorPool* absl_nonnull pool,
+              google::protobuf::MessageFactory* absl_nonnull factory,
+              google::protobuf::Arena* absl_nonnull) -> absl::Status {
+            descriptor_pool = pool;
+            evaluation_message_factory = factory;
+            if (!node_value.IsUnknown() && !node_value.IsError()) {
+              values.insert_or_assign(expr_id, node_value);
+            }
+            return absl::OkStatus();
+          }));
+
+  PartialEvaluationResult result;
+  result.value = std::move(value);
+  result.residual = std::make_unique<Ast>(*ast_);
+  if (values.empty()) {
+    return result;
+  }
+  ResidualRewriter rewriter(*ast_, values, activation.GetUnknownAttributes(),
+                            activation.GetMissingAttributes(), descriptor_pool,
+                            evaluation_message_factory, arena, next_id_);
+  RewriteTraversalOptions options;
+  options.use_comprehension_callbacks = true;
+  AstRewrite(result.residual->mutable_root_expr(), rewriter, options);
+  CEL_RETURN_IF_ERROR(rewriter.status());
+  PruneMetadata(*result.residual, rewriter.folded_ids());
+  return result;
+}
+
+absl::StatusOr<std::unique_ptr<PartialEvaluationProgram>>
+CreatePartialEvaluationProgram(const Runtime& runtime,
+                               std::unique_ptr<Ast> ast) {
+  if (ast == nullptr) {
+    return absl::InvalidArgumentError("ast must not be null");
+  }
+
+  int64_t max_id = 0;
+  ExprIdCollector collector;
+  AstTraverse(ast->root_expr(), collector);
+  for (int64_t id : collector.ids()) {
+    max_id = std::max(max_id, id);
+  }
+  for (const auto& [id, macro_call] : ast->source_info().macro_calls()) {
+    max_id = std::max(max_id, id);
+  }
+
+  auto planned_ast = std::make_unique<Ast>(*ast);
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<TraceableProgram> program,
+                       runtime.CreateTraceableProgram(std::move(planned_ast)));
+  return absl::WrapUnique(new PartialEvaluationProgram(
+      std::move(ast), std::move(program), max_id + 1));
+}
+
+}  // namespace cel::extensions
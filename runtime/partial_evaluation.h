@@ -0,0 +1,133 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_PARTIAL_EVALUATION_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_PARTIAL_EVALUATION_H_
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/base/attributes.h"
+#include "absl/base/nullability.h"
+#include "absl/status/statusor.h"
+#include "base/ast.h"
+#include "base/type_provider.h"
+#include "common/value.h"
+#include "runtime/activation_interface.h"
+#include "runtime/runtime.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/message.h"
+
+namespace cel::extensions {
+
+struct PartialEvaluationResult {
+  // The result of evaluating the expression, usually an `UnknownValue` if the
+  // activation declares unknown attribute patterns.
+  Value value;
+
+  // The expression with every subexpression that evaluated to a value with a
+  // literal representation replaced by that literal.
+  //
+  // Evaluating the residual against an activation that agrees with the
+  // partial one on its known variables gives the same result as evaluating
+  // the original expression. It is checked if the original one was.
+  std::unique_ptr<Ast> residual;
+};
+
+// A Program that can additionally produce a residual expression, which only
+// retains the parts of the expression that depend on unknown attributes or
+// function results.
+//
+// Subexpressions which evaluate to null, bool, int, uint, double, string or
+// bytes values, or to lists and maps of those, are folded into literals.
+// Other values (e.g. messages), errors and unknowns are not, in which case the
+// subexpression is kept and its operands are folded instead. Subexpressions
+// which are evaluated once per iteration of a comprehension (its condition and
+// step) are never folded. Neither are identifiers, selections and indexes
+// which refer to an attribute that an unknown or missing pattern of the
+// activation qualifies (e.g. `a` and `a.b` for the pattern `a.b.c`), since
+// their values are only partially known.
+// Logical operators with a folded operand that doesn't decide the result are
+// replaced by the other operand if the checked type of that operand is bool,
+// and conditionals with a folded condition are replaced by the selected
+// branch.
+//
+// The runtime must enable unknown processing (see
+// `RuntimeOptions::unknown_processing`), otherwise evaluations never produce
+// unknowns and the residual is a literal or retains the errors instead.
+//
+// Thread-safe if the wrapped program is.
+class PartialEvaluationProgram final : public Program {
+ public:
+  using Program::Evaluate;
+
+  absl::StatusOr<Value> Evaluate(
+      google::protobuf::Arena* absl_nonnull arena ABSL_ATTRIBUTE_LIFETIME_BOUND,
+      google::protobuf::MessageFactory* absl_nullable message_factory
+          ABSL_ATTRIBUTE_LIFETIME_BOUND,
+      const ActivationInterface& activation) const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND override {
+    return program_->Evaluate(arena, message_factory, activation);
+  }
+
+  const TypeProvider& GetTypeProvider() const override {
+    return program_->GetTypeProvider();
+  }
+
+  // Evaluates the expression and builds the residual expression for
+  // `activation`.
+  absl::StatusOr<PartialEvaluationResult> PartiallyEvaluate(
+      google::protobuf::Arena* absl_nonnull arena ABSL_ATTRIBUTE_LIFETIME_BOUND,
+      google::protobuf::MessageFactory* absl_nullable message_factory
+          ABSL_ATTRIBUTE_LIFETIME_BOUND,
+      const ActivationInterface& activation) const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND;
+
+  absl::StatusOr<PartialEvaluationResult> PartiallyEvaluate(
+      google::protobuf::Arena* absl_nonnull arena ABSL_ATTRIBUTE_LIFETIME_BOUND,
+      const ActivationInterface& activation) const
+      ABSL_ATTRIBUTE_LIFETIME_BOUND {
+    return PartiallyEvaluate(arena, /*message_factory=*/nullptr, activation);
+  }
+
+  // The planned expression.
+  const Ast& ast() const { return *ast_; }
+
+ private:
+  friend absl::StatusOr<std::unique_ptr<PartialEvaluationProgram>>
+  CreatePartialEvaluationProgram(const Runtime& runtime,
+                                 std::unique_ptr<Ast> ast);
+
+  PartialEvaluationProgram(std::unique_ptr<Ast> ast,
+                           std::unique_ptr<TraceableProgram> program,
+                           int64_t next_id)
+      : ast_(std::move(ast)), program_(std::move(program)), next_id_(next_id) {}
+
+  std::unique_ptr<const Ast> ast_;
+  std::unique_ptr<TraceableProgram> program_;
+  // Smallest id not used by `ast_`, for the literals of folded lists and maps.
+  int64_t next_id_;
+};
+
+// Plan `ast` with `runtime` as a program which can be partially evaluated.
+//
+// The runtime must outlive the returned program.
+absl::StatusOr<std::unique_ptr<PartialEvaluationProgram>>
+CreatePartialEvaluationProgram(const Runtime& runtime,
+                               std::unique_ptr<Ast> ast);
+
+}  // namespace cel::extensions
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_PARTIAL_EVALUATION_H_
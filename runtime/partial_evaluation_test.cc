@@ -0,0 +1,356 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/partial_evaluation.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "cel/expr/checked.pb.h"
+#include "cel/expr/syntax.pb.h"
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "base/ast.h"
+#include "base/attribute.h"
+#include "checker/standard_library.h"
+#include "checker/validation_result.h"
+#include "common/ast_proto.h"
+#include "common/decl.h"
+#include "common/expr.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "compiler/compiler.h"
+#include "compiler/compiler_factory.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::extensions {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::cel::expr::CheckedExpr;
+using ::cel::expr::ParsedExpr;
+using ::cel::test::BoolValueIs;
+using ::cel::test::ErrorValueIs;
+using ::cel::test::IntValueIs;
+using ::google::api::expr::parser::Parse;
+using ::testing::_;
+using ::testing::SizeIs;
+
+absl::StatusOr<std::unique_ptr<Ast>> ParseAst(absl::string_view expression) {
+  CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+  return CreateAstFromParsedExpr(parsed_expr);
+}
+
+absl::StatusOr<std::unique_ptr<Ast>> CompileAst(absl::string_view expression) {
+  CEL_ASSIGN_OR_RETURN(auto builder,
+                       NewCompilerBuilder(internal::GetTestingDescriptorPool()));
+  CEL_RETURN_IF_ERROR(builder->AddLibrary(StandardCheckerLibrary()));
+  CEL_RETURN_IF_ERROR(
+      builder->GetCheckerBuilder().AddVariable(MakeVariableDecl("x", IntType())));
+  CEL_RETURN_IF_ERROR(
+      builder->GetCheckerBuilder().AddVariable(MakeVariableDecl("y", BoolType())));
+  CEL_RETURN_IF_ERROR(
+      builder->GetCheckerBuilder().AddVariable(MakeVariableDecl("z", IntType())));
+  CEL_RETURN_IF_ERROR(
+      builder->GetCheckerBuilder().AddVariable(MakeVariableDecl("m", MapType())));
+  CEL_ASSIGN_OR_RETURN(auto compiler, std::move(*builder).Build());
+  CEL_ASSIGN_OR_RETURN(ValidationResult result, compiler->Compile(expression));
+  if (!result.IsValid()) {
+    return absl::InvalidArgumentError(result.FormatError());
+  }
+  return result.ReleaseAst();
+}
+
+class PartialEvaluationTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    RuntimeOptions options;
+    options.unknown_processing = UnknownProcessingOptions::kAttributeAndFunction;
+    ASSERT_OK_AND_ASSIGN(
+        RuntimeBuilder builder,
+        CreateStandardRuntimeBuilder(internal::GetTestingDescriptorPool(),
+                                     options));
+    ASSERT_OK_AND_ASSIGN(runtime_, std::move(builder).Build());
+  }
+
+  // Partially evaluates `ast` with `x` bound to 10, `m` bound to
+  // `{'bar': 1}`, and `y`, `z` and the attributes matching
+  // `extra_unknown_patterns` unknown.
+  absl::StatusOr<PartialEvaluationResult> PartiallyEvaluate(
+      std::unique_ptr<Ast> ast,
+      std::vector<AttributePattern> extra_unknown_patterns = {}) {
+    CEL_ASSIGN_OR_RETURN(program_,
+                         CreatePartialEvaluationProgram(*runtime_,
+                                                        std::move(ast)));
+    Activation activation;
+    activation.InsertOrAssignValue("x", IntValue(10));
+    activation.InsertOrAssignValue("m", MakeMap(/*foo=*/absl::nullopt));
+    std::vector<AttributePattern> unknown_patterns = {
+        AttributePattern("y", {}), AttributePattern("z", {})};
+    for (AttributePattern& pattern : extra_unknown_patterns) {
+      unknown_patterns.push_back(std::move(pattern));
+    }
+    activation.SetUnknownPatterns(std::move(unknown_patterns));
+    return program_->PartiallyEvaluate(&arena_, activation);
+  }
+
+  // Builds `{'bar': 1}`, with `'foo': foo` added if `foo` is set.
+  Value MakeMap(absl::optional<int64_t> foo) {
+    auto builder = NewMapValueBuilder(&arena_);
+    ABSL_CHECK_OK(builder->Put(StringValue("bar"), IntValue(1)));
+    if (foo.has_value()) {
+      ABSL_CHECK_OK(builder->Put(StringValue("foo"), IntValue(*foo)));
+    }
+    return std::move(*builder).Build();
+  }
+
+  // Evaluates `residual`, after a round trip through its proto
+  // representation, and the original expression with `y` and `z` bound and
+  // `m` bound to `{'bar': 1, 'foo': z}`. Returns the result of the residual,
+  // after checking that it matches.
+  absl::StatusOr<Value> EvaluateResidual(const Ast& residual, bool y,
+                                         int64_t z) {
+    std::unique_ptr<Ast> round_tripped;
+    if (residual.is_checked()) {
+      CheckedExpr checked_expr;
+      CEL_RETURN_IF_ERROR(AstToCheckedExpr(residual, &checked_expr));
+      CEL_ASSIGN_OR_RETURN(round_tripped,
+                           CreateAstFromCheckedExpr(checked_expr));
+    } else {
+      ParsedExpr parsed_expr;
+      CEL_RETURN_IF_ERROR(AstToParsedExpr(residual, &parsed_expr));
+      CEL_ASSIGN_OR_RETURN(round_tripped,
+                           CreateAstFromParsedExpr(parsed_expr));
+    }
+    CEL_ASSIGN_OR_RETURN(auto residual_program,
+                         runtime_->CreateProgram(std::move(round_tripped)));
+
+    Activation activation;
+    activation.InsertOrAssignValue("y", BoolValue(y));
+    activation.InsertOrAssignValue("z", IntValue(z));
+    activation.InsertOrAssignValue("m", MakeMap(z));
+    CEL_ASSIGN_OR_RETURN(Value residual_value,
+                         residual_program->Evaluate(&arena_, activation));
+
+    activation.InsertOrAssignValue("x", IntValue(10));
+    CEL_ASSIGN_OR_RETURN(Value value, program_->Evaluate(&arena_, activation));
+    if (residual_value.DebugString() != value.DebugString()) {
+      return absl::InternalError(
+          absl::StrCat("residual evaluated to ", residual_value.DebugString(),
+                       ", expected ", value.DebugString()));
+    }
+    return residual_value;
+  }
+
+  google::protobuf::Arena arena_;
+  std::unique_ptr<Runtime> runtime_;
+  std::unique_ptr<PartialEvaluationProgram> program_;
+};
+
+TEST_F(PartialEvaluationTest, FoldsKnownOperands) {
+  ASSERT_OK_AND_ASSIGN(auto ast, CompileAst("x + 1 > 5 && y"));
+  ASSERT_OK_AND_ASSIGN(PartialEvaluationResult result,
+                       PartiallyEvaluate(std::move(ast)));
+
+  EXPECT_TRUE(result.value.IsUnknown());
+  const Expr& root = result.residual->root_expr();
+  ASSERT_TRUE(root.has_ident_expr());
+  EXPECT_EQ(root.ident_expr().name(), "y");
+  EXPECT_TRUE(result.residual->is_checked());
+  // Only the reference to `y` is left.
+  EXPECT_THAT(result.residual->reference_map(), SizeIs(1));
+
+  EXPECT_THAT(EvaluateResidual(*result.residual, true, 0),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(EvaluateResidual(*result.residual, false, 0),
+              IsOkAndHolds(BoolValueIs(false)));
+}
+
+TEST_F(PartialEvaluationTest, SelectsConditionalBranch) {
+  ASSERT_OK_AND_ASSIGN(auto ast, CompileAst("x > 5 ? z * 2 : z + x"));
+  ASSERT_OK_AND_ASSIGN(PartialEvaluationResult result,
+                       PartiallyEvaluate(std::move(ast)));
+
+  EXPECT_TRUE(result.value.IsUnknown());
+  const Expr& root = result.residual->root_expr();
+  ASSERT_TRUE(root.has_call_expr());
+  EXPECT_EQ(root.call_expr().function(), "_*_");
+
+  EXPECT_THAT(EvaluateResidual(*result.residual, false, 3),
+              IsOkAndHolds(IntValueIs(6)));
+}
+
+TEST_F(PartialEvaluationTest, KeepsLogicalOperatorsOfParsedExpressions) {
+  // Without types, `y` might not be a bool, in which case `true && y` is an
+  // error rather than `y`.
+  ASSERT_OK_AND_ASSIGN(auto ast, ParseAst("x > 5 && y"));
+  ASSERT_OK_AND_ASSIGN(PartialEvaluationResult result,
+                       PartiallyEvaluate(std::move(ast)));
+
+  EXPECT_TRUE(result.value.IsUnknown());
+  const Expr& root = result.residual->root_expr();
+  ASSERT_TRUE(root.has_call_expr());
+  ASSERT_THAT(root.call_expr().args(), SizeIs(2));
+  EXPECT_TRUE(root.call_expr().args()[0].const_expr().bool_value());
+  EXPECT_TRUE(root.call_expr().args()[1].has_ident_expr());
+
+  EXPECT_THAT(EvaluateResidual(*result.residual, true, 0),
+              IsOkAndHolds(BoolValueIs(true)));
+}
+
+TEST_F(PartialEvaluationTest, FoldsListsAndMaps) {
+  ASSERT_OK_AND_ASSIGN(
+      auto ast, CompileAst("[x, x + 1].exists(e, e == z) || z in {x: 'ten'}"));
+  ASSERT_OK_AND_ASSIGN(PartialEvaluationResult result,
+                       PartiallyEvaluate(std::move(ast)));
+
+  EXPECT_TRUE(result.value.IsUnknown());
+  const Expr& root = result.residual->root_expr();
+  ASSERT_TRUE(root.has_call_expr());
+  const Expr& exists = root.call_expr().args()[0];
+  ASSERT_TRUE(exists.has_comprehension_expr());
+  const Expr& range = exists.comprehension_expr().iter_range();
+  ASSERT_TRUE(range.has_list_expr());
+  ASSERT_THAT(range.list_expr().elements(), SizeIs(2));
+  EXPECT_EQ(range.list_expr().elements()[1].expr().const_expr().int_value(),
+            11);
+  const Expr& in = root.call_expr().args()[1];
+  ASSERT_TRUE(in.has_call_expr());
+  EXPECT_TRUE(in.call_expr().args()[1].has_map_expr());
+
+  EXPECT_THAT(EvaluateResidual(*result.residual, false, 11),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(EvaluateResidual(*result.residual, false, 10),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(EvaluateResidual(*result.residual, false, 12),
+              IsOkAndHolds(BoolValueIs(false)));
+}
+
+TEST_F(PartialEvaluationTest, KeepsErrors) {
+  ASSERT_OK_AND_ASSIGN(auto ast, CompileAst("x / 0 == 1 || y"));
+  ASSERT_OK_AND_ASSIGN(PartialEvaluationResult result,
+                       PartiallyEvaluate(std::move(ast)));
+
+  EXPECT_TRUE(result.value.IsUnknown());
+  EXPECT_THAT(EvaluateResidual(*result.residual, true, 0),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(EvaluateResidual(*result.residual, false, 0),
+              IsOkAndHolds(ErrorValueIs(_)));
+}
+
+TEST_F(PartialEvaluationTest, FoldsKnownResult) {
+  ASSERT_OK_AND_ASSIGN(auto ast, CompileAst("[x, x * 2].map(e, e + 1)"));
+  ASSERT_OK_AND_ASSIGN(PartialEvaluationResult result,
+                       PartiallyEvaluate(std::move(ast)));
+
+  EXPECT_FALSE(result.value.IsUnknown());
+  const Expr& root = result.residual->root_expr();
+  ASSERT_TRUE(root.has_list_expr());
+  EXPECT_THAT(root.list_expr().elements(), SizeIs(2));
+  EXPECT_TRUE(result.residual->source_info().macro_calls().empty());
+}
+
+AttributePattern MFooPattern() {
+  return AttributePattern("m", {AttributeQualifierPattern::OfString("foo")});
+}
+
+TEST_F(PartialEvaluationTest, KeepsPartiallyUnknownSelects) {
+  ASSERT_OK_AND_ASSIGN(auto ast, CompileAst("m.foo == z && m.bar == 1"));
+  ASSERT_OK_AND_ASSIGN(
+      PartialEvaluationResult result,
+      PartiallyEvaluate(std::move(ast), {MFooPattern()}));
+
+  EXPECT_TRUE(result.value.IsUnknown());
+  // `m` is recorded as `{'bar': 1}`, but is not folded since `m.foo` is
+  // unknown.
+  const Expr& root = result.residual->root_expr();
+  ASSERT_TRUE(root.has_call_expr());
+  EXPECT_EQ(root.call_expr().function(), "_==_");
+  const Expr& select = root.call_expr().args()[0];
+  ASSERT_TRUE(select.has_select_expr());
+  EXPECT_TRUE(select.select_expr().operand().has_ident_expr());
+
+  EXPECT_THAT(EvaluateResidual(*result.residual, false, 3),
+              IsOkAndHolds(BoolValueIs(true)));
+}
+
+TEST_F(PartialEvaluationTest, KeepsPartiallyUnknownIndexes) {
+  ASSERT_OK_AND_ASSIGN(auto ast,
+                       CompileAst("m['foo'] + x == z || m['bar'] == 2"));
+  ASSERT_OK_AND_ASSIGN(
+      PartialEvaluationResult result,
+      PartiallyEvaluate(std::move(ast), {MFooPattern()}));
+
+  EXPECT_TRUE(result.value.IsUnknown());
+  const Expr& root = result.residual->root_expr();
+  ASSERT_TRUE(root.has_call_expr());
+  EXPECT_EQ(root.call_expr().function(), "_==_");
+  const Expr& add = root.call_expr().args()[0];
+  ASSERT_TRUE(add.has_call_expr());
+  const Expr& index = add.call_expr().args()[0];
+  ASSERT_TRUE(index.has_call_expr());
+  EXPECT_TRUE(index.call_expr().args()[0].has_ident_expr());
+  EXPECT_EQ(add.call_expr().args()[1].const_expr().int_value(), 10);
+
+  EXPECT_THAT(EvaluateResidual(*result.residual, false, 3),
+              IsOkAndHolds(BoolValueIs(false)));
+}
+
+TEST_F(PartialEvaluationTest, FoldsUnqualifiedSiblings) {
+  // Only `m.foo` is unknown, so `m.bar` is folded.
+  ASSERT_OK_AND_ASSIGN(auto ast, CompileAst("m.bar + z"));
+  ASSERT_OK_AND_ASSIGN(
+      PartialEvaluationResult result,
+      PartiallyEvaluate(std::move(ast), {MFooPattern()}));
+
+  EXPECT_TRUE(result.value.IsUnknown());
+  const Expr& root = result.residual->root_expr();
+  ASSERT_TRUE(root.has_call_expr());
+  EXPECT_EQ(root.call_expr().args()[0].const_expr().int_value(), 1);
+
+  EXPECT_THAT(EvaluateResidual(*result.residual, false, 3),
+              IsOkAndHolds(IntValueIs(4)));
+}
+
+TEST(CreatePartialEvaluationProgramTest, RejectsNullAst) {
+  ASSERT_OK_AND_ASSIGN(
+      auto builder,
+      CreateStandardRuntimeBuilder(internal::GetTestingDescriptorPool(),
+                                   RuntimeOptions()));
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  EXPECT_THAT(CreatePartialEvaluationProgram(*runtime, nullptr),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace cel::extensions
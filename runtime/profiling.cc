@@ -0,0 +1,101 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/profiling.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "absl/base/nullability.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "base/ast.h"
+#include "common/native_type.h"
+#include "common/value.h"
+#include "eval/compiler/flat_expr_builder_extensions.h"
+#include "eval/compiler/profiling.h"
+#include "internal/casts.h"
+#include "internal/status_macros.h"
+#include "runtime/activation_interface.h"
+#include "runtime/evaluation_profile.h"
+#include "runtime/internal/runtime_friend_access.h"
+#include "runtime/internal/runtime_impl.h"
+#include "runtime/runtime.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/message.h"
+
+namespace cel::extensions {
+
+using ::cel::internal::down_cast;
+using ::cel::runtime_internal::RuntimeFriendAccess;
+using ::cel::runtime_internal::RuntimeImpl;
+using ::google::api::expr::runtime::CreateProfilingExtension;
+using ::google::api::expr::runtime::ProgramOptimizerFactory;
+
+absl::StatusOr<Value> ProfiledProgram::Evaluate(
+    google::protobuf::Arena* absl_nonnull arena,
+    google::protobuf::MessageFactory* absl_nullable message_factory,
+    const ActivationInterface& activation) const {
+  // Drop the starts of nodes abandoned if evaluation fails with a status.
+  size_t depth = EvaluationProfile::ActiveDepth();
+  absl::StatusOr<Value> result =
+      program_->Evaluate(arena, message_factory, activation);
+  EvaluationProfile::Unwind(depth);
+  return result;
+}
+
+absl::StatusOr<std::unique_ptr<ProfiledProgram>> CreateProfiledProgram(
+    const Runtime& runtime, std::unique_ptr<Ast> ast,
+    const Runtime::CreateProgramOptions& options,
+    const ProfilingOptions& profiling_options) {
+  if (ast == nullptr) {
+    return absl::InvalidArgumentError("ast must not be null");
+  }
+  if (RuntimeFriendAccess::RuntimeTypeId(runtime) !=
+      NativeTypeId::For<RuntimeImpl>()) {
+    return absl::UnimplementedError(
+        "profiling only supported on the default cel::Runtime "
+        "implementation.");
+  }
+  const auto& runtime_impl = down_cast<const RuntimeImpl&>(runtime);
+
+  // The profile is created from the ast after any ast transforms are applied
+  // so that rewritten nodes are attributed correctly.
+  auto profile = std::make_shared<std::shared_ptr<EvaluationProfile>>();
+  ProgramOptimizerFactory extension =
+      CreateProfilingExtension(
+          [profile](const Ast& ast) {
+            *profile = std::make_shared<EvaluationProfile>(ast);
+            return *profile;
+          },
+          profiling_options.track_allocations);
+  CEL_ASSIGN_OR_RETURN(
+      std::unique_ptr<Program> program,
+      runtime_impl.CreateTraceableProgram(std::move(ast), options,
+                                          absl::MakeConstSpan(&extension, 1)));
+  if (*profile == nullptr) {
+    return absl::InternalError("profiling extension was not applied");
+  }
+  // Optimizers may evaluate parts of the plan while planning (e.g. constant
+  // folding).
+  (*profile)->Clear();
+
+  return absl::WrapUnique(
+      new ProfiledProgram(std::move(program), std::move(*profile)));
+}
+
+}  // namespace cel::extensions
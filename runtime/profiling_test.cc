@@ -0,0 +1,215 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/profiling.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cel/expr/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "base/ast.h"
+#include "common/ast_proto.h"
+#include "common/value.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/evaluation_profile.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::extensions {
+namespace {
+
+using ::absl_testing::StatusIs;
+using ::cel::expr::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+using ::testing::Contains;
+
+absl::StatusOr<std::unique_ptr<Ast>> ParseAst(absl::string_view expression) {
+  CEL_ASSIGN_OR_RETURN(ParsedExpr parsed_expr, Parse(expression));
+  return CreateAstFromParsedExpr(parsed_expr);
+}
+
+absl::StatusOr<std::unique_ptr<Runtime>> NewRuntime(bool recursive) {
+  RuntimeOptions options;
+  if (recursive) {
+    options.max_recursion_depth = -1;
+  }
+  CEL_ASSIGN_OR_RETURN(RuntimeBuilder builder,
+                       CreateStandardRuntimeBuilder(
+                           internal::GetTestingDescriptorPool(), options));
+  return std::move(builder).Build();
+}
+
+const NodeProfile* FindNode(const std::vector<NodeProfile>& nodes,
+                            absl::string_view label) {
+  for (const NodeProfile& node : nodes) {
+    if (node.label == label) {
+      return &node;
+    }
+  }
+  return nullptr;
+}
+
+class ProfilingTest : public testing::TestWithParam<bool> {
+ protected:
+  bool recursive() const { return GetParam(); }
+};
+
+TEST_P(ProfilingTest, CountsEvaluations) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, NewRuntime(recursive()));
+  ASSERT_OK_AND_ASSIGN(
+      auto ast, ParseAst("[1, 2, 3].map(x, x * y).size() == 3 &&\n"
+                         "  s.startsWith('a')"));
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       CreateProfiledProgram(*runtime, std::move(ast)));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  activation.InsertOrAssignValue("y", IntValue(2));
+  activation.InsertOrAssignValue("s", StringValue("abc"));
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena, activation));
+    ASSERT_TRUE(result.IsBool() && result.GetBool().NativeValue());
+  }
+
+  std::vector<NodeProfile> nodes = program->profile().nodes();
+  const NodeProfile* conjunction = FindNode(nodes, "_&&_");
+  ASSERT_NE(conjunction, nullptr);
+  EXPECT_EQ(conjunction->calls, 4);
+  EXPECT_EQ(conjunction->location.line, 1);
+
+  const NodeProfile* multiply = FindNode(nodes, "_*_");
+  ASSERT_NE(multiply, nullptr);
+  EXPECT_EQ(multiply->calls, 12);
+
+  const NodeProfile* starts_with = FindNode(nodes, "startsWith");
+  ASSERT_NE(starts_with, nullptr);
+  EXPECT_EQ(starts_with->calls, 4);
+  EXPECT_EQ(starts_with->location.line, 2);
+
+  // Constants aren't profiled.
+  const NodeProfile* constant = FindNode(nodes, "const");
+  ASSERT_NE(constant, nullptr);
+  EXPECT_EQ(constant->calls, 0);
+
+  for (const NodeProfile& node : nodes) {
+    EXPECT_LE(node.self_time, node.total_time) << node.label;
+    EXPECT_LE(node.self_allocated_bytes, node.total_allocated_bytes)
+        << node.label;
+  }
+  EXPECT_GT(conjunction->total_time, absl::ZeroDuration());
+  EXPECT_GE(conjunction->total_time, starts_with->total_time);
+
+  program->ClearProfile();
+  EXPECT_EQ(FindNode(program->profile().nodes(), "_&&_")->calls, 0);
+}
+
+TEST_P(ProfilingTest, TracksAllocationsIfEnabled) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, NewRuntime(recursive()));
+  for (bool track_allocations : {false, true}) {
+    ASSERT_OK_AND_ASSIGN(auto ast,
+                         ParseAst("[1, 2, 3].map(x, string(x) + s).size()"));
+    ProfilingOptions profiling_options;
+    profiling_options.track_allocations = track_allocations;
+    ASSERT_OK_AND_ASSIGN(
+        auto program,
+        CreateProfiledProgram(*runtime, std::move(ast),
+                              Runtime::CreateProgramOptions(),
+                              profiling_options));
+
+    google::protobuf::Arena arena;
+    Activation activation;
+    activation.InsertOrAssignValue(
+        "s", StringValue("a string that is too long to be stored inline"));
+    ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena, activation));
+    ASSERT_TRUE(result.IsInt() && result.GetInt().NativeValue() == 3);
+
+    const NodeProfile* size = FindNode(program->profile().nodes(), "size");
+    ASSERT_NE(size, nullptr);
+    EXPECT_EQ(size->calls, 1);
+    if (track_allocations) {
+      EXPECT_GT(size->total_allocated_bytes, 0);
+    } else {
+      EXPECT_EQ(size->total_allocated_bytes, 0);
+    }
+  }
+}
+
+TEST_P(ProfilingTest, SkipsShortCircuitedOperands) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, NewRuntime(recursive()));
+  ASSERT_OK_AND_ASSIGN(auto ast, ParseAst("s == 'x' && s.startsWith('a')"));
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       CreateProfiledProgram(*runtime, std::move(ast)));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  activation.InsertOrAssignValue("s", StringValue("abc"));
+  ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena, activation));
+  ASSERT_TRUE(result.IsBool() && !result.GetBool().NativeValue());
+
+  std::vector<NodeProfile> nodes = program->profile().nodes();
+  EXPECT_EQ(FindNode(nodes, "_==_")->calls, 1);
+  EXPECT_EQ(FindNode(nodes, "startsWith")->calls, 0);
+}
+
+TEST_P(ProfilingTest, FormatsFoldedStacks) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, NewRuntime(recursive()));
+  ASSERT_OK_AND_ASSIGN(auto ast, ParseAst("x * 2 == 5 || c"));
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       CreateProfiledProgram(*runtime, std::move(ast)));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  activation.InsertOrAssignValue("x", IntValue(2));
+  activation.InsertOrAssignValue("c", BoolValue(true));
+  ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena, activation));
+  ASSERT_TRUE(result.IsBool() && result.GetBool().NativeValue());
+
+  std::vector<std::string> stacks;
+  for (absl::string_view line :
+       absl::StrSplit(program->profile().FormatFoldedStacks(), '\n',
+                      absl::SkipEmpty())) {
+    std::vector<std::string> parts = absl::StrSplit(line, ' ');
+    ASSERT_EQ(parts.size(), 2) << line;
+    stacks.push_back(parts[0]);
+  }
+  EXPECT_THAT(stacks, Contains("_||_@1:11"));
+  EXPECT_THAT(stacks, Contains("_||_@1:11;_==_@1:6;_*_@1:2;x@1:0"));
+  EXPECT_THAT(stacks, Contains("_||_@1:11;c@1:14"));
+}
+
+INSTANTIATE_TEST_SUITE_P(ProfilingTest, ProfilingTest, testing::Bool());
+
+TEST(Profiling, NullAst) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, NewRuntime(/*recursive=*/false));
+  EXPECT_THAT(CreateProfiledProgram(*runtime, nullptr),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace cel::extensions
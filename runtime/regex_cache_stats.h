@@ -0,0 +1,40 @@
+// Copyright 2025 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_REGEX_CACHE_STATS_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_REGEX_CACHE_STATS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cel {
+
+// Counters of the cache of compiled regular expressions used by the regex
+// functions for patterns which are not constant.
+//
+// See `RuntimeOptions::regex_cache_capacity`.
+struct RegexCacheStats {
+  // Lookups served by a cached program.
+  uint64_t hits = 0;
+  // Lookups which compiled the pattern.
+  uint64_t misses = 0;
+  // Programs dropped to make room for another one.
+  uint64_t evictions = 0;
+  // Number of cached programs.
+  size_t size = 0;
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_REGEX_CACHE_STATS_H_
@@ -17,6 +17,7 @@
 #ifndef THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_H_
 #define THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <utility>
@@ -27,6 +28,7 @@
 #include "absl/functional/any_invocable.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
 #include "base/ast.h"
 #include "base/type_provider.h"
 #include "common/native_type.h"
@@ -80,6 +82,47 @@ class Program {
     return Evaluate(arena, /*message_factory=*/nullptr, activation);
   }
 
+  // Evaluate the program against each activation in `activations`.
+  //
+  // The result for `activations[i]` is written to `results[i]`. The two spans
+  // must be the same size.
+  //
+  // Implementations may reuse evaluation state (e.g. the value stack and
+  // comprehension slots) across the batch, which amortizes per-call setup for
+  // programs evaluated against many inputs.
+  //
+  // Non-recoverable errors stop the batch and are returned immediately.
+  // Results for activations that were not evaluated are left unmodified.
+  //
+  // All results are allocated on `arena`, which must outlive them.
+  virtual absl::Status EvaluateBatch(
+      google::protobuf::Arena* absl_nonnull arena ABSL_ATTRIBUTE_LIFETIME_BOUND,
+      google::protobuf::MessageFactory* absl_nullable message_factory
+          ABSL_ATTRIBUTE_LIFETIME_BOUND,
+      absl::Span<const ActivationInterface* const> activations,
+      absl::Span<Value> results) const {
+    if (activations.size() != results.size()) {
+      return absl::InvalidArgumentError(
+          "EvaluateBatch: activations and results must be the same size");
+    }
+    for (size_t i = 0; i < activations.size(); ++i) {
+      absl::StatusOr<Value> result =
+          Evaluate(arena, message_factory, *activations[i]);
+      if (!result.ok()) {
+        return std::move(result).status();
+      }
+      results[i] = *std::move(result);
+    }
+    return absl::OkStatus();
+  }
+  absl::Status EvaluateBatch(
+      google::protobuf::Arena* absl_nonnull arena ABSL_ATTRIBUTE_LIFETIME_BOUND,
+      absl::Span<const ActivationInterface* const> activations,
+      absl::Span<Value> results) const {
+    return EvaluateBatch(arena, /*message_factory=*/nullptr, activations,
+                         results);
+  }
+
   virtual const TypeProvider& GetTypeProvider() const = 0;
 };
 
@@ -15,9 +15,11 @@
 #ifndef THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_ISSUE_H_
 #define THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_ISSUE_H_
 
+#include <string>
 #include <utility>
 
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
 
 namespace cel {
 
@@ -31,11 +33,16 @@ class RuntimeIssue {
   //
   // Can be used to determine whether to continue program planning or return
   // early.
+  //
+  // The numeric values are stable and not ordered by severity.
   enum class Severity {
     // The issue may lead to runtime errors in evaluation.
     kWarning = 0,
     // The expression is invalid or unsupported.
     kError = 1,
+    // Informational note about how the expression was planned. Never fails
+    // planning.
+    kInformation = 2,
     // Arbitrary max value above Error.
     kNotForUseWithExhaustiveSwitchStatements = 15
   };
@@ -60,6 +67,15 @@ class RuntimeIssue {
     return RuntimeIssue(std::move(status), Severity::kWarning, error_code);
   }
 
+  // Informational issues are not errors: they carry a message and their
+  // status is OK.
+  static RuntimeIssue CreateInformation(std::string message) {
+    RuntimeIssue issue(absl::OkStatus(), Severity::kInformation,
+                       ErrorCode::kOther);
+    issue.message_ = std::move(message);
+    return issue;
+  }
+
   RuntimeIssue(const RuntimeIssue& other) = default;
   RuntimeIssue& operator=(const RuntimeIssue& other) = default;
   RuntimeIssue(RuntimeIssue&& other) = default;
@@ -72,6 +88,11 @@ class RuntimeIssue {
   const absl::Status& ToStatus() const& { return status_; }
   absl::Status ToStatus() && { return std::move(status_); }
 
+  // Human readable description of the issue.
+  absl::string_view message() const {
+    return status_.ok() ? absl::string_view(message_) : status_.message();
+  }
+
  private:
   RuntimeIssue(absl::Status status, Severity severity, ErrorCode error_code)
       : status_(std::move(status)),
@@ -79,6 +100,7 @@ class RuntimeIssue {
         severity_(severity) {}
 
   absl::Status status_;
+  std::string message_;
   ErrorCode error_code_;
   Severity severity_;
 };
@@ -14,7 +14,6 @@
 
 #include "runtime/standard/container_functions.h"
 
-#include <cstddef>
 #include <cstdint>
 #include <utility>
 
@@ -49,33 +48,10 @@ absl::StatusOr<ListValue> ConcatList(
     const google::protobuf::DescriptorPool* absl_nonnull descriptor_pool,
     google::protobuf::MessageFactory* absl_nonnull message_factory,
     google::protobuf::Arena* absl_nonnull arena) {
-  CEL_ASSIGN_OR_RETURN(auto size1, value1.Size());
-  if (size1 == 0) {
-    return value2;
-  }
-  CEL_ASSIGN_OR_RETURN(auto size2, value2.Size());
-  if (size2 == 0) {
-    return value1;
-  }
-
-  // TODO(uncreated-issue/50): add option for checking lists have homogenous element
-  // types and use a more specialized list type when possible.
-  auto list_builder = NewListValueBuilder(arena);
-
-  list_builder->Reserve(size1 + size2);
-
-  for (size_t i = 0; i < size1; i++) {
-    CEL_ASSIGN_OR_RETURN(
-        Value elem, value1.Get(i, descriptor_pool, message_factory, arena));
-    CEL_RETURN_IF_ERROR(list_builder->Add(std::move(elem)));
-  }
-  for (size_t i = 0; i < size2; i++) {
-    CEL_ASSIGN_OR_RETURN(
-        Value elem, value2.Get(i, descriptor_pool, message_factory, arena));
-    CEL_RETURN_IF_ERROR(list_builder->Add(std::move(elem)));
-  }
-
-  return std::move(*list_builder).Build();
+  // The result shares the elements of both operands, so accumulating a list
+  // by repeated concatenation in a comprehension is linear.
+  return common_internal::ConcatListValues(value1, value2, descriptor_pool,
+                                           message_factory, arena);
 }
 
 // AppendList will append the elements in value2 to value1.
@@ -13,6 +13,9 @@
 // limitations under the License.
 #include "runtime/standard/regex_functions.h"
 
+#include <memory>
+#include <string>
+
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
 #include "base/builtins.h"
@@ -20,6 +23,8 @@
 #include "common/value.h"
 #include "internal/status_macros.h"
 #include "runtime/function_registry.h"
+#include "runtime/internal/regex_cache.h"
+#include "runtime/internal/regex_cache_access.h"
 #include "runtime/runtime_options.h"
 #include "re2/re2.h"
 
@@ -29,19 +34,28 @@ namespace {}  // namespace
 absl::Status RegisterRegexFunctions(FunctionRegistry& registry,
                                     const RuntimeOptions& options) {
   if (options.enable_regex) {
-    auto regex_matches = [max_size = options.regex_max_program_size](
+    // Patterns which are not constant, and therefore not precompiled by the
+    // planner, are compiled through the registry's regex cache.
+    auto regex_matches = [max_size = options.regex_max_program_size,
+                          cache = runtime_internal::RegexCacheAccess::
+                              GetOrCreate(registry,
+                                          options.regex_cache_capacity)](
                              const StringValue& target,
                              const StringValue& regex) -> Value {
-      RE2 re2(regex.ToString());
-      if (max_size > 0 && re2.ProgramSize() > max_size) {
+      std::string regex_scratch;
+      std::shared_ptr<const RE2> re2 =
+          cache->Get(regex.ToStringView(&regex_scratch), max_size);
+      if (max_size > 0 && re2->ProgramSize() > max_size) {
         return ErrorValue(
             absl::InvalidArgumentError("exceeded RE2 max program size"));
       }
-      if (!re2.ok()) {
+      if (!re2->ok()) {
         return ErrorValue(
             absl::InvalidArgumentError("invalid regex for match"));
       }
-      return BoolValue(RE2::PartialMatch(target.ToString(), re2));
+      std::string target_scratch;
+      return BoolValue(
+          RE2::PartialMatch(target.ToStringView(&target_scratch), *re2));
     };
 
     // bind str.matches(re) and matches(str, re)
@@ -17,11 +17,23 @@
 
 #include "base/builtins.h"
 #include "common/function_descriptor.h"
+#include "common/kind.h"
+#include "common/value.h"
+#include "common/value_testing.h"
 #include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "internal/testing_message_factory.h"
+#include "runtime/function_registry.h"
+#include "runtime/regex_cache_stats.h"
+#include "runtime/runtime_options.h"
+#include "google/protobuf/arena.h"
 
 namespace cel {
 namespace {
 
+using ::absl_testing::IsOkAndHolds;
+using ::cel::test::BoolValueIs;
+using ::cel::test::ErrorValueIs;
 using ::testing::IsEmpty;
 using ::testing::UnorderedElementsAre;
 
@@ -70,6 +82,65 @@ TEST(RegisterRegexFunctions, NotRegisteredIfDisabled) {
   EXPECT_THAT(overloads[builtin::kRegexMatch], IsEmpty());
 }
 
+TEST(RegisterRegexFunctions, CompilesThroughRegistryCache) {
+  FunctionRegistry registry;
+  RuntimeOptions options;
+  options.regex_max_program_size = 100;
+
+  ASSERT_OK(RegisterRegexFunctions(registry, options));
+
+  auto overloads = registry.FindStaticOverloads(
+      builtin::kRegexMatch, /*receiver_style=*/true,
+      {Kind::kString, Kind::kString});
+  ASSERT_THAT(overloads, testing::SizeIs(1));
+  const Function& matches = overloads[0].implementation;
+  google::protobuf::Arena arena;
+  auto invoke = [&](const char* target, const char* pattern) {
+    std::vector<Value> args = {StringValue(target), StringValue(pattern)};
+    return matches.Invoke(args, internal::GetTestingDescriptorPool(),
+                          internal::GetTestingMessageFactory(), &arena);
+  };
+
+  EXPECT_THAT(invoke("abc", "b+"), IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(invoke("xyz", "b+"), IsOkAndHolds(BoolValueIs(false)));
+  EXPECT_THAT(invoke("abc", "("), IsOkAndHolds(ErrorValueIs(testing::_)));
+  EXPECT_THAT(invoke("abc", "[a-z]{1,100}"),
+              IsOkAndHolds(ErrorValueIs(testing::_)));
+
+  RegexCacheStats stats = registry.regex_cache_stats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 3);
+  // The program exceeding `regex_max_program_size` is not retained.
+  EXPECT_EQ(stats.size, 2);
+}
+
+TEST(RegisterRegexFunctions, CacheCapacityFromOptions) {
+  FunctionRegistry registry;
+  RuntimeOptions options;
+  options.regex_cache_capacity = 0;
+
+  EXPECT_EQ(registry.regex_cache_stats().misses, 0);
+  ASSERT_OK(RegisterRegexFunctions(registry, options));
+
+  auto overloads = registry.FindStaticOverloads(
+      builtin::kRegexMatch, /*receiver_style=*/true,
+      {Kind::kString, Kind::kString});
+  ASSERT_THAT(overloads, testing::SizeIs(1));
+  const Function& matches = overloads[0].implementation;
+  google::protobuf::Arena arena;
+  std::vector<Value> args = {StringValue("abc"), StringValue("b+")};
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_THAT(matches.Invoke(args, internal::GetTestingDescriptorPool(),
+                               internal::GetTestingMessageFactory(), &arena),
+                IsOkAndHolds(BoolValueIs(true)));
+  }
+
+  RegexCacheStats stats = registry.regex_cache_stats();
+  EXPECT_EQ(stats.hits, 0);
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.size, 0);
+}
+
 // TODO(uncreated-issue/41): move functional parsed expr tests when modern APIs for
 // evaluator available.
 
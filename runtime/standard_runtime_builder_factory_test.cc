@@ -27,6 +27,7 @@
 #include "absl/status/status_matchers.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "base/builtins.h"
 #include "common/source.h"
 #include "common/value.h"
@@ -38,6 +39,7 @@
 #include "parser/parser.h"
 #include "parser/standard_macros.h"
 #include "runtime/activation.h"
+#include "runtime/activation_interface.h"
 #include "runtime/internal/runtime_impl.h"
 #include "runtime/runtime.h"
 #include "runtime/runtime_issue.h"
@@ -52,9 +54,12 @@ using ::absl_testing::IsOk;
 using ::absl_testing::StatusIs;
 using ::cel::extensions::ProtobufRuntimeAdapter;
 using ::cel::test::BoolValueIs;
+using ::cel::test::ErrorValueIs;
+using ::cel::test::IntValueIs;
 using ::cel::expr::ParsedExpr;
 using ::google::api::expr::parser::Parse;
 using ::testing::ElementsAre;
+using ::testing::HasSubstr;
 using ::testing::TestWithParam;
 using ::testing::Truly;
 
@@ -221,6 +226,72 @@ TEST_P(StandardRuntimeTest, RecursiveFastBuiltins) {
       << test_case.expression;
 }
 
+TEST_P(StandardRuntimeTest, InstructionLowering) {
+  RuntimeOptions opts;
+  opts.enable_instruction_lowering = true;
+  const EvaluateResultTestCase& test_case = GetTestCase();
+
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       CreateStandardRuntimeBuilder(
+                           google::protobuf::DescriptorPool::generated_pool(), opts));
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr expr,
+                       ParseWithTestMacros(test_case.expression));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  EXPECT_FALSE(runtime_internal::TestOnly_IsRecursiveImpl(program.get()));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  if (test_case.activation_builder != nullptr) {
+    ASSERT_THAT(test_case.activation_builder(activation), IsOk());
+  }
+
+  ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena, activation));
+
+  EXPECT_THAT(result, BoolValueIs(test_case.expected_result))
+      << test_case.expression;
+}
+
+TEST_P(StandardRuntimeTest, EvaluatorStatePool) {
+  RuntimeOptions opts;
+  opts.evaluator_state_pool_size = 2;
+  const EvaluateResultTestCase& test_case = GetTestCase();
+
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       CreateStandardRuntimeBuilder(
+                           google::protobuf::DescriptorPool::generated_pool(), opts));
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr expr,
+                       ParseWithTestMacros(test_case.expression));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  Activation activation;
+  if (test_case.activation_builder != nullptr) {
+    ASSERT_THAT(test_case.activation_builder(activation), IsOk());
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    google::protobuf::Arena arena;
+    ASSERT_OK_AND_ASSIGN(Value result, program->Evaluate(&arena, activation));
+    EXPECT_THAT(result, BoolValueIs(test_case.expected_result))
+        << test_case.expression;
+  }
+
+  auto stats = runtime_internal::GetEvaluatorStatePoolStats(*program);
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(stats->misses, 1);
+  EXPECT_EQ(stats->hits, 2);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     Basic, StandardRuntimeTest,
     testing::ValuesIn(std::vector<EvaluateResultTestCase>{
@@ -756,6 +827,82 @@ TEST_P(StandardRuntimeEvalStrategyTest, InvalidBuiltinIn) {
               StatusIs(absl::StatusCode::kInvalidArgument));
 }
 
+TEST_P(StandardRuntimeEvalStrategyTest, EvaluateBatch) {
+  EvalStrategy eval_strategy = GetParam();
+  RuntimeOptions options;
+  if (eval_strategy == EvalStrategy::kRecursive) {
+    options.max_recursion_depth = -1;
+  } else {
+    options.max_recursion_depth = 0;
+  }
+
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       CreateStandardRuntimeBuilder(
+                           google::protobuf::DescriptorPool::generated_pool(), options));
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(
+      ParsedExpr expr,
+      ParseWithTestMacros("[1, 2, 3].exists(i, i == x) ? x * 10 : 1 / x"));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  google::protobuf::Arena arena;
+  std::vector<Activation> activations(4);
+  activations[0].InsertOrAssignValue("x", IntValue(1));
+  activations[1].InsertOrAssignValue("x", IntValue(3));
+  activations[2].InsertOrAssignValue("x", IntValue(0));
+  activations[3].InsertOrAssignValue("x", IntValue(4));
+  std::vector<const ActivationInterface*> activation_ptrs;
+  for (const auto& activation : activations) {
+    activation_ptrs.push_back(&activation);
+  }
+  std::vector<Value> results(activation_ptrs.size());
+
+  ASSERT_THAT(program->EvaluateBatch(&arena, activation_ptrs,
+                                     absl::MakeSpan(results)),
+              IsOk());
+
+  EXPECT_THAT(results,
+              ElementsAre(IntValueIs(10), IntValueIs(30),
+                          ErrorValueIs(StatusIs(absl::StatusCode::kInvalidArgument,
+                                                HasSubstr("divide by zero"))),
+                          IntValueIs(0)));
+}
+
+TEST_P(StandardRuntimeEvalStrategyTest, EvaluateBatchSizeMismatch) {
+  EvalStrategy eval_strategy = GetParam();
+  RuntimeOptions options;
+  if (eval_strategy == EvalStrategy::kRecursive) {
+    options.max_recursion_depth = -1;
+  } else {
+    options.max_recursion_depth = 0;
+  }
+
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       CreateStandardRuntimeBuilder(
+                           google::protobuf::DescriptorPool::generated_pool(), options));
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr expr, ParseWithTestMacros("1 + 2"));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  google::protobuf::Arena arena;
+  Activation activation;
+  std::vector<const ActivationInterface*> activations = {&activation,
+                                                         &activation};
+  std::vector<Value> results(1);
+
+  EXPECT_THAT(
+      program->EvaluateBatch(&arena, activations, absl::MakeSpan(results)),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     StandardRuntimeEvalStrategyTest, StandardRuntimeEvalStrategyTest,
     testing::Values(EvalStrategy::kIterative, EvalStrategy::kRecursive),